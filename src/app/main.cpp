@@ -17,15 +17,396 @@
  * -----------------------------------------------------------------------
  */
 
+#include "aerodromecache.h"
 #include "asterixxmlreader.h"
-#include "dgpscsvreader.h"
+#include "evaldump.h"
+#include "jsonwriter.h"
 #include "kmlreader.h"
+#include "livefeed.h"
 #include "perfevaluator.h"
+#include "pipeline.h"
+#include "profiler.h"
+#include "rollingevaluator.h"
+#include "spoolserver.h"
 #include "targetreportextractor.h"
-#include "trackextractor.h"
 #include <QCoreApplication>
+#include <QDeadlineTimer>
 #include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
 #include <QLoggingCategory>
+#include <QProcess>
+#include <QRegularExpression>
+#include <QSaveFile>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <QThread>
+#include <QTimer>
+#include <memory>
+#include <vector>
+
+namespace
+{
+/*!
+ * \brief Evaluates a spooled recording and writes its results as JSON.
+ * If the recording cannot be evaluated, an "error" member is written
+ * instead, so that clients waiting for the result are not left hanging.
+ */
+bool writeResult(const Pipeline &pipeline, const QString &inputPath, const QString &resultPath)
+{
+    const std::optional<PerfResults> results = pipeline.evaluate(inputPath);
+
+    QSaveFile file(resultPath);
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        qWarning() << "Could not write" << resultPath;
+        return false;
+    }
+
+    if (results.has_value())
+    {
+        printJson(results.value(), &file);
+    }
+    else
+    {
+        JsonWriter json(&file);
+        json.beginObject();
+        json.writeMember(QLatin1String("error"), QLatin1String("Could not open the recording."));
+        json.endObject();
+    }
+
+    return file.commit() && results.has_value();
+}
+
+/*!
+ * \brief Value of the integer option \a name in \a args, or
+ * \a defaultValue if it is not given. Terminates if it is below \a min.
+ */
+int intOption(const QStringList &args, const QString &name, int defaultValue, int min)
+{
+    const int idx = args.indexOf(name);
+    if (idx == -1 || idx + 1 >= args.size())
+    {
+        return defaultValue;
+    }
+
+    bool ok = false;
+    const int value = args.at(idx + 1).toInt(&ok);
+    if (!ok || value < min)
+    {
+        qFatal("Invalid %s value.", qPrintable(name));
+    }
+
+    return value;
+}
+
+/*!
+ * \brief Prints \a results to stdout, as JSON with --json or as plain text
+ * tables otherwise.
+ */
+void printResults(const PerfResults &results, const QStringList &args)
+{
+    if (args.contains(QLatin1String("--json")))  // Print JSON output.
+    {
+        QFile out;
+        out.open(stdout, QIODevice::WriteOnly);
+        printJson(results, &out);
+    }
+    else  // Print plain text tables.
+    {
+        QTextStream out(stdout);
+        printText(results, out);
+    }
+}
+
+/*!
+ * \brief Merges the evaluation states at \a paths, written with --state,
+ * and prints the results of the whole.
+ */
+int mergeStates(const RunConfig &config, const QStringList &paths, const QStringList &args)
+{
+    PerfEvaluator perfEval(config);
+
+    for (const QString &path : paths)
+    {
+        QFile file(path);
+        if (!file.open(QIODevice::ReadOnly))
+        {
+            qWarning() << "Could not open" << path;
+            return 1;
+        }
+
+        if (!perfEval.mergeState(&file))
+        {
+            qWarning() << "Could not merge" << path;
+            return 1;
+        }
+    }
+
+    perfEval.finish();
+    printResults(perfEval.results(), args);
+
+    return 0;
+}
+
+/*!
+ * \brief Evaluates \a inputPath with \a shards worker processes, each one
+ * evaluating a Mode-S shard of the traffic ("--shard i/N"), and prints
+ * the results of their merged states. They are the same as those of a
+ * single process, as the RPA PIC threshold is only applied once merged.
+ */
+int runShards(const RunConfig &config, const QString &inputPath, int shards,
+    const QStringList &args)
+{
+    if (inputPath.isEmpty())
+    {
+        qWarning() << "Sharded evaluation needs an input file, not stdin";
+        return 1;
+    }
+
+    QTemporaryDir stateDir;
+    if (!stateDir.isValid())
+    {
+        qWarning() << "Could not create a directory for the shard states";
+        return 1;
+    }
+
+    // The workers get the same arguments, except for the options that
+    // write outputs of their own.
+    QStringList workerArgs;
+    for (int i = 1; i < args.size(); ++i)
+    {
+        const QString &arg = args.at(i);
+        if (arg == QLatin1String("--shards") || arg == QLatin1String("--state"))
+        {
+            ++i;
+        }
+        else if (arg != QLatin1String("--json") && !arg.startsWith(QLatin1String("--perf-report")))
+        {
+            workerArgs << arg;
+        }
+    }
+
+    std::vector<std::unique_ptr<QProcess>> workers;
+    QStringList statePaths;
+
+    for (int i = 0; i < shards; ++i)
+    {
+        const QString statePath = stateDir.filePath(QStringLiteral("shard-%1.state").arg(i));
+        statePaths << statePath;
+
+        auto worker = std::make_unique<QProcess>();
+        worker->setProcessChannelMode(QProcess::ForwardedErrorChannel);
+        worker->setStandardOutputFile(QProcess::nullDevice());
+        worker->start(QCoreApplication::applicationFilePath(),
+            QStringList(workerArgs)
+                << QLatin1String("--shard") << QStringLiteral("%1/%2").arg(i).arg(shards)
+                << QLatin1String("--state") << statePath);
+
+        workers.push_back(std::move(worker));
+    }
+
+    bool ok = true;
+    for (int i = 0; i < shards; ++i)
+    {
+        QProcess *worker = workers.at(i).get();
+        if (!worker->waitForFinished(-1) || worker->exitStatus() != QProcess::NormalExit ||
+            worker->exitCode() != 0)
+        {
+            qWarning() << "Shard" << i << "failed:" << worker->errorString();
+            ok = false;
+        }
+    }
+
+    if (!ok)
+    {
+        return 1;
+    }
+
+    return mergeStates(config, statePaths, args);
+}
+
+/*!
+ * \brief Submits \a files to the spool directory \a dir and prints the
+ * paths of their results as they appear. Returns non-zero if a result
+ * does not appear within \a timeoutSec seconds or reports an error.
+ */
+int submitRecordings(const QString &dir, const QStringList &files, int timeoutSec)
+{
+    QStringList resultPaths;
+    for (const QString &f : files)
+    {
+        std::optional<QString> resultPath = SpoolServer::submit(dir, f);
+        if (!resultPath.has_value())
+        {
+            return 1;
+        }
+
+        resultPaths << resultPath.value();
+    }
+
+    const QDeadlineTimer deadline(qint64(timeoutSec) * 1000);
+
+    int status = 0;
+    QTextStream out(stdout);
+    for (const QString &resultPath : qAsConst(resultPaths))
+    {
+        while (!QFileInfo::exists(resultPath))
+        {
+            if (deadline.hasExpired())
+            {
+                qWarning() << "Timed out waiting for" << resultPath;
+                return 1;
+            }
+
+            QThread::msleep(100);
+        }
+
+        // The server writes an "error" member for recordings it could not
+        // evaluate.
+        QFile file(resultPath);
+        file.open(QIODevice::ReadOnly);
+
+        QJsonParseError parseError;
+        const QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &parseError);
+
+        if (parseError.error != QJsonParseError::NoError || !doc.isObject())
+        {
+            qWarning() << "Invalid result" << resultPath;
+            status = 1;
+        }
+        else if (doc.object().contains(QLatin1String("error")))
+        {
+            qWarning() << "Evaluation failed:" << resultPath
+                       << doc.object().value(QLatin1String("error")).toString();
+            status = 1;
+        }
+
+        out << resultPath << '\n';
+        out.flush();
+    }
+
+    return status;
+}
+
+/*!
+ * \brief Evaluates the records received from the network feed \a spec
+ * (udp:<port>, udp:<group>:<port> or tcp:<host>:<port>) and prints the
+ * metrics over the last --window minutes every --interval seconds.
+ */
+int runLive(const RunConfig &config, const Aerodrome &aerodrome, const QString &spec, const QStringList &args)
+{
+    if (config.mode != ProcessingMode::Too)
+    {
+        qFatal("Live input is only supported in TOO mode.");
+    }
+
+    const QStringList fields = spec.split(QLatin1Char(':'));
+
+    bool ok = false;
+    const quint16 port = fields.last().toUShort(&ok);
+    if (!ok || fields.size() < 2 || fields.size() > 3)
+    {
+        qFatal("Invalid --listen value %s.", qPrintable(spec));
+    }
+
+    LiveFeed feed;
+    if (fields.first() == QLatin1String("udp"))
+    {
+        const QHostAddress group = fields.size() == 3 ? QHostAddress(fields.at(1)) : QHostAddress();
+        if (!feed.listenUdp(port, group))
+        {
+            return 1;
+        }
+    }
+    else if (fields.first() == QLatin1String("tcp") && fields.size() == 3)
+    {
+        feed.connectTcp(fields.at(1), port);
+    }
+    else
+    {
+        qFatal("Invalid --listen value %s.", qPrintable(spec));
+    }
+
+    const int windowMin = intOption(args, QLatin1String("--window"), 15, 1);
+    const int intervalSec = intOption(args, QLatin1String("--interval"), 60, 1);
+    const bool json = args.contains(QLatin1String("--json"));
+
+    auto locateCallback = [&aerodrome](const QVector3D cartPos, const bool gndBit) {
+        return aerodrome.locatePoint(cartPos, gndBit);
+    };
+
+    AsterixXmlReader astXmlReader(config);
+
+    TargetReportExtractor tgtRepExtr(config, aerodrome.arp(), aerodrome.smr());
+    tgtRepExtr.setLocatePointCallback(locateCallback);
+
+    RollingEvaluator rollingEval(config, qint64(windowMin) * 60 * 1000);
+
+    QObject::connect(&feed, &LiveFeed::readyRead, [&]() {
+        astXmlReader.addData(feed.takeData());
+    });
+
+    QVector<Asterix::Record> records;
+    QVector<TargetReport> tgtReps;
+
+    QObject::connect(&astXmlReader, &AsterixXmlReader::readyRead, [&]() {
+        astXmlReader.takeAll(records);
+        tgtRepExtr.addData(records);
+        records.resize(0);
+    });
+
+    QObject::connect(&tgtRepExtr, &TargetReportExtractor::readyRead, [&]() {
+        tgtRepExtr.takeAll(tgtReps);
+        for (const TargetReport &tr : qAsConst(tgtReps))
+        {
+            rollingEval.addData(tr);
+        }
+        tgtReps.resize(0);
+    });
+
+    QTimer snapshotTimer;
+    snapshotTimer.setInterval(intervalSec * 1000);
+
+    QObject::connect(&snapshotTimer, &QTimer::timeout, [&]() {
+        if (rollingEval.isEmpty())
+        {
+            return;
+        }
+
+        qInfo() << "Snapshot of" << rollingEval.size() << "target reports from"
+                << rollingEval.windowStart() << "to" << rollingEval.windowEnd();
+
+        if (rollingEval.watermarks().lateCount() > 0)
+        {
+            qInfo() << "Late target reports discarded:"
+                    << qPrintable(rollingEval.watermarks().lateSummary());
+        }
+
+        const PerfResults results = rollingEval.evaluate();
+
+        QFile out;
+        out.open(stdout, QIODevice::WriteOnly);
+
+        if (json)
+        {
+            printJson(results, &out);
+        }
+        else
+        {
+            QTextStream stream(&out);
+            stream << "Window " << rollingEval.windowStart().toString(Qt::ISODateWithMs)
+                   << " - " << rollingEval.windowEnd().toString(Qt::ISODateWithMs) << '\n';
+            printText(results, stream);
+        }
+    });
+
+    snapshotTimer.start();
+
+    return QCoreApplication::exec();
+}
+}  // namespace
 
 int main(int argc, char *argv[])
 {
@@ -33,8 +414,6 @@ int main(int argc, char *argv[])
     QCoreApplication::setOrganizationName(QLatin1String("astmops"));
     QCoreApplication::setApplicationName(QLatin1String("astmops"));
 
-    static ProcessingMode mode = Configuration::processingMode();
-
     std::optional<QString> logRules_opt = Configuration::logRules();
     if (logRules_opt.has_value())
     {
@@ -53,10 +432,62 @@ int main(int argc, char *argv[])
     }
 
     const QStringList args = application.arguments();
+
+    // Per-stage instrumentation: "--perf-report" prints a table and
+    // "--perf-report=json" a JSON document to stderr at the end of the run.
+    const int perfIdx = args.indexOf(QRegularExpression(QStringLiteral("^--perf-report(=json)?$")));
+    Profiler::setEnabled(perfIdx != -1);
     qDebug() << "args" << args;
 
+    // Client of the daemon mode: submit recordings to a spool directory
+    // and wait up to --timeout seconds for their results.
+    const int submitIdx = args.indexOf(QLatin1String("--submit"));
+    if (submitIdx != -1 && submitIdx + 1 < args.size())
+    {
+        const int timeoutSec = intOption(args, QLatin1String("--timeout"), 3600, 1);
+
+        QStringList files;
+        for (int i = submitIdx + 2; i < args.size(); ++i)
+        {
+            if (args.at(i) == QLatin1String("--timeout"))
+            {
+                ++i;
+            }
+            else if (!args.at(i).startsWith(QLatin1String("--")))
+            {
+                files << args.at(i);
+            }
+        }
+
+        return submitRecordings(args.at(submitIdx + 1), files, timeoutSec);
+    }
+
     qInfo() << "Configuration file:" << Configuration::fileName();
 
+    const RunConfig config = RunConfig::fromSettings();
+
+    // Merge of the evaluation states of several runs: "astmops merge
+    // a.state b.state ...".
+    if (args.size() > 1 && args.at(1) == QLatin1String("merge"))
+    {
+        if (args.contains(QLatin1String("--dump")))
+        {
+            qWarning() << "--dump is not supported by merge: the states hold no records";
+            return 1;
+        }
+
+        QStringList paths;
+        for (int i = 2; i < args.size(); ++i)
+        {
+            if (!args.at(i).startsWith(QLatin1String("--")))
+            {
+                paths << args.at(i);
+            }
+        }
+
+        return mergeStates(config, paths, args);
+    }
+
     if (qEnvironmentVariableIsSet("APPDIR"))
     {
         // When running from an AppImage, we need to find out the location of
@@ -69,92 +500,188 @@ int main(int argc, char *argv[])
     }
 
     QString kmlFilePath = Configuration::kmlFile();
-    QFile kmlFile(kmlFilePath);
-    kmlFile.open(QIODevice::ReadOnly);
+    AerodromeCache aerodromeCache(kmlFilePath);
 
-    KmlReader kmlReader;
-    kmlReader.read(&kmlFile);
+    Aerodrome aerodrome;
+    if (std::optional<Aerodrome> cached = aerodromeCache.load())
+    {
+        aerodrome = cached.value();
+        qInfo() << "Aerodrome loaded from cache" << aerodromeCache.filePath();
+    }
+    else
+    {
+        QFile kmlFile(kmlFilePath);
+        kmlFile.open(QIODevice::ReadOnly);
 
-    Aerodrome aerodrome = kmlReader.makeAerodrome();
+        KmlReader kmlReader;
+        kmlReader.read(&kmlFile);
 
-    auto leblCallback = [&aerodrome](const QVector3D cartPos, const bool gndBit) {
-        return aerodrome.locatePoint(cartPos, gndBit);
-    };
+        aerodrome = kmlReader.makeAerodrome();
+        aerodromeCache.store(aerodrome);
+    }
+
+    Pipeline pipeline(config, aerodrome);
+    pipeline.setKmlFile(kmlFilePath);
 
-    AsterixXmlReader astXmlReader;
+    if (config.mode == ProcessingMode::Dgps)
+    {
+        pipeline.setDgpsFile(Configuration::dgpsFile());
+    }
+
+    // Optional cache of the extracted tracks.
+    const int cacheIdx = args.indexOf(QLatin1String("--cache"));
+    if (cacheIdx != -1 && cacheIdx + 1 < args.size())
+    {
+        pipeline.setCacheDir(args.at(cacheIdx + 1));
+    }
 
-    TargetReportExtractor tgtRepExtr(aerodrome.arp(), aerodrome.smr());
-    tgtRepExtr.setLocatePointCallback(leblCallback);
+    // Time segments of the recording extracted in parallel.
+    pipeline.setSegments(intOption(args, QLatin1String("--segments"), 1, 1));
 
-    TrackExtractor trackExtr;
+    // Reading, extraction and track building on separate threads.
+    pipeline.setPipelined(args.contains(QLatin1String("--pipelined")));
 
-    QObject::connect(&astXmlReader, &AsterixXmlReader::readyRead, [&]() {
-        while (astXmlReader.hasPendingData())
+    // Daemon mode: evaluate every recording dropped into a spool
+    // directory, keeping the configuration and the aerodrome loaded.
+    const int serveIdx = args.indexOf(QLatin1String("--serve"));
+    if (serveIdx != -1 && serveIdx + 1 < args.size())
+    {
+        const int jobs = intOption(args, QLatin1String("--jobs"), QThread::idealThreadCount(), 1);
+
+        auto job = [&pipeline](const QString &inputPath, const QString &resultPath) {
+            return writeResult(pipeline, inputPath, resultPath);
+        };
+
+        SpoolServer server(args.at(serveIdx + 1), job, jobs);
+        if (!server.start())
         {
-            tgtRepExtr.addData(astXmlReader.takeData().value());
+            return 1;
         }
-    });
 
-    QObject::connect(&tgtRepExtr, &TargetReportExtractor::readyRead, [&]() {
-        while (tgtRepExtr.hasPendingData())
+        qInfo() << "Serving" << args.at(serveIdx + 1) << "with" << jobs << "jobs";
+
+        return application.exec();
+    }
+
+    // Live mode: evaluate a network feed over a sliding window.
+    const int listenIdx = args.indexOf(QLatin1String("--listen"));
+    if (listenIdx != -1 && listenIdx + 1 < args.size())
+    {
+        return runLive(config, aerodrome, args.at(listenIdx + 1), args);
+    }
+
+    // ASTERIX XML input: the first argument that is not an option, or
+    // stdin if there is none.
+    const QStringList valueOptions = {QLatin1String("--dump"), QLatin1String("--cache"),
+        QLatin1String("--serve"), QLatin1String("--jobs"), QLatin1String("--listen"),
+        QLatin1String("--window"), QLatin1String("--interval"), QLatin1String("--state"),
+        QLatin1String("--shards"), QLatin1String("--shard"), QLatin1String("--segments")};
+
+    QString inputPath;
+    for (int i = 1; i < args.size(); ++i)
+    {
+        if (valueOptions.contains(args.at(i)))
         {
-            trackExtr.addData(tgtRepExtr.takeData().value());
+            ++i;
         }
-    });
+        else if (!args.at(i).startsWith(QLatin1String("--")))
+        {
+            inputPath = args.at(i);
+            break;
+        }
+    }
 
-    PerfEvaluator perfEval;
+    // Sharded evaluation: worker processes evaluate a Mode-S shard each
+    // and their states are merged.
+    const int shards = intOption(args, QLatin1String("--shards"), 1, 1);
+    if (shards > 1)
+    {
+        if (args.contains(QLatin1String("--dump")))
+        {
+            qWarning() << "--dump is not supported with --shards";
+            return 1;
+        }
 
-    // DGPS CSV reference.
-    if (mode == ProcessingMode::Dgps)
+        return runShards(config, inputPath, shards, args);
+    }
+
+    // Evaluation of a single shard: "--shard i/N".
+    const int shardIdx = args.indexOf(QLatin1String("--shard"));
+    if (shardIdx != -1 && shardIdx + 1 < args.size())
     {
-        QString dgpsPath = Configuration::dgpsFile();
-        ModeS mode_s = Configuration::dgpsModeS();
-        Mode3A mode_3a = Configuration::dgpsMode3A();
-        Ident ident = Configuration::dgpsIdent();
-        qint32 tod_offset = Configuration::dgpsTodOffset();
+        const QRegularExpressionMatch match =
+            QRegularExpression(QStringLiteral("^(\\d+)/(\\d+)$")).match(args.at(shardIdx + 1));
 
-        QFile dgpsFile(dgpsPath);
-        dgpsFile.open(QIODevice::ReadOnly);
+        const int index = match.captured(1).toInt();
+        const int count = match.captured(2).toInt();
+        if (!match.hasMatch() || count < 1 || index >= count)
+        {
+            qFatal("Invalid --shard value.");
+        }
 
-        DgpsTargetData dgps;
-        dgps.mode_s_ = mode_s;
-        dgps.mode_3a_ = mode_3a;
-        dgps.ident_ = ident;
-        dgps.tod_offset_ = tod_offset;
-        dgps.data_ = readDgpsCsv(&dgpsFile);
+        pipeline.setShard(index, count);
+    }
+
+    // Optional dump of the intermediate evaluation records. Written to a
+    // QSaveFile, so that a failed run does not leave a truncated dump.
+    QSaveFile dumpFile;
+    std::unique_ptr<EvalDump> dump;
 
-        tgtRepExtr.addDgpsData(dgps);
+    const int dumpIdx = args.indexOf(QLatin1String("--dump"));
+    if (dumpIdx != -1 && dumpIdx + 1 < args.size())
+    {
+        dumpFile.setFileName(args.at(dumpIdx + 1));
+        if (!dumpFile.open(QIODevice::WriteOnly))
+        {
+            qFatal("Could not open dump file %s.", qPrintable(dumpFile.fileName()));
+        }
+
+        dump = std::make_unique<EvalDump>(&dumpFile);
     }
 
+    // Optional mergeable evaluation state, see "astmops merge".
+    QSaveFile stateFile;
 
-    // ASTERIX XML.
-    QFile astXmlFile;
-    if (args.size() > 1)
+    const int stateIdx = args.indexOf(QLatin1String("--state"));
+    if (stateIdx != -1 && stateIdx + 1 < args.size())
     {
-        astXmlFile.setFileName(args.at(1));
-        astXmlFile.open(QIODevice::ReadOnly);
+        stateFile.setFileName(args.at(stateIdx + 1));
+        if (!stateFile.open(QIODevice::WriteOnly))
+        {
+            qFatal("Could not open state file %s.", qPrintable(stateFile.fileName()));
+        }
     }
-    else  // stdin
+
+    const std::optional<PerfResults> results = pipeline.evaluate(inputPath, dump.get(),
+        stateFile.isOpen() ? &stateFile : nullptr);
+    if (!results.has_value() || (stateFile.isOpen() && !stateFile.commit()))
     {
-        astXmlFile.open(stdin, QIODevice::ReadOnly);
+        return 1;
     }
 
-    while (!astXmlFile.atEnd())
+    if (dump && (!dump->finish() || !dumpFile.commit()))
     {
-        const QByteArray line = astXmlFile.readLine();
-        astXmlReader.addData(line);
+        qWarning() << "Could not write dump file" << dumpFile.fileName() << dumpFile.errorString();
+        return 1;
     }
 
-    while (trackExtr.hasPendingData())
+    printResults(results.value(), args);
+
+    if (Profiler::isEnabled())
     {
-        std::optional<Track> trk_opt = trackExtr.takeData();
-        if (trk_opt.has_value())
+        QFile err;
+        err.open(stderr, QIODevice::WriteOnly);
+
+        if (args.at(perfIdx).endsWith(QLatin1String("=json")))
         {
-            perfEval.addData(trk_opt.value());
+            Profiler::printJson(&err);
+        }
+        else
+        {
+            QTextStream out(&err);
+            Profiler::printText(out);
         }
     }
 
-    perfEval.run();
-
     qDebug() << "\nFinished!";
 }
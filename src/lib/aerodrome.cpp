@@ -218,6 +218,52 @@ bool operator!=(const Aerodrome::NamedArea &lhs, const Aerodrome::NamedArea &rhs
     return !(lhs == rhs);
 }
 
+QDataStream &operator<<(QDataStream &out, const Aerodrome::NamedArea &narea)
+{
+    return out << static_cast<quint32>(narea.area_) << narea.name_;
+}
+
+QDataStream &operator>>(QDataStream &in, Aerodrome::NamedArea &narea)
+{
+    quint32 area = 0;
+    in >> area >> narea.name_;
+    narea.area_ = static_cast<Aerodrome::Area>(area);
+
+    return in;
+}
+
+/*!
+ * \brief Binary serialization of the aerodrome geometry, as used by the
+ * aerodrome cache.
+ */
+QDataStream &operator<<(QDataStream &out, const Aerodrome &aerodrome)
+{
+    out << aerodrome.arp_
+        << aerodrome.smr_
+        << aerodrome.runwayElements_
+        << aerodrome.taxiwayElements_
+        << aerodrome.apronLaneElements_
+        << aerodrome.standElements_
+        << aerodrome.airborne1Elements_
+        << aerodrome.airborne2Elements_;
+
+    return out;
+}
+
+QDataStream &operator>>(QDataStream &in, Aerodrome &aerodrome)
+{
+    in >> aerodrome.arp_
+        >> aerodrome.smr_
+        >> aerodrome.runwayElements_
+        >> aerodrome.taxiwayElements_
+        >> aerodrome.apronLaneElements_
+        >> aerodrome.standElements_
+        >> aerodrome.airborne1Elements_
+        >> aerodrome.airborne2Elements_;
+
+    return in;
+}
+
 bool areaBelongsToAreaGroup(Aerodrome::Area area, Aerodrome::Area group)
 {
     if (area != Aerodrome::Area::None && (area | group) == group)
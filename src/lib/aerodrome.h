@@ -21,6 +21,7 @@
 #define ASTMOPS_AERODROME_H
 
 #include "astmops.h"
+#include <QDataStream>
 #include <QGeoCoordinate>
 #include <QHash>
 #include <QMetaEnum>
@@ -123,6 +124,9 @@ public:
     NamedArea locatePoint(const QVector3D cartPos, const bool gndBit) const;
 
 private:
+    friend QDataStream &operator<<(QDataStream &out, const Aerodrome &aerodrome);
+    friend QDataStream &operator>>(QDataStream &in, Aerodrome &aerodrome);
+
     bool collectionContainsPoint(const Polygons &col, QPointF pt) const;
     bool collectionContainsPoint(const QHash<QString, Polygons> &col, QPointF pt) const;
     std::optional<QString> areasContainingPoint(const QHash<QString, Polygons> &col, QPointF pt) const;
@@ -153,6 +157,12 @@ size_t qHash(const Aerodrome::NamedArea &narea, size_t seed);
 bool operator==(const Aerodrome::NamedArea &lhs, const Aerodrome::NamedArea &rhs);
 bool operator!=(const Aerodrome::NamedArea &lhs, const Aerodrome::NamedArea &rhs);
 
+QDataStream &operator<<(QDataStream &out, const Aerodrome::NamedArea &narea);
+QDataStream &operator>>(QDataStream &in, Aerodrome::NamedArea &narea);
+
+QDataStream &operator<<(QDataStream &out, const Aerodrome &aerodrome);
+QDataStream &operator>>(QDataStream &in, Aerodrome &aerodrome);
+
 
 bool areaBelongsToAreaGroup(Aerodrome::Area area, Aerodrome::Area group);
 bool areaBelongsToAreaGroup(const Aerodrome::NamedArea &narea, Aerodrome::Area group);
@@ -0,0 +1,125 @@
+/*!
+ * \file aerodromecache.cpp
+ * \brief Implementation of the AerodromeCache class.
+ * \author Álvaro Cebrián Juan, 2020. acebrianjuan(at)gmail.com
+ *
+ * -----------------------------------------------------------------------
+ *
+ * Copyright (C) 2020-2021 Álvaro Cebrián Juan <acebrianjuan@gmail.com>
+ *
+ * ASTMOPS is a command line tool for evaluating 
+ * the performance of A-SMGCS sensors at airports
+ *
+ * This file is part of ASTMOPS.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -----------------------------------------------------------------------
+ */
+
+#include "aerodromecache.h"
+#include "functions.h"
+#include <QDebug>
+#include <QFile>
+#include <QSaveFile>
+#include <cstring>
+
+namespace
+{
+const char magic[] = "ASTMAERO";
+const int magicSize = 8;
+const QDataStream::Version streamVersion = QDataStream::Qt_5_12;
+}  // namespace
+
+AerodromeCache::AerodromeCache(const QString &sourcePath)
+    : sourcePath_(sourcePath), digest_(fileDigest(sourcePath))
+{
+}
+
+QString AerodromeCache::filePath() const
+{
+    return sourcePath_ + QLatin1String(".cache");
+}
+
+/*!
+ * \brief Returns the cached aerodrome, or an empty optional if there is
+ * no cache file or it does not match the current source file.
+ */
+std::optional<Aerodrome> AerodromeCache::load() const
+{
+    if (digest_.isEmpty())
+    {
+        return std::nullopt;
+    }
+
+    QFile file(filePath());
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        return std::nullopt;
+    }
+
+    QDataStream in(&file);
+    in.setVersion(streamVersion);
+
+    char fileMagic[magicSize];
+    quint16 fileVersion = 0;
+    QByteArray cachedDigest;
+
+    if (in.readRawData(fileMagic, magicSize) != magicSize ||
+        std::memcmp(fileMagic, magic, magicSize) != 0)
+    {
+        qWarning() << "Ignoring invalid aerodrome cache" << file.fileName();
+        return std::nullopt;
+    }
+
+    in >> fileVersion >> cachedDigest;
+
+    if (in.status() != QDataStream::Ok || fileVersion != version || cachedDigest != digest_)
+    {
+        return std::nullopt;
+    }
+
+    Aerodrome aerodrome;
+    in >> aerodrome;
+
+    if (in.status() != QDataStream::Ok || !in.atEnd())
+    {
+        qWarning() << "Ignoring corrupt aerodrome cache" << file.fileName();
+        return std::nullopt;
+    }
+
+    return aerodrome;
+}
+
+/*!
+ * \brief Writes \a aerodrome to the cache file, replacing any previous
+ * one. Returns false if the file could not be written.
+ */
+bool AerodromeCache::store(const Aerodrome &aerodrome) const
+{
+    if (digest_.isEmpty())
+    {
+        return false;
+    }
+
+    QSaveFile file(filePath());
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        qWarning() << "Could not write aerodrome cache" << file.fileName();
+        return false;
+    }
+
+    QDataStream out(&file);
+    out.setVersion(streamVersion);
+
+    out.writeRawData(magic, magicSize);
+    out << version << digest_ << aerodrome;
+
+    if (out.status() != QDataStream::Ok || !file.commit())
+    {
+        qWarning() << "Could not write aerodrome cache" << file.fileName();
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,60 @@
+/*!
+ * \file aerodromecache.h
+ * \brief Interface of the AerodromeCache class.
+ * \author Álvaro Cebrián Juan, 2020. acebrianjuan(at)gmail.com
+ *
+ * -----------------------------------------------------------------------
+ *
+ * Copyright (C) 2020-2021 Álvaro Cebrián Juan <acebrianjuan@gmail.com>
+ *
+ * ASTMOPS is a command line tool for evaluating 
+ * the performance of A-SMGCS sensors at airports
+ *
+ * This file is part of ASTMOPS.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -----------------------------------------------------------------------
+ */
+
+#ifndef ASTMOPS_AERODROMECACHE_H
+#define ASTMOPS_AERODROMECACHE_H
+
+#include "aerodrome.h"
+#include <QString>
+#include <optional>
+
+/*!
+ * \brief The AerodromeCache class keeps a compiled copy of the aerodrome
+ * built from a description file, so that later runs skip the XML parsing
+ * and the geodetic to ENU conversion of every vertex.
+ *
+ * The cache is stored next to the source file, with a ".cache" suffix,
+ * and is only used while the SHA-256 of the source file matches the one
+ * recorded in it.
+ *
+ * File layout (QDataStream, Qt 5.12 format):
+ *
+ *     magic      8 bytes   "ASTMAERO"
+ *     version    quint16   AerodromeCache::version
+ *     digest     QByteArray SHA-256 of the source file
+ *     aerodrome  serialized Aerodrome
+ */
+class AerodromeCache
+{
+public:
+    static constexpr quint16 version = 2;
+
+    explicit AerodromeCache(const QString &sourcePath);
+
+    QString filePath() const;
+
+    std::optional<Aerodrome> load() const;
+    bool store(const Aerodrome &aerodrome) const;
+
+private:
+    QString sourcePath_;
+    QByteArray digest_;
+};
+
+#endif  // ASTMOPS_AERODROMECACHE_H
@@ -59,6 +59,7 @@ Aerodrome AixmReader::makeAerodrome() const
 
     // Coordinates of the local tangent plane origin.
     QGeoCoordinate geoOrigin = arp_;
+    LocalTangentPlane ltp(geoOrigin);
 
     // Runway elements.
     for (auto it = runwayElements_.begin(); it != runwayElements_.end(); ++it)
@@ -68,13 +69,7 @@ Aerodrome AixmReader::makeAerodrome() const
 
         for (const QVector<QGeoCoordinate> &rwyEleGeo : rwyElements)
         {
-            QPolygonF polygon;
-            polygon.reserve(rwyEleGeo.size());
-
-            for (const QGeoCoordinate &coord : rwyEleGeo)
-            {
-                polygon << geoToLocalEnu(coord, geoOrigin).toPointF();
-            }
+            QPolygonF polygon = ltp.toEnuPolygon(rwyEleGeo);
 
             aerodrome.addRunwayElement(idStr, polygon);
         }
@@ -88,13 +83,7 @@ Aerodrome AixmReader::makeAerodrome() const
 
         for (const QVector<QGeoCoordinate> &twyEleGeo : twyElements)
         {
-            QPolygonF polygon;
-            polygon.reserve(twyEleGeo.size());
-
-            for (const QGeoCoordinate &coord : twyEleGeo)
-            {
-                polygon << geoToLocalEnu(coord, geoOrigin).toPointF();
-            }
+            QPolygonF polygon = ltp.toEnuPolygon(twyEleGeo);
 
             aerodrome.addTaxiwayElement(idStr, polygon);
         }
@@ -108,13 +97,7 @@ Aerodrome AixmReader::makeAerodrome() const
 
         for (const QVector<QGeoCoordinate> &apronLaneEleGeo : apronLaneElements)
         {
-            QPolygonF polygon;
-            polygon.reserve(apronLaneEleGeo.size());
-
-            for (const QGeoCoordinate &coord : apronLaneEleGeo)
-            {
-                polygon << geoToLocalEnu(coord, geoOrigin).toPointF();
-            }
+            QPolygonF polygon = ltp.toEnuPolygon(apronLaneEleGeo);
 
             aerodrome.addApronLaneElement(idStr, polygon);
         }
@@ -128,13 +111,7 @@ Aerodrome AixmReader::makeAerodrome() const
 
         for (const QVector<QGeoCoordinate> &standEleGeo : standElements)
         {
-            QPolygonF polygon;
-            polygon.reserve(standEleGeo.size());
-
-            for (const QGeoCoordinate &coord : standEleGeo)
-            {
-                polygon << geoToLocalEnu(coord, geoOrigin).toPointF();
-            }
+            QPolygonF polygon = ltp.toEnuPolygon(standEleGeo);
 
             aerodrome.addStandElement(idStr, polygon);
         }
@@ -148,13 +125,7 @@ Aerodrome AixmReader::makeAerodrome() const
 
         for (const QVector<QGeoCoordinate> &airborne1EleGeo : airborne1Elements)
         {
-            QPolygonF polygon;
-            polygon.reserve(airborne1EleGeo.size());
-
-            for (const QGeoCoordinate &coord : airborne1EleGeo)
-            {
-                polygon << geoToLocalEnu(coord, geoOrigin).toPointF();
-            }
+            QPolygonF polygon = ltp.toEnuPolygon(airborne1EleGeo);
 
             aerodrome.addAirborne1Element(idStr, polygon);
         }
@@ -168,13 +139,7 @@ Aerodrome AixmReader::makeAerodrome() const
 
         for (const QVector<QGeoCoordinate> &airborne2EleGeo : airborne2Elements)
         {
-            QPolygonF polygon;
-            polygon.reserve(airborne2EleGeo.size());
-
-            for (const QGeoCoordinate &coord : airborne2EleGeo)
-            {
-                polygon << geoToLocalEnu(coord, geoOrigin).toPointF();
-            }
+            QPolygonF polygon = ltp.toEnuPolygon(airborne2EleGeo);
 
             aerodrome.addAirborne2Element(idStr, polygon);
         }
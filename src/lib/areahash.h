@@ -21,6 +21,7 @@
 #define ASTMOPS_AREAHASH_H
 
 #include "aerodrome.h"
+#include <QDataStream>
 #include <QHash>
 
 template <typename T>
@@ -43,6 +44,20 @@ struct AreaHash : public QHash<Aerodrome::NamedArea, T>
 
         return result;
     }
+
+    /*!
+     * \brief Merges \a other into this hash, adding the values of the
+     * areas present in both.
+     */
+    AreaHash &operator+=(const AreaHash &other)
+    {
+        for (auto it = other.constBegin(), last = other.constEnd(); it != last; ++it)
+        {
+            (*this)[it.key()] += it.value();
+        }
+
+        return *this;
+    }
 };
 
 template <typename T>
@@ -54,6 +69,18 @@ bool operator==(const AreaHash<T> &lhs, const AreaHash<T> &rhs)
     return lhs_h == rhs_h;
 }
 
+template <typename T>
+QDataStream &operator<<(QDataStream &out, const AreaHash<T> &hash)
+{
+    return out << static_cast<const QHash<Aerodrome::NamedArea, T> &>(hash);
+}
+
+template <typename T>
+QDataStream &operator>>(QDataStream &in, AreaHash<T> &hash)
+{
+    return in >> static_cast<QHash<Aerodrome::NamedArea, T> &>(hash);
+}
+
 Q_DECLARE_METATYPE(AreaHash<QVector<double>>);
 
 #endif  // ASTMOPS_AREAHASH_H
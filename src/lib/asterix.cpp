@@ -113,7 +113,7 @@ std::optional<QString> Asterix::getElementValue(const Asterix::Record &rec, QLat
     return std::nullopt;
 }
 
-RecordType Asterix::getRecordType(const Asterix::Record &rec)
+RecordType Asterix::getRecordType(const Asterix::Record &rec, const RunConfig &config)
 {
     SystemType st = SystemType::Unknown;
     MessageType mt = MessageType::Unknown;
@@ -123,10 +123,9 @@ RecordType Asterix::getRecordType(const Asterix::Record &rec)
         return RecordType(st, mt);
     }
 
-    // Read only once.
-    static const QSet<Sic> smrSic = Configuration::smrSic();
-    static const QSet<Sic> mlatSic = Configuration::mlatSic();
-    static const QSet<Sic> adsbSic = Configuration::adsbSic();
+    const QSet<Sic> &smrSic = config.smrSic;
+    const QSet<Sic> &mlatSic = config.mlatSic;
+    const QSet<Sic> &adsbSic = config.adsbSic;
 
     // SICs assigned to SMR should not be assigned to any other sensors.
     Q_ASSERT(!mlatSic.intersects(smrSic) && !adsbSic.intersects(smrSic));
@@ -23,6 +23,7 @@
 #define ASTMOPS_ASTERIX_H
 
 #include "astmops.h"
+#include "config.h"
 #include <QDateTime>
 #include <QString>
 #include <optional>
@@ -106,7 +107,7 @@ bool containsDataItem(const Asterix::Record &rec, QLatin1String diName);
 bool containsDataItem(const Asterix::Record &rec, const QVector<QLatin1String> &diNames);
 bool containsElement(const Asterix::Record &rec, QLatin1String diName, QLatin1String deName);
 std::optional<QString> getElementValue(const Asterix::Record &rec, QLatin1String diName, QLatin1String deName);
-RecordType getRecordType(const Asterix::Record &rec);
+RecordType getRecordType(const Asterix::Record &rec, const RunConfig &config);
 QTime getTimeOfDay(const Asterix::Record &rec);
 
 bool isCategorySupported(const Cat cat);
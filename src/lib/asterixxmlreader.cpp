@@ -18,6 +18,7 @@
  */
 
 #include "asterixxmlreader.h"
+#include "profiler.h"
 #include <QRegularExpression>
 
 #if (QT_VERSION < QT_VERSION_CHECK(5, 14, 0))
@@ -29,11 +30,12 @@ static const auto& dec = &::dec;
 }  // namespace Qt
 #endif
 
-AsterixXmlReader::AsterixXmlReader(QObject* parent) : QObject(parent)
+AsterixXmlReader::AsterixXmlReader(const RunConfig& config, QObject* parent)
+    : QObject(parent), config_(config)
 {
     // Read date from configuration. If no date is provided by the user then
     // use the current system date.
-    QDate date = Configuration::asterixDate();
+    QDate date = config_.asterixDate;
     if (date.isValid())
     {
         startDate_ = date;
@@ -44,8 +46,13 @@ AsterixXmlReader::AsterixXmlReader(QObject* parent) : QObject(parent)
     }
 }
 
+/*!
+ * \brief Reads the complete lines of \a data. readyRead() is emitted once
+ * at the end if any record was read, however many lines \a data holds.
+ */
 void AsterixXmlReader::addData(const QByteArray& data)
 {
+    const int pending = records_.size();
     const QByteArrayList lines = data.split('\n');
 
     for (int i = 0; i < lines.size(); ++i)
@@ -85,6 +92,11 @@ void AsterixXmlReader::addData(const QByteArray& data)
 
         xml_.clear();
     }
+
+    if (records_.size() > pending)
+    {
+        emit readyRead();
+    }
 }
 
 void AsterixXmlReader::setStartDate(QDate date)
@@ -110,8 +122,48 @@ std::optional<Asterix::Record> AsterixXmlReader::takeData()
     return std::nullopt;
 }
 
+/*!
+ * \brief Appends all the pending records to \a out, oldest first.
+ */
+void AsterixXmlReader::takeAll(QVector<Asterix::Record>& out)
+{
+    out.reserve(out.size() + records_.size());
+    while (!records_.isEmpty())
+    {
+        out.append(records_.dequeue());
+    }
+}
+
+/*!
+ * \brief Returns the timestamp of the first record of each record type.
+ */
+QHash<RecordType, QDateTime> AsterixXmlReader::firstTimes() const
+{
+    return first_times_;
+}
+
+/*!
+ * \brief Returns the most recent timestamp of each record type, the one
+ * the next record is compared with to detect midnight TOD rollovers.
+ */
+QHash<RecordType, QDateTime> AsterixXmlReader::lastTimes() const
+{
+    return last_times_;
+}
+
+/*!
+ * \brief Returns the number of midnight TOD rollovers detected for each
+ * record type.
+ */
+QHash<RecordType, qint64> AsterixXmlReader::dayCounts() const
+{
+    return day_count_;
+}
+
 void AsterixXmlReader::readRecord()
 {
+    Profiler::ScopedTimer timer(Profiler::Stage::RecordDecode);
+
     Q_ASSERT(xml_.isStartElement() && xml_.name() == QLatin1String("ASTERIX"));
 
     auto hasMinimumAttributes = [this]() {
@@ -187,7 +239,7 @@ void AsterixXmlReader::readRecord()
     }
 
     // Determine record type.
-    RecordType rt = Asterix::getRecordType(record);
+    RecordType rt = Asterix::getRecordType(record, config_);
     if (rt.isUnknown())
     {
         // Skip unknown record types.
@@ -196,8 +248,7 @@ void AsterixXmlReader::readRecord()
         return;
     }
 
-    static ProcessingMode mode = Configuration::processingMode();
-    if (mode == ProcessingMode::Dgps)
+    if (config_.mode == ProcessingMode::Dgps)
     {
         if (rt == RecordType(SystemType::Adsb, MessageType::TargetReport))
         {
@@ -209,7 +260,7 @@ void AsterixXmlReader::readRecord()
     record.rec_typ_ = rt;
 
     QDateTime datetime;
-    if (useXmlTimestamp_)
+    if (config_.useXmlTimestamp)
     {
         datetime = QDateTime(startDate_, QTime::fromMSecsSinceStartOfDay(tstamp), Qt::UTC);
     }
@@ -311,6 +362,7 @@ void AsterixXmlReader::readRecord()
     else
     {
         // First timestamp insertion.
+        first_times_.insert(rt, record.timestamp_);
         last_times_.insert(rt, record.timestamp_);
         day_count_.insert(rt, 0);
         // qDebug();
@@ -323,7 +375,6 @@ void AsterixXmlReader::readRecord()
     }
 
     records_.enqueue(record);
-    emit readyRead();
 }
 
 Asterix::DataItem AsterixXmlReader::readDataItem()
@@ -364,8 +415,9 @@ Asterix::DataElement AsterixXmlReader::readDataElement()
 bool AsterixXmlReader::isValidDataItem(const QString& di)
 {
     // Creating a QRegularExpression object is expensive.
-    // Making it static solves the performance cost.
-    static QRegularExpression re(QLatin1String("I(\\d{3}|RE|SP)\\b"));
+    // Making it static solves the performance cost. One per thread, as
+    // several readers may run concurrently.
+    static thread_local QRegularExpression re(QLatin1String("I(\\d{3}|RE|SP)\\b"));
     QRegularExpressionMatch match = re.match(di);
 
     return match.hasMatch();
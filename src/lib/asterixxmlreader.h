@@ -22,9 +22,9 @@
 
 #include "asterix.h"
 #include "config.h"
+#include "poolqueue.h"
 #include <QMultiMap>
 #include <QObject>
-#include <QQueue>
 #include <QXmlStreamReader>
 
 /*!
@@ -40,13 +40,18 @@ class AsterixXmlReader : public QObject
     Q_OBJECT
 
 public:
-    explicit AsterixXmlReader(QObject* parent = nullptr);
+    explicit AsterixXmlReader(const RunConfig& config, QObject* parent = nullptr);
 
     void addData(const QByteArray& data);
     void setStartDate(QDate date);
 
     bool hasPendingData() const;
     std::optional<Asterix::Record> takeData();
+    void takeAll(QVector<Asterix::Record>& out);
+
+    QHash<RecordType, QDateTime> firstTimes() const;
+    QHash<RecordType, QDateTime> lastTimes() const;
+    QHash<RecordType, qint64> dayCounts() const;
 
 public slots:
 
@@ -59,13 +64,14 @@ private:
     Asterix::DataElement readDataElement();
     bool isValidDataItem(const QString& di);
 
-    bool useXmlTimestamp_ = Configuration::useXmlTimestamp();
+    RunConfig config_;
 
     QDate startDate_;
+    QHash<RecordType, QDateTime> first_times_;
     QHash<RecordType, QDateTime> last_times_;
     QHash<RecordType, qint64> day_count_;
     QXmlStreamReader xml_;
-    QQueue<Asterix::Record> records_;
+    PoolQueue<Asterix::Record> records_;
 };
 
 #endif  // ASTMOPS_ASTERIXXMLREADER_H
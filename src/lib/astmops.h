@@ -49,7 +49,7 @@ enum class ProcessingMode
 Q_DECLARE_METATYPE(ProcessingMode);
 
 
-enum class TargetType
+enum class TargetType : quint8
 {
     Unknown,
     FixedTransponder,
@@ -59,7 +59,7 @@ enum class TargetType
 Q_DECLARE_METATYPE(TargetType);
 
 
-enum class SystemType
+enum class SystemType : quint8
 {
     Unknown,
     Smr,
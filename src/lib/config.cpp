@@ -18,8 +18,10 @@
  */
 
 #include "config.h"
+#include "targetreport.h"
 #include <QCoreApplication>
 #include <QStandardPaths>
+#include <QThread>
 
 
 Settings::Settings() : QSettings(configFilePath(), QSettings::IniFormat)
@@ -182,6 +184,37 @@ QSet<Sic> Configuration::adsbSic()
     return readSic(key);
 }
 
+/*!
+ * \brief Returns how far, in seconds, a target report may lag behind the
+ * most recent one of its system type before it is counted as late and
+ * discarded. When not set every target report is merged into its track,
+ * however late.
+ */
+std::optional<double> Configuration::allowedLateness()
+{
+    QString key = QLatin1String("AllowedLateness");
+
+    Settings settings;
+    settings.beginGroup(QLatin1String("Asterix"));
+
+    if (!settings.contains(key))
+    {
+        return std::nullopt;
+    }
+
+    bool ok;
+    double val = settings.value(key).toDouble(&ok);
+
+    if (!ok || val < 0)
+    {
+        qWarning() << "Invalid Allowed Lateness, merging every target report";
+
+        return std::nullopt;
+    }
+
+    return val;
+}
+
 QString Configuration::dgpsFile()
 {
     QString key = QLatin1String("Filepath");
@@ -261,7 +294,7 @@ Ident Configuration::dgpsIdent()
 
     QString val = settings.value(key).toString();
 
-    if (val.size() > 8)  // Maximum 8 characters.
+    if (!InlineIdent::isValid(val))  // Maximum 8 Latin-1 characters.
     {
         qFatal("Invalid %s value.", qPrintable(key));
     }
@@ -296,6 +329,33 @@ qint32 Configuration::dgpsTodOffset()
     return val;
 }
 
+int Configuration::dgpsParseThreads()
+{
+    QString key = QLatin1String("ParseThreads");
+
+    Settings settings;
+    settings.beginGroup(QLatin1String("Dgps"));
+
+    if (!settings.contains(key))
+    {
+        // Stream the file from a single thread.
+        return 1;
+    }
+
+    bool ok;
+    int val = settings.value(key).toInt(&ok);
+
+    if (!ok || val < 0)
+    {
+        qWarning() << "Invalid DGPS Parse Threads, using a single thread";
+
+        return 1;
+    }
+
+    // Zero picks one thread per core.
+    return val == 0 ? QThread::idealThreadCount() : val;
+}
+
 double Configuration::rpaPicPercentile()
 {
     QString key = QLatin1String("RpaPicPercentile");
@@ -322,6 +382,32 @@ double Configuration::rpaPicPercentile()
     return val;
 }
 
+std::optional<int> Configuration::rpaSketchSize()
+{
+    QString key = QLatin1String("RpaSketchSize");
+
+    Settings settings;
+    settings.beginGroup(QLatin1String("Mops"));
+
+    if (!settings.contains(key))
+    {
+        // Keep every RPA error sample for exact statistics.
+        return std::nullopt;
+    }
+
+    bool ok;
+    int val = settings.value(key).toInt(&ok);
+
+    if (!ok || val < 8)
+    {
+        qWarning() << "Invalid RPA Sketch Size, using exact statistics";
+
+        return std::nullopt;
+    }
+
+    return val;
+}
+
 std::optional<QString> Configuration::logRules()
 {
     QString key = QLatin1String("Rules");
@@ -355,3 +441,41 @@ std::optional<QString> Configuration::logPattern()
 
     return pattern;
 }
+
+/*!
+ * \brief Reads and validates the processing settings. Terminates, as the
+ * Configuration getters do, if a mandatory setting is missing or invalid.
+ */
+RunConfig RunConfig::fromSettings()
+{
+    RunConfig config;
+
+    config.mode = Configuration::processingMode();
+
+    config.asterixDate = Configuration::asterixDate();
+    config.useXmlTimestamp = Configuration::useXmlTimestamp();
+    config.smrSic = Configuration::smrSic();
+    config.mlatSic = Configuration::mlatSic();
+    config.adsbSic = Configuration::adsbSic();
+    config.allowedLateness = Configuration::allowedLateness();
+
+    // SICs assigned to SMR should not be assigned to any other sensors.
+    if (config.mlatSic.intersects(config.smrSic) || config.adsbSic.intersects(config.smrSic))
+    {
+        qFatal("SmrSic values must not be assigned to other sensors.");
+    }
+
+    if (config.mode == ProcessingMode::Dgps)
+    {
+        config.dgpsModeS = Configuration::dgpsModeS();
+        config.dgpsMode3A = Configuration::dgpsMode3A();
+        config.dgpsIdent = Configuration::dgpsIdent();
+        config.dgpsTodOffset = Configuration::dgpsTodOffset();
+        config.dgpsParseThreads = Configuration::dgpsParseThreads();
+    }
+
+    config.rpaPicPercentile = Configuration::rpaPicPercentile();
+    config.rpaSketchSize = Configuration::rpaSketchSize();
+
+    return config;
+}
@@ -21,6 +21,8 @@
 #define ASTMOPS_CONFIG_H
 
 #include "astmops.h"
+#include <QDate>
+#include <QSet>
 #include <QSettings>
 #include <optional>
 
@@ -50,6 +52,7 @@ QSet<Sic> readSic(const QString& key);
 QSet<Sic> smrSic();
 QSet<Sic> mlatSic();
 QSet<Sic> adsbSic();
+std::optional<double> allowedLateness();
 
 // [Dgps]
 QString dgpsFile();
@@ -57,9 +60,11 @@ ModeS dgpsModeS();
 Mode3A dgpsMode3A();
 Ident dgpsIdent();
 qint32 dgpsTodOffset();
+int dgpsParseThreads();
 
 // [Mops]
 double rpaPicPercentile();
+std::optional<int> rpaSketchSize();
 
 // [Log]
 std::optional<QString> logRules();
@@ -67,4 +72,42 @@ std::optional<QString> logPattern();
 
 };  // namespace Configuration
 
+/*!
+ * \brief Snapshot of the settings that drive the processing stages.
+ *
+ * Read and validated once with fromSettings() and then handed to the
+ * reader, the extractors and the evaluator on construction, so that no
+ * stage touches the configuration file while processing records. A
+ * default constructed RunConfig holds the default values of every
+ * setting and no SICs.
+ *
+ * Input file locations (KML, DGPS CSV) are not part of it; they are
+ * resolved once by the application through Configuration.
+ */
+struct RunConfig
+{
+    static RunConfig fromSettings();
+
+    ProcessingMode mode = ProcessingMode::Too;
+
+    // [Asterix]
+    QDate asterixDate;
+    bool useXmlTimestamp = false;
+    QSet<Sic> smrSic;
+    QSet<Sic> mlatSic;
+    QSet<Sic> adsbSic;
+    std::optional<double> allowedLateness;  // Seconds, none to merge every record.
+
+    // [Dgps], only read in DGPS mode.
+    ModeS dgpsModeS = 0;
+    Mode3A dgpsMode3A = 0;
+    Ident dgpsIdent;
+    qint32 dgpsTodOffset = MOPS::defaultDgpsTodOffset;
+    int dgpsParseThreads = 1;
+
+    // [Mops]
+    double rpaPicPercentile = MOPS::defaultRpaPicPercentile;
+    std::optional<int> rpaSketchSize;
+};
+
 #endif  // ASTMOPS_CONFIG_H
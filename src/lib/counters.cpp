@@ -43,17 +43,27 @@ Counters::IntervalCounter::IntervalCounter(double period, const QDateTime &tod)
 
 bool Counters::IntervalCounter::isInitialized() const
 {
-    return intervalStart_.isValid();
+    return origin_.isValid();
 }
 
 QDateTime Counters::IntervalCounter::intervalStart() const
 {
-    return intervalStart_;
+    if (!isInitialized())
+    {
+        return QDateTime();
+    }
+
+    return origin_.addMSecs(index_ * period_ms_);
 }
 
 QDateTime Counters::IntervalCounter::intervalEnd() const
 {
-    return intervalStart_.addMSecs(period_ * 1000.0);
+    if (!isInitialized())
+    {
+        return QDateTime();
+    }
+
+    return origin_.addMSecs((index_ + 1) * period_ms_);
 }
 
 Counters::IntervalCounter::operator bool() const
@@ -63,17 +73,29 @@ Counters::IntervalCounter::operator bool() const
 
 void Counters::IntervalCounter::setPeriod(double period)
 {
-    if (period <= 0)
+    const qint64 period_ms = period * 1000.0;
+    if (period_ms <= 0)
     {
         return;
     }
 
+    // Keep counting from the current interval with the new period.
+    if (isInitialized())
+    {
+        origin_ = intervalStart();
+        origin_ms_ = origin_.toMSecsSinceEpoch();
+        index_ = 0;
+    }
+
     period_ = period;
+    period_ms_ = period_ms;
 }
 
 void Counters::IntervalCounter::init(const QDateTime &tod)
 {
-    intervalStart_ = tod;
+    origin_ = tod;
+    origin_ms_ = tod.isValid() ? tod.toMSecsSinceEpoch() : 0;
+    index_ = 0;
 }
 
 void Counters::IntervalCounter::update(const QDateTime &tod)
@@ -84,15 +106,16 @@ void Counters::IntervalCounter::update(const QDateTime &tod)
         return;
     }
 
-    if (tod >= intervalStart())
+    const qint64 ms = tod.toMSecsSinceEpoch();
+    if (tod.isValid() && ms >= currentStartMSecs())
     {
-        while (!contains(tod))
-        {
-            advance();
-        }
+        // Skip to the interval that contains the timestamp, count it as
+        // valid and move past it.
+        const qint64 idx = (ms - origin_ms_) / period_ms_;
 
+        counter_.total_ += idx - index_ + 1;
         ++counter_.valid_;
-        advance();
+        index_ = idx + 1;
     }
 }
 
@@ -104,18 +127,21 @@ void Counters::IntervalCounter::finish(const QDateTime &tod)
         return;
     }
 
-    if (tod >= intervalStart())
+    const qint64 ms = tod.toMSecsSinceEpoch();
+    if (tod.isValid() && ms >= currentStartMSecs())
     {
-        while (!contains(tod))
-        {
-            advance();
-        }
+        const qint64 idx = (ms - origin_ms_) / period_ms_;
+
+        counter_.total_ += idx - index_;
+        index_ = idx;
     }
 }
 
 void Counters::IntervalCounter::reset()
 {
-    intervalStart_ = QDateTime();
+    origin_ = QDateTime();
+    origin_ms_ = 0;
+    index_ = 0;
     counter_.reset();
 }
 
@@ -127,20 +153,9 @@ Counters::BasicCounter Counters::IntervalCounter::read()
     return counter;
 }
 
-bool Counters::IntervalCounter::contains(const QDateTime &tod) const
+qint64 Counters::IntervalCounter::currentStartMSecs() const
 {
-    if (intervalStart() <= tod && tod < intervalEnd())
-    {
-        return true;
-    }
-
-    return false;
-}
-
-void Counters::IntervalCounter::advance()
-{
-    intervalStart_ = intervalEnd();
-    ++counter_.total_;
+    return origin_ms_ + index_ * period_ms_;
 }
 
 /* ---------------------------- Free functions ---------------------------- */
@@ -187,3 +202,130 @@ bool Counters::operator==(Counters::PlgCounter lhs, Counters::PlgCounter rhs)
     return lhs.n_tr_ == rhs.n_tr_ &&
            lhs.n_g_ == rhs.n_g_;
 }
+
+Counters::UrCounter &Counters::operator+=(Counters::UrCounter &lhs, Counters::UrCounter rhs)
+{
+    lhs.n_trp_ += rhs.n_trp_;
+    lhs.n_etrp_ += rhs.n_etrp_;
+
+    return lhs;
+}
+
+Counters::PdCounter &Counters::operator+=(Counters::PdCounter &lhs, Counters::PdCounter rhs)
+{
+    lhs.n_trp_ += rhs.n_trp_;
+    lhs.n_up_ += rhs.n_up_;
+
+    return lhs;
+}
+
+Counters::PfdCounter &Counters::operator+=(Counters::PfdCounter &lhs, Counters::PfdCounter rhs)
+{
+    lhs.n_ftr_ += rhs.n_ftr_;
+    lhs.n_tr_ += rhs.n_tr_;
+
+    return lhs;
+}
+
+Counters::PfdCounter2 &Counters::operator+=(Counters::PfdCounter2 &lhs, Counters::PfdCounter2 rhs)
+{
+    lhs.n_tr_ += rhs.n_tr_;
+    lhs.n_etr_ += rhs.n_etr_;
+    lhs.n_u_ += rhs.n_u_;
+
+    return lhs;
+}
+
+Counters::PidCounter &Counters::operator+=(Counters::PidCounter &lhs, Counters::PidCounter rhs)
+{
+    lhs.n_citr_ += rhs.n_citr_;
+    lhs.n_itr_ += rhs.n_itr_;
+
+    return lhs;
+}
+
+Counters::PfidCounter &Counters::operator+=(Counters::PfidCounter &lhs, Counters::PfidCounter rhs)
+{
+    lhs.n_eitr_ += rhs.n_eitr_;
+    lhs.n_itr_ += rhs.n_itr_;
+
+    return lhs;
+}
+
+Counters::PlgCounter &Counters::operator+=(Counters::PlgCounter &lhs, Counters::PlgCounter rhs)
+{
+    lhs.n_g_ += rhs.n_g_;
+    lhs.n_tr_ += rhs.n_tr_;
+
+    return lhs;
+}
+
+QDataStream &Counters::operator<<(QDataStream &out, Counters::UrCounter ctr)
+{
+    return out << ctr.n_trp_ << ctr.n_etrp_;
+}
+
+QDataStream &Counters::operator>>(QDataStream &in, Counters::UrCounter &ctr)
+{
+    return in >> ctr.n_trp_ >> ctr.n_etrp_;
+}
+
+QDataStream &Counters::operator<<(QDataStream &out, Counters::PdCounter ctr)
+{
+    return out << ctr.n_trp_ << ctr.n_up_;
+}
+
+QDataStream &Counters::operator>>(QDataStream &in, Counters::PdCounter &ctr)
+{
+    return in >> ctr.n_trp_ >> ctr.n_up_;
+}
+
+QDataStream &Counters::operator<<(QDataStream &out, Counters::PfdCounter ctr)
+{
+    return out << ctr.n_ftr_ << ctr.n_tr_;
+}
+
+QDataStream &Counters::operator>>(QDataStream &in, Counters::PfdCounter &ctr)
+{
+    return in >> ctr.n_ftr_ >> ctr.n_tr_;
+}
+
+QDataStream &Counters::operator<<(QDataStream &out, Counters::PfdCounter2 ctr)
+{
+    return out << ctr.n_tr_ << ctr.n_etr_ << ctr.n_u_;
+}
+
+QDataStream &Counters::operator>>(QDataStream &in, Counters::PfdCounter2 &ctr)
+{
+    return in >> ctr.n_tr_ >> ctr.n_etr_ >> ctr.n_u_;
+}
+
+QDataStream &Counters::operator<<(QDataStream &out, Counters::PidCounter ctr)
+{
+    return out << ctr.n_citr_ << ctr.n_itr_;
+}
+
+QDataStream &Counters::operator>>(QDataStream &in, Counters::PidCounter &ctr)
+{
+    return in >> ctr.n_citr_ >> ctr.n_itr_;
+}
+
+QDataStream &Counters::operator<<(QDataStream &out, Counters::PfidCounter ctr)
+{
+    return out << ctr.n_eitr_ << ctr.n_itr_;
+}
+
+QDataStream &Counters::operator>>(QDataStream &in, Counters::PfidCounter &ctr)
+{
+    return in >> ctr.n_eitr_ >> ctr.n_itr_;
+}
+
+QDataStream &Counters::operator<<(QDataStream &out, Counters::PlgCounter ctr)
+{
+    return out << ctr.n_g_ << ctr.n_tr_;
+}
+
+QDataStream &Counters::operator>>(QDataStream &in, Counters::PlgCounter &ctr)
+{
+    return in >> ctr.n_g_ >> ctr.n_tr_;
+}
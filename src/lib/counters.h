@@ -22,6 +22,7 @@
 #define ASTMOPS_COUNTERS_H
 
 #include "aerodrome.h"
+#include <QDataStream>
 #include <QDateTime>
 
 namespace Counters
@@ -106,11 +107,18 @@ public:
     BasicCounter read();
 
 private:
-    bool contains(const QDateTime &tod) const;
-    void advance();
+    qint64 currentStartMSecs() const;
 
     double period_ = 1.0;
-    QDateTime intervalStart_;
+    qint64 period_ms_ = 1000;
+
+    // Intervals are numbered from the origin, so the interval a timestamp
+    // falls in is computed arithmetically instead of stepping through
+    // every interval in between.
+    QDateTime origin_;
+    qint64 origin_ms_ = 0;
+    qint64 index_ = 0;  // Index of the current interval.
+
     BasicCounter counter_;
 };
 
@@ -123,6 +131,29 @@ bool operator==(Counters::PidCounter lhs, Counters::PidCounter rhs);
 bool operator==(Counters::PfidCounter lhs, Counters::PfidCounter rhs);
 bool operator==(Counters::PlgCounter lhs, Counters::PlgCounter rhs);
 
+Counters::UrCounter &operator+=(Counters::UrCounter &lhs, Counters::UrCounter rhs);
+Counters::PdCounter &operator+=(Counters::PdCounter &lhs, Counters::PdCounter rhs);
+Counters::PfdCounter &operator+=(Counters::PfdCounter &lhs, Counters::PfdCounter rhs);
+Counters::PfdCounter2 &operator+=(Counters::PfdCounter2 &lhs, Counters::PfdCounter2 rhs);
+Counters::PidCounter &operator+=(Counters::PidCounter &lhs, Counters::PidCounter rhs);
+Counters::PfidCounter &operator+=(Counters::PfidCounter &lhs, Counters::PfidCounter rhs);
+Counters::PlgCounter &operator+=(Counters::PlgCounter &lhs, Counters::PlgCounter rhs);
+
+QDataStream &operator<<(QDataStream &out, Counters::UrCounter ctr);
+QDataStream &operator>>(QDataStream &in, Counters::UrCounter &ctr);
+QDataStream &operator<<(QDataStream &out, Counters::PdCounter ctr);
+QDataStream &operator>>(QDataStream &in, Counters::PdCounter &ctr);
+QDataStream &operator<<(QDataStream &out, Counters::PfdCounter ctr);
+QDataStream &operator>>(QDataStream &in, Counters::PfdCounter &ctr);
+QDataStream &operator<<(QDataStream &out, Counters::PfdCounter2 ctr);
+QDataStream &operator>>(QDataStream &in, Counters::PfdCounter2 &ctr);
+QDataStream &operator<<(QDataStream &out, Counters::PidCounter ctr);
+QDataStream &operator>>(QDataStream &in, Counters::PidCounter &ctr);
+QDataStream &operator<<(QDataStream &out, Counters::PfidCounter ctr);
+QDataStream &operator>>(QDataStream &in, Counters::PfidCounter &ctr);
+QDataStream &operator<<(QDataStream &out, Counters::PlgCounter ctr);
+QDataStream &operator>>(QDataStream &in, Counters::PlgCounter &ctr);
+
 }  // namespace Counters
 
 Q_DECLARE_METATYPE(Counters::UrCounter);
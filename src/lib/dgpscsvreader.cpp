@@ -20,65 +20,88 @@
 #include "dgpscsvreader.h"
 #include "config.h"
 #include "geofunctions.h"
+#include <QDate>
 #include <QDebug>
+#include <QFile>
+#include <QThread>
+#include <cstring>
+#include <memory>
+#include <vector>
 
-/*!
- * \brief readDgpsCsv
- * \param file
- * \param error
- * \return
- */
-QVector<QGeoPositionInfo> readDgpsCsv(QIODevice *file, ErrorType *error)
+namespace
 {
-    if (error)
-    {
-        *error = NoError;
-    }
-
-    QVector<QGeoPositionInfo> result;
-
-    enum Timestamp
-    {
-        Unix,
-        Iso
-    };
+enum Timestamp
+{
+    Unix,
+    Iso
+};
 
-    enum Position
-    {
-        Degrees,
-        Dms
-    };
+enum Position
+{
+    Degrees,
+    Dms
+};
 
-    enum Altitude
-    {
-        Feet,
-        Meters
-    };
+enum Altitude
+{
+    Feet,
+    Meters
+};
 
-    // Default units.
+// Layout and units of the columns, as declared in the header line.
+struct DgpsCsvFormat
+{
     Timestamp timeUnit = Unix;
     Position positionUnit = Degrees;
     Altitude altitudeUnit = Feet;
 
-    // Default column values.
     int timeColumn = -1;
     int latitudeColumn = -1;
     int longitudeColumn = -1;
     int altitudeColumn = -1;
+};
 
-    const QByteArray first = file->readLine();
+// Field of a line, as a range of characters.
+struct Span
+{
+    const char *begin = nullptr;
+    const char *end = nullptr;
+};
+
+const qint64 blockSize = 1 << 16;
+
+bool isSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\v' || c == '\f';
+}
 
+bool isDigit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+Span trimmed(Span s)
+{
+    while (s.begin < s.end && isSpace(*s.begin))
+    {
+        ++s.begin;
+    }
+    while (s.end > s.begin && isSpace(*(s.end - 1)))
+    {
+        --s.end;
+    }
+    return s;
+}
+
+bool parseHeader(const QByteArray &first, DgpsCsvFormat &format)
+{
     // Split line at ";" delimiter.
     const auto headerParts = first.split(';');
 
     // Header must contain 4 elements.
     if (headerParts.size() != 4)
     {
-        if (error)
-        {
-            *error = NotWellFormedHeaderError;
-        }
-        return result;
+        return false;
     }
 
     for (int index = 0, last = headerParts.size(); index < last; ++index)
@@ -89,131 +112,455 @@ QVector<QGeoPositionInfo> readDgpsCsv(QIODevice *file, ErrorType *error)
         // Split "FieldName_format" into "FieldName" + "format" parts.
         if (fieldSpecParts.size() != 2)
         {
-            if (error)
-            {
-                *error = NotWellFormedHeaderError;
-            }
-            return result;
+            return false;
         }
 
         const QByteArray fieldName = fieldSpecParts.at(0).trimmed();
 
         if (qstricmp(fieldName.constData(), "datetime") == 0)
         {
-            timeColumn = index;
+            format.timeColumn = index;
         }
         else if (qstricmp(fieldName.constData(), "latitude") == 0)
         {
-            latitudeColumn = index;
+            format.latitudeColumn = index;
         }
         else if (qstricmp(fieldName.constData(), "longitude") == 0)
         {
-            longitudeColumn = index;
+            format.longitudeColumn = index;
         }
         else if (qstricmp(fieldName.constData(), "gpsaltitude") == 0)
         {
-            altitudeColumn = index;
+            format.altitudeColumn = index;
         }
     }
 
     // Stop if any column is missing.
-    if (timeColumn == -1 || latitudeColumn == -1 || longitudeColumn == -1 || altitudeColumn == -1)
+    if (format.timeColumn == -1 || format.latitudeColumn == -1 ||
+        format.longitudeColumn == -1 || format.altitudeColumn == -1)
     {
-        if (error)
-        {
-            *error = NotWellFormedHeaderError;
-        }
-        return result;
+        return false;
     }
 
     const QByteArray timeFormat =
-        headerParts.at(timeColumn).trimmed().split('_').at(1);
+        headerParts.at(format.timeColumn).trimmed().split('_').at(1);
     if (qstricmp(timeFormat.constData(), "unix") == 0)
     {
-        timeUnit = Unix;
+        format.timeUnit = Unix;
     }
     else if (qstricmp(timeFormat.constData(), "iso8601") == 0)
     {
-        timeUnit = Iso;
+        format.timeUnit = Iso;
     }
 
     const QByteArray positionFormat =
-        headerParts.at(latitudeColumn).trimmed().split('_').at(1);
+        headerParts.at(format.latitudeColumn).trimmed().split('_').at(1);
     if (qstricmp(positionFormat.constData(), "deg") == 0)
     {
-        positionUnit = Degrees;
+        format.positionUnit = Degrees;
     }
     else if (qstricmp(positionFormat.constData(), "dms") == 0)
     {
-        positionUnit = Dms;
+        format.positionUnit = Dms;
     }
 
     const QByteArray altitudeFormat =
-        headerParts.at(altitudeColumn).trimmed().split('_').at(1);
+        headerParts.at(format.altitudeColumn).trimmed().split('_').at(1);
     if (qstricmp(altitudeFormat.constData(), "ft") == 0)
     {
-        altitudeUnit = Feet;
+        format.altitudeUnit = Feet;
     }
     else if (qstricmp(altitudeFormat.constData(), "m") == 0)
     {
-        altitudeUnit = Meters;
+        format.altitudeUnit = Meters;
     }
 
-    while (!file->atEnd())
+    return true;
+}
+
+/*!
+ * \brief Parses a decimal number such as "41.2854687222".
+ *
+ * Plain decimals of up to 15 significant digits are converted as an
+ * integer mantissa divided by an exact power of ten, which is correctly
+ * rounded and hence identical to QByteArray::toDouble(). Anything else
+ * (exponents, long mantissas) goes through QByteArray::toDouble().
+ * Returns NaN if the text is not a number.
+ */
+double parseDouble(Span s)
+{
+    static const double powersOf10[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7,
+        1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19,
+        1e20, 1e21, 1e22};
+
+    const char *p = s.begin;
+    bool negative = false;
+    if (p < s.end && (*p == '-' || *p == '+'))
     {
-        const QByteArray line = file->readLine().trimmed();
+        negative = *p == '-';
+        ++p;
+    }
+
+    quint64 mantissa = 0;
+    bool anyDigit = false;
+    int digits = 0;
+    int decimals = 0;
+    bool point = false;
 
-        // Skip empty lines or comments.
-        if (line.isEmpty() || line.startsWith('#'))
+    for (; p < s.end; ++p)
+    {
+        if (isDigit(*p))
         {
-            continue;
+            anyDigit = true;
+            if (mantissa != 0 || *p != '0')
+            {
+                ++digits;
+            }
+            mantissa = mantissa * 10 + static_cast<quint64>(*p - '0');
+            decimals += point ? 1 : 0;
+
+            if (digits > 15 || decimals > 22)
+            {
+                break;
+            }
+        }
+        else if (*p == '.' && !point)
+        {
+            point = true;
+        }
+        else
+        {
+            break;
         }
+    }
+
+    if (p == s.end && anyDigit)
+    {
+        const double value = static_cast<double>(mantissa) / powersOf10[decimals];
+        return negative ? -value : value;
+    }
+
+    bool ok;
+    const double value =
+        QByteArray::fromRawData(s.begin, static_cast<int>(s.end - s.begin)).toDouble(&ok);
 
-        // Split line at ";" delimiter.
-        const QByteArrayList lineParts = line.split(';');
+    return ok ? value : qQNaN();
+}
+
+/*!
+ * \brief Parses a Unix timestamp written in seconds with a fixed number of
+ * decimals, such as "1588665965.351", dropping the decimal point to get
+ * the milliseconds.
+ */
+QDateTime parseUnixTimestamp(Span s)
+{
+    quint64 msecs = 0;
+    int digits = 0;
 
-        // Data must contain 4 elements.
-        if (lineParts.size() != 4)
+    for (const char *p = s.begin; p < s.end; ++p)
+    {
+        if (*p == '.')
         {
-            qDebug() << "Ignoring line:" << line;
             continue;
         }
+        if (!isDigit(*p) || ++digits > 18)
+        {
+            return QDateTime();
+        }
+        msecs = msecs * 10 + static_cast<quint64>(*p - '0');
+    }
+
+    if (digits == 0)
+    {
+        return QDateTime();
+    }
+
+    return QDateTime::fromMSecsSinceEpoch(static_cast<qint64>(msecs), Qt::UTC);
+}
+
+/*!
+ * \brief Parses an ISO 8601 timestamp.
+ *
+ * The UTC form "yyyy-MM-ddThh:mm:ss[.zzz]Z" written by the DGPS loggers
+ * is decoded by hand; any other form falls back to QDateTime::fromString().
+ */
+QDateTime parseIsoTimestamp(Span s)
+{
+    const char *p = s.begin;
+    const qint64 size = s.end - s.begin;
+
+    auto number = [p](int pos, int len, int *value) {
+        int v = 0;
+        for (int i = pos; i < pos + len; ++i)
+        {
+            if (!isDigit(p[i]))
+            {
+                return false;
+            }
+            v = v * 10 + (p[i] - '0');
+        }
+        *value = v;
+        return true;
+    };
+
+    int year, month, day, hour, minute, second;
+    int msec = 0;
+
+    bool fast = size >= 20 && s.end[-1] == 'Z' &&
+                p[4] == '-' && p[7] == '-' && p[10] == 'T' && p[13] == ':' && p[16] == ':' &&
+                number(0, 4, &year) && number(5, 2, &month) && number(8, 2, &day) &&
+                number(11, 2, &hour) && number(14, 2, &minute) && number(17, 2, &second) &&
+                hour < 24 && minute < 60 && second < 60 && QDate::isValid(year, month, day);
+
+    if (fast && size > 20)
+    {
+        // Fraction of 1 to 3 digits.
+        const int fracDigits = static_cast<int>(size) - 21;
+        fast = p[19] == '.' && fracDigits >= 1 && fracDigits <= 3 &&
+               number(20, fracDigits, &msec);
+        for (int i = fracDigits; i < 3; ++i)
+        {
+            msec *= 10;
+        }
+    }
 
-        const QByteArray timeText = lineParts.at(timeColumn).trimmed();
-        const QByteArray latitudeText = lineParts.at(latitudeColumn).trimmed();
-        const QByteArray longitudeText = lineParts.at(longitudeColumn).trimmed();
-        const QByteArray altitudeText = lineParts.at(altitudeColumn).trimmed();
+    if (!fast)
+    {
+        const QString str = QString::fromLatin1(s.begin, static_cast<int>(size));
+        return QDateTime::fromString(str, Qt::ISODateWithMs);
+    }
+
+    const qint64 days = QDate(year, month, day).toJulianDay() - QDate(1970, 1, 1).toJulianDay();
+    const qint64 msecs = ((days * 24 + hour) * 60 + minute) * 60000 + second * 1000 + msec;
+
+    return QDateTime::fromMSecsSinceEpoch(msecs, Qt::UTC);
+}
 
-        QString timeStr = QString::fromLatin1(timeText);
+/*!
+ * \brief Parses a data line. Returns false for empty lines, comments and
+ * lines that do not hold valid reference data.
+ */
+bool parseLine(Span line, const DgpsCsvFormat &format, QGeoPositionInfo &info)
+{
+    line = trimmed(line);
+
+    // Skip empty lines or comments.
+    if (line.begin == line.end || *line.begin == '#')
+    {
+        return false;
+    }
 
-        // Remove decimal point from Unix timestamp.
-        if (timeUnit == Unix)
+    // Split line at ";" delimiter.
+    Span fields[4];
+    int count = 0;
+    const char *fieldBegin = line.begin;
+    for (const char *p = line.begin; p <= line.end; ++p)
+    {
+        if (p == line.end || *p == ';')
         {
-            timeStr.remove(QLatin1Char('.'));
+            if (count < 4)
+            {
+                fields[count] = trimmed(Span{fieldBegin, p});
+            }
+            ++count;
+            fieldBegin = p + 1;
         }
+    }
+
+    // Data must contain 4 elements.
+    if (count != 4)
+    {
+        qDebug() << "Ignoring line:" << QByteArray(line.begin, static_cast<int>(line.end - line.begin));
+        return false;
+    }
+
+    const Span timeText = fields[format.timeColumn];
+    const Span latitudeText = fields[format.latitudeColumn];
+    const Span longitudeText = fields[format.longitudeColumn];
+    const Span altitudeText = fields[format.altitudeColumn];
 
-        const QDateTime timeValue =
-            timeUnit == Unix ? QDateTime::fromMSecsSinceEpoch(timeStr.toULong(), Qt::UTC)
-                             : QDateTime::fromString(timeStr, Qt::ISODateWithMs);
+    const QDateTime timeValue =
+        format.timeUnit == Unix ? parseUnixTimestamp(timeText)
+                                : parseIsoTimestamp(timeText);
 
-        const double latitude =
-            positionUnit == Degrees ? latitudeText.toDouble() : qQNaN();
-        const double longitude =
-            positionUnit == Degrees ? longitudeText.toDouble() : qQNaN();
+    const double latitude =
+        format.positionUnit == Degrees ? parseDouble(latitudeText) : qQNaN();
+    const double longitude =
+        format.positionUnit == Degrees ? parseDouble(longitudeText) : qQNaN();
 
-        const double altitudeValue =
-            altitudeText.toDouble() * (altitudeUnit == Meters ? 1 : 0.3048);
+    const double altitudeValue =
+        parseDouble(altitudeText) * (format.altitudeUnit == Meters ? 1 : 0.3048);
 
-        const QGeoCoordinate position =
-            QGeoCoordinate(latitude, longitude, altitudeValue);
+    const QGeoCoordinate position =
+        QGeoCoordinate(latitude, longitude, altitudeValue);
+
+    if (!timeValue.isValid() || !position.isValid())
+    {
+        qDebug() << "Ignoring invalid reference data:"
+                 << QByteArray(line.begin, static_cast<int>(line.end - line.begin));
+        return false;
+    }
 
-        if (!timeValue.isValid() || !position.isValid())
+    info = QGeoPositionInfo(position, timeValue);
+
+    return true;
+}
+
+// Calls callback for every position in the lines of [begin, end).
+void parseLines(const char *begin, const char *end, const DgpsCsvFormat &format,
+    const DgpsCsvCallback &callback)
+{
+    QGeoPositionInfo info;
+
+    while (begin < end)
+    {
+        const char *eol = static_cast<const char *>(std::memchr(begin, '\n', static_cast<size_t>(end - begin)));
+        const char *lineEnd = eol ? eol : end;
+
+        if (parseLine(Span{begin, lineEnd}, format, info))
         {
-            qDebug() << "Ignoring invalid reference data:" << line;
+            callback(info);
         }
 
-        result.append(QGeoPositionInfo(position, timeValue));
+        begin = eol ? eol + 1 : end;
+    }
+}
+
+}  // namespace
+
+/* ---------------------------- Free functions ---------------------------- */
+
+/*!
+ * \brief Reads all the DGPS reference positions of a CSV \a file.
+ * \param file Device positioned at the header line.
+ * \param error Set to the outcome of the read, if not null.
+ * \return Positions in file order.
+ */
+QVector<QGeoPositionInfo> readDgpsCsv(QIODevice *file, ErrorType *error)
+{
+    QVector<QGeoPositionInfo> result;
+
+    const ErrorType e = streamDgpsCsv(file, [&result](const QGeoPositionInfo &info) {
+        result.append(info);
+    });
+
+    if (error)
+    {
+        *error = e;
     }
 
     return result;
 }
+
+/*!
+ * \brief Reads a DGPS CSV \a file block by block and passes each position
+ * to \a callback as soon as it is parsed, without holding the whole file
+ * in memory.
+ */
+ErrorType streamDgpsCsv(QIODevice *file, const DgpsCsvCallback &callback)
+{
+    DgpsCsvFormat format;
+
+    if (!parseHeader(file->readLine(), format))
+    {
+        return NotWellFormedHeaderError;
+    }
+
+    // Parse whole lines and carry the partial last one over to the next
+    // block.
+    QByteArray buffer;
+    while (!file->atEnd())
+    {
+        buffer.append(file->read(blockSize));
+
+        const int lastEol = buffer.lastIndexOf('\n');
+        if (lastEol < 0)
+        {
+            continue;
+        }
+
+        parseLines(buffer.constData(), buffer.constData() + lastEol + 1, format, callback);
+        buffer.remove(0, lastEol + 1);
+    }
+
+    parseLines(buffer.constData(), buffer.constData() + buffer.size(), format, callback);
+
+    return NoError;
+}
+
+/*!
+ * \brief Reads the DGPS CSV file at \a path splitting it into \a threads
+ * chunks that are parsed in parallel from a memory mapping of the file.
+ *
+ * Positions are passed to \a callback in file order once all chunks are
+ * parsed. Falls back to streamDgpsCsv() for a single thread or when the
+ * file cannot be mapped.
+ */
+ErrorType streamDgpsCsvFile(const QString &path, int threads, const DgpsCsvCallback &callback)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        qWarning() << "Could not open DGPS file" << path;
+        return OtherError;
+    }
+
+    const uchar *map = threads > 1 ? file.map(0, file.size()) : nullptr;
+    if (!map)
+    {
+        return streamDgpsCsv(&file, callback);
+    }
+
+    const char *data = reinterpret_cast<const char *>(map);
+    const char *end = data + file.size();
+
+    const char *eol = static_cast<const char *>(std::memchr(data, '\n', static_cast<size_t>(end - data)));
+    const char *body = eol ? eol + 1 : end;
+
+    DgpsCsvFormat format;
+    if (!parseHeader(QByteArray::fromRawData(data, static_cast<int>(body - data)), format))
+    {
+        return NotWellFormedHeaderError;
+    }
+
+    // Chunk boundaries, moved forward to the start of the next line.
+    std::vector<const char *> bounds;
+    bounds.push_back(body);
+    for (int i = 1; i < threads; ++i)
+    {
+        const char *b = body + (end - body) * i / threads;
+        b = qMax(b, bounds.back());
+        const char *nl = static_cast<const char *>(std::memchr(b, '\n', static_cast<size_t>(end - b)));
+        bounds.push_back(nl ? nl + 1 : end);
+    }
+    bounds.push_back(end);
+
+    std::vector<QVector<QGeoPositionInfo>> chunks(static_cast<size_t>(threads));
+    std::vector<std::unique_ptr<QThread>> workers;
+
+    for (size_t i = 0; i < chunks.size(); ++i)
+    {
+        workers.emplace_back(QThread::create([&bounds, &chunks, &format, i]() {
+            QVector<QGeoPositionInfo> &chunk = chunks[i];
+            parseLines(bounds[i], bounds[i + 1], format, [&chunk](const QGeoPositionInfo &info) {
+                chunk.append(info);
+            });
+        }));
+        workers.back()->start();
+    }
+
+    for (const std::unique_ptr<QThread> &worker : workers)
+    {
+        worker->wait();
+    }
+
+    for (const QVector<QGeoPositionInfo> &chunk : chunks)
+    {
+        for (const QGeoPositionInfo &info : chunk)
+        {
+            callback(info);
+        }
+    }
+
+    return NoError;
+}
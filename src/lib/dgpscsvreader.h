@@ -23,6 +23,7 @@
 #include "targetreport.h"
 #include <QGeoPositionInfo>
 #include <QIODevice>
+#include <functional>
 
 enum ErrorType
 {
@@ -33,6 +34,10 @@ enum ErrorType
 
 Q_DECLARE_METATYPE(ErrorType);
 
+using DgpsCsvCallback = std::function<void(const QGeoPositionInfo &)>;
+
 QVector<QGeoPositionInfo> readDgpsCsv(QIODevice *file, ErrorType *error = nullptr);
+ErrorType streamDgpsCsv(QIODevice *file, const DgpsCsvCallback &callback);
+ErrorType streamDgpsCsvFile(const QString &path, int threads, const DgpsCsvCallback &callback);
 
 #endif  // ASTMOPS_DGPSCSVREADER_H
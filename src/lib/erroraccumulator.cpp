@@ -0,0 +1,197 @@
+/*!
+ * \file erroraccumulator.cpp
+ * \brief Implementation of the ErrorAccumulator class.
+ * \author Álvaro Cebrián Juan, 2020. acebrianjuan(at)gmail.com
+ *
+ * -----------------------------------------------------------------------
+ *
+ * Copyright (C) 2020-2021 Álvaro Cebrián Juan <acebrianjuan@gmail.com>
+ *
+ * ASTMOPS is a command line tool for evaluating 
+ * the performance of A-SMGCS sensors at airports
+ *
+ * This file is part of ASTMOPS.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -----------------------------------------------------------------------
+ */
+
+#include "erroraccumulator.h"
+#include "functions.h"
+
+ErrorAccumulator::ErrorAccumulator(std::optional<int> sketchSize)
+{
+    if (sketchSize.has_value())
+    {
+        toSketch(sketchSize.value());
+    }
+}
+
+ErrorAccumulator &ErrorAccumulator::operator<<(double error)
+{
+    if (exact_)
+    {
+        samples_ << error;
+    }
+    else
+    {
+        sketch_ << error;
+    }
+
+    stats_ << error;
+
+    return *this;
+}
+
+ErrorAccumulator &ErrorAccumulator::operator+=(const ErrorAccumulator &other)
+{
+    if (other.stats_.isEmpty())
+    {
+        return *this;
+    }
+
+    // The merged accumulator is exact only if both of them are.
+    if (exact_ && !other.exact_)
+    {
+        toSketch(other.sketch_.k());
+    }
+
+    if (exact_)
+    {
+        samples_ << other.samples_;
+    }
+    else if (other.exact_)
+    {
+        for (double error : other.samples_)
+        {
+            sketch_ << error;
+        }
+    }
+    else
+    {
+        sketch_ += other.sketch_;
+    }
+
+    stats_ += other.stats_;
+
+    return *this;
+}
+
+bool ErrorAccumulator::isExact() const
+{
+    return exact_;
+}
+
+qint64 ErrorAccumulator::count() const
+{
+    return stats_.count();
+}
+
+double ErrorAccumulator::percentile(double percent) const
+{
+    return percentiles({percent}).first();
+}
+
+/*!
+ * \brief Returns the given \a percents percentiles of the errors. In exact
+ * mode they are selected together, without sorting the samples.
+ */
+QVector<double> ErrorAccumulator::percentiles(const QVector<double> &percents) const
+{
+    if (!exact_)
+    {
+        QVector<double> result;
+        result.reserve(percents.size());
+        for (double percent : percents)
+        {
+            result << sketch_.quantile(percent / 100.0);
+        }
+
+        return result;
+    }
+
+    QVector<double> v = samples_;
+    return quantiles(v, percents);
+}
+
+double ErrorAccumulator::mean() const
+{
+    return stats_.mean();
+}
+
+double ErrorAccumulator::stdDev() const
+{
+    return stats_.stdDev();
+}
+
+double ErrorAccumulator::min() const
+{
+    return stats_.min();
+}
+
+double ErrorAccumulator::max() const
+{
+    return stats_.max();
+}
+
+/*!
+ * \brief Returns the samples in insertion order. Only available in exact
+ * mode.
+ */
+QVector<double> ErrorAccumulator::samples() const
+{
+    return samples_;
+}
+
+void ErrorAccumulator::toSketch(int sketchSize)
+{
+    exact_ = false;
+    sketch_ = QuantileSketch(sketchSize);
+
+    for (double error : qAsConst(samples_))
+    {
+        sketch_ << error;
+    }
+
+    samples_.clear();
+}
+
+/* ---------------------------- Free functions ---------------------------- */
+
+/*!
+ * \brief Binary serialization, keeping either the samples (exact mode) or
+ * the sketch, so that deserialized accumulators merge as the originals.
+ */
+QDataStream &operator<<(QDataStream &out, const ErrorAccumulator &errors)
+{
+    out << errors.exact_;
+
+    if (errors.exact_)
+    {
+        out << errors.samples_;
+    }
+    else
+    {
+        out << errors.sketch_;
+    }
+
+    return out << errors.stats_;
+}
+
+QDataStream &operator>>(QDataStream &in, ErrorAccumulator &errors)
+{
+    errors = ErrorAccumulator();
+    in >> errors.exact_;
+
+    if (errors.exact_)
+    {
+        in >> errors.samples_;
+    }
+    else
+    {
+        in >> errors.sketch_;
+    }
+
+    return in >> errors.stats_;
+}
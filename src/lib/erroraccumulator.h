@@ -0,0 +1,83 @@
+/*!
+ * \file erroraccumulator.h
+ * \brief Interface of the ErrorAccumulator class.
+ * \author Álvaro Cebrián Juan, 2020. acebrianjuan(at)gmail.com
+ *
+ * -----------------------------------------------------------------------
+ *
+ * Copyright (C) 2020-2021 Álvaro Cebrián Juan <acebrianjuan@gmail.com>
+ *
+ * ASTMOPS is a command line tool for evaluating 
+ * the performance of A-SMGCS sensors at airports
+ *
+ * This file is part of ASTMOPS.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -----------------------------------------------------------------------
+ */
+
+#ifndef ASTMOPS_ERRORACCUMULATOR_H
+#define ASTMOPS_ERRORACCUMULATOR_H
+
+#include "quantilesketch.h"
+#include "runningstats.h"
+#include <QDataStream>
+#include <QVector>
+#include <optional>
+
+/*!
+ * \brief The ErrorAccumulator class collects position error samples and
+ * provides their percentiles, mean and standard deviation.
+ *
+ * In exact mode (the default) every sample is kept, and percentiles are
+ * selected from a copy of them with quantiles(), all the ones asked for
+ * by a percentiles() call in a single pass. In sketch mode the samples are summarized in a bounded
+ * QuantileSketch of the given size, so memory does not grow with the
+ * number of samples. In both modes the mean and standard deviation come
+ * from a RunningStats updated as samples arrive. Accumulators of either
+ * mode can be merged.
+ */
+class ErrorAccumulator
+{
+public:
+    ErrorAccumulator() = default;
+    explicit ErrorAccumulator(std::optional<int> sketchSize);
+
+    ErrorAccumulator &operator<<(double error);
+    ErrorAccumulator &operator+=(const ErrorAccumulator &other);
+
+    bool isExact() const;
+    qint64 count() const;
+
+    double percentile(double percent) const;
+    QVector<double> percentiles(const QVector<double> &percents) const;
+    double mean() const;
+    double stdDev() const;
+    double min() const;
+    double max() const;
+
+    QVector<double> samples() const;
+
+    friend QDataStream &operator<<(QDataStream &out, const ErrorAccumulator &errors);
+    friend QDataStream &operator>>(QDataStream &in, ErrorAccumulator &errors);
+
+private:
+    void toSketch(int sketchSize);
+
+    bool exact_ = true;
+
+    // Exact mode.
+    QVector<double> samples_;
+
+    // Sketch mode.
+    QuantileSketch sketch_;
+
+    RunningStats stats_;
+};
+
+// FREE OPERATORS.
+QDataStream &operator<<(QDataStream &out, const ErrorAccumulator &errors);
+QDataStream &operator>>(QDataStream &in, ErrorAccumulator &errors);
+
+#endif  // ASTMOPS_ERRORACCUMULATOR_H
@@ -0,0 +1,222 @@
+/*!
+ * \file evaldump.cpp
+ * \brief Implementation of the EvalDump class.
+ * \author Álvaro Cebrián Juan, 2020. acebrianjuan(at)gmail.com
+ *
+ * -----------------------------------------------------------------------
+ *
+ * Copyright (C) 2020-2021 Álvaro Cebrián Juan <acebrianjuan@gmail.com>
+ *
+ * ASTMOPS is a command line tool for evaluating 
+ * the performance of A-SMGCS sensors at airports
+ *
+ * This file is part of ASTMOPS.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -----------------------------------------------------------------------
+ */
+
+#include "evaldump.h"
+
+EvalDump::EvalDump(QIODevice *device, int chunkRows)
+    : stream_(device), chunkRows_(qMax(1, chunkRows))
+{
+    stream_.setByteOrder(QDataStream::LittleEndian);
+    stream_.setFloatingPointPrecision(QDataStream::DoublePrecision);
+
+    stream_.writeRawData("ASTMDUMP", 8);
+    stream_ << version;
+}
+
+EvalDump::~EvalDump()
+{
+    finish();
+}
+
+int EvalDump::chunkRows() const
+{
+    return chunkRows_;
+}
+
+void EvalDump::addRpaError(SystemType st, const Aerodrome::NamedArea &narea, TrackNum tn,
+    std::optional<ModeS> mode_s, const QDateTime &tod, double error)
+{
+    Q_ASSERT(!finished_);
+
+    rpaErrors_.keys_.append(st, areaId(narea), tn, mode_s);
+    rpaErrors_.tod_ << tod.toMSecsSinceEpoch();
+    rpaErrors_.error_ << error;
+
+    if (rpaErrors_.tod_.size() >= chunkRows_)
+    {
+        flushRpaErrors();
+    }
+}
+
+void EvalDump::addPdWindow(SystemType st, const Aerodrome::NamedArea &narea, TrackNum tn,
+    std::optional<ModeS> mode_s, const QDateTime &begin, const QDateTime &end,
+    quint32 hits, quint32 total)
+{
+    Q_ASSERT(!finished_);
+
+    pdWindows_.keys_.append(st, areaId(narea), tn, mode_s);
+    pdWindows_.begin_ << begin.toMSecsSinceEpoch();
+    pdWindows_.end_ << end.toMSecsSinceEpoch();
+    pdWindows_.count_ << hits;
+    pdWindows_.total_ << total;
+
+    if (pdWindows_.begin_.size() >= chunkRows_)
+    {
+        flushWindows(Table::PdWindows, pdWindows_);
+    }
+}
+
+void EvalDump::addUrWindow(SystemType st, const Aerodrome::NamedArea &narea, TrackNum tn,
+    std::optional<ModeS> mode_s, const QDateTime &begin, const QDateTime &end,
+    quint32 received, quint32 expected)
+{
+    Q_ASSERT(!finished_);
+
+    urWindows_.keys_.append(st, areaId(narea), tn, mode_s);
+    urWindows_.begin_ << begin.toMSecsSinceEpoch();
+    urWindows_.end_ << end.toMSecsSinceEpoch();
+    urWindows_.count_ << received;
+    urWindows_.total_ << expected;
+
+    if (urWindows_.begin_.size() >= chunkRows_)
+    {
+        flushWindows(Table::UrWindows, urWindows_);
+    }
+}
+
+/*!
+ * \brief Writes the pending rows, the area dictionary and the end mark.
+ * Called by the destructor if not called before. Returns false if any
+ * write to the device failed, e.g. because the disk is full, in which
+ * case the dump is incomplete.
+ */
+bool EvalDump::finish()
+{
+    if (finished_)
+    {
+        return isOk();
+    }
+
+    flushRpaErrors();
+    flushWindows(Table::PdWindows, pdWindows_);
+    flushWindows(Table::UrWindows, urWindows_);
+
+    stream_ << static_cast<quint8>(Table::Areas) << static_cast<quint32>(areas_.size());
+    for (int i = 0; i < areas_.size(); ++i)
+    {
+        const Aerodrome::NamedArea &narea = areas_.at(i);
+        const QByteArray name = narea.fullName().toUtf8();
+
+        stream_ << static_cast<quint16>(i) << static_cast<quint32>(narea.area_)
+                << static_cast<quint32>(name.size());
+        stream_.writeRawData(name.constData(), name.size());
+    }
+
+    stream_ << static_cast<quint8>(Table::End);
+
+    finished_ = true;
+
+    return isOk();
+}
+
+/*!
+ * \brief Returns false once a write to the device has failed.
+ */
+bool EvalDump::isOk() const
+{
+    return stream_.status() == QDataStream::Ok;
+}
+
+quint16 EvalDump::areaId(const Aerodrome::NamedArea &narea)
+{
+    auto it = areaIds_.constFind(narea);
+    if (it != areaIds_.constEnd())
+    {
+        return it.value();
+    }
+
+    const quint16 id = static_cast<quint16>(areas_.size());
+    areaIds_.insert(narea, id);
+    areas_ << narea;
+
+    return id;
+}
+
+void EvalDump::flushRpaErrors()
+{
+    if (rpaErrors_.tod_.isEmpty())
+    {
+        return;
+    }
+
+    stream_ << static_cast<quint8>(Table::RpaErrors) << static_cast<quint32>(rpaErrors_.tod_.size());
+
+    writeColumn(rpaErrors_.keys_.system_);
+    writeColumn(rpaErrors_.tod_);
+    writeColumn(rpaErrors_.keys_.area_);
+    writeColumn(rpaErrors_.keys_.trackNum_);
+    writeColumn(rpaErrors_.keys_.modeS_);
+    writeColumn(rpaErrors_.error_);
+
+    // resize(0) keeps the capacity of the buffers for the next chunk.
+    rpaErrors_.keys_.clear();
+    rpaErrors_.tod_.resize(0);
+    rpaErrors_.error_.resize(0);
+}
+
+void EvalDump::flushWindows(Table table, Windows &windows)
+{
+    if (windows.begin_.isEmpty())
+    {
+        return;
+    }
+
+    stream_ << static_cast<quint8>(table) << static_cast<quint32>(windows.begin_.size());
+
+    writeColumn(windows.keys_.system_);
+    writeColumn(windows.begin_);
+    writeColumn(windows.end_);
+    writeColumn(windows.keys_.area_);
+    writeColumn(windows.keys_.trackNum_);
+    writeColumn(windows.keys_.modeS_);
+    writeColumn(windows.count_);
+    writeColumn(windows.total_);
+
+    // resize(0) keeps the capacity of the buffers for the next chunk.
+    windows.keys_.clear();
+    windows.begin_.resize(0);
+    windows.end_.resize(0);
+    windows.count_.resize(0);
+    windows.total_.resize(0);
+}
+
+template <typename T>
+void EvalDump::writeColumn(const QVector<T> &column)
+{
+    for (const T &value : column)
+    {
+        stream_ << value;
+    }
+}
+
+void EvalDump::Keys::append(SystemType st, quint16 area, TrackNum tn, std::optional<ModeS> mode_s)
+{
+    system_ << static_cast<quint8>(st);
+    area_ << area;
+    trackNum_ << tn;
+    modeS_ << mode_s.value_or(noModeS);
+}
+
+void EvalDump::Keys::clear()
+{
+    system_.resize(0);
+    area_.resize(0);
+    trackNum_.resize(0);
+    modeS_.resize(0);
+}
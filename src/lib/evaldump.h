@@ -0,0 +1,175 @@
+/*!
+ * \file evaldump.h
+ * \brief Interface of the EvalDump class.
+ * \author Álvaro Cebrián Juan, 2020. acebrianjuan(at)gmail.com
+ *
+ * -----------------------------------------------------------------------
+ *
+ * Copyright (C) 2020-2021 Álvaro Cebrián Juan <acebrianjuan@gmail.com>
+ *
+ * ASTMOPS is a command line tool for evaluating 
+ * the performance of A-SMGCS sensors at airports
+ *
+ * This file is part of ASTMOPS.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -----------------------------------------------------------------------
+ */
+
+#ifndef ASTMOPS_EVALDUMP_H
+#define ASTMOPS_EVALDUMP_H
+
+#include "aerodrome.h"
+#include "astmops.h"
+#include <QDataStream>
+#include <QDateTime>
+#include <QHash>
+#include <QIODevice>
+#include <QVector>
+#include <optional>
+
+/*!
+ * \brief The EvalDump class streams the intermediate records of an
+ * evaluation to a columnar binary file, so that they can be analysed
+ * offline without running the evaluation again.
+ *
+ * Records are buffered per table and written out in chunks of at most
+ * chunkRows() rows, so memory use does not grow with the recording.
+ *
+ * File layout (all integers and doubles are little-endian):
+ *
+ *     magic     8 bytes   "ASTMDUMP"
+ *     version   quint16   EvalDump::version
+ *     chunk...
+ *     end       quint8    0
+ *
+ * Every chunk is:
+ *
+ *     table     quint8    Table id
+ *     rows      quint32   Number of rows in the chunk
+ *     columns             Each column in schema order, as rows
+ *                         consecutive values of its type
+ *
+ * Table schemas, in column order:
+ *
+ *     RpaErrors (1): one row per TST-REF position pair.
+ *         system    quint8    SystemType of the TST track
+ *         tod       qint64    Timestamp [ms since epoch, UTC]
+ *         area      quint16   Area id (see Areas)
+ *         trackNum  quint16   REF track number
+ *         modeS     quint32   REF Mode S address, noModeS if unknown
+ *         error     double    Horizontal position error [m]
+ *
+ *     PdWindows (2): one row per REF sub-track.
+ *         system    quint8    SystemType under evaluation
+ *         begin     qint64    Sub-track begin [ms since epoch, UTC]
+ *         end       qint64    Sub-track end [ms since epoch, UTC]
+ *         area      quint16   Area id
+ *         trackNum  quint16   REF track number
+ *         modeS     quint32   REF Mode S address, noModeS if unknown
+ *         hits      quint32   Update intervals with a TST report
+ *         total     quint32   Update intervals in the sub-track
+ *
+ *     UrWindows (3): one row per REF sub-track.
+ *         system    quint8    SystemType under evaluation
+ *         begin     qint64    Sub-track begin [ms since epoch, UTC]
+ *         end       qint64    Sub-track end [ms since epoch, UTC]
+ *         area      quint16   Area id
+ *         trackNum  quint16   REF track number
+ *         modeS     quint32   REF Mode S address, noModeS if unknown
+ *         received  quint32   TST reports received
+ *         expected  quint32   TST reports expected
+ *
+ *     Areas (255): dictionary of the area ids, written once at the end.
+ *         id        quint16   Area id
+ *         area      quint32   Aerodrome::Area flags
+ *         nameSize  quint32   Size of the name in bytes
+ *         name      nameSize bytes of UTF-8, the NamedArea full name
+ *
+ * The Areas table is the only one that is not columnar: each of its rows
+ * is written whole, since the name has a variable size.
+ */
+class EvalDump
+{
+public:
+    enum class Table : quint8
+    {
+        End = 0,
+        RpaErrors = 1,
+        PdWindows = 2,
+        UrWindows = 3,
+        Areas = 255
+    };
+
+    static constexpr quint16 version = 1;
+    static constexpr ModeS noModeS = 0xFFFFFFFF;
+    static constexpr int defaultChunkRows = 65536;
+
+    explicit EvalDump(QIODevice *device, int chunkRows = defaultChunkRows);
+    ~EvalDump();
+
+    int chunkRows() const;
+
+    void addRpaError(SystemType st, const Aerodrome::NamedArea &narea, TrackNum tn,
+        std::optional<ModeS> mode_s, const QDateTime &tod, double error);
+    void addPdWindow(SystemType st, const Aerodrome::NamedArea &narea, TrackNum tn,
+        std::optional<ModeS> mode_s, const QDateTime &begin, const QDateTime &end,
+        quint32 hits, quint32 total);
+    void addUrWindow(SystemType st, const Aerodrome::NamedArea &narea, TrackNum tn,
+        std::optional<ModeS> mode_s, const QDateTime &begin, const QDateTime &end,
+        quint32 received, quint32 expected);
+
+    bool finish();
+    bool isOk() const;
+
+private:
+    // Columns shared by every table.
+    struct Keys
+    {
+        void append(SystemType st, quint16 area, TrackNum tn, std::optional<ModeS> mode_s);
+        void clear();
+
+        QVector<quint8> system_;
+        QVector<quint16> area_;
+        QVector<quint16> trackNum_;
+        QVector<quint32> modeS_;
+    };
+
+    struct RpaErrors
+    {
+        Keys keys_;
+        QVector<qint64> tod_;
+        QVector<double> error_;
+    };
+
+    struct Windows
+    {
+        Keys keys_;
+        QVector<qint64> begin_;
+        QVector<qint64> end_;
+        QVector<quint32> count_;
+        QVector<quint32> total_;
+    };
+
+    quint16 areaId(const Aerodrome::NamedArea &narea);
+
+    void flushRpaErrors();
+    void flushWindows(Table table, Windows &windows);
+
+    template <typename T>
+    void writeColumn(const QVector<T> &column);
+
+    QDataStream stream_;
+    int chunkRows_;
+    bool finished_ = false;
+
+    QHash<Aerodrome::NamedArea, quint16> areaIds_;
+    QVector<Aerodrome::NamedArea> areas_;
+
+    RpaErrors rpaErrors_;
+    Windows pdWindows_;
+    Windows urWindows_;
+};
+
+#endif  // ASTMOPS_EVALDUMP_H
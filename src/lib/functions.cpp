@@ -18,40 +18,46 @@
  */
 
 #include "functions.h"
+#include <QCryptographicHash>
+#include <QFile>
+#include <QPair>
+#include <algorithm>
 #include <cmath>
-#include <numeric>
+#include <limits>
 
-double percentile(QVector<double> v, double percent)
+namespace
 {
-    //Q_ASSERT(!v.isEmpty() && percent <= 100);
-
-    if (v.isEmpty() || percent < 0 || percent > 100)
+/*!
+ * \brief Ranks (0-based positions in the sorted data) of the values
+ * whose average is the given percentile of \a n values. Both ranks are
+ * the same when no averaging is needed. Returns false for the cases in
+ * which the percentile is NaN.
+ */
+bool percentileRanks(int n, double percent, QPair<int, int> &ranks)
+{
+    if (n == 0 || percent < 0 || percent > 100)
     {
-        return qSNaN();  // TODO: Should throw a warning here.
+        return false;
     }
 
-    if (v.size() == 1)
+    if (n == 1 || percent == 0)
     {
-        return v.first();
+        ranks = qMakePair(0, 0);
+        return true;
     }
 
-    std::sort(v.begin(), v.end());
-
-    if (percent == 0)
-    {
-        return v.first();
-    }
     if (percent == 100)
     {
-        return v.last();
+        ranks = qMakePair(n - 1, n - 1);
+        return true;
     }
 
-    const int numRecords = v.size();
-    double rank = percent / 100.0 * numRecords;
+    double rank = percent / 100.0 * n;
 
-    if (rank >= numRecords - 1)
+    if (rank >= n - 1)
     {
-        return v.last();
+        ranks = qMakePair(n - 1, n - 1);
+        return true;
     }
 
     double intPart;
@@ -61,49 +67,181 @@ double percentile(QVector<double> v, double percent)
 
     if (fractPart != 0)
     {
-        return v.at(idx + 1);
+        ranks = qMakePair(idx + 1, idx + 1);
     }
     else
     {
-        return (v.at(idx) + v.at(idx + 1)) / 2.0;
+        ranks = qMakePair(idx, idx + 1);
     }
+
+    return true;
 }
+}  // namespace
 
-double mean(const QVector<double> &v)
+double percentile(QVector<double> v, double percent)
 {
-    int N = v.size();
+    return quantiles(v, {percent}).first();
+}
 
-    if (N == 0)
+/*!
+ * \brief Same as percentile() for a vector that is already sorted in
+ * ascending order, which saves sorting it again for every percentile.
+ */
+double sortedPercentile(const QVector<double> &v, double percent)
+{
+    QPair<int, int> ranks;
+    if (!percentileRanks(v.size(), percent, ranks))
     {
-        return qSNaN();
+        return qSNaN();  // TODO: Should throw a warning here.
     }
 
-    double sum = std::accumulate(v.begin(), v.end(), 0.0);
-    double mean = sum / N;
+    if (ranks.first == ranks.second)
+    {
+        return v.at(ranks.first);
+    }
 
-    return mean;
+    return (v.at(ranks.first) + v.at(ranks.second)) / 2.0;
 }
 
-double stdDev(const QVector<double> &v)
+/*!
+ * \brief Computes several percentiles of the range [\a first, \a last)
+ * at once, with the same semantics as percentile().
+ *
+ * Instead of sorting, the order statistics needed by all the requested
+ * percents are selected in ascending order with std::nth_element, each
+ * selection working on the part of the range left after the previous
+ * one. That is O(n) for a handful of percentiles. The range is reordered
+ * in place, so no copy of the caller's data is made.
+ */
+QVector<double> quantiles(double *first, double *last, const QVector<double> &percents)
+{
+    const int n = static_cast<int>(last - first);
+
+    QVector<QPair<int, int>> ranks(percents.size());
+    QVector<bool> valid(percents.size());
+    QVector<int> wanted;
+    for (int i = 0; i < percents.size(); ++i)
+    {
+        valid[i] = percentileRanks(n, percents.at(i), ranks[i]);
+        if (valid.at(i))
+        {
+            wanted << ranks.at(i).first << ranks.at(i).second;
+        }
+    }
+
+    std::sort(wanted.begin(), wanted.end());
+    wanted.erase(std::unique(wanted.begin(), wanted.end()), wanted.end());
+
+    double *lo = first;
+    for (int rank : qAsConst(wanted))
+    {
+        std::nth_element(lo, first + rank, last);
+        lo = first + rank + 1;
+    }
+
+    QVector<double> result;
+    result.reserve(percents.size());
+    for (int i = 0; i < percents.size(); ++i)
+    {
+        if (!valid.at(i))
+        {
+            result << qSNaN();
+        }
+        else if (ranks.at(i).first == ranks.at(i).second)
+        {
+            result << first[ranks.at(i).first];
+        }
+        else
+        {
+            result << (first[ranks.at(i).first] + first[ranks.at(i).second]) / 2.0;
+        }
+    }
+
+    return result;
+}
+
+QVector<double> quantiles(QVector<double> &v, const QVector<double> &percents)
 {
-    int N = v.size();
+    return quantiles(v.data(), v.data() + v.size(), percents);
+}
 
-    if (N == 0)
+/*!
+ * \brief Computes a percentile, with the same semantics as percentile(),
+ * of a set of small non-negative integers given as a counting histogram
+ * (\a histogram[x] is the number of occurrences of the value x).
+ */
+double histogramPercentile(const QVector<quint64> &histogram, double percent)
+{
+    quint64 total = 0;
+    for (quint64 count : histogram)
+    {
+        total += count;
+    }
+
+    QPair<int, int> ranks;
+    if (total > static_cast<quint64>(std::numeric_limits<int>::max()) ||
+        !percentileRanks(static_cast<int>(total), percent, ranks))
     {
         return qSNaN();
     }
 
-    if (N == 1)
+    // Value at a given rank of the sorted data.
+    auto valueAt = [&histogram](quint64 rank) {
+        quint64 cum = 0;
+        for (int x = 0; x < histogram.size(); ++x)
+        {
+            cum += histogram.at(x);
+            if (rank < cum)
+            {
+                return static_cast<double>(x);
+            }
+        }
+
+        return qSNaN();
+    };
+
+    return (valueAt(ranks.first) + valueAt(ranks.second)) / 2.0;
+}
+
+/*!
+ * \brief Accumulates all the values of \a v in a RunningStats, in a
+ * single pass.
+ */
+RunningStats runningStats(const QVector<double> &v)
+{
+    RunningStats stats;
+    for (double x : v)
     {
-        return 0.0;
+        stats << x;
     }
 
-    double mn = mean(v);
+    return stats;
+}
+
+double mean(const QVector<double> &v)
+{
+    return runningStats(v).mean();
+}
+
+double stdDev(const QVector<double> &v)
+{
+    return runningStats(v).stdDev();
+}
+
+/*!
+ * \brief SHA-256 of the contents of the file at \a path. Returns an
+ * empty array if the file cannot be read.
+ */
+QByteArray fileDigest(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        return QByteArray();
+    }
 
-    std::vector<double> diff(v.size());
-    std::transform(v.begin(), v.end(), diff.begin(), [mn](double x) { return x - mn; });
-    double sq_sum = std::inner_product(diff.begin(), diff.end(), diff.begin(), 0.0);
-    double stdev = std::sqrt(sq_sum / (N - 1));
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    hash.addData(&file);
 
-    return stdev;
+    return hash.result();
 }
@@ -20,10 +20,19 @@
 #ifndef ASTMOPS_FUNCTIONS_H
 #define ASTMOPS_FUNCTIONS_H
 
+#include "runningstats.h"
+#include <QByteArray>
+#include <QString>
 #include <QVector>
 
 double percentile(QVector<double> v, double percent);
+double sortedPercentile(const QVector<double> &v, double percent);
+QVector<double> quantiles(double *first, double *last, const QVector<double> &percents);
+QVector<double> quantiles(QVector<double> &v, const QVector<double> &percents);
+double histogramPercentile(const QVector<quint64> &histogram, double percent);
+RunningStats runningStats(const QVector<double> &v);
 double mean(const QVector<double> &v);
 double stdDev(const QVector<double> &v);
+QByteArray fileDigest(const QString &path);
 
 #endif  // ASTMOPS_FUNCTIONS_H
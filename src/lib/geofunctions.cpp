@@ -21,6 +21,7 @@
 #include "geofunctions.h"
 #include <QDebug>
 #include <QRegularExpression>
+#include <cmath>
 
 /*!
  * \brief Computes the prime vertical radius of curvature for the given
@@ -126,9 +127,7 @@ QVector3D ecefToLocalEnu(const QVector3D ecef, const QGeoCoordinate &llhRef)
  */
 QVector3D geoToLocalEnu(const QGeoCoordinate &llh, const QGeoCoordinate &llhRef)
 {
-    QVector3D ecef = geoToEcef(llh);
-    QVector3D enu = ecefToLocalEnu(ecef, llhRef);
-    return enu;
+    return LocalTangentPlane(llhRef).toEnu(llh);
 }
 
 double dmsToDeg(const double deg, const double min, const double sec)
@@ -169,3 +168,129 @@ double dmsToDeg(const double deg, const double min, const double sec, const QStr
 
     return d;
 }
+
+/* -------------------------- LocalTangentPlane --------------------------- */
+
+/*!
+ * \brief Local tangent plane with its origin at \a origin. Latitude in
+ * degrees, longitude in degrees and height in meters.
+ */
+LocalTangentPlane::LocalTangentPlane(const QGeoCoordinate &origin) : origin_(origin)
+{
+    const double phi = qDegreesToRadians(origin.latitude());
+    const double lambda = qDegreesToRadians(origin.longitude());
+    const double h = origin.altitude();
+
+    const double sinPhi = std::sin(phi);
+    const double cosPhi = std::cos(phi);
+
+    const double sinLambda = std::sin(lambda);
+    const double cosLambda = std::cos(lambda);
+
+    const double N = wgs84TransverseRadius(phi);
+
+    x0_ = (h + N) * cosPhi * cosLambda;
+    y0_ = (h + N) * cosPhi * sinLambda;
+    z0_ = (h + (1 - WGS84_E2) * N) * sinPhi;
+
+    east_[0] = -sinLambda;
+    east_[1] = cosLambda;
+    east_[2] = 0;
+
+    north_[0] = -sinPhi * cosLambda;
+    north_[1] = -sinPhi * sinLambda;
+    north_[2] = cosPhi;
+
+    up_[0] = cosPhi * cosLambda;
+    up_[1] = cosPhi * sinLambda;
+    up_[2] = sinPhi;
+}
+
+QGeoCoordinate LocalTangentPlane::origin() const
+{
+    return origin_;
+}
+
+/*!
+ * \brief Converts \a n geographic positions, given as arrays of latitudes
+ * (deg), longitudes (deg) and heights (m), to local ENU coordinates (m).
+ * The output arrays must hold \a n elements each.
+ */
+void LocalTangentPlane::toEnu(int n, const double *lat, const double *lon, const double *h,
+    double *east, double *north, double *up) const
+{
+    const double x0 = x0_;
+    const double y0 = y0_;
+    const double z0 = z0_;
+
+    const double e0 = east_[0], e1 = east_[1];
+    const double n0 = north_[0], n1 = north_[1], n2 = north_[2];
+    const double u0 = up_[0], u1 = up_[1], u2 = up_[2];
+
+    for (int i = 0; i < n; ++i)
+    {
+        const double phi = qDegreesToRadians(lat[i]);
+        const double lambda = qDegreesToRadians(lon[i]);
+
+        const double sinPhi = std::sin(phi);
+        const double cosPhi = std::cos(phi);
+
+        const double sinLambda = std::sin(lambda);
+        const double cosLambda = std::cos(lambda);
+
+        const double N = WGS84_A / std::sqrt(1 - WGS84_E2 * sinPhi * sinPhi);
+
+        const double xd = (h[i] + N) * cosPhi * cosLambda - x0;
+        const double yd = (h[i] + N) * cosPhi * sinLambda - y0;
+        const double zd = (h[i] + (1 - WGS84_E2) * N) * sinPhi - z0;
+
+        east[i] = e0 * xd + e1 * yd;
+        north[i] = n0 * xd + n1 * yd + n2 * zd;
+        up[i] = u0 * xd + u1 * yd + u2 * zd;
+    }
+}
+
+void LocalTangentPlane::toEnu(double lat, double lon, double h,
+    double *east, double *north, double *up) const
+{
+    toEnu(1, &lat, &lon, &h, east, north, up);
+}
+
+QVector3D LocalTangentPlane::toEnu(const QGeoCoordinate &llh) const
+{
+    double east, north, up;
+    toEnu(llh.latitude(), llh.longitude(), llh.altitude(), &east, &north, &up);
+
+    return QVector3D(east, north, up);
+}
+
+/*!
+ * \brief Converts the vertices of a polygon in geographic coordinates to a
+ * polygon in the local EN plane, in a single batch.
+ */
+QPolygonF LocalTangentPlane::toEnuPolygon(const QVector<QGeoCoordinate> &llh) const
+{
+    const int n = llh.size();
+
+    QVector<double> lat(n), lon(n), h(n);
+    for (int i = 0; i < n; ++i)
+    {
+        const QGeoCoordinate &c = llh.at(i);
+        lat[i] = c.latitude();
+        lon[i] = c.longitude();
+        h[i] = c.altitude();
+    }
+
+    QVector<double> east(n), north(n), up(n);
+    toEnu(n, lat.constData(), lon.constData(), h.constData(),
+        east.data(), north.data(), up.data());
+
+    QPolygonF polygon;
+    polygon.reserve(n);
+    for (int i = 0; i < n; ++i)
+    {
+        polygon << QPointF(east.at(i), north.at(i));
+    }
+
+    return polygon;
+}
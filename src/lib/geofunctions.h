@@ -22,7 +22,9 @@
 #define ASTMOPS_GEOFUNCTIONS_H
 
 #include <QGeoCoordinate>
+#include <QPolygonF>
 #include <QVector3D>
+#include <QVector>
 #include <QtMath>
 
 constexpr double WGS84_A = 6378137.0;          // Semi-major axis of the ellipsoid, a [m].
@@ -39,4 +41,43 @@ QVector3D geoToLocalEnu(const QGeoCoordinate &llh, const QGeoCoordinate &llhRef)
 double dmsToDeg(const double deg, const double min, const double sec);
 double dmsToDeg(const double deg, const double min, const double sec, const QString &hemisphere);
 
+/*!
+ * \brief The LocalTangentPlane class converts geographic coordinates to the
+ * local ENU frame of a fixed origin.
+ *
+ * The ECEF position of the origin and the ECEF to ENU rotation matrix are
+ * computed once on construction, and every conversion is carried out in
+ * double precision. The batch overload of toEnu() works on separate arrays
+ * of latitudes, longitudes and heights (structure of arrays) with a
+ * branchless loop body, so that the compiler can vectorize it.
+ */
+class LocalTangentPlane
+{
+public:
+    LocalTangentPlane() = default;
+    explicit LocalTangentPlane(const QGeoCoordinate &origin);
+
+    QGeoCoordinate origin() const;
+
+    void toEnu(int n, const double *lat, const double *lon, const double *h,
+        double *east, double *north, double *up) const;
+    void toEnu(double lat, double lon, double h,
+        double *east, double *north, double *up) const;
+    QVector3D toEnu(const QGeoCoordinate &llh) const;
+    QPolygonF toEnuPolygon(const QVector<QGeoCoordinate> &llh) const;
+
+private:
+    QGeoCoordinate origin_;
+
+    // ECEF coordinates of the origin [m].
+    double x0_ = 0;
+    double y0_ = 0;
+    double z0_ = 0;
+
+    // Rows of the ECEF to ENU rotation matrix.
+    double east_[3] = {};
+    double north_[3] = {};
+    double up_[3] = {};
+};
+
 #endif  // ASTMOPS_GEOFUNCTIONS_H
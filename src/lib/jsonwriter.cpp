@@ -0,0 +1,88 @@
+/*!
+ * \file jsonwriter.cpp
+ * \brief Implementation of the JsonWriter class.
+ * \author Álvaro Cebrián Juan, 2020. acebrianjuan(at)gmail.com
+ *
+ * -----------------------------------------------------------------------
+ *
+ * Copyright (C) 2020-2021 Álvaro Cebrián Juan <acebrianjuan@gmail.com>
+ *
+ * ASTMOPS is a command line tool for evaluating 
+ * the performance of A-SMGCS sensors at airports
+ *
+ * This file is part of ASTMOPS.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -----------------------------------------------------------------------
+ */
+
+#include "jsonwriter.h"
+#include <QJsonArray>
+#include <QJsonDocument>
+
+JsonWriter::JsonWriter(QIODevice *device) : device_(device)
+{
+}
+
+void JsonWriter::beginObject()
+{
+    device_->write("{\n");
+    hasMembers_ << false;
+}
+
+void JsonWriter::endObject()
+{
+    Q_ASSERT(!hasMembers_.isEmpty());
+
+    if (hasMembers_.takeLast())
+    {
+        device_->write("\n");
+    }
+
+    device_->write(QByteArray(4 * hasMembers_.size(), ' '));
+    device_->write("}");
+
+    if (hasMembers_.isEmpty())
+    {
+        device_->write("\n");
+    }
+}
+
+void JsonWriter::writeKey(const QString &key)
+{
+    Q_ASSERT(!hasMembers_.isEmpty());
+
+    if (hasMembers_.last())
+    {
+        device_->write(",\n");
+    }
+    hasMembers_.last() = true;
+
+    device_->write(QByteArray(4 * hasMembers_.size(), ' '));
+    device_->write(fragment(key));
+    device_->write(": ");
+}
+
+void JsonWriter::writeValue(const QJsonValue &value)
+{
+    device_->write(fragment(value));
+}
+
+void JsonWriter::writeMember(const QString &key, const QJsonValue &value)
+{
+    writeKey(key);
+    writeValue(value);
+}
+
+/*!
+ * \brief Serializes a single scalar value through QJsonDocument, so that
+ * number formatting and string escaping are exactly Qt's.
+ */
+QByteArray JsonWriter::fragment(const QJsonValue &value)
+{
+    const QByteArray json = QJsonDocument(QJsonArray({value})).toJson(QJsonDocument::Compact);
+
+    // Strip the enclosing brackets.
+    return json.mid(1, json.size() - 2);
+}
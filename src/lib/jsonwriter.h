@@ -0,0 +1,56 @@
+/*!
+ * \file jsonwriter.h
+ * \brief Interface of the JsonWriter class.
+ * \author Álvaro Cebrián Juan, 2020. acebrianjuan(at)gmail.com
+ *
+ * -----------------------------------------------------------------------
+ *
+ * Copyright (C) 2020-2021 Álvaro Cebrián Juan <acebrianjuan@gmail.com>
+ *
+ * ASTMOPS is a command line tool for evaluating 
+ * the performance of A-SMGCS sensors at airports
+ *
+ * This file is part of ASTMOPS.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -----------------------------------------------------------------------
+ */
+
+#ifndef ASTMOPS_JSONWRITER_H
+#define ASTMOPS_JSONWRITER_H
+
+#include <QIODevice>
+#include <QJsonValue>
+#include <QVector>
+
+/*!
+ * \brief The JsonWriter class writes a JSON document to a device as it is
+ * produced, instead of building a QJsonDocument in memory first.
+ *
+ * The layout is the same as QJsonDocument::Indented. QJsonObject sorts
+ * its keys, so callers wanting byte-identical output must write the
+ * members of each object in ascending key order.
+ */
+class JsonWriter
+{
+public:
+    explicit JsonWriter(QIODevice *device);
+
+    void beginObject();
+    void endObject();
+
+    void writeKey(const QString &key);
+    void writeValue(const QJsonValue &value);
+    void writeMember(const QString &key, const QJsonValue &value);
+
+private:
+    static QByteArray fragment(const QJsonValue &value);
+
+    QIODevice *device_ = nullptr;
+
+    // One entry per open object, telling whether it has members yet.
+    QVector<bool> hasMembers_;
+};
+
+#endif  // ASTMOPS_JSONWRITER_H
@@ -61,6 +61,7 @@ Aerodrome KmlReader::makeAerodrome() const
 
     // Coordinates of the local tangent plane origin.
     QGeoCoordinate originGeo = arp_;
+    LocalTangentPlane ltp(originGeo);
 
     // SMR origins.
     if (smr_.isEmpty())
@@ -75,7 +76,7 @@ Aerodrome KmlReader::makeAerodrome() const
             Sic sic = it.key();
             QGeoCoordinate smrGeo = it.value();
 
-            aerodrome.addSmr(sic, geoToLocalEnu(smrGeo, originGeo));
+            aerodrome.addSmr(sic, ltp.toEnu(smrGeo));
         }
     }
 
@@ -94,13 +95,7 @@ Aerodrome KmlReader::makeAerodrome() const
 
             for (const QVector<QGeoCoordinate> &rwyEleGeo : rwyElements)
             {
-                QPolygonF polygon;
-                polygon.reserve(rwyEleGeo.size());
-
-                for (const QGeoCoordinate &coord : rwyEleGeo)
-                {
-                    polygon << geoToLocalEnu(coord, originGeo).toPointF();
-                }
+                QPolygonF polygon = ltp.toEnuPolygon(rwyEleGeo);
 
                 aerodrome.addRunwayElement(idStr, polygon);
             }
@@ -122,13 +117,7 @@ Aerodrome KmlReader::makeAerodrome() const
 
             for (const QVector<QGeoCoordinate> &twyEleGeo : twyElements)
             {
-                QPolygonF polygon;
-                polygon.reserve(twyEleGeo.size());
-
-                for (const QGeoCoordinate &coord : twyEleGeo)
-                {
-                    polygon << geoToLocalEnu(coord, originGeo).toPointF();
-                }
+                QPolygonF polygon = ltp.toEnuPolygon(twyEleGeo);
 
                 aerodrome.addTaxiwayElement(idStr, polygon);
             }
@@ -150,13 +139,7 @@ Aerodrome KmlReader::makeAerodrome() const
 
             for (const QVector<QGeoCoordinate> &apronLaneEleGeo : apronLaneElements)
             {
-                QPolygonF polygon;
-                polygon.reserve(apronLaneEleGeo.size());
-
-                for (const QGeoCoordinate &coord : apronLaneEleGeo)
-                {
-                    polygon << geoToLocalEnu(coord, originGeo).toPointF();
-                }
+                QPolygonF polygon = ltp.toEnuPolygon(apronLaneEleGeo);
 
                 aerodrome.addApronLaneElement(idStr, polygon);
             }
@@ -178,13 +161,7 @@ Aerodrome KmlReader::makeAerodrome() const
 
             for (const QVector<QGeoCoordinate> &standEleGeo : standElements)
             {
-                QPolygonF polygon;
-                polygon.reserve(standEleGeo.size());
-
-                for (const QGeoCoordinate &coord : standEleGeo)
-                {
-                    polygon << geoToLocalEnu(coord, originGeo).toPointF();
-                }
+                QPolygonF polygon = ltp.toEnuPolygon(standEleGeo);
 
                 aerodrome.addStandElement(idStr, polygon);
             }
@@ -206,13 +183,7 @@ Aerodrome KmlReader::makeAerodrome() const
 
             for (const QVector<QGeoCoordinate> &airborne1EleGeo : airborne1Elements)
             {
-                QPolygonF polygon;
-                polygon.reserve(airborne1EleGeo.size());
-
-                for (const QGeoCoordinate &coord : airborne1EleGeo)
-                {
-                    polygon << geoToLocalEnu(coord, originGeo).toPointF();
-                }
+                QPolygonF polygon = ltp.toEnuPolygon(airborne1EleGeo);
 
                 aerodrome.addAirborne1Element(idStr, polygon);
             }
@@ -234,13 +205,7 @@ Aerodrome KmlReader::makeAerodrome() const
 
             for (const QVector<QGeoCoordinate> &airborne2EleGeo : airborne2Elements)
             {
-                QPolygonF polygon;
-                polygon.reserve(airborne2EleGeo.size());
-
-                for (const QGeoCoordinate &coord : airborne2EleGeo)
-                {
-                    polygon << geoToLocalEnu(coord, originGeo).toPointF();
-                }
+                QPolygonF polygon = ltp.toEnuPolygon(airborne2EleGeo);
 
                 aerodrome.addAirborne2Element(idStr, polygon);
             }
@@ -0,0 +1,147 @@
+/*!
+ * \file livefeed.cpp
+ * \brief Implementation of the LiveFeed class.
+ * \author Álvaro Cebrián Juan, 2020. acebrianjuan(at)gmail.com
+ *
+ * -----------------------------------------------------------------------
+ *
+ * Copyright (C) 2020-2021 Álvaro Cebrián Juan <acebrianjuan@gmail.com>
+ *
+ * ASTMOPS is a command line tool for evaluating 
+ * the performance of A-SMGCS sensors at airports
+ *
+ * This file is part of ASTMOPS.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -----------------------------------------------------------------------
+ */
+
+#include "livefeed.h"
+#include <QDebug>
+#include <QNetworkDatagram>
+
+namespace
+{
+const int reconnectInterval = 1000;  // ms
+}  // namespace
+
+LiveFeed::LiveFeed(QObject *parent) : QObject(parent)
+{
+    connect(&udp_, &QUdpSocket::readyRead, this, &LiveFeed::readDatagrams);
+    connect(&tcp_, &QTcpSocket::readyRead, this, &LiveFeed::readStream);
+
+    // Covers both lost connections and failed connection attempts.
+    connect(&tcp_, &QAbstractSocket::stateChanged, this, [this](QAbstractSocket::SocketState state) {
+        if (state == QAbstractSocket::UnconnectedState && !host_.isEmpty())
+        {
+            reconnectTimer_.start();
+        }
+    });
+
+    reconnectTimer_.setInterval(reconnectInterval);
+    reconnectTimer_.setSingleShot(true);
+    connect(&reconnectTimer_, &QTimer::timeout, this, &LiveFeed::reconnect);
+}
+
+/*!
+ * \brief Receives datagrams on \a port, joining the multicast \a group
+ * if one is given. Returns false if the socket cannot be bound.
+ */
+bool LiveFeed::listenUdp(quint16 port, const QHostAddress &group)
+{
+    if (!udp_.bind(QHostAddress::AnyIPv4, port, QUdpSocket::ShareAddress | QUdpSocket::ReuseAddressHint))
+    {
+        qWarning() << "Could not bind UDP port" << port << udp_.errorString();
+        return false;
+    }
+
+    if (!group.isNull() && !udp_.joinMulticastGroup(group))
+    {
+        qWarning() << "Could not join multicast group" << group << udp_.errorString();
+        return false;
+    }
+
+    return true;
+}
+
+/*!
+ * \brief Connects to the TCP server at \a host and \a port, and again
+ * each time the connection is lost.
+ */
+void LiveFeed::connectTcp(const QString &host, quint16 port)
+{
+    host_ = host;
+    port_ = port;
+
+    reconnect();
+}
+
+bool LiveFeed::hasPendingData() const
+{
+    return !lines_.isEmpty();
+}
+
+/*!
+ * \brief Returns the complete lines received since the last call.
+ */
+QByteArray LiveFeed::takeData()
+{
+    QByteArray data;
+    data.swap(lines_);
+
+    return data;
+}
+
+void LiveFeed::readDatagrams()
+{
+    while (udp_.hasPendingDatagrams())
+    {
+        const QByteArray data = udp_.receiveDatagram().data();
+        if (data.isEmpty())
+        {
+            continue;
+        }
+
+        lines_.append(data);
+        if (!data.endsWith('\n'))
+        {
+            lines_.append('\n');
+        }
+    }
+
+    if (hasPendingData())
+    {
+        emit readyRead();
+    }
+}
+
+void LiveFeed::readStream()
+{
+    partial_.append(tcp_.readAll());
+
+    const int end = partial_.lastIndexOf('\n');
+    if (end == -1)
+    {
+        return;
+    }
+
+    lines_.append(partial_.constData(), end + 1);
+    partial_.remove(0, end + 1);
+
+    emit readyRead();
+}
+
+void LiveFeed::reconnect()
+{
+    if (tcp_.state() != QAbstractSocket::UnconnectedState)
+    {
+        return;
+    }
+
+    // A line cut by the lost connection is not resumed by the next one.
+    partial_.clear();
+
+    qInfo() << "Connecting to" << host_ << port_;
+    tcp_.connectToHost(host_, port_);
+}
@@ -0,0 +1,73 @@
+/*!
+ * \file livefeed.h
+ * \brief Interface of the LiveFeed class.
+ * \author Álvaro Cebrián Juan, 2020. acebrianjuan(at)gmail.com
+ *
+ * -----------------------------------------------------------------------
+ *
+ * Copyright (C) 2020-2021 Álvaro Cebrián Juan <acebrianjuan@gmail.com>
+ *
+ * ASTMOPS is a command line tool for evaluating 
+ * the performance of A-SMGCS sensors at airports
+ *
+ * This file is part of ASTMOPS.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -----------------------------------------------------------------------
+ */
+
+#ifndef ASTMOPS_LIVEFEED_H
+#define ASTMOPS_LIVEFEED_H
+
+#include <QHostAddress>
+#include <QObject>
+#include <QTcpSocket>
+#include <QTimer>
+#include <QUdpSocket>
+
+/*!
+ * \brief The LiveFeed class receives ASTERIX XML records, one per line as
+ * in the recordings, from the network.
+ *
+ * Over UDP (unicast or multicast) every datagram carries whole lines. Over
+ * TCP the feed connects to a server streaming the lines and reconnects
+ * whenever the connection is lost. In both cases readyRead() is emitted
+ * once complete lines are available, to be fed to an AsterixXmlReader.
+ */
+class LiveFeed : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit LiveFeed(QObject *parent = nullptr);
+
+    bool listenUdp(quint16 port, const QHostAddress &group = QHostAddress());
+    void connectTcp(const QString &host, quint16 port);
+
+    bool hasPendingData() const;
+    QByteArray takeData();
+
+signals:
+    void readyRead();
+
+private slots:
+    void readDatagrams();
+    void readStream();
+    void reconnect();
+
+private:
+    QString host_;
+    quint16 port_ = 0;
+    QTimer reconnectTimer_;
+
+    QByteArray lines_;    // Complete lines not taken yet.
+    QByteArray partial_;  // Incomplete last line of the TCP stream.
+
+    // Declared last, so that they are destroyed while the members their
+    // signals use are still alive.
+    QUdpSocket udp_;
+    QTcpSocket tcp_;
+};
+
+#endif  // ASTMOPS_LIVEFEED_H
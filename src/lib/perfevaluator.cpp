@@ -18,23 +18,21 @@
  */
 
 #include "perfevaluator.h"
-#include "config.h"
-#include <QCoreApplication>
-#include <QJsonDocument>
+#include "profiler.h"
 #include <QMetaEnum>
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <numeric>
 
-#if (QT_VERSION < QT_VERSION_CHECK(5, 14, 0))
-#include <QTextStream>
-namespace Qt
+namespace
 {
-static const auto &endl = &::endl;
-static const auto &left = &::left;
-//static const auto &center = &::center;
-static const auto &right = &::right;
-}  // namespace Qt
-#endif
-
-PerfEvaluator::PerfEvaluator()
+const char stateMagic[] = "ASTMSTAT";
+const int stateMagicSize = 8;
+const QDataStream::Version stateStreamVersion = QDataStream::Qt_5_12;
+}  // namespace
+
+PerfEvaluator::PerfEvaluator(const RunConfig &config) : config_(config)
 {
 }
 
@@ -43,13 +41,36 @@ void PerfEvaluator::addData(const Track &t)
     trkAssoc_.addData(t);
 }
 
+/*!
+ * \brief Evaluates the tracks added and computes the results.
+ */
 void PerfEvaluator::run()
+{
+    evaluate();
+    finish();
+}
+
+/*!
+ * \brief Associates the tracks added and accumulates the counters of
+ * every metric, without computing the results yet. At this point the
+ * state of a mergeable evaluation (see setMergeable()) can be saved with
+ * saveState() and merged with the states of evaluations of other parts
+ * of the traffic.
+ */
+void PerfEvaluator::evaluate()
 {
     // Run track association.
-    trkAssoc_.run();
+    {
+        Profiler::ScopedTimer timer(Profiler::Stage::Association);
+        trkAssoc_.run();
+        timer.setItems(trkAssoc_.sets().size());
+    }
 
-    // Set PIC threshold value.
-    computePicThreshold(Configuration::rpaPicPercentile());
+    // PIC threshold of the reference target reports used for RPA. In a
+    // mergeable evaluation it is computed again in finish() from the
+    // histograms of every merged part.
+    computePicHistogram();
+    computePicThreshold(config_.rpaPicPercentile);
 
     // Iterate through each target set.
     for (const TrackCollectionSet &s : qAsConst(trkAssoc_.sets()))
@@ -69,82 +90,250 @@ void PerfEvaluator::run()
         evalED117PFID(s);
         evalED117PLG(s);
     }
+}
+
+/*!
+ * \brief Computes the results from the accumulated counters.
+ */
+void PerfEvaluator::finish()
+{
+    {
+        Profiler::ScopedTimer timer(Profiler::Stage::ED116PFD, 0);
+        finishED116PFD();
+    }
+
+    Profiler::ScopedTimer timer(Profiler::Stage::Results);
+
+    // The PIC threshold of the whole traffic, from the merged histograms.
+    if (mergeable_)
+    {
+        computePicThreshold(config_.rpaPicPercentile);
+        finishRpa();
+    }
+
+    results_ = computeResults();
+}
+
+/*!
+ * \brief Makes the evaluation mergeable: evaluate() keeps the RPA errors
+ * for every PIC threshold, so that its state can be saved and merged with
+ * others, and finish() applies the threshold of the merged traffic. That
+ * takes one RPA pass per distinct PIC of each reference sub-track, so it
+ * is only worth it when the state is saved.
+ */
+void PerfEvaluator::setMergeable(bool mergeable)
+{
+    mergeable_ = mergeable;
+}
+
+void PerfEvaluator::setDump(EvalDump *dump)
+{
+    dump_ = dump;
+}
+
+const PerfResults &PerfEvaluator::results() const
+{
+    return results_;
+}
 
-    // Print results.
+/*!
+ * \brief Merges the counters accumulated by \a other, an evaluation of
+ * another part of the same traffic (e.g. another hour or another set of
+ * targets). Both must have been evaluated but not finished, \a other
+ * as a mergeable evaluation. The result is mergeable.
+ */
+PerfEvaluator &PerfEvaluator::operator+=(const PerfEvaluator &other)
+{
+    // Evaluations that are not mergeable only kept the RPA errors at
+    // their own PIC threshold.
+    if (!other.mergeable_ && (!other.smrRpaErrors_.isEmpty() || !other.mlatRpaErrors_.isEmpty()))
+    {
+        qWarning() << "Merging an evaluation that is not mergeable, its RPA errors are left out";
+    }
 
-    const QStringList args = QCoreApplication::arguments();
-    const int idx = args.indexOf(QLatin1String("--json"));
+    mergeable_ = true;
 
-    if (idx != -1)  // Print JSON output.
+    // The PIC threshold of the merged evaluation comes from the sum of
+    // the histograms, see finish().
+    if (picHistogram_.isEmpty())
     {
-        QJsonObject jsonRoot;
-        jsonRoot.insert(QLatin1String("type"), QLatin1String("astmops 1.0"));
-
-        jsonRoot.insert(QLatin1String("ED116RPA"), printED116RPA_json());
-        jsonRoot.insert(QLatin1String("ED116UR"), printED116UR_json());
-        jsonRoot.insert(QLatin1String("ED116PD"), printED116PD_json());
-        jsonRoot.insert(QLatin1String("ED116PFD"), printED116PFD_json());
-
-        jsonRoot.insert(QLatin1String("ED117RPA"), printED117RPA_json());
-        jsonRoot.insert(QLatin1String("ED117UR"), printED117UR_json());
-        jsonRoot.insert(QLatin1String("ED117PD"), printED117PD_json());
-        jsonRoot.insert(QLatin1String("ED117PFD"), printED117PFD_json());
-        jsonRoot.insert(QLatin1String("ED117PID_Ident"), printED117PID_Ident_json());
-        jsonRoot.insert(QLatin1String("ED117PID_Mode3A"), printED117PID_Mode3A_json());
-        jsonRoot.insert(QLatin1String("ED117PFID_Ident"), printED117PFID_Ident_json());
-        jsonRoot.insert(QLatin1String("ED117PFID_Mode3A"), printED117PFID_Mode3A_json());
-        jsonRoot.insert(QLatin1String("ED117PLG"), printED117PLG_json());
-
-        QJsonDocument document(jsonRoot);
-        QTextStream(stdout) << QString::fromLatin1(document.toJson(QJsonDocument::Indented));
+        picHistogram_ = other.picHistogram_;
     }
-    else  // Print plain text tables.
+    else
     {
-        printED116RPA();
-        printED116UR();
-        printED116PD();
-        printED116PFD();
-
-        printED117RPA();
-        printED117UR();
-        printED117PD();
-        printED117PFD();
-        printED117PID_Ident();
-        printED117PID_Mode3A();
-        printED117PFID_Ident();
-        printED117PFID_Mode3A();
-        printED117PLG();
+        for (int i = 0; i < other.picHistogram_.size() && i < picHistogram_.size(); ++i)
+        {
+            picHistogram_[i] += other.picHistogram_.at(i);
+        }
     }
+
+    trafficPeriodBuilders_ += other.trafficPeriodBuilders_;
+
+    auto addRpaErrors = [](RpaErrorsByPic &errors, const RpaErrorsByPic &otherErrors) {
+        for (auto it = otherErrors.constBegin(); it != otherErrors.constEnd(); ++it)
+        {
+            errors[it.key()] += it.value();
+        }
+    };
+
+    addRpaErrors(smrRpaErrorsByPic_, other.smrRpaErrorsByPic_);
+    addRpaErrors(mlatRpaErrorsByPic_, other.mlatRpaErrorsByPic_);
+
+    smrUr_ += other.smrUr_;
+    mlatUr_ += other.mlatUr_;
+
+    smrPd_ += other.smrPd_;
+    mlatPd_ += other.mlatPd_;
+
+    smrPfd_ += other.smrPfd_;
+    mlatPfd_ += other.mlatPfd_;
+
+    mlatPidIdent_ += other.mlatPidIdent_;
+    mlatPidMode3A_ += other.mlatPidMode3A_;
+
+    mlatPfidIdent_ += other.mlatPfidIdent_;
+    mlatPfidMode3A_ += other.mlatPfidMode3A_;
+
+    mlatPlg_ += other.mlatPlg_;
+
+    return *this;
 }
 
-void PerfEvaluator::computePicThreshold(double prctl)
+/*!
+ * \brief Writes the accumulated counters to \a device, to be merged later
+ * with mergeState(). Must be called after evaluate() and before finish(),
+ * and only on a mergeable evaluation.
+ *
+ * File layout (QDataStream, Qt 5.12 format):
+ *
+ *     magic      8 bytes   "ASTMSTAT"
+ *     version    quint16   PerfEvaluator::stateVersion
+ *     settings   RPA PIC percentile
+ *     counters   PIC histogram, ED-116 PFD traffic periods, RPA errors by
+ *                range of PIC thresholds and the per-area counters of
+ *                every other metric
+ */
+bool PerfEvaluator::saveState(QIODevice *device) const
+{
+    if (!mergeable_)
+    {
+        qWarning() << "Cannot save the state of an evaluation that is not mergeable";
+        return false;
+    }
+
+    QDataStream out(device);
+    out.setVersion(stateStreamVersion);
+
+    out.writeRawData(stateMagic, stateMagicSize);
+    out << stateVersion << config_.rpaPicPercentile
+        << picHistogram_
+        << trafficPeriodBuilders_
+        << smrRpaErrorsByPic_ << mlatRpaErrorsByPic_
+        << smrUr_ << mlatUr_
+        << smrPd_ << mlatPd_
+        << smrPfd_ << mlatPfd_
+        << mlatPidIdent_ << mlatPidMode3A_
+        << mlatPfidIdent_ << mlatPfidMode3A_
+        << mlatPlg_;
+
+    return out.status() == QDataStream::Ok;
+}
+
+/*!
+ * \brief Reads a state written by saveState() from \a device and merges
+ * it into this evaluation. Returns false, leaving the evaluation as it
+ * was, if the state cannot be read.
+ */
+bool PerfEvaluator::mergeState(QIODevice *device)
+{
+    QDataStream in(device);
+    in.setVersion(stateStreamVersion);
+
+    char fileMagic[stateMagicSize];
+    quint16 fileVersion = 0;
+
+    if (in.readRawData(fileMagic, stateMagicSize) != stateMagicSize ||
+        std::memcmp(fileMagic, stateMagic, stateMagicSize) != 0)
+    {
+        qWarning() << "Not an evaluation state";
+        return false;
+    }
+
+    in >> fileVersion;
+    if (fileVersion != stateVersion)
+    {
+        qWarning() << "Unsupported evaluation state version" << fileVersion;
+        return false;
+    }
+
+    PerfEvaluator part(config_);
+    part.setMergeable(true);
+    double picPercentile = qSNaN();
+
+    in >> picPercentile
+        >> part.picHistogram_
+        >> part.trafficPeriodBuilders_
+        >> part.smrRpaErrorsByPic_ >> part.mlatRpaErrorsByPic_
+        >> part.smrUr_ >> part.mlatUr_
+        >> part.smrPd_ >> part.mlatPd_
+        >> part.smrPfd_ >> part.mlatPfd_
+        >> part.mlatPidIdent_ >> part.mlatPidMode3A_
+        >> part.mlatPfidIdent_ >> part.mlatPfidMode3A_
+        >> part.mlatPlg_;
+
+    if (in.status() != QDataStream::Ok)
+    {
+        qWarning() << "Corrupt evaluation state";
+        return false;
+    }
+
+    if (!qFuzzyCompare(picPercentile, config_.rpaPicPercentile))
+    {
+        qWarning() << "Evaluation state computed with RPA PIC percentile" << picPercentile
+                   << "instead of" << config_.rpaPicPercentile;
+    }
+
+    *this += part;
+
+    return true;
+}
+
+void PerfEvaluator::computePicHistogram()
 {
-    QVector<double> vec;
+    // PIC values are small integers, so a counting histogram is enough
+    // to compute their percentile without collecting or sorting them.
+    QVector<quint64> histogram(std::numeric_limits<quint8>::max() + 1, 0);
+
     for (const TrackCollectionSet &s : qAsConst(trkAssoc_.sets()))
     {
         for (const Track &t : s.refTrackCol())
         {
             for (const TargetReport &tr : t)
             {
-                if (tr.narea_.area_ != Aerodrome::Area::None &&
+                if (tr.narea_.area() != Aerodrome::Area::None &&
                     tr.ver_.has_value() && tr.pic_.has_value())
                 {
                     if (tr.ver_ == 2)
                     {
-                        vec << tr.pic_.value();
+                        ++histogram[tr.pic_.value()];
                     }
                 }
             }
         }
     }
 
-    if (vec.isEmpty())
+    picHistogram_ = histogram;
+}
+
+void PerfEvaluator::computePicThreshold(double prctl)
+{
+    if (std::accumulate(picHistogram_.begin(), picHistogram_.end(), quint64(0)) == 0)
     {
         // qWarning() or qFatal();
         return;
     }
 
-    double pctl = percentile(vec, prctl);
+    double pctl = histogramPercentile(picHistogram_, prctl);
     if (qIsNaN(pctl))
     {
         // qWarning() or qFatal();
@@ -154,6 +343,122 @@ void PerfEvaluator::computePicThreshold(double prctl)
     pic_p95_ = pctl;
 }
 
+ErrorAccumulator &PerfEvaluator::rpaErrors(AreaHash<ErrorAccumulator> &hash, const Aerodrome::NamedArea &narea)
+{
+    auto it = hash.find(narea);
+    if (it == hash.end())
+    {
+        it = hash.insert(narea, ErrorAccumulator(config_.rpaSketchSize));
+    }
+
+    return it.value();
+}
+
+/*!
+ * \brief Accumulates the RPA errors of the test track \a trk_tst, or its
+ * copy \a t_t averaged on stands, against the reference sub-track
+ * \a sub_trk_ref of \a trk_ref.
+ *
+ * Only reference target reports with MOPS version 2 and a PIC not below
+ * the threshold are used. The errors go to \a errors, at the threshold of
+ * this evaluation. In a mergeable evaluation the threshold of the whole
+ * traffic is only known once every part is merged, so the errors are
+ * instead computed once per distinct PIC of the sub-track and go to
+ * \a errorsByPic, under the range of thresholds that keep the same target
+ * reports.
+ */
+void PerfEvaluator::evalRpaErrors(const Track &trk_ref, const Track &sub_trk_ref, const Track &trk_tst,
+    const Track &t_t, SystemType st, AreaHash<ErrorAccumulator> &errors, RpaErrorsByPic &errorsByPic)
+{
+    const QVector<QDateTime> timestamps = trk_tst.timestamps();
+
+    // Errors of the REF target reports with a PIC of at least pic.
+    auto addErrors = [&](quint8 pic, AreaHash<ErrorAccumulator> &hash, bool dumped) {
+        Track t_r = filterTrackByQuality(sub_trk_ref, 2, pic);
+
+        if (t_r.isEmpty())
+        {
+            return;
+        }
+
+        // Resample the REF sub-track at the times of the TST track.
+        t_r = resample(t_r, timestamps);
+
+        // Calculate Euclidean distance between TST-REF pairs.
+        QVector<QPair<TargetReport, double>> dists = euclideanDistance(t_r.rdata(), t_t.rdata());
+
+        for (const QPair<TargetReport, double> &p : dists)
+        {
+            Aerodrome::NamedArea narea = p.first.narea_;
+            double dist = p.second;
+            rpaErrors(hash, narea) << dist;
+
+            if (dumped)
+            {
+                dump_->addRpaError(st, narea, trk_ref.track_number(), trk_ref.mode_s(), p.first.tod_, dist);
+            }
+        }
+    };
+
+    if (!mergeable_)
+    {
+        addErrors(pic_p95_, errors, dump_ != nullptr);
+        return;
+    }
+
+    QVector<quint8> pics;
+    for (const TargetReport &tr : sub_trk_ref)
+    {
+        if (tr.ver_ == 2 && tr.pic_.has_value())
+        {
+            pics << tr.pic_.value();
+        }
+    }
+
+    std::sort(pics.begin(), pics.end());
+    pics.erase(std::unique(pics.begin(), pics.end()), pics.end());
+
+    int first = 0;
+    for (quint8 pic : qAsConst(pics))
+    {
+        // Only the errors at the threshold of this evaluation are dumped.
+        const bool dumped = dump_ && first <= pic_p95_ && pic_p95_ <= pic;
+
+        addErrors(pic, errorsByPic[quint16((first << 8) | pic)], dumped);
+
+        first = pic + 1;
+    }
+}
+
+/*!
+ * \brief Picks the RPA errors at the PIC threshold of the whole traffic.
+ */
+void PerfEvaluator::finishRpa()
+{
+    auto errorsAtThreshold = [this](const RpaErrorsByPic &errors) {
+        AreaHash<ErrorAccumulator> result;
+
+        for (auto it = errors.constBegin(); it != errors.constEnd(); ++it)
+        {
+            const int first = it.key() >> 8;
+            const int last = it.key() & 0xFF;
+
+            if (first <= pic_p95_ && pic_p95_ <= last)
+            {
+                for (auto jt = it.value().constBegin(); jt != it.value().constEnd(); ++jt)
+                {
+                    rpaErrors(result, jt.key()) += jt.value();
+                }
+            }
+        }
+
+        return result;
+    };
+
+    smrRpaErrors_ = errorsAtThreshold(smrRpaErrorsByPic_);
+    mlatRpaErrors_ = errorsAtThreshold(mlatRpaErrorsByPic_);
+}
+
 QVector<QPair<TargetReport, double>> PerfEvaluator::euclideanDistance(const TgtRepMap &ref, const TgtRepMap &tst) const
 {
     QVector<QPair<TargetReport, double>> v;
@@ -213,6 +518,8 @@ Track PerfEvaluator::filterTrackByQuality(const Track &trk, quint8 ver, quint8 p
 
 void PerfEvaluator::evalED116RPA(const TrackCollectionSet &s)
 {
+    Profiler::ScopedTimer timer(Profiler::Stage::ED116RPA);
+
     TrackCollection col_ref = s.refTrackCol();
 
     // Iterate through each track in the reference data collection.
@@ -236,8 +543,6 @@ void PerfEvaluator::evalED116RPA(const TrackCollectionSet &s)
                     continue;
                 }
 
-                Aerodrome::NamedArea narea = sub_trk_ref.begin()->narea_;
-
                 // Iterate through each track in the test data collection.
                 for (const Track &trk_tst : col_tst)
                 {
@@ -246,31 +551,8 @@ void PerfEvaluator::evalED116RPA(const TrackCollectionSet &s)
                         continue;
                     }
 
-                    // Local copy of the TST track.
-                    Track t_t = trk_tst;
-
-                    // Local copy of the REF sub-track.
-                    // Only keep target reports with MOPS version 2 and PIC above the
-                    // 95th percentile threshold.
-                    Track t_r = filterTrackByQuality(sub_trk_ref, 2, pic_p95_);
-
-                    if (t_r.isEmpty())
-                    {
-                        continue;
-                    }
-
-                    // Resample the REF sub-track at the times of the TST track.
-                    t_r = resample(t_r, t_t.timestamps());
-
-                    // Calculate Euclidean distance between TST-REF pairs.
-                    QVector<QPair<TargetReport, double>> dists = euclideanDistance(t_r.rdata(), t_t.rdata());
-
-                    for (const QPair<TargetReport, double> &p : dists)
-                    {
-                        Aerodrome::NamedArea narea = p.first.narea_;
-                        double dist = p.second;
-                        smrRpaErrors_[narea] << dist;
-                    }
+                    evalRpaErrors(trk_ref, sub_trk_ref, trk_tst, trk_tst, SystemType::Smr,
+                        smrRpaErrors_, smrRpaErrorsByPic_);
                 }
             }
         }
@@ -279,6 +561,8 @@ void PerfEvaluator::evalED116RPA(const TrackCollectionSet &s)
 
 void PerfEvaluator::evalED116UR(const TrackCollectionSet &s)
 {
+    Profiler::ScopedTimer timer(Profiler::Stage::ED116UR);
+
     TrackCollection col_ref = s.refTrackCol();
 
     // Iterate through each track in the reference data collection.
@@ -310,6 +594,8 @@ void PerfEvaluator::evalED116UR(const TrackCollectionSet &s)
 
                 smrUr_[narea].n_etrp_ += n_etrp;
 
+                quint32 n_trp = 0;
+
                 // Iterate through each track in the test data collection.
                 for (const Track &trk_tst : col_tst)
                 {
@@ -329,7 +615,15 @@ void PerfEvaluator::evalED116UR(const TrackCollectionSet &s)
 
                     Track sub_trk_tst = sub_trk_tst_opt.value();
 
-                    smrUr_[narea].n_trp_ += sub_trk_tst.size();
+                    n_trp += sub_trk_tst.size();
+                }
+
+                smrUr_[narea].n_trp_ += n_trp;
+
+                if (dump_)
+                {
+                    dump_->addUrWindow(SystemType::Smr, narea, ref_tn, trk_ref.mode_s(),
+                        sub_trk_ref.beginTimestamp(), sub_trk_ref.endTimestamp(), n_trp, n_etrp);
                 }
             }
         }
@@ -353,6 +647,12 @@ void PerfEvaluator::evalED116UR(const TrackCollectionSet &s)
                 int n_etrp = qFloor(dur * freq);
 
                 smrUr_[narea].n_etrp_ += n_etrp;
+
+                if (dump_)
+                {
+                    dump_->addUrWindow(SystemType::Smr, narea, ref_tn, trk_ref.mode_s(),
+                        sub_trk_ref.beginTimestamp(), sub_trk_ref.endTimestamp(), 0, n_etrp);
+                }
             }
         }
     }
@@ -360,6 +660,8 @@ void PerfEvaluator::evalED116UR(const TrackCollectionSet &s)
 
 void PerfEvaluator::evalED116PD(const TrackCollectionSet &s)
 {
+    Profiler::ScopedTimer timer(Profiler::Stage::ED116PD);
+
     auto hasPosition = [](const TargetReport &tr) {
         return !qIsNaN(tr.x_) && !qIsNaN(tr.y_);
     };
@@ -427,6 +729,12 @@ void PerfEvaluator::evalED116PD(const TrackCollectionSet &s)
 
                 smrPd_[narea].n_trp_ += ctr.valid_;
                 smrPd_[narea].n_up_ += ctr.total_;
+
+                if (dump_)
+                {
+                    dump_->addPdWindow(SystemType::Smr, narea, ref_tn, trk_ref.mode_s(),
+                        sub_trk_ref.beginTimestamp(), sub_trk_ref.endTimestamp(), ctr.valid_, ctr.total_);
+                }
             }
         }
         else
@@ -454,6 +762,12 @@ void PerfEvaluator::evalED116PD(const TrackCollectionSet &s)
 
                 smrPd_[narea].n_trp_ += ctr.valid_;
                 smrPd_[narea].n_up_ += ctr.total_;
+
+                if (dump_)
+                {
+                    dump_->addPdWindow(SystemType::Smr, narea, ref_tn, trk_ref.mode_s(),
+                        sub_trk_ref.beginTimestamp(), sub_trk_ref.endTimestamp(), ctr.valid_, ctr.total_);
+                }
             }
         }
     }
@@ -461,8 +775,9 @@ void PerfEvaluator::evalED116PD(const TrackCollectionSet &s)
 
 void PerfEvaluator::evalED116PFD(const TrackCollectionSet &s)
 {
+    Profiler::ScopedTimer timer(Profiler::Stage::ED116PFD);
+
     TrackCollection col_ref = s.refTrackCol();
-    double freq = 1.0;
 
     // Iterate through each track in the reference data collection.
     for (const Track &trk_ref : col_ref)
@@ -487,15 +802,10 @@ void PerfEvaluator::evalED116PFD(const TrackCollectionSet &s)
 
                 Aerodrome::NamedArea narea = sub_trk_ref.begin()->narea_;
 
-                // Note to avoid confusion:
-                // Beware that, unlike the actual target reports count, here
-                // we are overwriting the updates count and expected target
-                // reports count with updated values from the traffic periods
-                // counter after each track insertion, so no data is being
-                // duplicated.
-                trafficPeriods_[narea] << sub_trk_ref;
-                smrPfd_[narea].n_u_ = trafficPeriods_[narea].expectedUpdates(freq);
-                smrPfd_[narea].n_etr_ = trafficPeriods_[narea].expectedTgtReps(freq);
+                // The updates count and expected target reports count are
+                // derived from the traffic periods once all the reference
+                // sub-tracks have been collected (see finishED116PFD()).
+                trafficPeriodBuilders_[narea] << sub_trk_ref;
 
                 // Iterate through each track in the test data collection.
                 for (const Track &trk_tst : col_tst)
@@ -531,22 +841,35 @@ void PerfEvaluator::evalED116PFD(const TrackCollectionSet &s)
 
                 Aerodrome::NamedArea narea = sub_trk_ref.begin()->narea_;
 
-                // Note to avoid confusion:
-                // Beware that, unlike the actual target reports count, here
-                // we are overwriting the updates count and expected target
-                // reports count with updated values from the traffic periods
-                // counter after each track insertion, so no data is being
-                // duplicated.
-                trafficPeriods_[narea] << sub_trk_ref;
-                smrPfd_[narea].n_u_ = trafficPeriods_[narea].expectedUpdates(freq);
-                smrPfd_[narea].n_etr_ = trafficPeriods_[narea].expectedTgtReps(freq);
+                // The updates count and expected target reports count are
+                // derived from the traffic periods once all the reference
+                // sub-tracks have been collected (see finishED116PFD()).
+                trafficPeriodBuilders_[narea] << sub_trk_ref;
             }
         }
     }
 }
 
+void PerfEvaluator::finishED116PFD()
+{
+    double freq = 1.0;
+
+    for (auto it = trafficPeriodBuilders_.constBegin(); it != trafficPeriodBuilders_.constEnd(); ++it)
+    {
+        const Aerodrome::NamedArea &narea = it.key();
+
+        trafficPeriods_[narea] = it.value().build();
+        smrPfd_[narea].n_u_ = trafficPeriods_[narea].expectedUpdates(freq);
+        smrPfd_[narea].n_etr_ = trafficPeriods_[narea].expectedTgtReps(freq);
+    }
+
+    trafficPeriodBuilders_.clear();
+}
+
 void PerfEvaluator::evalED117RPA(const TrackCollectionSet &s)
 {
+    Profiler::ScopedTimer timer(Profiler::Stage::ED117RPA);
+
     TrackCollection col_ref = s.refTrackCol();
 
     // Iterate through each track in the reference data collection.
@@ -580,37 +903,11 @@ void PerfEvaluator::evalED117RPA(const TrackCollectionSet &s)
                         continue;
                     }
 
-                    // Local copy of the TST track.
-                    Track t_t = trk_tst;
-
-                    // Local copy of the REF sub-track.
-                    // Only keep target reports with MOPS version 2 and PIC above the
-                    // 95th percentile threshold.
-                    Track t_r = filterTrackByQuality(sub_trk_ref, 2, pic_p95_);
-
-                    if (t_r.isEmpty())
-                    {
-                        continue;
-                    }
-
-                    // Resample the REF sub-track at the times of the TST track.
-                    t_r = resample(t_r, t_t.timestamps());
-
                     // On Stand, average TST track positions over a period of 5 s.
-                    if (narea.area_ == Aerodrome::Stand)
-                    {
-                        t_t = average(t_t, 5.0);
-                    }
-
-                    // Calculate Euclidean distance between TST-REF pairs.
-                    QVector<QPair<TargetReport, double>> dists = euclideanDistance(t_r.rdata(), t_t.rdata());
+                    const Track t_t = narea.area_ == Aerodrome::Stand ? average(trk_tst, 5.0) : trk_tst;
 
-                    for (const QPair<TargetReport, double> &p : dists)
-                    {
-                        Aerodrome::NamedArea narea = p.first.narea_;
-                        double dist = p.second;
-                        mlatRpaErrors_[narea] << dist;
-                    }
+                    evalRpaErrors(trk_ref, sub_trk_ref, trk_tst, t_t, SystemType::Mlat,
+                        mlatRpaErrors_, mlatRpaErrorsByPic_);
                 }
             }
         }
@@ -619,6 +916,8 @@ void PerfEvaluator::evalED117RPA(const TrackCollectionSet &s)
 
 void PerfEvaluator::evalED117UR(const TrackCollectionSet &s)
 {
+    Profiler::ScopedTimer timer(Profiler::Stage::ED117UR);
+
     TrackCollection col_ref = s.refTrackCol();
 
     // Iterate through each track in the reference data collection.
@@ -650,6 +949,8 @@ void PerfEvaluator::evalED117UR(const TrackCollectionSet &s)
 
                 mlatUr_[narea].n_etrp_ += n_etrp;
 
+                quint32 n_trp = 0;
+
                 // Iterate through each track in the test data collection.
                 for (const Track &trk_tst : col_tst)
                 {
@@ -669,7 +970,15 @@ void PerfEvaluator::evalED117UR(const TrackCollectionSet &s)
 
                     Track sub_trk_tst = sub_trk_tst_opt.value();
 
-                    mlatUr_[narea].n_trp_ += sub_trk_tst.size();
+                    n_trp += sub_trk_tst.size();
+                }
+
+                mlatUr_[narea].n_trp_ += n_trp;
+
+                if (dump_)
+                {
+                    dump_->addUrWindow(SystemType::Mlat, narea, ref_tn, trk_ref.mode_s(),
+                        sub_trk_ref.beginTimestamp(), sub_trk_ref.endTimestamp(), n_trp, n_etrp);
                 }
             }
         }
@@ -693,6 +1002,12 @@ void PerfEvaluator::evalED117UR(const TrackCollectionSet &s)
                 int n_etrp = qFloor(dur * freq);
 
                 mlatUr_[narea].n_etrp_ += n_etrp;
+
+                if (dump_)
+                {
+                    dump_->addUrWindow(SystemType::Mlat, narea, ref_tn, trk_ref.mode_s(),
+                        sub_trk_ref.beginTimestamp(), sub_trk_ref.endTimestamp(), 0, n_etrp);
+                }
             }
         }
     }
@@ -700,6 +1015,8 @@ void PerfEvaluator::evalED117UR(const TrackCollectionSet &s)
 
 void PerfEvaluator::evalED117PD(const TrackCollectionSet &s)
 {
+    Profiler::ScopedTimer timer(Profiler::Stage::ED117PD);
+
     auto hasPosition = [](const TargetReport &tr) {
         return !qIsNaN(tr.x_) && !qIsNaN(tr.y_);
     };
@@ -797,6 +1114,12 @@ void PerfEvaluator::evalED117PD(const TrackCollectionSet &s)
 
                 mlatPd_[narea].n_trp_ += ctr.valid_;
                 mlatPd_[narea].n_up_ += ctr.total_;
+
+                if (dump_)
+                {
+                    dump_->addPdWindow(SystemType::Mlat, narea, ref_tn, trk_ref.mode_s(),
+                        sub_trk_ref.beginTimestamp(), sub_trk_ref.endTimestamp(), ctr.valid_, ctr.total_);
+                }
             }
         }
         else
@@ -825,6 +1148,12 @@ void PerfEvaluator::evalED117PD(const TrackCollectionSet &s)
 
                 mlatPd_[narea].n_trp_ += ctr.valid_;
                 mlatPd_[narea].n_up_ += ctr.total_;
+
+                if (dump_)
+                {
+                    dump_->addPdWindow(SystemType::Mlat, narea, ref_tn, trk_ref.mode_s(),
+                        sub_trk_ref.beginTimestamp(), sub_trk_ref.endTimestamp(), ctr.valid_, ctr.total_);
+                }
             }
         }
     }
@@ -832,6 +1161,8 @@ void PerfEvaluator::evalED117PD(const TrackCollectionSet &s)
 
 void PerfEvaluator::evalED117PFD(const TrackCollectionSet &s)
 {
+    Profiler::ScopedTimer timer(Profiler::Stage::ED117PFD);
+
     TrackCollection col_ref = s.refTrackCol();
 
     // Iterate through each track in the reference data collection.
@@ -891,6 +1222,8 @@ void PerfEvaluator::evalED117PFD(const TrackCollectionSet &s)
 
 void PerfEvaluator::evalED117PID(const TrackCollectionSet &s)
 {
+    Profiler::ScopedTimer timer(Profiler::Stage::ED117PID);
+
     TrackCollection col_ref = s.refTrackCol();
 
     // Iterate through each track in the reference data collection.
@@ -1050,6 +1383,8 @@ void PerfEvaluator::evalED117PID(const TrackCollectionSet &s)
 
 void PerfEvaluator::evalED117PFID(const TrackCollectionSet &s)
 {
+    Profiler::ScopedTimer timer(Profiler::Stage::ED117PFID);
+
     TrackCollection col_ref = s.refTrackCol();
 
     // Iterate through each track in the reference data collection.
@@ -1209,6 +1544,8 @@ void PerfEvaluator::evalED117PFID(const TrackCollectionSet &s)
 
 void PerfEvaluator::evalED117PLG(const TrackCollectionSet &s)
 {
+    Profiler::ScopedTimer timer(Profiler::Stage::ED117PLG);
+
     TrackCollection col_ref = s.refTrackCol();
 
     // Iterate through each track in the reference data collection.
@@ -1292,1712 +1629,215 @@ void PerfEvaluator::evalED117PLG(const TrackCollectionSet &s)
     }
 }
 
-void PerfEvaluator::printED116RPA() const
+namespace
 {
-    QMetaEnum e = QMetaEnum::fromType<Aerodrome::Area>();
+/*!
+ * \brief Percentage given by \a num / \a den, capped at 100 %.
+ */
+PerfResults::Stats ratioStats(quint32 num, quint32 den, quint32 n)
+{
+    double ratio = num / static_cast<double>(den);
+    if (ratio > 1)
+    {
+        ratio = 1;
+    }
 
-    QTextStream out(stdout);
-    out.setRealNumberPrecision(2);
-    out.setRealNumberNotation(QTextStream::FixedNotation);
-
-    out << Qt::endl;
-
-    out.setFieldAlignment(QTextStream::AlignCenter);
-    out.setPadChar(QLatin1Char('-'));
-    out << qSetFieldWidth(56) << "[ ED-116 RPA ]" << qSetFieldWidth(0) << Qt::endl;
-    out.setPadChar(QLatin1Char(' '));
-
-    out << qSetFieldWidth(15) << "AREA" << qSetFieldWidth(1) << ""
-        << qSetFieldWidth(7) << "P95 [m]" << qSetFieldWidth(1) << ""
-        << qSetFieldWidth(7) << "P99 [m]" << qSetFieldWidth(1) << ""
-        << qSetFieldWidth(8) << "Mean [m]" << qSetFieldWidth(1) << ""
-        << qSetFieldWidth(8) << "SDev [m]" << qSetFieldWidth(1) << ""
-        << qSetFieldWidth(6) << "N"
-        << qSetFieldWidth(0) << Qt::endl;
-
-    out.setFieldAlignment(QTextStream::AlignRight);
-
-    out << qSetFieldWidth(15) << "---------------" << qSetFieldWidth(1) << ""
-        << qSetFieldWidth(7) << "-------" << qSetFieldWidth(1) << ""
-        << qSetFieldWidth(7) << "-------" << qSetFieldWidth(1) << ""
-        << qSetFieldWidth(8) << "--------" << qSetFieldWidth(1) << ""
-        << qSetFieldWidth(8) << "--------" << qSetFieldWidth(1) << ""
-        << qSetFieldWidth(6) << "------"
-        << qSetFieldWidth(0) << Qt::endl;
-
-    QVector<Aerodrome::Area> areas;
-    areas << Aerodrome::Area::Manoeuvering;
-
-    auto printStats = [&out](AreaHash<QVector<double>>::const_iterator it, const QVector<double> &errors) {
-        out << qSetFieldWidth(15) << Qt::left << it.key().fullName() << qSetFieldWidth(1) << ""
-            << qSetFieldWidth(7) << Qt::right << percentile(errors, 95) << qSetFieldWidth(1) << ""
-            << qSetFieldWidth(7) << Qt::right << percentile(errors, 99) << qSetFieldWidth(1) << ""
-            << qSetFieldWidth(8) << Qt::right << mean(errors) << qSetFieldWidth(1) << ""
-            << qSetFieldWidth(8) << Qt::right << stdDev(errors) << qSetFieldWidth(1) << ""
-            << qSetFieldWidth(6) << Qt::right << errors.size()
-            << qSetFieldWidth(0) << Qt::endl;
-    };
+    PerfResults::Stats stats;
+    stats.percent = ratio * 100.0;
+    stats.n = n;
+
+    return stats;
+}
+
+/*!
+ * \brief Summarizes the sub-areas of each of the given \a areas and their
+ * total, which is obtained by adding each sub-area to a copy of \a init.
+ */
+template <typename T, typename Total, typename Add, typename Summarize>
+QVector<PerfResults::AreaResult> areaResults(const QVector<Aerodrome::Area> &areas, const AreaHash<T> &hash,
+    const Total &init, Add add, Summarize summarize)
+{
+    QMetaEnum e = QMetaEnum::fromType<Aerodrome::Area>();
 
-    for (const Aerodrome::Area area : qAsConst(areas))
+    QVector<PerfResults::AreaResult> results;
+    for (const Aerodrome::Area area : areas)
     {
-        const auto subAreas = smrRpaErrors_.findByArea(area);
+        PerfResults::AreaResult result;
+        result.name = QLatin1String(e.valueToKey(area));
 
-        QVector<double> errorsTotal;
-        for (const auto &it : subAreas)
-        {
-            QVector<double> errors = it.value();
-            errorsTotal.append(errors);
+        // Sub-areas sorted by name, so that the output does not depend on
+        // the hash order.
+        auto subAreas = hash.findByArea(area);
+        std::sort(subAreas.begin(), subAreas.end(), [](const auto &lhs, const auto &rhs) {
+            return lhs.key().fullName() < rhs.key().fullName();
+        });
 
-            printStats(it, errors);
+        Total total = init;
+        for (const auto &it : qAsConst(subAreas))
+        {
+            add(total, it);
+            result.subAreas << qMakePair(it.key().fullName(), summarize(it.value()));
         }
 
-        out << qSetFieldWidth(15) << Qt::left << e.valueToKey(area) << qSetFieldWidth(1) << ""
-            << qSetFieldWidth(7) << Qt::right << percentile(errorsTotal, 95) << qSetFieldWidth(1) << ""
-            << qSetFieldWidth(7) << Qt::right << percentile(errorsTotal, 99) << qSetFieldWidth(1) << ""
-            << qSetFieldWidth(8) << Qt::right << mean(errorsTotal) << qSetFieldWidth(1) << ""
-            << qSetFieldWidth(8) << Qt::right << stdDev(errorsTotal) << qSetFieldWidth(1) << ""
-            << qSetFieldWidth(6) << Qt::right << errorsTotal.size()
-            << qSetFieldWidth(0) << Qt::endl;
-
-        out << Qt::endl;
+        result.total = summarize(total);
+        results << result;
     }
+
+    return results;
 }
+}  // namespace
 
-void PerfEvaluator::printED116UR() const
+/*!
+ * \brief Computes the final figures of every metric from the evaluation
+ * counters. Group totals are obtained by merging the counters of the
+ * sub-areas of each area.
+ */
+PerfResults PerfEvaluator::computeResults() const
 {
-    QMetaEnum e = QMetaEnum::fromType<Aerodrome::Area>();
-
-    QTextStream out(stdout);
-    out.setRealNumberPrecision(2);
-    out.setRealNumberNotation(QTextStream::FixedNotation);
+    using Kind = PerfResults::Kind;
+    using Metric = PerfResults::Metric;
 
-    out << Qt::endl;
+    const QVector<Aerodrome::Area> smrAreas = {Aerodrome::Area::Manoeuvering};
+    const QVector<Aerodrome::Area> mlatAreas = {Aerodrome::Area::Movement, Aerodrome::Area::Airborne};
 
-    out.setFieldAlignment(QTextStream::AlignCenter);
-    out.setPadChar(QLatin1Char('-'));
-    out << qSetFieldWidth(30) << "[ ED-116 UR ]" << qSetFieldWidth(0) << Qt::endl;
-    out.setPadChar(QLatin1Char(' '));
+    // RPA.
+    auto addErrors = [](ErrorAccumulator &total, AreaHash<ErrorAccumulator>::const_iterator it) {
+        total += it.value();
+    };
 
-    out << qSetFieldWidth(15) << "AREA" << qSetFieldWidth(1) << ""
-        << qSetFieldWidth(7) << "UR [%]" << qSetFieldWidth(1) << ""
-        << qSetFieldWidth(6) << "N"
-        << qSetFieldWidth(0) << Qt::endl;
+    auto rpaStats = [](const ErrorAccumulator &errors) {
+        PerfResults::Stats stats;
+        const QVector<double> p = errors.percentiles({95, 99});
+        stats.p95 = p.at(0);
+        stats.p99 = p.at(1);
+        stats.mean = errors.mean();
+        stats.stdDev = errors.stdDev();
+        stats.n = errors.count();
 
-    out.setFieldAlignment(QTextStream::AlignRight);
+        return stats;
+    };
 
-    out << qSetFieldWidth(15) << "---------------" << qSetFieldWidth(1) << ""
-        << qSetFieldWidth(7) << "-------" << qSetFieldWidth(1) << ""
-        << qSetFieldWidth(6) << "------"
-        << qSetFieldWidth(0) << Qt::endl;
+    // UR.
+    auto addUr = [](Counters::UrCounter &total, AreaHash<Counters::UrCounter>::const_iterator it) {
+        total.n_trp_ += it.value().n_trp_;
+        total.n_etrp_ += it.value().n_etrp_;
+    };
 
-    QVector<Aerodrome::Area> areas;
-    areas << Aerodrome::Area::Manoeuvering;
+    auto urStats = [](const Counters::UrCounter &ctr) {
+        return ratioStats(ctr.n_trp_, ctr.n_etrp_, ctr.n_trp_);
+    };
 
-    auto printStats = [&out](AreaHash<Counters::UrCounter>::const_iterator it, Counters::UrCounter ctr) {
-        double ur = ctr.n_trp_ / static_cast<double>(ctr.n_etrp_);
-        if (ur > 1)
-        {
-            ur = 1;
-        }
+    // PD.
+    auto addPd = [](Counters::PdCounter &total, AreaHash<Counters::PdCounter>::const_iterator it) {
+        total.n_trp_ += it.value().n_trp_;
+        total.n_up_ += it.value().n_up_;
+    };
 
-        out << qSetFieldWidth(15) << Qt::left << it.key().fullName() << qSetFieldWidth(1) << ""
-            << qSetFieldWidth(7) << Qt::right << ur * 100.0 << qSetFieldWidth(1) << ""
-            << qSetFieldWidth(6) << Qt::right << ctr.n_trp_
-            << qSetFieldWidth(0) << Qt::endl;
+    auto pdStats = [](const Counters::PdCounter &ctr) {
+        return ratioStats(ctr.n_trp_, ctr.n_up_, ctr.n_trp_);
     };
 
-    for (const Aerodrome::Area area : qAsConst(areas))
+    // ED-116 PFD. The expected figures of an area are those of the union
+    // of the traffic periods of its sub-areas.
+    struct PfdTotal : Counters::PfdCounter2
     {
-        const auto subAreas = smrUr_.findByArea(area);
+        TrafficPeriodCollection tpcol_;
+    };
 
-        Counters::UrCounter ctrTotal;
-        for (const auto &it : subAreas)
-        {
-            Counters::UrCounter ctr = it.value();
-            ctrTotal.n_trp_ += ctr.n_trp_;
-            ctrTotal.n_etrp_ += ctr.n_etrp_;
+    auto addPfd2 = [this](PfdTotal &total, AreaHash<Counters::PfdCounter2>::const_iterator it) {
+        total.tpcol_ << trafficPeriods_[it.key()];
+        total.n_tr_ += it.value().n_tr_;
+        total.n_etr_ = total.tpcol_.expectedTgtReps(1.0);
+        total.n_u_ = total.tpcol_.expectedUpdates(1.0);
+    };
 
-            printStats(it, ctr);
+    auto pfd2Stats = [](const Counters::PfdCounter2 &ctr) {
+        double pfd = (static_cast<double>(ctr.n_tr_) - static_cast<double>(ctr.n_etr_)) / static_cast<double>(ctr.n_u_);
+        if (pfd < 0)
+        {
+            pfd = 0;
         }
 
-        double ur = ctrTotal.n_trp_ / static_cast<double>(ctrTotal.n_etrp_);
-        if (ur > 1)
-        {
-            ur = 1;
-        }
-
-        out << qSetFieldWidth(15) << Qt::left << e.valueToKey(area) << qSetFieldWidth(1) << ""
-            << qSetFieldWidth(7) << Qt::right << ur * 100.0 << qSetFieldWidth(1) << ""
-            << qSetFieldWidth(6) << Qt::right << ctrTotal.n_trp_
-            << qSetFieldWidth(0) << Qt::endl;
-
-        out << Qt::endl;
-    }
-}
-
-void PerfEvaluator::printED116PD() const
-{
-    QMetaEnum e = QMetaEnum::fromType<Aerodrome::Area>();
-
-    QTextStream out(stdout);
-    out.setRealNumberPrecision(2);
-    out.setRealNumberNotation(QTextStream::FixedNotation);
-
-    out << Qt::endl;
-
-    out.setFieldAlignment(QTextStream::AlignCenter);
-    out.setPadChar(QLatin1Char('-'));
-    out << qSetFieldWidth(30) << "[ ED-116 PD ]" << qSetFieldWidth(0) << Qt::endl;
-    out.setPadChar(QLatin1Char(' '));
-
-    out << qSetFieldWidth(15) << "AREA" << qSetFieldWidth(1) << ""
-        << qSetFieldWidth(7) << "PD [%]" << qSetFieldWidth(1) << ""
-        << qSetFieldWidth(6) << "N"
-        << qSetFieldWidth(0) << Qt::endl;
-
-    out.setFieldAlignment(QTextStream::AlignRight);
-
-    out << qSetFieldWidth(15) << "---------------" << qSetFieldWidth(1) << ""
-        << qSetFieldWidth(7) << "-------" << qSetFieldWidth(1) << ""
-        << qSetFieldWidth(6) << "------"
-        << qSetFieldWidth(0) << Qt::endl;
-
-    QVector<Aerodrome::Area> areas;
-    areas << Aerodrome::Area::Manoeuvering;
-
-    auto printStats = [&out](AreaHash<Counters::PdCounter>::const_iterator it, Counters::PdCounter ctr) {
-        double pd = ctr.n_trp_ / static_cast<double>(ctr.n_up_);
-        if (pd > 1)
-        {
-            pd = 1;
-        }
-
-        out << qSetFieldWidth(15) << Qt::left << it.key().fullName() << qSetFieldWidth(1) << ""
-            << qSetFieldWidth(7) << Qt::right << pd * 100.0 << qSetFieldWidth(1) << ""
-            << qSetFieldWidth(6) << Qt::right << ctr.n_trp_
-            << qSetFieldWidth(0) << Qt::endl;
-    };
-
-    for (const Aerodrome::Area area : qAsConst(areas))
-    {
-        const auto subAreas = smrPd_.findByArea(area);
-
-        Counters::PdCounter ctrTotal;
-        for (const auto &it : subAreas)
-        {
-            Counters::PdCounter ctr = it.value();
-            ctrTotal.n_trp_ += ctr.n_trp_;
-            ctrTotal.n_up_ += ctr.n_up_;
-
-            printStats(it, ctr);
-        }
-
-        double pd = ctrTotal.n_trp_ / static_cast<double>(ctrTotal.n_up_);
-        if (pd > 1)
-        {
-            pd = 1;
-        }
-
-        out << qSetFieldWidth(15) << Qt::left << e.valueToKey(area) << qSetFieldWidth(1) << ""
-            << qSetFieldWidth(7) << Qt::right << pd * 100.0 << qSetFieldWidth(1) << ""
-            << qSetFieldWidth(6) << Qt::right << ctrTotal.n_trp_
-            << qSetFieldWidth(0) << Qt::endl;
-
-        out << Qt::endl;
-    }
-}
-
-void PerfEvaluator::printED116PFD() const
-{
-    QMetaEnum e = QMetaEnum::fromType<Aerodrome::Area>();
-
-    QTextStream out(stdout);
-    out.setRealNumberPrecision(2);
-    out.setRealNumberNotation(QTextStream::FixedNotation);
-
-    out << Qt::endl;
-
-    out.setFieldAlignment(QTextStream::AlignCenter);
-    out.setPadChar(QLatin1Char('-'));
-    out << qSetFieldWidth(30) << "[ ED-116 PFD ]" << qSetFieldWidth(0) << Qt::endl;
-    out.setPadChar(QLatin1Char(' '));
-
-    out << qSetFieldWidth(15) << "AREA" << qSetFieldWidth(1) << ""
-        << qSetFieldWidth(7) << "PFD [%]" << qSetFieldWidth(1) << ""
-        << qSetFieldWidth(6) << "N"
-        << qSetFieldWidth(0) << Qt::endl;
-
-    out.setFieldAlignment(QTextStream::AlignRight);
-
-    out << qSetFieldWidth(15) << "---------------" << qSetFieldWidth(1) << ""
-        << qSetFieldWidth(7) << "-------" << qSetFieldWidth(1) << ""
-        << qSetFieldWidth(6) << "------"
-        << qSetFieldWidth(0) << Qt::endl;
-
-    QVector<Aerodrome::Area> areas;
-    areas << Aerodrome::Area::Manoeuvering;
-
-    auto printStats = [&out](AreaHash<Counters::PfdCounter2>::const_iterator it, Counters::PfdCounter2 ctr) {
-        double pfd = (static_cast<double>(ctr.n_tr_) - static_cast<double>(ctr.n_etr_)) / static_cast<double>(ctr.n_u_);
-        if (pfd < 0)
-        {
-            pfd = 0;
-        }
-
-        out << qSetFieldWidth(15) << Qt::left << it.key().fullName() << qSetFieldWidth(1) << ""
-            << qSetFieldWidth(7) << Qt::right << pfd * 100.0 << qSetFieldWidth(1) << ""
-            << qSetFieldWidth(6) << Qt::right << ctr.n_tr_
-            << qSetFieldWidth(0) << Qt::endl;
-    };
-
-    for (const Aerodrome::Area area : qAsConst(areas))
-    {
-        const auto subAreas = smrPfd_.findByArea(area);
-
-        TrafficPeriodCollection tpcolTotal;
-        Counters::PfdCounter2 ctrTotal;
-        for (const auto &it : subAreas)
-        {
-            Aerodrome::NamedArea narea = it.key();
-            tpcolTotal << trafficPeriods_[narea];
-
-            Counters::PfdCounter2 ctr = it.value();
-            ctrTotal.n_tr_ += ctr.n_tr_;
-            ctrTotal.n_etr_ = tpcolTotal.expectedTgtReps(1.0);
-            ctrTotal.n_u_ = tpcolTotal.expectedUpdates(1.0);
-
-            printStats(it, ctr);
-        }
-
-        double pfd = (static_cast<double>(ctrTotal.n_tr_) - static_cast<double>(ctrTotal.n_etr_)) / static_cast<double>(ctrTotal.n_u_);
-        if (pfd < 0)
-        {
-            pfd = 0;
-        }
-
-        out << qSetFieldWidth(15) << Qt::left << e.valueToKey(area) << qSetFieldWidth(1) << ""
-            << qSetFieldWidth(7) << Qt::right << pfd * 100.0 << qSetFieldWidth(1) << ""
-            << qSetFieldWidth(6) << Qt::right << ctrTotal.n_tr_
-            << qSetFieldWidth(0) << Qt::endl;
-
-        out << Qt::endl;
-    }
-}
-
-void PerfEvaluator::printED117RPA() const
-{
-    QMetaEnum e = QMetaEnum::fromType<Aerodrome::Area>();
-
-    QTextStream out(stdout);
-    out.setRealNumberPrecision(2);
-    out.setRealNumberNotation(QTextStream::FixedNotation);
-
-    out << Qt::endl;
-
-    out.setFieldAlignment(QTextStream::AlignCenter);
-    out.setPadChar(QLatin1Char('-'));
-    out << qSetFieldWidth(56) << "[ ED-117 RPA ]" << qSetFieldWidth(0) << Qt::endl;
-    out.setPadChar(QLatin1Char(' '));
-
-    out << qSetFieldWidth(15) << "AREA" << qSetFieldWidth(1) << ""
-        << qSetFieldWidth(7) << "P95 [m]" << qSetFieldWidth(1) << ""
-        << qSetFieldWidth(7) << "P99 [m]" << qSetFieldWidth(1) << ""
-        << qSetFieldWidth(8) << "Mean [m]" << qSetFieldWidth(1) << ""
-        << qSetFieldWidth(8) << "SDev [m]" << qSetFieldWidth(1) << ""
-        << qSetFieldWidth(6) << "N"
-        << qSetFieldWidth(0) << Qt::endl;
-
-    out.setFieldAlignment(QTextStream::AlignRight);
-
-    out << qSetFieldWidth(15) << "---------------" << qSetFieldWidth(1) << ""
-        << qSetFieldWidth(7) << "-------" << qSetFieldWidth(1) << ""
-        << qSetFieldWidth(7) << "-------" << qSetFieldWidth(1) << ""
-        << qSetFieldWidth(8) << "--------" << qSetFieldWidth(1) << ""
-        << qSetFieldWidth(8) << "--------" << qSetFieldWidth(1) << ""
-        << qSetFieldWidth(6) << "------"
-        << qSetFieldWidth(0) << Qt::endl;
-
-    QVector<Aerodrome::Area> areas;
-    areas << Aerodrome::Area::Movement << Aerodrome::Area::Airborne;
-
-    auto printStats = [&out](AreaHash<QVector<double>>::const_iterator it, const QVector<double> &errors) {
-        out << qSetFieldWidth(15) << Qt::left << it.key().fullName() << qSetFieldWidth(1) << ""
-            << qSetFieldWidth(7) << Qt::right << percentile(errors, 95) << qSetFieldWidth(1) << ""
-            << qSetFieldWidth(7) << Qt::right << percentile(errors, 99) << qSetFieldWidth(1) << ""
-            << qSetFieldWidth(8) << Qt::right << mean(errors) << qSetFieldWidth(1) << ""
-            << qSetFieldWidth(8) << Qt::right << stdDev(errors) << qSetFieldWidth(1) << ""
-            << qSetFieldWidth(6) << Qt::right << errors.size()
-            << qSetFieldWidth(0) << Qt::endl;
-    };
-
-    for (const Aerodrome::Area area : qAsConst(areas))
-    {
-        const auto subAreas = mlatRpaErrors_.findByArea(area);
-
-        QVector<double> errorsTotal;
-        for (const auto &it : subAreas)
-        {
-            QVector<double> errors = it.value();
-            errorsTotal.append(errors);
-
-            printStats(it, errors);
-        }
-
-        out << qSetFieldWidth(15) << Qt::left << e.valueToKey(area) << qSetFieldWidth(1) << ""
-            << qSetFieldWidth(7) << Qt::right << percentile(errorsTotal, 95) << qSetFieldWidth(1) << ""
-            << qSetFieldWidth(7) << Qt::right << percentile(errorsTotal, 99) << qSetFieldWidth(1) << ""
-            << qSetFieldWidth(8) << Qt::right << mean(errorsTotal) << qSetFieldWidth(1) << ""
-            << qSetFieldWidth(8) << Qt::right << stdDev(errorsTotal) << qSetFieldWidth(1) << ""
-            << qSetFieldWidth(6) << Qt::right << errorsTotal.size()
-            << qSetFieldWidth(0) << Qt::endl;
-
-        out << Qt::endl;
-    }
-}
-
-void PerfEvaluator::printED117UR() const
-{
-    QMetaEnum e = QMetaEnum::fromType<Aerodrome::Area>();
-
-    QTextStream out(stdout);
-    out.setRealNumberPrecision(2);
-    out.setRealNumberNotation(QTextStream::FixedNotation);
-
-    out << Qt::endl;
-
-    out.setFieldAlignment(QTextStream::AlignCenter);
-    out.setPadChar(QLatin1Char('-'));
-    out << qSetFieldWidth(30) << "[ ED-117 UR ]" << qSetFieldWidth(0) << Qt::endl;
-    out.setPadChar(QLatin1Char(' '));
-
-    out << qSetFieldWidth(15) << "AREA" << qSetFieldWidth(1) << ""
-        << qSetFieldWidth(7) << "UR [%]" << qSetFieldWidth(1) << ""
-        << qSetFieldWidth(6) << "N"
-        << qSetFieldWidth(0) << Qt::endl;
-
-    out.setFieldAlignment(QTextStream::AlignRight);
-
-    out << qSetFieldWidth(15) << "---------------" << qSetFieldWidth(1) << ""
-        << qSetFieldWidth(7) << "-------" << qSetFieldWidth(1) << ""
-        << qSetFieldWidth(6) << "------"
-        << qSetFieldWidth(0) << Qt::endl;
-
-    QVector<Aerodrome::Area> areas;
-    areas << Aerodrome::Area::Movement << Aerodrome::Area::Airborne;
-
-    auto printStats = [&out](AreaHash<Counters::UrCounter>::const_iterator it, Counters::UrCounter ctr) {
-        double ur = ctr.n_trp_ / static_cast<double>(ctr.n_etrp_);
-        if (ur > 1)
-        {
-            ur = 1;
-        }
-
-        out << qSetFieldWidth(15) << Qt::left << it.key().fullName() << qSetFieldWidth(1) << ""
-            << qSetFieldWidth(7) << Qt::right << ur * 100.0 << qSetFieldWidth(1) << ""
-            << qSetFieldWidth(6) << Qt::right << ctr.n_trp_
-            << qSetFieldWidth(0) << Qt::endl;
-    };
-
-    for (const Aerodrome::Area area : qAsConst(areas))
-    {
-        const auto subAreas = mlatUr_.findByArea(area);
-
-        Counters::UrCounter ctrTotal;
-        for (const auto &it : subAreas)
-        {
-            Counters::UrCounter ctr = it.value();
-            ctrTotal.n_trp_ += ctr.n_trp_;
-            ctrTotal.n_etrp_ += ctr.n_etrp_;
-
-            printStats(it, ctr);
-        }
-
-        double ur = ctrTotal.n_trp_ / static_cast<double>(ctrTotal.n_etrp_);
-        if (ur > 1)
-        {
-            ur = 1;
-        }
-
-        out << qSetFieldWidth(15) << Qt::left << e.valueToKey(area) << qSetFieldWidth(1) << ""
-            << qSetFieldWidth(7) << Qt::right << ur * 100.0 << qSetFieldWidth(1) << ""
-            << qSetFieldWidth(6) << Qt::right << ctrTotal.n_trp_
-            << qSetFieldWidth(0) << Qt::endl;
-
-        out << Qt::endl;
-    }
-}
-
-void PerfEvaluator::printED117PD() const
-{
-    QMetaEnum e = QMetaEnum::fromType<Aerodrome::Area>();
-
-    QTextStream out(stdout);
-    out.setRealNumberPrecision(2);
-    out.setRealNumberNotation(QTextStream::FixedNotation);
-
-    out << Qt::endl;
-
-    out.setFieldAlignment(QTextStream::AlignCenter);
-    out.setPadChar(QLatin1Char('-'));
-    out << qSetFieldWidth(30) << "[ ED-117 PD ]" << qSetFieldWidth(0) << Qt::endl;
-    out.setPadChar(QLatin1Char(' '));
-
-    out << qSetFieldWidth(15) << "AREA" << qSetFieldWidth(1) << ""
-        << qSetFieldWidth(7) << "PD [%]" << qSetFieldWidth(1) << ""
-        << qSetFieldWidth(6) << "N"
-        << qSetFieldWidth(0) << Qt::endl;
-
-    out.setFieldAlignment(QTextStream::AlignRight);
-
-    out << qSetFieldWidth(15) << "---------------" << qSetFieldWidth(1) << ""
-        << qSetFieldWidth(7) << "-------" << qSetFieldWidth(1) << ""
-        << qSetFieldWidth(6) << "------"
-        << qSetFieldWidth(0) << Qt::endl;
-
-    QVector<Aerodrome::Area> areas;
-    areas << Aerodrome::Area::Movement << Aerodrome::Area::Airborne;
-
-    auto printStats = [&out](AreaHash<Counters::PdCounter>::const_iterator it, Counters::PdCounter ctr) {
-        double pd = ctr.n_trp_ / static_cast<double>(ctr.n_up_);
-        if (pd > 1)
-        {
-            pd = 1;
-        }
-
-        out << qSetFieldWidth(15) << Qt::left << it.key().fullName() << qSetFieldWidth(1) << ""
-            << qSetFieldWidth(7) << Qt::right << pd * 100.0 << qSetFieldWidth(1) << ""
-            << qSetFieldWidth(6) << Qt::right << ctr.n_trp_
-            << qSetFieldWidth(0) << Qt::endl;
-    };
-
-    for (const Aerodrome::Area area : qAsConst(areas))
-    {
-        const auto subAreas = mlatPd_.findByArea(area);
-
-        Counters::PdCounter ctrTotal;
-        for (const auto &it : subAreas)
-        {
-            Counters::PdCounter ctr = it.value();
-            ctrTotal.n_trp_ += ctr.n_trp_;
-            ctrTotal.n_up_ += ctr.n_up_;
-
-            printStats(it, ctr);
-        }
-
-        double pd = ctrTotal.n_trp_ / static_cast<double>(ctrTotal.n_up_);
-        if (pd > 1)
-        {
-            pd = 1;
-        }
-
-        out << qSetFieldWidth(15) << Qt::left << e.valueToKey(area) << qSetFieldWidth(1) << ""
-            << qSetFieldWidth(7) << Qt::right << pd * 100.0 << qSetFieldWidth(1) << ""
-            << qSetFieldWidth(6) << Qt::right << ctrTotal.n_trp_
-            << qSetFieldWidth(0) << Qt::endl;
-
-        out << Qt::endl;
-    }
-}
-
-void PerfEvaluator::printED117PFD() const
-{
-    QMetaEnum e = QMetaEnum::fromType<Aerodrome::Area>();
-
-    QTextStream out(stdout);
-    out.setRealNumberPrecision(2);
-    out.setRealNumberNotation(QTextStream::FixedNotation);
-
-    out << Qt::endl;
-
-    out.setFieldAlignment(QTextStream::AlignCenter);
-    out.setPadChar(QLatin1Char('-'));
-    out << qSetFieldWidth(30) << "[ ED-117 PFD ]" << qSetFieldWidth(0) << Qt::endl;
-    out.setPadChar(QLatin1Char(' '));
-
-    out << qSetFieldWidth(15) << "AREA" << qSetFieldWidth(1) << ""
-        << qSetFieldWidth(7) << "PFD [%]" << qSetFieldWidth(1) << ""
-        << qSetFieldWidth(6) << "N"
-        << qSetFieldWidth(0) << Qt::endl;
-
-    out.setFieldAlignment(QTextStream::AlignRight);
-
-    out << qSetFieldWidth(15) << "---------------" << qSetFieldWidth(1) << ""
-        << qSetFieldWidth(7) << "-------" << qSetFieldWidth(1) << ""
-        << qSetFieldWidth(6) << "------"
-        << qSetFieldWidth(0) << Qt::endl;
-
-    QVector<Aerodrome::Area> areas;
-    areas << Aerodrome::Area::Movement << Aerodrome::Area::Airborne;
-
-    auto printStats = [&out](AreaHash<Counters::PfdCounter>::const_iterator it, Counters::PfdCounter ctr) {
-        double pfd = ctr.n_ftr_ / static_cast<double>(ctr.n_tr_);
-        if (pfd > 1)
-        {
-            pfd = 1;
-        }
-
-        out << qSetFieldWidth(15) << Qt::left << it.key().fullName() << qSetFieldWidth(1) << ""
-            << qSetFieldWidth(7) << Qt::right << pfd * 100.0 << qSetFieldWidth(1) << ""
-            << qSetFieldWidth(6) << Qt::right << ctr.n_tr_
-            << qSetFieldWidth(0) << Qt::endl;
-    };
-
-    for (const Aerodrome::Area area : qAsConst(areas))
-    {
-        const auto subAreas = mlatPfd_.findByArea(area);
-
-        Counters::PfdCounter ctrTotal;
-        for (const auto &it : subAreas)
-        {
-            Counters::PfdCounter ctr = it.value();
-            ctrTotal.n_ftr_ += ctr.n_ftr_;
-            ctrTotal.n_tr_ += ctr.n_tr_;
-
-            printStats(it, ctr);
-        }
-
-        double pfd = ctrTotal.n_ftr_ / static_cast<double>(ctrTotal.n_tr_);
-        if (pfd > 1)
-        {
-            pfd = 1;
-        }
-
-        out << qSetFieldWidth(15) << Qt::left << e.valueToKey(area) << qSetFieldWidth(1) << ""
-            << qSetFieldWidth(7) << Qt::right << pfd * 100.0 << qSetFieldWidth(1) << ""
-            << qSetFieldWidth(6) << Qt::right << ctrTotal.n_tr_
-            << qSetFieldWidth(0) << Qt::endl;
-
-        out << Qt::endl;
-    }
-}
-
-void PerfEvaluator::printED117PID_Ident() const
-{
-    QMetaEnum e = QMetaEnum::fromType<Aerodrome::Area>();
-
-    QTextStream out(stdout);
-    out.setRealNumberPrecision(2);
-    out.setRealNumberNotation(QTextStream::FixedNotation);
-
-    out << Qt::endl;
-
-    out.setFieldAlignment(QTextStream::AlignCenter);
-    out.setPadChar(QLatin1Char('-'));
-    out << qSetFieldWidth(30) << "[ ED-117 PID (IDENT) ]" << qSetFieldWidth(0) << Qt::endl;
-    out.setPadChar(QLatin1Char(' '));
-
-    out << qSetFieldWidth(15) << "AREA" << qSetFieldWidth(1) << ""
-        << qSetFieldWidth(7) << "PID [%]" << qSetFieldWidth(1) << ""
-        << qSetFieldWidth(6) << "N"
-        << qSetFieldWidth(0) << Qt::endl;
-
-    out.setFieldAlignment(QTextStream::AlignRight);
-
-    out << qSetFieldWidth(15) << "---------------" << qSetFieldWidth(1) << ""
-        << qSetFieldWidth(7) << "-------" << qSetFieldWidth(1) << ""
-        << qSetFieldWidth(6) << "------"
-        << qSetFieldWidth(0) << Qt::endl;
-
-    QVector<Aerodrome::Area> areas;
-    areas << Aerodrome::Area::Movement << Aerodrome::Area::Airborne;
-
-    auto printStats = [&out](AreaHash<Counters::PidCounter>::const_iterator it, Counters::PidCounter ctr) {
-        double pid = ctr.n_citr_ / static_cast<double>(ctr.n_itr_);
-        if (pid > 1)
-        {
-            pid = 1;
-        }
-
-        out << qSetFieldWidth(15) << Qt::left << it.key().fullName() << qSetFieldWidth(1) << ""
-            << qSetFieldWidth(7) << Qt::right << pid * 100.0 << qSetFieldWidth(1) << ""
-            << qSetFieldWidth(6) << Qt::right << ctr.n_itr_
-            << qSetFieldWidth(0) << Qt::endl;
-    };
-
-    for (const Aerodrome::Area area : qAsConst(areas))
-    {
-        const auto subAreas = mlatPidIdent_.findByArea(area);
-
-        Counters::PidCounter ctrTotal;
-        for (const auto &it : subAreas)
-        {
-            Counters::PidCounter ctr = it.value();
-            ctrTotal.n_citr_ += ctr.n_citr_;
-            ctrTotal.n_itr_ += ctr.n_itr_;
-
-            printStats(it, ctr);
-        }
-
-        double pid = ctrTotal.n_citr_ / static_cast<double>(ctrTotal.n_itr_);
-        if (pid > 1)
-        {
-            pid = 1;
-        }
-
-        out << qSetFieldWidth(15) << Qt::left << e.valueToKey(area) << qSetFieldWidth(1) << ""
-            << qSetFieldWidth(7) << Qt::right << pid * 100.0 << qSetFieldWidth(1) << ""
-            << qSetFieldWidth(6) << Qt::right << ctrTotal.n_itr_
-            << qSetFieldWidth(0) << Qt::endl;
-
-        out << Qt::endl;
-    }
-}
-
-void PerfEvaluator::printED117PID_Mode3A() const
-{
-    QMetaEnum e = QMetaEnum::fromType<Aerodrome::Area>();
-
-    QTextStream out(stdout);
-    out.setRealNumberPrecision(2);
-    out.setRealNumberNotation(QTextStream::FixedNotation);
-
-    out << Qt::endl;
-
-    out.setFieldAlignment(QTextStream::AlignCenter);
-    out.setPadChar(QLatin1Char('-'));
-    out << qSetFieldWidth(30) << "[ ED-117 PID (MODE3A) ]" << qSetFieldWidth(0) << Qt::endl;
-    out.setPadChar(QLatin1Char(' '));
-
-    out << qSetFieldWidth(15) << "AREA" << qSetFieldWidth(1) << ""
-        << qSetFieldWidth(7) << "PID [%]" << qSetFieldWidth(1) << ""
-        << qSetFieldWidth(6) << "N"
-        << qSetFieldWidth(0) << Qt::endl;
-
-    out.setFieldAlignment(QTextStream::AlignRight);
-
-    out << qSetFieldWidth(15) << "---------------" << qSetFieldWidth(1) << ""
-        << qSetFieldWidth(7) << "-------" << qSetFieldWidth(1) << ""
-        << qSetFieldWidth(6) << "------"
-        << qSetFieldWidth(0) << Qt::endl;
-
-    QVector<Aerodrome::Area> areas;
-    areas << Aerodrome::Area::Movement << Aerodrome::Area::Airborne;
-
-    auto printStats = [&out](AreaHash<Counters::PidCounter>::const_iterator it, Counters::PidCounter ctr) {
-        double pid = ctr.n_citr_ / static_cast<double>(ctr.n_itr_);
-        if (pid > 1)
-        {
-            pid = 1;
-        }
-
-        out << qSetFieldWidth(15) << Qt::left << it.key().fullName() << qSetFieldWidth(1) << ""
-            << qSetFieldWidth(7) << Qt::right << pid * 100.0 << qSetFieldWidth(1) << ""
-            << qSetFieldWidth(6) << Qt::right << ctr.n_itr_
-            << qSetFieldWidth(0) << Qt::endl;
-    };
-
-    for (const Aerodrome::Area area : qAsConst(areas))
-    {
-        const auto subAreas = mlatPidMode3A_.findByArea(area);
-
-        Counters::PidCounter ctrTotal;
-        for (const auto &it : subAreas)
-        {
-            Counters::PidCounter ctr = it.value();
-            ctrTotal.n_citr_ += ctr.n_citr_;
-            ctrTotal.n_itr_ += ctr.n_itr_;
-
-            printStats(it, ctr);
-        }
-
-        double pid = ctrTotal.n_citr_ / static_cast<double>(ctrTotal.n_itr_);
-        if (pid > 1)
-        {
-            pid = 1;
-        }
-
-        out << qSetFieldWidth(15) << Qt::left << e.valueToKey(area) << qSetFieldWidth(1) << ""
-            << qSetFieldWidth(7) << Qt::right << pid * 100.0 << qSetFieldWidth(1) << ""
-            << qSetFieldWidth(6) << Qt::right << ctrTotal.n_itr_
-            << qSetFieldWidth(0) << Qt::endl;
-
-        out << Qt::endl;
-    }
-}
-
-void PerfEvaluator::printED117PFID_Ident() const
-{
-    QMetaEnum e = QMetaEnum::fromType<Aerodrome::Area>();
-
-    QTextStream out(stdout);
-    out.setRealNumberPrecision(2);
-    out.setRealNumberNotation(QTextStream::FixedNotation);
-
-    out << Qt::endl;
-
-    out.setFieldAlignment(QTextStream::AlignCenter);
-    out.setPadChar(QLatin1Char('-'));
-    out << qSetFieldWidth(31) << "[ ED-117 PFID (IDENT) ]" << qSetFieldWidth(0) << Qt::endl;
-    out.setPadChar(QLatin1Char(' '));
-
-    out << qSetFieldWidth(15) << "AREA" << qSetFieldWidth(1) << ""
-        << qSetFieldWidth(8) << "PFID [%]" << qSetFieldWidth(1) << ""
-        << qSetFieldWidth(6) << "N"
-        << qSetFieldWidth(0) << Qt::endl;
-
-    out.setFieldAlignment(QTextStream::AlignRight);
-
-    out << qSetFieldWidth(15) << "---------------" << qSetFieldWidth(1) << ""
-        << qSetFieldWidth(8) << "--------" << qSetFieldWidth(1) << ""
-        << qSetFieldWidth(6) << "------"
-        << qSetFieldWidth(0) << Qt::endl;
-
-    QVector<Aerodrome::Area> areas;
-    areas << Aerodrome::Area::Movement << Aerodrome::Area::Airborne;
-
-    auto printStats = [&out](AreaHash<Counters::PfidCounter>::const_iterator it, Counters::PfidCounter ctr) {
-        double pfid = ctr.n_eitr_ / static_cast<double>(ctr.n_itr_);
-        if (pfid > 1)
-        {
-            pfid = 1;
-        }
-
-        out << qSetFieldWidth(15) << Qt::left << it.key().fullName() << qSetFieldWidth(1) << ""
-            << qSetFieldWidth(8) << Qt::right << pfid * 100.0 << qSetFieldWidth(1) << ""
-            << qSetFieldWidth(6) << Qt::right << ctr.n_itr_
-            << qSetFieldWidth(0) << Qt::endl;
-    };
-
-    for (const Aerodrome::Area area : qAsConst(areas))
-    {
-        const auto subAreas = mlatPfidIdent_.findByArea(area);
-
-        Counters::PfidCounter ctrTotal;
-        for (const auto &it : subAreas)
-        {
-            Counters::PfidCounter ctr = it.value();
-            ctrTotal.n_eitr_ += ctr.n_eitr_;
-            ctrTotal.n_itr_ += ctr.n_itr_;
-
-            printStats(it, ctr);
-        }
-
-        double pfid = ctrTotal.n_eitr_ / static_cast<double>(ctrTotal.n_itr_);
-        if (pfid > 1)
-        {
-            pfid = 1;
-        }
-
-        out << qSetFieldWidth(15) << Qt::left << e.valueToKey(area) << qSetFieldWidth(1) << ""
-            << qSetFieldWidth(8) << Qt::right << pfid * 100.0 << qSetFieldWidth(1) << ""
-            << qSetFieldWidth(6) << Qt::right << ctrTotal.n_itr_
-            << qSetFieldWidth(0) << Qt::endl;
-
-        out << Qt::endl;
-    }
-}
-
-void PerfEvaluator::printED117PFID_Mode3A() const
-{
-    QMetaEnum e = QMetaEnum::fromType<Aerodrome::Area>();
-
-    QTextStream out(stdout);
-    out.setRealNumberPrecision(2);
-    out.setRealNumberNotation(QTextStream::FixedNotation);
-
-    out << Qt::endl;
-
-    out.setFieldAlignment(QTextStream::AlignCenter);
-    out.setPadChar(QLatin1Char('-'));
-    out << qSetFieldWidth(31) << "[ ED-117 PFID (MODE3A) ]" << qSetFieldWidth(0) << Qt::endl;
-    out.setPadChar(QLatin1Char(' '));
-
-    out << qSetFieldWidth(15) << "AREA" << qSetFieldWidth(1) << ""
-        << qSetFieldWidth(8) << "PFID [%]" << qSetFieldWidth(1) << ""
-        << qSetFieldWidth(6) << "N"
-        << qSetFieldWidth(0) << Qt::endl;
-
-    out.setFieldAlignment(QTextStream::AlignRight);
-
-    out << qSetFieldWidth(15) << "---------------" << qSetFieldWidth(1) << ""
-        << qSetFieldWidth(8) << "--------" << qSetFieldWidth(1) << ""
-        << qSetFieldWidth(6) << "------"
-        << qSetFieldWidth(0) << Qt::endl;
-
-    QVector<Aerodrome::Area> areas;
-    areas << Aerodrome::Area::Movement << Aerodrome::Area::Airborne;
-
-    auto printStats = [&out](AreaHash<Counters::PfidCounter>::const_iterator it, Counters::PfidCounter ctr) {
-        double pfid = ctr.n_eitr_ / static_cast<double>(ctr.n_itr_);
-        if (pfid > 1)
-        {
-            pfid = 1;
-        }
-
-        out << qSetFieldWidth(15) << Qt::left << it.key().fullName() << qSetFieldWidth(1) << ""
-            << qSetFieldWidth(8) << Qt::right << pfid * 100.0 << qSetFieldWidth(1) << ""
-            << qSetFieldWidth(6) << Qt::right << ctr.n_itr_
-            << qSetFieldWidth(0) << Qt::endl;
-    };
-
-    for (const Aerodrome::Area area : qAsConst(areas))
-    {
-        const auto subAreas = mlatPfidMode3A_.findByArea(area);
-
-        Counters::PfidCounter ctrTotal;
-        for (const auto &it : subAreas)
-        {
-            Counters::PfidCounter ctr = it.value();
-            ctrTotal.n_eitr_ += ctr.n_eitr_;
-            ctrTotal.n_itr_ += ctr.n_itr_;
-
-            printStats(it, ctr);
-        }
-
-        double pfid = ctrTotal.n_eitr_ / static_cast<double>(ctrTotal.n_itr_);
-        if (pfid > 1)
-        {
-            pfid = 1;
-        }
-
-        out << qSetFieldWidth(15) << Qt::left << e.valueToKey(area) << qSetFieldWidth(1) << ""
-            << qSetFieldWidth(8) << Qt::right << pfid * 100.0 << qSetFieldWidth(1) << ""
-            << qSetFieldWidth(6) << Qt::right << ctrTotal.n_itr_
-            << qSetFieldWidth(0) << Qt::endl;
-
-        out << Qt::endl;
-    }
-}
-
-void PerfEvaluator::printED117PLG() const
-{
-    QMetaEnum e = QMetaEnum::fromType<Aerodrome::Area>();
-
-    QTextStream out(stdout);
-    out.setRealNumberPrecision(2);
-    out.setRealNumberNotation(QTextStream::FixedNotation);
-
-    out << Qt::endl;
-
-    out.setFieldAlignment(QTextStream::AlignCenter);
-    out.setPadChar(QLatin1Char('-'));
-    out << qSetFieldWidth(30) << "[ ED-117A PLG ]" << qSetFieldWidth(0) << Qt::endl;
-    out.setPadChar(QLatin1Char(' '));
-
-    out << qSetFieldWidth(15) << "AREA" << qSetFieldWidth(1) << ""
-        << qSetFieldWidth(7) << "PLG [%]" << qSetFieldWidth(1) << ""
-        << qSetFieldWidth(6) << "N"
-        << qSetFieldWidth(0) << Qt::endl;
-
-    out.setFieldAlignment(QTextStream::AlignRight);
-
-    out << qSetFieldWidth(15) << "---------------" << qSetFieldWidth(1) << ""
-        << qSetFieldWidth(7) << "-------" << qSetFieldWidth(1) << ""
-        << qSetFieldWidth(6) << "------"
-        << qSetFieldWidth(0) << Qt::endl;
-
-    QVector<Aerodrome::Area> areas;
-    areas << Aerodrome::Area::Movement << Aerodrome::Area::Airborne;
-
-    auto printStats = [&out](AreaHash<Counters::PlgCounter>::const_iterator it, Counters::PlgCounter ctr) {
-        double plg = ctr.n_g_ / static_cast<double>(ctr.n_tr_);
-        if (plg > 1)
-        {
-            plg = 1;
-        }
-
-        out << qSetFieldWidth(15) << Qt::left << it.key().fullName() << qSetFieldWidth(1) << ""
-            << qSetFieldWidth(7) << Qt::right << plg * 100.0 << qSetFieldWidth(1) << ""
-            << qSetFieldWidth(6) << Qt::right << ctr.n_tr_
-            << qSetFieldWidth(0) << Qt::endl;
-    };
-
-    for (const Aerodrome::Area area : qAsConst(areas))
-    {
-        const auto subAreas = mlatPlg_.findByArea(area);
-
-        Counters::PlgCounter ctrTotal;
-        for (const auto &it : subAreas)
-        {
-            Counters::PlgCounter ctr = it.value();
-            ctrTotal.n_g_ += ctr.n_g_;
-            ctrTotal.n_tr_ += ctr.n_tr_;
-
-            printStats(it, ctr);
-        }
-
-        double plg = ctrTotal.n_g_ / static_cast<double>(ctrTotal.n_tr_);
-        if (plg > 1)
-        {
-            plg = 1;
-        }
-
-        out << qSetFieldWidth(15) << Qt::left << e.valueToKey(area) << qSetFieldWidth(1) << ""
-            << qSetFieldWidth(7) << Qt::right << plg * 100.0 << qSetFieldWidth(1) << ""
-            << qSetFieldWidth(6) << Qt::right << ctrTotal.n_tr_
-            << qSetFieldWidth(0) << Qt::endl;
-
-        out << Qt::endl;
-    }
-}
-
-QJsonObject PerfEvaluator::printED116RPA_json() const
-{
-    QMetaEnum e = QMetaEnum::fromType<Aerodrome::Area>();
-
-    QVector<Aerodrome::Area> areas;
-    areas << Aerodrome::Area::Manoeuvering;
-
-
-    auto sa_results = [](const QVector<double> &errors) {
-        QJsonObject obj;
-        obj.insert(QLatin1String("P95"), percentile(errors, 95));
-        obj.insert(QLatin1String("P99"), percentile(errors, 99));
-        obj.insert(QLatin1String("Mean"), mean(errors));
-        obj.insert(QLatin1String("StdDev"), stdDev(errors));
-        obj.insert(QLatin1String("N"), errors.size());
-
-        return obj;
-    };
-
-
-    QJsonObject resultObj;
-    for (const Aerodrome::Area area : qAsConst(areas))
-    {
-        QJsonObject areaObj;
-        const auto subAreas = smrRpaErrors_.findByArea(area);
-
-        QJsonObject subAreasObj;
-        QVector<double> errorsTotal;
-        for (const auto &it : subAreas)
-        {
-            QVector<double> errors = it.value();
-            errorsTotal.append(errors);
-
-            QString sa_name = it.key().fullName();
-            subAreasObj.insert(sa_name, sa_results(errors));
-        }
-
-        areaObj.insert(QLatin1String("subAreas"), subAreasObj);
-
-        areaObj.insert(QLatin1String("P95"), percentile(errorsTotal, 95));
-        areaObj.insert(QLatin1String("P99"), percentile(errorsTotal, 99));
-        areaObj.insert(QLatin1String("Mean"), mean(errorsTotal));
-        areaObj.insert(QLatin1String("StdDev"), stdDev(errorsTotal));
-        areaObj.insert(QLatin1String("N"), errorsTotal.size());
-
-
-        QString a_name = QLatin1String(e.valueToKey(area));
-        resultObj.insert(a_name, areaObj);
-    }
-
-    return resultObj;
-}
-
-QJsonObject PerfEvaluator::printED116UR_json() const
-{
-    QMetaEnum e = QMetaEnum::fromType<Aerodrome::Area>();
-
-    QVector<Aerodrome::Area> areas;
-    areas << Aerodrome::Area::Manoeuvering;
-
-
-    auto sa_results = [](Counters::UrCounter ctr) {
-        double ur = ctr.n_trp_ / static_cast<double>(ctr.n_etrp_);
-        if (ur > 1)
-        {
-            ur = 1;
-        }
-
-        QJsonObject obj;
-        obj.insert(QLatin1String("UR"), ur * 100);
-        obj.insert(QLatin1String("N"), static_cast<qint32>(ctr.n_trp_));
-
-        return obj;
-    };
-
-
-    QJsonObject resultObj;
-    for (const Aerodrome::Area area : qAsConst(areas))
-    {
-        QJsonObject areaObj;
-        const auto subAreas = smrUr_.findByArea(area);
-
-        QJsonObject subAreasObj;
-        Counters::UrCounter ctrTotal;
-        for (const auto &it : subAreas)
-        {
-            Counters::UrCounter ctr = it.value();
-            ctrTotal.n_trp_ += ctr.n_trp_;
-            ctrTotal.n_etrp_ += ctr.n_etrp_;
-
-            QString sa_name = it.key().fullName();
-            subAreasObj.insert(sa_name, sa_results(ctr));
-        }
-
-        areaObj.insert(QLatin1String("subAreas"), subAreasObj);
-
-        double ur = ctrTotal.n_trp_ / static_cast<double>(ctrTotal.n_etrp_);
-        if (ur > 1)
-        {
-            ur = 1;
-        }
-
-        areaObj.insert(QLatin1String("UR"), ur * 100);
-        areaObj.insert(QLatin1String("N"), static_cast<qint32>(ctrTotal.n_trp_));
-
-
-        QString a_name = QLatin1String(e.valueToKey(area));
-        resultObj.insert(a_name, areaObj);
-    }
-
-    return resultObj;
-}
-
-QJsonObject PerfEvaluator::printED116PD_json() const
-{
-    QMetaEnum e = QMetaEnum::fromType<Aerodrome::Area>();
-
-    QVector<Aerodrome::Area> areas;
-    areas << Aerodrome::Area::Manoeuvering;
-
-
-    auto sa_results = [](Counters::PdCounter ctr) {
-        double pd = ctr.n_trp_ / static_cast<double>(ctr.n_up_);
-        if (pd > 1)
-        {
-            pd = 1;
-        }
-
-        QJsonObject obj;
-        obj.insert(QLatin1String("PD"), pd * 100);
-        obj.insert(QLatin1String("N"), static_cast<qint32>(ctr.n_trp_));
-
-        return obj;
-    };
-
-
-    QJsonObject resultObj;
-    for (const Aerodrome::Area area : qAsConst(areas))
-    {
-        QJsonObject areaObj;
-        const auto subAreas = smrPd_.findByArea(area);
-
-        QJsonObject subAreasObj;
-        Counters::PdCounter ctrTotal;
-        for (const auto &it : subAreas)
-        {
-            Counters::PdCounter ctr = it.value();
-            ctrTotal.n_trp_ += ctr.n_trp_;
-            ctrTotal.n_up_ += ctr.n_up_;
-
-            QString sa_name = it.key().fullName();
-            subAreasObj.insert(sa_name, sa_results(ctr));
-        }
-
-        areaObj.insert(QLatin1String("subAreas"), subAreasObj);
-
-        double pd = ctrTotal.n_trp_ / static_cast<double>(ctrTotal.n_up_);
-        if (pd > 1)
-        {
-            pd = 1;
-        }
-
-        areaObj.insert(QLatin1String("PD"), pd * 100);
-        areaObj.insert(QLatin1String("N"), static_cast<qint32>(ctrTotal.n_trp_));
-
-
-        QString a_name = QLatin1String(e.valueToKey(area));
-        resultObj.insert(a_name, areaObj);
-    }
-
-    return resultObj;
-}
-
-QJsonObject PerfEvaluator::printED116PFD_json() const
-{
-    QMetaEnum e = QMetaEnum::fromType<Aerodrome::Area>();
-
-    QVector<Aerodrome::Area> areas;
-    areas << Aerodrome::Area::Manoeuvering;
+        PerfResults::Stats stats;
+        stats.percent = pfd * 100.0;
+        stats.n = ctr.n_tr_;
 
-
-    auto sa_results = [](Counters::PfdCounter2 ctr) {
-        double pfd = (static_cast<double>(ctr.n_tr_) - static_cast<double>(ctr.n_etr_)) / static_cast<double>(ctr.n_u_);
-        if (pfd < 0)
-        {
-            pfd = 0;
-        }
-
-        QJsonObject obj;
-        obj.insert(QLatin1String("PFD"), pfd * 100);
-        obj.insert(QLatin1String("N"), static_cast<qint32>(ctr.n_tr_));
-
-        return obj;
-    };
-
-
-    QJsonObject resultObj;
-    for (const Aerodrome::Area area : qAsConst(areas))
-    {
-        QJsonObject areaObj;
-        const auto subAreas = smrPfd_.findByArea(area);
-
-        QJsonObject subAreasObj;
-        TrafficPeriodCollection tpcolTotal;
-        Counters::PfdCounter2 ctrTotal;
-        for (const auto &it : subAreas)
-        {
-            Aerodrome::NamedArea narea = it.key();
-            tpcolTotal << trafficPeriods_[narea];
-
-            Counters::PfdCounter2 ctr = it.value();
-            ctrTotal.n_tr_ += ctr.n_tr_;
-            ctrTotal.n_etr_ = tpcolTotal.expectedTgtReps(1.0);
-            ctrTotal.n_u_ = tpcolTotal.expectedUpdates(1.0);
-
-            QString sa_name = it.key().fullName();
-            subAreasObj.insert(sa_name, sa_results(ctr));
-        }
-
-        areaObj.insert(QLatin1String("subAreas"), subAreasObj);
-
-        double pfd = (static_cast<double>(ctrTotal.n_tr_) - static_cast<double>(ctrTotal.n_etr_)) / static_cast<double>(ctrTotal.n_u_);
-        if (pfd < 0)
-        {
-            pfd = 0;
-        }
-
-        areaObj.insert(QLatin1String("PFD"), pfd * 100);
-        areaObj.insert(QLatin1String("N"), static_cast<qint32>(ctrTotal.n_tr_));
-
-
-        QString a_name = QLatin1String(e.valueToKey(area));
-        resultObj.insert(a_name, areaObj);
-    }
-
-    return resultObj;
-}
-
-QJsonObject PerfEvaluator::printED117RPA_json() const
-{
-    QMetaEnum e = QMetaEnum::fromType<Aerodrome::Area>();
-
-    QVector<Aerodrome::Area> areas;
-    areas << Aerodrome::Area::Movement << Aerodrome::Area::Airborne;
-
-
-    auto sa_results = [](const QVector<double> &errors) {
-        QJsonObject obj;
-        obj.insert(QLatin1String("P95"), percentile(errors, 95));
-        obj.insert(QLatin1String("P99"), percentile(errors, 99));
-        obj.insert(QLatin1String("Mean"), mean(errors));
-        obj.insert(QLatin1String("StdDev"), stdDev(errors));
-        obj.insert(QLatin1String("N"), errors.size());
-
-        return obj;
+        return stats;
     };
 
-
-    QJsonObject resultObj;
-    for (const Aerodrome::Area area : qAsConst(areas))
-    {
-        QJsonObject areaObj;
-        const auto subAreas = mlatRpaErrors_.findByArea(area);
-
-        QJsonObject subAreasObj;
-        QVector<double> errorsTotal;
-        for (const auto &it : subAreas)
-        {
-            QVector<double> errors = it.value();
-            errorsTotal.append(errors);
-
-            QString sa_name = it.key().fullName();
-            subAreasObj.insert(sa_name, sa_results(errors));
-        }
-
-        areaObj.insert(QLatin1String("subAreas"), subAreasObj);
-
-        areaObj.insert(QLatin1String("P95"), percentile(errorsTotal, 95));
-        areaObj.insert(QLatin1String("P99"), percentile(errorsTotal, 99));
-        areaObj.insert(QLatin1String("Mean"), mean(errorsTotal));
-        areaObj.insert(QLatin1String("StdDev"), stdDev(errorsTotal));
-        areaObj.insert(QLatin1String("N"), errorsTotal.size());
-
-
-        QString a_name = QLatin1String(e.valueToKey(area));
-        resultObj.insert(a_name, areaObj);
-    }
-
-    return resultObj;
-}
-
-QJsonObject PerfEvaluator::printED117UR_json() const
-{
-    QMetaEnum e = QMetaEnum::fromType<Aerodrome::Area>();
-
-    QVector<Aerodrome::Area> areas;
-    areas << Aerodrome::Area::Movement << Aerodrome::Area::Airborne;
-
-
-    auto sa_results = [](Counters::UrCounter ctr) {
-        double ur = ctr.n_trp_ / static_cast<double>(ctr.n_etrp_);
-        if (ur > 1)
-        {
-            ur = 1;
-        }
-
-        QJsonObject obj;
-        obj.insert(QLatin1String("UR"), ur * 100);
-        obj.insert(QLatin1String("N"), static_cast<qint32>(ctr.n_trp_));
-
-        return obj;
+    // ED-117 PFD.
+    auto addPfd = [](Counters::PfdCounter &total, AreaHash<Counters::PfdCounter>::const_iterator it) {
+        total.n_ftr_ += it.value().n_ftr_;
+        total.n_tr_ += it.value().n_tr_;
     };
 
-
-    QJsonObject resultObj;
-    for (const Aerodrome::Area area : qAsConst(areas))
-    {
-        QJsonObject areaObj;
-        const auto subAreas = mlatUr_.findByArea(area);
-
-        QJsonObject subAreasObj;
-        Counters::UrCounter ctrTotal;
-        for (const auto &it : subAreas)
-        {
-            Counters::UrCounter ctr = it.value();
-            ctrTotal.n_trp_ += ctr.n_trp_;
-            ctrTotal.n_etrp_ += ctr.n_etrp_;
-
-            QString sa_name = it.key().fullName();
-            subAreasObj.insert(sa_name, sa_results(ctr));
-        }
-
-        areaObj.insert(QLatin1String("subAreas"), subAreasObj);
-
-        double ur = ctrTotal.n_trp_ / static_cast<double>(ctrTotal.n_etrp_);
-        if (ur > 1)
-        {
-            ur = 1;
-        }
-
-        areaObj.insert(QLatin1String("UR"), ur * 100);
-        areaObj.insert(QLatin1String("N"), static_cast<qint32>(ctrTotal.n_trp_));
-
-
-        QString a_name = QLatin1String(e.valueToKey(area));
-        resultObj.insert(a_name, areaObj);
-    }
-
-    return resultObj;
-}
-
-QJsonObject PerfEvaluator::printED117PD_json() const
-{
-    QMetaEnum e = QMetaEnum::fromType<Aerodrome::Area>();
-
-    QVector<Aerodrome::Area> areas;
-    areas << Aerodrome::Area::Movement << Aerodrome::Area::Airborne;
-
-
-    auto sa_results = [](Counters::PdCounter ctr) {
-        double pd = ctr.n_trp_ / static_cast<double>(ctr.n_up_);
-        if (pd > 1)
-        {
-            pd = 1;
-        }
-
-        QJsonObject obj;
-        obj.insert(QLatin1String("PD"), pd * 100);
-        obj.insert(QLatin1String("N"), static_cast<qint32>(ctr.n_trp_));
-
-        return obj;
+    auto pfdStats = [](const Counters::PfdCounter &ctr) {
+        return ratioStats(ctr.n_ftr_, ctr.n_tr_, ctr.n_tr_);
     };
 
-
-    QJsonObject resultObj;
-    for (const Aerodrome::Area area : qAsConst(areas))
-    {
-        QJsonObject areaObj;
-        const auto subAreas = mlatPd_.findByArea(area);
-
-        QJsonObject subAreasObj;
-        Counters::PdCounter ctrTotal;
-        for (const auto &it : subAreas)
-        {
-            Counters::PdCounter ctr = it.value();
-            ctrTotal.n_trp_ += ctr.n_trp_;
-            ctrTotal.n_up_ += ctr.n_up_;
-
-            QString sa_name = it.key().fullName();
-            subAreasObj.insert(sa_name, sa_results(ctr));
-        }
-
-        areaObj.insert(QLatin1String("subAreas"), subAreasObj);
-
-        double pd = ctrTotal.n_trp_ / static_cast<double>(ctrTotal.n_up_);
-        if (pd > 1)
-        {
-            pd = 1;
-        }
-
-        areaObj.insert(QLatin1String("PD"), pd * 100);
-        areaObj.insert(QLatin1String("N"), static_cast<qint32>(ctrTotal.n_trp_));
-
-
-        QString a_name = QLatin1String(e.valueToKey(area));
-        resultObj.insert(a_name, areaObj);
-    }
-
-    return resultObj;
-}
-
-QJsonObject PerfEvaluator::printED117PFD_json() const
-{
-    QMetaEnum e = QMetaEnum::fromType<Aerodrome::Area>();
-
-    QVector<Aerodrome::Area> areas;
-    areas << Aerodrome::Area::Movement << Aerodrome::Area::Airborne;
-
-
-    auto sa_results = [](Counters::PfdCounter ctr) {
-        double pfd = ctr.n_ftr_ / static_cast<double>(ctr.n_tr_);
-        if (pfd > 1)
-        {
-            pfd = 1;
-        }
-
-        QJsonObject obj;
-        obj.insert(QLatin1String("PFD"), pfd * 100);
-        obj.insert(QLatin1String("N"), static_cast<qint32>(ctr.n_tr_));
-
-        return obj;
+    // PID.
+    auto addPid = [](Counters::PidCounter &total, AreaHash<Counters::PidCounter>::const_iterator it) {
+        total.n_citr_ += it.value().n_citr_;
+        total.n_itr_ += it.value().n_itr_;
     };
 
-
-    QJsonObject resultObj;
-    for (const Aerodrome::Area area : qAsConst(areas))
-    {
-        QJsonObject areaObj;
-        const auto subAreas = mlatPfd_.findByArea(area);
-
-        QJsonObject subAreasObj;
-        Counters::PfdCounter ctrTotal;
-        for (const auto &it : subAreas)
-        {
-            Counters::PfdCounter ctr = it.value();
-            ctrTotal.n_ftr_ += ctr.n_ftr_;
-            ctrTotal.n_tr_ += ctr.n_tr_;
-
-            QString sa_name = it.key().fullName();
-            subAreasObj.insert(sa_name, sa_results(ctr));
-        }
-
-        areaObj.insert(QLatin1String("subAreas"), subAreasObj);
-
-        double pfd = ctrTotal.n_ftr_ / static_cast<double>(ctrTotal.n_tr_);
-        if (pfd > 1)
-        {
-            pfd = 1;
-        }
-
-        areaObj.insert(QLatin1String("PFD"), pfd * 100);
-        areaObj.insert(QLatin1String("N"), static_cast<qint32>(ctrTotal.n_tr_));
-
-
-        QString a_name = QLatin1String(e.valueToKey(area));
-        resultObj.insert(a_name, areaObj);
-    }
-
-    return resultObj;
-}
-
-QJsonObject PerfEvaluator::printED117PID_Ident_json() const
-{
-    QMetaEnum e = QMetaEnum::fromType<Aerodrome::Area>();
-
-    QVector<Aerodrome::Area> areas;
-    areas << Aerodrome::Area::Movement << Aerodrome::Area::Airborne;
-
-
-    auto sa_results = [](Counters::PidCounter ctr) {
-        double pid = ctr.n_citr_ / static_cast<double>(ctr.n_itr_);
-        if (pid > 1)
-        {
-            pid = 1;
-        }
-
-        QJsonObject obj;
-        obj.insert(QLatin1String("PID"), pid * 100);
-        obj.insert(QLatin1String("N"), static_cast<qint32>(ctr.n_itr_));
-
-        return obj;
+    auto pidStats = [](const Counters::PidCounter &ctr) {
+        return ratioStats(ctr.n_citr_, ctr.n_itr_, ctr.n_itr_);
     };
 
-
-    QJsonObject resultObj;
-    for (const Aerodrome::Area area : qAsConst(areas))
-    {
-        QJsonObject areaObj;
-        const auto subAreas = mlatPidIdent_.findByArea(area);
-
-        QJsonObject subAreasObj;
-        Counters::PidCounter ctrTotal;
-        for (const auto &it : subAreas)
-        {
-            Counters::PidCounter ctr = it.value();
-            ctrTotal.n_citr_ += ctr.n_citr_;
-            ctrTotal.n_itr_ += ctr.n_itr_;
-
-            QString sa_name = it.key().fullName();
-            subAreasObj.insert(sa_name, sa_results(ctr));
-        }
-
-        areaObj.insert(QLatin1String("subAreas"), subAreasObj);
-
-        double pid = ctrTotal.n_citr_ / static_cast<double>(ctrTotal.n_itr_);
-        if (pid > 1)
-        {
-            pid = 1;
-        }
-
-        areaObj.insert(QLatin1String("PID"), pid * 100);
-        areaObj.insert(QLatin1String("N"), static_cast<qint32>(ctrTotal.n_itr_));
-
-
-        QString a_name = QLatin1String(e.valueToKey(area));
-        resultObj.insert(a_name, areaObj);
-    }
-
-    return resultObj;
-}
-
-QJsonObject PerfEvaluator::printED117PID_Mode3A_json() const
-{
-    QMetaEnum e = QMetaEnum::fromType<Aerodrome::Area>();
-
-    QVector<Aerodrome::Area> areas;
-    areas << Aerodrome::Area::Movement << Aerodrome::Area::Airborne;
-
-
-    auto sa_results = [](Counters::PidCounter ctr) {
-        double pid = ctr.n_citr_ / static_cast<double>(ctr.n_itr_);
-        if (pid > 1)
-        {
-            pid = 1;
-        }
-
-        QJsonObject obj;
-        obj.insert(QLatin1String("PID"), pid * 100);
-        obj.insert(QLatin1String("N"), static_cast<qint32>(ctr.n_itr_));
-
-        return obj;
+    // PFID.
+    auto addPfid = [](Counters::PfidCounter &total, AreaHash<Counters::PfidCounter>::const_iterator it) {
+        total.n_eitr_ += it.value().n_eitr_;
+        total.n_itr_ += it.value().n_itr_;
     };
 
-
-    QJsonObject resultObj;
-    for (const Aerodrome::Area area : qAsConst(areas))
-    {
-        QJsonObject areaObj;
-        const auto subAreas = mlatPidMode3A_.findByArea(area);
-
-        QJsonObject subAreasObj;
-        Counters::PidCounter ctrTotal;
-        for (const auto &it : subAreas)
-        {
-            Counters::PidCounter ctr = it.value();
-            ctrTotal.n_citr_ += ctr.n_citr_;
-            ctrTotal.n_itr_ += ctr.n_itr_;
-
-            QString sa_name = it.key().fullName();
-            subAreasObj.insert(sa_name, sa_results(ctr));
-        }
-
-        areaObj.insert(QLatin1String("subAreas"), subAreasObj);
-
-        double pid = ctrTotal.n_citr_ / static_cast<double>(ctrTotal.n_itr_);
-        if (pid > 1)
-        {
-            pid = 1;
-        }
-
-        areaObj.insert(QLatin1String("PID"), pid * 100);
-        areaObj.insert(QLatin1String("N"), static_cast<qint32>(ctrTotal.n_itr_));
-
-
-        QString a_name = QLatin1String(e.valueToKey(area));
-        resultObj.insert(a_name, areaObj);
-    }
-
-    return resultObj;
-}
-
-QJsonObject PerfEvaluator::printED117PFID_Ident_json() const
-{
-    QMetaEnum e = QMetaEnum::fromType<Aerodrome::Area>();
-
-    QVector<Aerodrome::Area> areas;
-    areas << Aerodrome::Area::Movement << Aerodrome::Area::Airborne;
-
-
-    auto sa_results = [](Counters::PfidCounter ctr) {
-        double pfid = ctr.n_eitr_ / static_cast<double>(ctr.n_itr_);
-        if (pfid > 1)
-        {
-            pfid = 1;
-        }
-
-        QJsonObject obj;
-        obj.insert(QLatin1String("PFID"), pfid * 100);
-        obj.insert(QLatin1String("N"), static_cast<qint32>(ctr.n_itr_));
-
-        return obj;
+    auto pfidStats = [](const Counters::PfidCounter &ctr) {
+        return ratioStats(ctr.n_eitr_, ctr.n_itr_, ctr.n_itr_);
     };
 
-
-    QJsonObject resultObj;
-    for (const Aerodrome::Area area : qAsConst(areas))
-    {
-        QJsonObject areaObj;
-        const auto subAreas = mlatPfidIdent_.findByArea(area);
-
-        QJsonObject subAreasObj;
-        Counters::PfidCounter ctrTotal;
-        for (const auto &it : subAreas)
-        {
-            Counters::PfidCounter ctr = it.value();
-            ctrTotal.n_eitr_ += ctr.n_eitr_;
-            ctrTotal.n_itr_ += ctr.n_itr_;
-
-            QString sa_name = it.key().fullName();
-            subAreasObj.insert(sa_name, sa_results(ctr));
-        }
-
-        areaObj.insert(QLatin1String("subAreas"), subAreasObj);
-
-        double pfid = ctrTotal.n_eitr_ / static_cast<double>(ctrTotal.n_itr_);
-        if (pfid > 1)
-        {
-            pfid = 1;
-        }
-
-        areaObj.insert(QLatin1String("PFID"), pfid * 100);
-        areaObj.insert(QLatin1String("N"), static_cast<qint32>(ctrTotal.n_itr_));
-
-
-        QString a_name = QLatin1String(e.valueToKey(area));
-        resultObj.insert(a_name, areaObj);
-    }
-
-    return resultObj;
-}
-
-QJsonObject PerfEvaluator::printED117PFID_Mode3A_json() const
-{
-    QMetaEnum e = QMetaEnum::fromType<Aerodrome::Area>();
-
-    QVector<Aerodrome::Area> areas;
-    areas << Aerodrome::Area::Movement << Aerodrome::Area::Airborne;
-
-
-    auto sa_results = [](Counters::PfidCounter ctr) {
-        double pfid = ctr.n_eitr_ / static_cast<double>(ctr.n_itr_);
-        if (pfid > 1)
-        {
-            pfid = 1;
-        }
-
-        QJsonObject obj;
-        obj.insert(QLatin1String("PFID"), pfid * 100);
-        obj.insert(QLatin1String("N"), static_cast<qint32>(ctr.n_itr_));
-
-        return obj;
+    // PLG.
+    auto addPlg = [](Counters::PlgCounter &total, AreaHash<Counters::PlgCounter>::const_iterator it) {
+        total.n_g_ += it.value().n_g_;
+        total.n_tr_ += it.value().n_tr_;
     };
 
-
-    QJsonObject resultObj;
-    for (const Aerodrome::Area area : qAsConst(areas))
-    {
-        QJsonObject areaObj;
-        const auto subAreas = mlatPfidMode3A_.findByArea(area);
-
-        QJsonObject subAreasObj;
-        Counters::PfidCounter ctrTotal;
-        for (const auto &it : subAreas)
-        {
-            Counters::PfidCounter ctr = it.value();
-            ctrTotal.n_eitr_ += ctr.n_eitr_;
-            ctrTotal.n_itr_ += ctr.n_itr_;
-
-            QString sa_name = it.key().fullName();
-            subAreasObj.insert(sa_name, sa_results(ctr));
-        }
-
-        areaObj.insert(QLatin1String("subAreas"), subAreasObj);
-
-        double pfid = ctrTotal.n_eitr_ / static_cast<double>(ctrTotal.n_itr_);
-        if (pfid > 1)
-        {
-            pfid = 1;
-        }
-
-        areaObj.insert(QLatin1String("PFID"), pfid * 100);
-        areaObj.insert(QLatin1String("N"), static_cast<qint32>(ctrTotal.n_itr_));
-
-
-        QString a_name = QLatin1String(e.valueToKey(area));
-        resultObj.insert(a_name, areaObj);
-    }
-
-    return resultObj;
-}
-
-QJsonObject PerfEvaluator::printED117PLG_json() const
-{
-    QMetaEnum e = QMetaEnum::fromType<Aerodrome::Area>();
-
-    QVector<Aerodrome::Area> areas;
-    areas << Aerodrome::Area::Movement << Aerodrome::Area::Airborne;
-
-
-    auto sa_results = [](Counters::PlgCounter ctr) {
-        double plg = ctr.n_g_ / static_cast<double>(ctr.n_tr_);
-        if (plg > 1)
-        {
-            plg = 1;
-        }
-
-        QJsonObject obj;
-        obj.insert(QLatin1String("PLG"), plg * 100);
-        obj.insert(QLatin1String("N"), static_cast<qint32>(ctr.n_tr_));
-
-        return obj;
+    auto plgStats = [](const Counters::PlgCounter &ctr) {
+        return ratioStats(ctr.n_g_, ctr.n_tr_, ctr.n_tr_);
     };
 
-
-    QJsonObject resultObj;
-    for (const Aerodrome::Area area : qAsConst(areas))
-    {
-        QJsonObject areaObj;
-        const auto subAreas = mlatPlg_.findByArea(area);
-
-        QJsonObject subAreasObj;
-        Counters::PlgCounter ctrTotal;
-        for (const auto &it : subAreas)
-        {
-            Counters::PlgCounter ctr = it.value();
-            ctrTotal.n_g_ += ctr.n_g_;
-            ctrTotal.n_tr_ += ctr.n_tr_;
-
-            QString sa_name = it.key().fullName();
-            subAreasObj.insert(sa_name, sa_results(ctr));
-        }
-
-        areaObj.insert(QLatin1String("subAreas"), subAreasObj);
-
-        double plg = ctrTotal.n_g_ / static_cast<double>(ctrTotal.n_tr_);
-        if (plg > 1)
-        {
-            plg = 1;
-        }
-
-        areaObj.insert(QLatin1String("PLG"), plg * 100);
-        areaObj.insert(QLatin1String("N"), static_cast<qint32>(ctrTotal.n_tr_));
-
-
-        QString a_name = QLatin1String(e.valueToKey(area));
-        resultObj.insert(a_name, areaObj);
-    }
-
-    return resultObj;
+    const ErrorAccumulator noErrors(config_.rpaSketchSize);
+
+    QVector<Metric> metrics;
+
+    // SMR ED-116.
+    metrics << Metric{QStringLiteral("ED116RPA"), QStringLiteral("ED-116 RPA"), QString(), Kind::Rpa,
+        areaResults(smrAreas, smrRpaErrors_, noErrors, addErrors, rpaStats)};
+    metrics << Metric{QStringLiteral("ED116UR"), QStringLiteral("ED-116 UR"), QStringLiteral("UR"), Kind::Ratio,
+        areaResults(smrAreas, smrUr_, Counters::UrCounter(), addUr, urStats)};
+    metrics << Metric{QStringLiteral("ED116PD"), QStringLiteral("ED-116 PD"), QStringLiteral("PD"), Kind::Ratio,
+        areaResults(smrAreas, smrPd_, Counters::PdCounter(), addPd, pdStats)};
+    metrics << Metric{QStringLiteral("ED116PFD"), QStringLiteral("ED-116 PFD"), QStringLiteral("PFD"), Kind::Ratio,
+        areaResults(smrAreas, smrPfd_, PfdTotal(), addPfd2, pfd2Stats)};
+
+    // MLAT ED-117.
+    metrics << Metric{QStringLiteral("ED117RPA"), QStringLiteral("ED-117 RPA"), QString(), Kind::Rpa,
+        areaResults(mlatAreas, mlatRpaErrors_, noErrors, addErrors, rpaStats)};
+    metrics << Metric{QStringLiteral("ED117UR"), QStringLiteral("ED-117 UR"), QStringLiteral("UR"), Kind::Ratio,
+        areaResults(mlatAreas, mlatUr_, Counters::UrCounter(), addUr, urStats)};
+    metrics << Metric{QStringLiteral("ED117PD"), QStringLiteral("ED-117 PD"), QStringLiteral("PD"), Kind::Ratio,
+        areaResults(mlatAreas, mlatPd_, Counters::PdCounter(), addPd, pdStats)};
+    metrics << Metric{QStringLiteral("ED117PFD"), QStringLiteral("ED-117 PFD"), QStringLiteral("PFD"), Kind::Ratio,
+        areaResults(mlatAreas, mlatPfd_, Counters::PfdCounter(), addPfd, pfdStats)};
+    metrics << Metric{QStringLiteral("ED117PID_Ident"), QStringLiteral("ED-117 PID (IDENT)"), QStringLiteral("PID"), Kind::Ratio,
+        areaResults(mlatAreas, mlatPidIdent_, Counters::PidCounter(), addPid, pidStats)};
+    metrics << Metric{QStringLiteral("ED117PID_Mode3A"), QStringLiteral("ED-117 PID (MODE3A)"), QStringLiteral("PID"), Kind::Ratio,
+        areaResults(mlatAreas, mlatPidMode3A_, Counters::PidCounter(), addPid, pidStats)};
+    metrics << Metric{QStringLiteral("ED117PFID_Ident"), QStringLiteral("ED-117 PFID (IDENT)"), QStringLiteral("PFID"), Kind::Ratio,
+        areaResults(mlatAreas, mlatPfidIdent_, Counters::PfidCounter(), addPfid, pfidStats)};
+    metrics << Metric{QStringLiteral("ED117PFID_Mode3A"), QStringLiteral("ED-117 PFID (MODE3A)"), QStringLiteral("PFID"), Kind::Ratio,
+        areaResults(mlatAreas, mlatPfidMode3A_, Counters::PfidCounter(), addPfid, pfidStats)};
+    metrics << Metric{QStringLiteral("ED117PLG"), QStringLiteral("ED-117A PLG"), QStringLiteral("PLG"), Kind::Ratio,
+        areaResults(mlatAreas, mlatPlg_, Counters::PlgCounter(), addPlg, plgStats)};
+
+    return PerfResults(metrics);
 }
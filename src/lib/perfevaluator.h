@@ -22,25 +22,51 @@
 
 #include "areahash.h"
 #include "astmops.h"
+#include "config.h"
 #include "counters.h"
+#include "erroraccumulator.h"
+#include "evaldump.h"
 #include "functions.h"
+#include "perfresults.h"
 #include "track.h"
 #include "trackassociator.h"
 #include "trafficperiod.h"
-#include <QJsonObject>
+#include <QMap>
 
 class PerfEvaluator
 {
     friend class PerfEvaluatorTest;
 
 public:
-    PerfEvaluator();
+    static constexpr quint16 stateVersion = 2;
+
+    explicit PerfEvaluator(const RunConfig& config);
 
     void addData(const Track &t);
     void run();
+    void evaluate();
+    void finish();
+
+    PerfEvaluator &operator+=(const PerfEvaluator &other);
+    bool saveState(QIODevice *device) const;
+    bool mergeState(QIODevice *device);
+
+    void setMergeable(bool mergeable);
+    void setDump(EvalDump *dump);
+
+    const PerfResults &results() const;
 
 private:
+    // RPA errors by the range of PIC thresholds [first, last] they hold
+    // for, packed as (first << 8) | last.
+    using RpaErrorsByPic = QMap<quint16, AreaHash<ErrorAccumulator>>;
+
+    void computePicHistogram();
     void computePicThreshold(double prctl);
+    ErrorAccumulator &rpaErrors(AreaHash<ErrorAccumulator> &hash, const Aerodrome::NamedArea &narea);
+    void evalRpaErrors(const Track &trk_ref, const Track &sub_trk_ref, const Track &trk_tst,
+        const Track &t_t, SystemType st, AreaHash<ErrorAccumulator> &errors, RpaErrorsByPic &errorsByPic);
+    void finishRpa();
     QVector<QPair<TargetReport, double>> euclideanDistance(const TgtRepMap &ref, const TgtRepMap &tst) const;
     Track filterTrackByQuality(const Track &trk, quint8 ver, quint8 pic) const;
 
@@ -48,6 +74,7 @@ private:
     void evalED116UR(const TrackCollectionSet &s);
     void evalED116PD(const TrackCollectionSet &s);
     void evalED116PFD(const TrackCollectionSet &s);
+    void finishED116PFD();
 
     void evalED117RPA(const TrackCollectionSet &s);
     void evalED117UR(const TrackCollectionSet &s);
@@ -57,46 +84,31 @@ private:
     void evalED117PFID(const TrackCollectionSet &s);
     void evalED117PLG(const TrackCollectionSet &s);
 
-    // Output printing functions.
-    void printED116RPA() const;
-    void printED116UR() const;
-    void printED116PD() const;
-    void printED116PFD() const;
-
-    void printED117RPA() const;
-    void printED117UR() const;
-    void printED117PD() const;
-    void printED117PFD() const;
-    void printED117PID_Ident() const;
-    void printED117PID_Mode3A() const;
-    void printED117PFID_Ident() const;
-    void printED117PFID_Mode3A() const;
-    void printED117PLG() const;
-
-    QJsonObject printED116RPA_json() const;
-    QJsonObject printED116UR_json() const;
-    QJsonObject printED116PD_json() const;
-    QJsonObject printED116PFD_json() const;
-
-    QJsonObject printED117RPA_json() const;
-    QJsonObject printED117UR_json() const;
-    QJsonObject printED117PD_json() const;
-    QJsonObject printED117PFD_json() const;
-    QJsonObject printED117PID_Ident_json() const;
-    QJsonObject printED117PID_Mode3A_json() const;
-    QJsonObject printED117PFID_Ident_json() const;
-    QJsonObject printED117PFID_Mode3A_json() const;
-    QJsonObject printED117PLG_json() const;
-
+    PerfResults computeResults() const;
 
     TrackAssociator trkAssoc_;
 
+    RunConfig config_;
+
     quint8 pic_p95_ = 0;
+    QVector<quint64> picHistogram_;
+
+    // RPA errors kept for every PIC threshold, see setMergeable().
+    bool mergeable_ = false;
+
+    // Optional sink of per-report and per-sub-track records.
+    EvalDump *dump_ = nullptr;
 
+    AreaHash<TrafficPeriodBuilder> trafficPeriodBuilders_;
     AreaHash<TrafficPeriodCollection> trafficPeriods_;
 
-    AreaHash<QVector<double>> smrRpaErrors_;
-    AreaHash<QVector<double>> mlatRpaErrors_;
+    RpaErrorsByPic smrRpaErrorsByPic_;
+    RpaErrorsByPic mlatRpaErrorsByPic_;
+
+    // RPA errors at the PIC threshold, picked by finishRpa() in a
+    // mergeable evaluation.
+    AreaHash<ErrorAccumulator> smrRpaErrors_;
+    AreaHash<ErrorAccumulator> mlatRpaErrors_;
 
     AreaHash<Counters::UrCounter> smrUr_;
     AreaHash<Counters::UrCounter> mlatUr_;
@@ -114,6 +126,8 @@ private:
     AreaHash<Counters::PfidCounter> mlatPfidMode3A_;
 
     AreaHash<Counters::PlgCounter> mlatPlg_;
+
+    PerfResults results_;
 };
 
 #endif  // ASTMOPS_PERFEVALUATOR_H
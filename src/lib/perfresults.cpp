@@ -0,0 +1,223 @@
+/*!
+ * \file perfresults.cpp
+ * \brief Implementation of the PerfResults class and its renderers.
+ * \author Álvaro Cebrián Juan, 2020. acebrianjuan(at)gmail.com
+ *
+ * -----------------------------------------------------------------------
+ *
+ * Copyright (C) 2020-2021 Álvaro Cebrián Juan <acebrianjuan@gmail.com>
+ *
+ * ASTMOPS is a command line tool for evaluating 
+ * the performance of A-SMGCS sensors at airports
+ *
+ * This file is part of ASTMOPS.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -----------------------------------------------------------------------
+ */
+
+#include "perfresults.h"
+#include "jsonwriter.h"
+#include <QMap>
+
+#if (QT_VERSION < QT_VERSION_CHECK(5, 14, 0))
+namespace Qt
+{
+static const auto &endl = &::endl;
+static const auto &left = &::left;
+static const auto &right = &::right;
+}  // namespace Qt
+#endif
+
+PerfResults::PerfResults(const QVector<Metric> &metrics) : metrics_(metrics)
+{
+}
+
+const QVector<PerfResults::Metric> &PerfResults::metrics() const
+{
+    return metrics_;
+}
+
+/* ---------------------------- Free functions ---------------------------- */
+
+void printText(const PerfResults &results, QTextStream &out)
+{
+    out.setRealNumberPrecision(2);
+    out.setRealNumberNotation(QTextStream::FixedNotation);
+
+    const int nameWidth = 15;
+    const int nWidth = 6;
+
+    for (const PerfResults::Metric &metric : results.metrics())
+    {
+        const bool rpa = metric.kind == PerfResults::Kind::Rpa;
+
+        // Header and width of the columns between the area name and N.
+        QVector<QPair<QString, int>> columns;
+        if (rpa)
+        {
+            columns << qMakePair(QStringLiteral("P95 [m]"), 7)
+                    << qMakePair(QStringLiteral("P99 [m]"), 7)
+                    << qMakePair(QStringLiteral("Mean [m]"), 8)
+                    << qMakePair(QStringLiteral("SDev [m]"), 8);
+        }
+        else
+        {
+            const QString header = metric.label + QLatin1String(" [%]");
+            columns << qMakePair(header, qMax(7, header.size()));
+        }
+
+        int tableWidth = nameWidth + 1 + nWidth;
+        for (const auto &column : qAsConst(columns))
+        {
+            tableWidth += column.second + 1;
+        }
+
+        out << Qt::endl;
+
+        out.setFieldAlignment(QTextStream::AlignCenter);
+        out.setPadChar(QLatin1Char('-'));
+        out << qSetFieldWidth(tableWidth) << QStringLiteral("[ %1 ]").arg(metric.title) << qSetFieldWidth(0) << Qt::endl;
+        out.setPadChar(QLatin1Char(' '));
+
+        out << qSetFieldWidth(nameWidth) << "AREA";
+        for (const auto &column : qAsConst(columns))
+        {
+            out << qSetFieldWidth(1) << "" << qSetFieldWidth(column.second) << column.first;
+        }
+        out << qSetFieldWidth(1) << "" << qSetFieldWidth(nWidth) << "N"
+            << qSetFieldWidth(0) << Qt::endl;
+
+        out.setFieldAlignment(QTextStream::AlignRight);
+
+        out << qSetFieldWidth(nameWidth) << QString(nameWidth, QLatin1Char('-'));
+        for (const auto &column : qAsConst(columns))
+        {
+            out << qSetFieldWidth(1) << "" << qSetFieldWidth(column.second) << QString(column.second, QLatin1Char('-'));
+        }
+        out << qSetFieldWidth(1) << "" << qSetFieldWidth(nWidth) << QString(nWidth, QLatin1Char('-'))
+            << qSetFieldWidth(0) << Qt::endl;
+
+        auto printRow = [&](const QString &name, const PerfResults::Stats &stats) {
+            out << qSetFieldWidth(nameWidth) << Qt::left << name;
+
+            if (rpa)
+            {
+                out << qSetFieldWidth(1) << "" << qSetFieldWidth(7) << Qt::right << stats.p95
+                    << qSetFieldWidth(1) << "" << qSetFieldWidth(7) << Qt::right << stats.p99
+                    << qSetFieldWidth(1) << "" << qSetFieldWidth(8) << Qt::right << stats.mean
+                    << qSetFieldWidth(1) << "" << qSetFieldWidth(8) << Qt::right << stats.stdDev;
+            }
+            else
+            {
+                out << qSetFieldWidth(1) << "" << qSetFieldWidth(columns.first().second) << Qt::right << stats.percent;
+            }
+
+            out << qSetFieldWidth(1) << "" << qSetFieldWidth(nWidth) << Qt::right << stats.n
+                << qSetFieldWidth(0) << Qt::endl;
+        };
+
+        for (const PerfResults::AreaResult &area : metric.areas)
+        {
+            for (const auto &subArea : area.subAreas)
+            {
+                printRow(subArea.first, subArea.second);
+            }
+
+            printRow(area.name, area.total);
+
+            out << Qt::endl;
+        }
+    }
+}
+
+/*!
+ * \brief Streams the results as JSON, with the same layout and key order
+ * that serializing them through QJsonObject gave.
+ */
+void printJson(const PerfResults &results, QIODevice *device)
+{
+    JsonWriter json(device);
+
+    // Statistic keys all start with an uppercase letter, so writing them
+    // sorted and then "subAreas" keeps the whole object in key order.
+    auto writeStats = [&json](const PerfResults::Metric &metric, const PerfResults::Stats &stats) {
+        QMap<QString, QJsonValue> members;
+        if (metric.kind == PerfResults::Kind::Rpa)
+        {
+            members.insert(QStringLiteral("P95"), stats.p95);
+            members.insert(QStringLiteral("P99"), stats.p99);
+            members.insert(QStringLiteral("Mean"), stats.mean);
+            members.insert(QStringLiteral("StdDev"), stats.stdDev);
+        }
+        else
+        {
+            members.insert(metric.label, stats.percent);
+        }
+        members.insert(QStringLiteral("N"), stats.n);
+
+        for (auto it = members.cbegin(); it != members.cend(); ++it)
+        {
+            json.writeMember(it.key(), it.value());
+        }
+    };
+
+    QMap<QString, const PerfResults::Metric *> metrics;
+    for (const PerfResults::Metric &metric : results.metrics())
+    {
+        metrics.insert(metric.id, &metric);
+    }
+
+    json.beginObject();
+
+    for (auto mit = metrics.cbegin(); mit != metrics.cend(); ++mit)
+    {
+        const PerfResults::Metric &metric = *mit.value();
+
+        QMap<QString, const PerfResults::AreaResult *> areas;
+        for (const PerfResults::AreaResult &area : metric.areas)
+        {
+            areas.insert(area.name, &area);
+        }
+
+        json.writeKey(metric.id);
+        json.beginObject();
+
+        for (auto ait = areas.cbegin(); ait != areas.cend(); ++ait)
+        {
+            const PerfResults::AreaResult &area = *ait.value();
+
+            // Same sub-area name twice: the last one wins, as in QJsonObject.
+            QMap<QString, const PerfResults::Stats *> subAreas;
+            for (const auto &subArea : area.subAreas)
+            {
+                subAreas.insert(subArea.first, &subArea.second);
+            }
+
+            json.writeKey(area.name);
+            json.beginObject();
+
+            writeStats(metric, area.total);
+
+            json.writeKey(QStringLiteral("subAreas"));
+            json.beginObject();
+            for (auto sit = subAreas.cbegin(); sit != subAreas.cend(); ++sit)
+            {
+                json.writeKey(sit.key());
+                json.beginObject();
+                writeStats(metric, *sit.value());
+                json.endObject();
+            }
+            json.endObject();
+
+            json.endObject();
+        }
+
+        json.endObject();
+    }
+
+    json.writeMember(QStringLiteral("type"), QStringLiteral("astmops 1.0"));
+
+    json.endObject();
+}
@@ -0,0 +1,88 @@
+/*!
+ * \file perfresults.h
+ * \brief Interface of the PerfResults class and its renderers.
+ * \author Álvaro Cebrián Juan, 2020. acebrianjuan(at)gmail.com
+ *
+ * -----------------------------------------------------------------------
+ *
+ * Copyright (C) 2020-2021 Álvaro Cebrián Juan <acebrianjuan@gmail.com>
+ *
+ * ASTMOPS is a command line tool for evaluating 
+ * the performance of A-SMGCS sensors at airports
+ *
+ * This file is part of ASTMOPS.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -----------------------------------------------------------------------
+ */
+
+#ifndef ASTMOPS_PERFRESULTS_H
+#define ASTMOPS_PERFRESULTS_H
+
+#include <QIODevice>
+#include <QPair>
+#include <QString>
+#include <QTextStream>
+#include <QVector>
+
+/*!
+ * \brief The PerfResults class holds the final figures of an evaluation,
+ * computed once, so that every output format is just a renderer over it.
+ *
+ * Results are grouped by metric, then by area (with its total) and then
+ * by sub-area, in output order.
+ */
+class PerfResults
+{
+public:
+    enum class Kind
+    {
+        Rpa,   // Position accuracy statistics, in meters.
+        Ratio  // A single ratio, in percent.
+    };
+
+    struct Stats
+    {
+        // Kind::Rpa.
+        double p95 = qSNaN();
+        double p99 = qSNaN();
+        double mean = qSNaN();
+        double stdDev = qSNaN();
+
+        // Kind::Ratio.
+        double percent = qSNaN();
+
+        qint64 n = 0;
+    };
+
+    struct AreaResult
+    {
+        QString name;
+        QVector<QPair<QString, Stats>> subAreas;
+        Stats total;
+    };
+
+    struct Metric
+    {
+        QString id;     // JSON key, e.g. "ED116PFD".
+        QString title;  // Table title, e.g. "ED-116 PFD".
+        QString label;  // Ratio name, e.g. "PFD". Empty for Kind::Rpa.
+        Kind kind = Kind::Ratio;
+        QVector<AreaResult> areas;
+    };
+
+    PerfResults() = default;
+    explicit PerfResults(const QVector<Metric> &metrics);
+
+    const QVector<Metric> &metrics() const;
+
+private:
+    QVector<Metric> metrics_;
+};
+
+// RENDERERS.
+void printText(const PerfResults &results, QTextStream &out);
+void printJson(const PerfResults &results, QIODevice *device);
+
+#endif  // ASTMOPS_PERFRESULTS_H
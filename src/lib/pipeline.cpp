@@ -0,0 +1,339 @@
+/*!
+ * \file pipeline.cpp
+ * \brief Implementation of the Pipeline class.
+ * \author Álvaro Cebrián Juan, 2020. acebrianjuan(at)gmail.com
+ *
+ * -----------------------------------------------------------------------
+ *
+ * Copyright (C) 2020-2021 Álvaro Cebrián Juan <acebrianjuan@gmail.com>
+ *
+ * ASTMOPS is a command line tool for evaluating 
+ * the performance of A-SMGCS sensors at airports
+ *
+ * This file is part of ASTMOPS.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -----------------------------------------------------------------------
+ */
+
+#include "pipeline.h"
+#include "asterixxmlreader.h"
+#include "dgpscsvreader.h"
+#include "perfevaluator.h"
+#include "pipelinedextraction.h"
+#include "profiler.h"
+#include "segmentedextraction.h"
+#include "targetreportextractor.h"
+#include "trackcache.h"
+#include "trackextractor.h"
+#include <QFile>
+#include <memory>
+
+namespace
+{
+// DGPS positions passed to the target report extractor at once.
+const int batchSize = 1024;
+
+// Bytes of ASTERIX XML lines passed to the reader at once.
+const int xmlChunkSize = 64 * 1024;
+}  // namespace
+
+Pipeline::Pipeline(const RunConfig &config, const Aerodrome &aerodrome)
+    : config_(config), aerodrome_(aerodrome)
+{
+}
+
+/*!
+ * \brief Sets the KML file the aerodrome was built from. Only used to key
+ * the track cache.
+ */
+void Pipeline::setKmlFile(const QString &path)
+{
+    kmlPath_ = path;
+}
+
+/*!
+ * \brief Sets the DGPS CSV reference read in DGPS mode.
+ */
+void Pipeline::setDgpsFile(const QString &path)
+{
+    dgpsPath_ = path;
+}
+
+/*!
+ * \brief Enables the track cache in \a dir. Empty disables it.
+ */
+void Pipeline::setCacheDir(const QString &dir)
+{
+    cacheDir_ = dir;
+}
+
+/*!
+ * \brief Restricts the evaluation to the shard \a index of \a count,
+ * see shardOf(). The default, shard 0 of 1, evaluates all the traffic.
+ */
+void Pipeline::setShard(int index, int count)
+{
+    Q_ASSERT(count > 0 && index >= 0 && index < count);
+
+    shardIndex_ = index;
+    shardCount_ = count;
+}
+
+/*!
+ * \brief Splits recordings read from a file into \a segments time segments
+ * whose target reports are extracted in parallel, see
+ * streamSegmentedTargetReports(). The tracks and the results are the
+ * same as with a single segment, the default.
+ */
+void Pipeline::setSegments(int segments)
+{
+    Q_ASSERT(segments > 0);
+
+    segments_ = segments;
+}
+
+/*!
+ * \brief Runs the reading, the target report extraction and the track
+ * building of a recording on separate threads when \a pipelined is true,
+ * see streamPipelinedTargetReports(). Segmented extraction takes
+ * precedence when both are set.
+ */
+void Pipeline::setPipelined(bool pipelined)
+{
+    pipelined_ = pipelined;
+}
+
+/*!
+ * \brief Returns the shard of \a count that the target \a addr belongs to.
+ *
+ * The addresses are mixed with a multiplicative hash, as ICAO addresses
+ * are allocated in blocks per country and would not spread evenly
+ * modulo \a count. The result depends only on \a addr and \a count, so
+ * it is the same on every machine.
+ */
+int Pipeline::shardOf(ModeS addr, int count)
+{
+    const quint32 h = addr * 2654435761u;  // Knuth's multiplicative hash.
+    return static_cast<int>((static_cast<quint64>(h) * static_cast<quint64>(count)) >> 32);
+}
+
+/*!
+ * \brief Returns true if \a t is needed to evaluate the current shard.
+ *
+ * Association and evaluation are done per Mode-S address, so reference
+ * and MLAT tracks are only kept in the shard of their address. SMR tracks
+ * and tracks without an address are matched by position against every
+ * reference, so every shard keeps them.
+ */
+bool Pipeline::inShard(const Track &t) const
+{
+    if (shardCount_ == 1 || t.system_type() == SystemType::Smr || !t.mode_s().has_value())
+    {
+        return true;
+    }
+
+    return shardOf(t.mode_s().value(), shardCount_) == shardIndex_;
+}
+
+/*!
+ * \brief Evaluates the ASTERIX XML recording at \a inputPath, or the one
+ * read from stdin if it is empty, and returns its results. Intermediate
+ * records are written to \a dump and the mergeable evaluation state to
+ * \a state when given.
+ *
+ * Returns std::nullopt if the recording cannot be opened or the state
+ * cannot be written.
+ */
+std::optional<PerfResults> Pipeline::evaluate(const QString &inputPath, EvalDump *dump,
+    QIODevice *state) const
+{
+    QFile astXmlFile;
+    if (!inputPath.isEmpty())
+    {
+        astXmlFile.setFileName(inputPath);
+        if (!astXmlFile.open(QIODevice::ReadOnly))
+        {
+            qWarning() << "Could not open" << inputPath;
+            return std::nullopt;
+        }
+    }
+    else  // stdin
+    {
+        astXmlFile.open(stdin, QIODevice::ReadOnly);
+    }
+
+    const Aerodrome &aerodrome = aerodrome_;
+    auto locateCallback = [&aerodrome](const QVector3D cartPos, const bool gndBit) {
+        return aerodrome.locatePoint(cartPos, gndBit);
+    };
+
+    AsterixXmlReader astXmlReader(config_);
+
+    TargetReportExtractor tgtRepExtr(config_, aerodrome_.arp(), aerodrome_.smr());
+    tgtRepExtr.setLocatePointCallback(locateCallback);
+
+    TrackExtractor trackExtr(config_);
+
+    // The stages hand over everything they have pending at once, and are
+    // signalled once per batch of lines or positions, not per record.
+    // The buffers are reused: resize(0) keeps their capacity.
+    QVector<Asterix::Record> records;
+    QVector<TargetReport> tgtReps;
+
+    QObject::connect(&astXmlReader, &AsterixXmlReader::readyRead, [&]() {
+        astXmlReader.takeAll(records);
+        tgtRepExtr.addData(records);
+        records.resize(0);
+    });
+
+    QObject::connect(&tgtRepExtr, &TargetReportExtractor::readyRead, [&]() {
+        tgtRepExtr.takeAll(tgtReps);
+        trackExtr.addData(tgtReps);
+        tgtReps.resize(0);
+    });
+
+    PerfEvaluator perfEval(config_);
+
+    // Optional cache of the extracted tracks, keyed by the input files and
+    // the extraction settings. Not available when reading from stdin.
+    std::unique_ptr<TrackCache> trackCache;
+    QByteArray cacheKey;
+
+    if (!cacheDir_.isEmpty() && !inputPath.isEmpty())
+    {
+        trackCache = std::make_unique<TrackCache>(cacheDir_);
+        cacheKey = TrackCache::extractionKey(config_, inputPath, kmlPath_, dgpsPath_);
+    }
+
+    // The cache stores every track, so that it is shared by all shards.
+    auto addTrack = [this, &perfEval](const Track &t) {
+        if (inShard(t))
+        {
+            perfEval.addData(t);
+        }
+    };
+
+    if (trackCache && trackCache->load(cacheKey, addTrack))
+    {
+        qInfo() << "Tracks loaded from cache.";
+    }
+    else
+    {
+        if (trackCache)
+        {
+            trackCache->beginStore(cacheKey);
+        }
+
+        // DGPS CSV reference.
+        if (config_.mode == ProcessingMode::Dgps)
+        {
+            DgpsTargetData dgps;
+            dgps.mode_s_ = config_.dgpsModeS;
+            dgps.mode_3a_ = config_.dgpsMode3A;
+            dgps.ident_ = config_.dgpsIdent;
+            dgps.tod_offset_ = config_.dgpsTodOffset;
+
+            // Feed the positions to the extractor in batches as they are
+            // parsed.
+            Profiler::ScopedTimer timer(Profiler::Stage::DgpsRead, 0);
+            qint64 n_pos = 0;
+
+            QVector<QGeoPositionInfo> positions;
+            positions.reserve(batchSize);
+
+            streamDgpsCsvFile(dgpsPath_, config_.dgpsParseThreads,
+                [&tgtRepExtr, &dgps, &n_pos, &positions](const QGeoPositionInfo &pi) {
+                    positions.append(pi);
+                    ++n_pos;
+
+                    if (positions.size() == batchSize)
+                    {
+                        tgtRepExtr.addDgpsData(dgps, positions);
+                        positions.resize(0);
+                    }
+                });
+
+            tgtRepExtr.addDgpsData(dgps, positions);
+
+            timer.setItems(n_pos);
+        }
+
+        // ASTERIX XML.
+        auto addTargetReport = [&trackExtr](const TargetReport &tr) {
+            trackExtr.addData(tr);
+        };
+
+        if (segments_ > 1 && !inputPath.isEmpty())
+        {
+            if (!streamSegmentedTargetReports(inputPath, segments_, config_, aerodrome_,
+                    addTargetReport))
+            {
+                return std::nullopt;
+            }
+        }
+        else if (pipelined_)
+        {
+            streamPipelinedTargetReports(&astXmlFile, config_, aerodrome_, addTargetReport);
+        }
+        else
+        {
+            QByteArray lines;
+            while (!astXmlFile.atEnd())
+            {
+                Profiler::ScopedTimer timer(Profiler::Stage::XmlRead, 0);
+
+                // Whole lines, up to xmlChunkSize bytes.
+                lines.resize(0);
+                while (lines.size() < xmlChunkSize && !astXmlFile.atEnd())
+                {
+                    lines.append(astXmlFile.readLine());
+                }
+                timer.setItems(lines.size());
+
+                astXmlReader.addData(lines);
+            }
+        }
+
+        while (trackExtr.hasPendingData())
+        {
+            std::optional<Track> trk_opt = trackExtr.takeData();
+            if (trk_opt.has_value())
+            {
+                addTrack(trk_opt.value());
+
+                if (trackCache)
+                {
+                    trackCache->store(trk_opt.value());
+                }
+            }
+        }
+
+        if (trackExtr.watermarks().lateCount() > 0)
+        {
+            qInfo() << "Late target reports discarded:"
+                    << qPrintable(trackExtr.watermarks().lateSummary());
+        }
+
+        if (trackCache)
+        {
+            trackCache->commit();
+        }
+    }
+
+    // Only a saved state needs the RPA errors of every PIC threshold.
+    perfEval.setMergeable(state != nullptr);
+    perfEval.setDump(dump);
+    perfEval.evaluate();
+
+    if (state && !perfEval.saveState(state))
+    {
+        qWarning() << "Could not write the evaluation state";
+        return std::nullopt;
+    }
+
+    perfEval.finish();
+
+    return perfEval.results();
+}
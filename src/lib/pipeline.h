@@ -0,0 +1,82 @@
+/*!
+ * \file pipeline.h
+ * \brief Interface of the Pipeline class.
+ * \author Álvaro Cebrián Juan, 2020. acebrianjuan(at)gmail.com
+ *
+ * -----------------------------------------------------------------------
+ *
+ * Copyright (C) 2020-2021 Álvaro Cebrián Juan <acebrianjuan@gmail.com>
+ *
+ * ASTMOPS is a command line tool for evaluating 
+ * the performance of A-SMGCS sensors at airports
+ *
+ * This file is part of ASTMOPS.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -----------------------------------------------------------------------
+ */
+
+#ifndef ASTMOPS_PIPELINE_H
+#define ASTMOPS_PIPELINE_H
+
+#include "aerodrome.h"
+#include "astmops.h"
+#include "config.h"
+#include "evaldump.h"
+#include "perfresults.h"
+#include "track.h"
+#include <QString>
+#include <optional>
+
+/*!
+ * \brief The Pipeline class evaluates one ASTERIX XML recording end to
+ * end: XML reading, target report and track extraction (or loading the
+ * tracks from the track cache) and performance evaluation.
+ *
+ * The settings and the aerodrome are kept by value and only read, so a
+ * single Pipeline evaluates any number of recordings, also concurrently
+ * from several threads. Every call to evaluate() builds its own reader,
+ * extractors and evaluator.
+ *
+ * With setShard() only one Mode-S shard of the traffic is evaluated, so
+ * that several processes, possibly on several machines, can share the
+ * evaluation of a recording and merge their states afterwards. With
+ * setSegments() the target reports of a recording are extracted from
+ * several time segments in parallel.
+ */
+class Pipeline
+{
+public:
+    Pipeline(const RunConfig &config, const Aerodrome &aerodrome);
+
+    void setKmlFile(const QString &path);
+    void setDgpsFile(const QString &path);
+    void setCacheDir(const QString &dir);
+    void setShard(int index, int count);
+    void setSegments(int segments);
+    void setPipelined(bool pipelined);
+
+    static int shardOf(ModeS addr, int count);
+
+    std::optional<PerfResults> evaluate(const QString &inputPath, EvalDump *dump = nullptr,
+        QIODevice *state = nullptr) const;
+
+private:
+    RunConfig config_;
+    Aerodrome aerodrome_;
+
+    QString kmlPath_;
+    QString dgpsPath_;
+    QString cacheDir_;
+
+    int shardIndex_ = 0;
+    int shardCount_ = 1;
+
+    int segments_ = 1;
+    bool pipelined_ = false;
+
+    bool inShard(const Track &t) const;
+};
+
+#endif  // ASTMOPS_PIPELINE_H
@@ -0,0 +1,181 @@
+/*!
+ * \file pipelinedextraction.cpp
+ * \brief Multi-threaded target report extraction of a recording.
+ * \author Álvaro Cebrián Juan, 2020. acebrianjuan(at)gmail.com
+ *
+ * -----------------------------------------------------------------------
+ *
+ * Copyright (C) 2020-2021 Álvaro Cebrián Juan <acebrianjuan@gmail.com>
+ *
+ * ASTMOPS is a command line tool for evaluating 
+ * the performance of A-SMGCS sensors at airports
+ *
+ * This file is part of ASTMOPS.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -----------------------------------------------------------------------
+ */
+
+#include "pipelinedextraction.h"
+#include "asterixxmlreader.h"
+#include "profiler.h"
+#include "spscqueue.h"
+#include "targetreportextractor.h"
+#include <QThread>
+#include <memory>
+
+namespace
+{
+using RecordBatch = QVector<Asterix::Record>;
+using TargetReportBatch = QVector<TargetReport>;
+
+// Pushes a batch, accounting the time waited on a full queue.
+template <typename T>
+void pushBatch(SpscQueue<T> &queue, T &batch, int batchSize)
+{
+    if (!queue.tryPush(std::move(batch)))
+    {
+        Profiler::ScopedTimer timer(Profiler::Stage::QueueWait, 0);
+        queue.push(std::move(batch));
+    }
+
+    batch = T();
+    batch.reserve(batchSize);
+}
+
+// Pops a batch, accounting the time waited on an empty queue. Returns
+// std::nullopt at the end of the stream.
+template <typename T>
+std::optional<T> popBatch(SpscQueue<T> &queue)
+{
+    std::optional<T> batch = queue.tryPop();
+    if (!batch.has_value())
+    {
+        Profiler::ScopedTimer timer(Profiler::Stage::QueueWait, 0);
+        batch = queue.pop();
+    }
+
+    return batch;
+}
+}  // namespace
+
+/* ---------------------------- Free functions ---------------------------- */
+
+/*!
+ * \brief Extracts the target reports of the ASTERIX XML recording read
+ * from \a device with each stage on its own thread.
+ *
+ * One thread reads and decodes the XML records, another one extracts the
+ * target reports and classifies them by area, and the calling thread
+ * passes them to \a callback, usually track building. The stages are
+ * connected by bounded SpscQueue objects that carry batches of records
+ * or target reports, so a slow stage holds back the ones before it
+ * instead of letting the buffers grow. The time every stage waits on a
+ * queue is reported as the QueueWait stage of the profiler.
+ *
+ * Records and target reports are passed between the stages in batches of
+ * \a batchSize, so that the cost of the queue operations is shared by
+ * many items. A stage that gets \a queueCapacity batches ahead of the
+ * next one waits.
+ *
+ * Target reports are passed to \a callback in the same order as in a
+ * single-threaded run.
+ */
+void streamPipelinedTargetReports(QIODevice *device, const RunConfig &config,
+    const Aerodrome &aerodrome, const TargetReportCallback &callback, int batchSize,
+    int queueCapacity)
+{
+    SpscQueue<RecordBatch> records(queueCapacity);
+    SpscQueue<TargetReportBatch> reports(queueCapacity);
+
+    // Ingest and decode.
+    std::unique_ptr<QThread> reader(QThread::create([device, &config, &records, batchSize]() {
+        AsterixXmlReader astXmlReader(config);
+
+        RecordBatch batch;
+        batch.reserve(batchSize);
+
+        while (!device->atEnd())
+        {
+            {
+                Profiler::ScopedTimer timer(Profiler::Stage::XmlRead, 0);
+
+                const QByteArray line = device->readLine();
+                timer.setItems(line.size());
+
+                astXmlReader.addData(line);
+            }
+
+            while (astXmlReader.hasPendingData())
+            {
+                batch.append(astXmlReader.takeData().value());
+            }
+
+            if (batch.size() >= batchSize)
+            {
+                pushBatch(records, batch, batchSize);
+            }
+        }
+
+        if (!batch.isEmpty())
+        {
+            pushBatch(records, batch, batchSize);
+        }
+
+        records.close();
+    }));
+
+    // Target report extraction and area classification.
+    std::unique_ptr<QThread> extractor(QThread::create([&config, &aerodrome, &records, &reports, batchSize]() {
+        TargetReportExtractor tgtRepExtr(config, aerodrome.arp(), aerodrome.smr());
+        tgtRepExtr.setLocatePointCallback([&aerodrome](const QVector3D cartPos, const bool gndBit) {
+            return aerodrome.locatePoint(cartPos, gndBit);
+        });
+
+        TargetReportBatch batch;
+        batch.reserve(batchSize);
+
+        while (std::optional<RecordBatch> in = popBatch(records))
+        {
+            // Drained record by record, so that the target reports come
+            // out in the same order as in a single-threaded run.
+            for (const Asterix::Record &rec : qAsConst(in.value()))
+            {
+                tgtRepExtr.addData(rec);
+
+                while (tgtRepExtr.hasPendingData())
+                {
+                    batch.append(tgtRepExtr.takeData().value());
+                }
+            }
+
+            if (batch.size() >= batchSize)
+            {
+                pushBatch(reports, batch, batchSize);
+            }
+        }
+
+        if (!batch.isEmpty())
+        {
+            pushBatch(reports, batch, batchSize);
+        }
+
+        reports.close();
+    }));
+
+    reader->start();
+    extractor->start();
+
+    // Track building, on the calling thread.
+    while (std::optional<TargetReportBatch> in = popBatch(reports))
+    {
+        for (const TargetReport &tr : qAsConst(in.value()))
+        {
+            callback(tr);
+        }
+    }
+
+    reader->wait();
+    extractor->wait();
+}
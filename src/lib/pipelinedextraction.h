@@ -0,0 +1,32 @@
+/*!
+ * \file pipelinedextraction.h
+ * \brief Multi-threaded target report extraction of a recording.
+ * \author Álvaro Cebrián Juan, 2020. acebrianjuan(at)gmail.com
+ *
+ * -----------------------------------------------------------------------
+ *
+ * Copyright (C) 2020-2021 Álvaro Cebrián Juan <acebrianjuan@gmail.com>
+ *
+ * ASTMOPS is a command line tool for evaluating 
+ * the performance of A-SMGCS sensors at airports
+ *
+ * This file is part of ASTMOPS.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -----------------------------------------------------------------------
+ */
+
+#ifndef ASTMOPS_PIPELINEDEXTRACTION_H
+#define ASTMOPS_PIPELINEDEXTRACTION_H
+
+#include "aerodrome.h"
+#include "config.h"
+#include "targetreport.h"
+#include <QIODevice>
+
+void streamPipelinedTargetReports(QIODevice *device, const RunConfig &config,
+    const Aerodrome &aerodrome, const TargetReportCallback &callback, int batchSize = 256,
+    int queueCapacity = 64);
+
+#endif  // ASTMOPS_PIPELINEDEXTRACTION_H
@@ -0,0 +1,244 @@
+/*!
+ * \file poolqueue.h
+ * \brief FIFO queue with pooled block storage.
+ * \author Álvaro Cebrián Juan, 2020. acebrianjuan(at)gmail.com
+ *
+ * -----------------------------------------------------------------------
+ *
+ * Copyright (C) 2020-2021 Álvaro Cebrián Juan <acebrianjuan@gmail.com>
+ *
+ * ASTMOPS is a command line tool for evaluating 
+ * the performance of A-SMGCS sensors at airports
+ *
+ * This file is part of ASTMOPS.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -----------------------------------------------------------------------
+ */
+
+#ifndef ASTMOPS_POOLQUEUE_H
+#define ASTMOPS_POOLQUEUE_H
+
+#include <QQueue>
+#include <QtGlobal>
+#include <deque>
+#include <memory>
+#include <utility>
+#include <vector>
+
+/*!
+ * \brief The PoolQueue class is an unbounded FIFO queue that stores its
+ * items in fixed-size blocks drawn from a pool owned by the queue.
+ *
+ * QQueue allocates a heap node for every item larger than a pointer, so
+ * queuing millions of records or target reports means millions of small
+ * allocations and frees. PoolQueue allocates a block of blockSize items
+ * at a time and returns drained blocks to its pool instead of freeing
+ * them, so a queue that is filled and drained repeatedly stops
+ * allocating once its pool covers the largest backlog. All the blocks
+ * are released together when the queue is destroyed or released.
+ *
+ * It only backs the queues of AsterixXmlReader and TargetReportExtractor.
+ * Tracks, track collections and sets keep their Qt containers, which
+ * take no allocator, so they still allocate every node from the heap.
+ */
+template <typename T>
+class PoolQueue
+{
+public:
+    static constexpr int blockSize = 256;
+
+    PoolQueue() = default;
+
+    PoolQueue(const PoolQueue &other)
+    {
+        for (int i = 0; i < other.size(); ++i)
+        {
+            enqueue(other.at(i));
+        }
+    }
+
+    PoolQueue(PoolQueue &&other) noexcept
+    {
+        swap(other);
+    }
+
+    PoolQueue &operator=(PoolQueue other) noexcept
+    {
+        swap(other);
+
+        return *this;
+    }
+
+    void swap(PoolQueue &other) noexcept
+    {
+        std::swap(blocks_, other.blocks_);
+        std::swap(pool_, other.pool_);
+        std::swap(head_, other.head_);
+        std::swap(tail_, other.tail_);
+        std::swap(size_, other.size_);
+    }
+
+    int size() const
+    {
+        return size_;
+    }
+
+    bool isEmpty() const
+    {
+        return size_ == 0;
+    }
+
+    /*!
+     * \brief Returns the number of blocks allocated by the queue, both in
+     * use and pooled.
+     */
+    int blockCount() const
+    {
+        return static_cast<int>(blocks_.size() + pool_.size());
+    }
+
+    void enqueue(T value)
+    {
+        if (blocks_.empty() || tail_ == blockSize)
+        {
+            blocks_.push_back(takeBlock());
+            tail_ = 0;
+        }
+
+        blocks_.back()[tail_++] = std::move(value);
+        ++size_;
+    }
+
+    /*!
+     * \brief Removes and returns the oldest item. The queue must not be
+     * empty.
+     */
+    T dequeue()
+    {
+        Q_ASSERT(size_ > 0);
+
+        T &slot = blocks_.front()[head_];
+        T value = std::move(slot);
+        slot = T();  // Releases whatever the moved-from item still holds.
+
+        ++head_;
+        --size_;
+
+        if (size_ == 0)
+        {
+            recycleBlocks();
+        }
+        else if (head_ == blockSize)
+        {
+            pool_.push_back(std::move(blocks_.front()));
+            blocks_.pop_front();
+            head_ = 0;
+        }
+
+        return value;
+    }
+
+    const T &head() const
+    {
+        Q_ASSERT(size_ > 0);
+
+        return blocks_.front()[head_];
+    }
+
+    /*!
+     * \brief Returns the item at position \a i, counting from the oldest.
+     */
+    const T &at(int i) const
+    {
+        Q_ASSERT(i >= 0 && i < size_);
+
+        const int pos = head_ + i;
+        return blocks_[static_cast<size_t>(pos / blockSize)][pos % blockSize];
+    }
+
+    QQueue<T> toQueue() const
+    {
+        QQueue<T> queue;
+        queue.reserve(size_);
+
+        for (int i = 0; i < size_; ++i)
+        {
+            queue.enqueue(at(i));
+        }
+
+        return queue;
+    }
+
+    /*!
+     * \brief Removes all the items, keeping the blocks in the pool.
+     */
+    void clear()
+    {
+        while (size_ > 0)
+        {
+            T &slot = blocks_.front()[head_];
+            slot = T();
+
+            ++head_;
+            --size_;
+
+            if (head_ == blockSize && size_ > 0)
+            {
+                pool_.push_back(std::move(blocks_.front()));
+                blocks_.pop_front();
+                head_ = 0;
+            }
+        }
+
+        recycleBlocks();
+    }
+
+    /*!
+     * \brief Removes all the items and frees every block.
+     */
+    void release()
+    {
+        clear();
+        pool_.clear();
+        pool_.shrink_to_fit();
+    }
+
+private:
+    using Block = std::unique_ptr<T[]>;
+
+    Block takeBlock()
+    {
+        if (pool_.empty())
+        {
+            return std::make_unique<T[]>(blockSize);
+        }
+
+        Block block = std::move(pool_.back());
+        pool_.pop_back();
+
+        return block;
+    }
+
+    void recycleBlocks()
+    {
+        for (Block &block : blocks_)
+        {
+            pool_.push_back(std::move(block));
+        }
+
+        blocks_.clear();
+        head_ = 0;
+        tail_ = 0;
+    }
+
+    std::deque<Block> blocks_;
+    std::vector<Block> pool_;
+
+    int head_ = 0;  // Position of the oldest item in the first block.
+    int tail_ = 0;  // Position past the newest item in the last block.
+    int size_ = 0;
+};
+
+#endif  // ASTMOPS_POOLQUEUE_H
@@ -0,0 +1,449 @@
+/*!
+ * \file profiler.cpp
+ * \brief Implementation of the run profiler.
+ * \author Álvaro Cebrián Juan, 2020. acebrianjuan(at)gmail.com
+ *
+ * -----------------------------------------------------------------------
+ *
+ * Copyright (C) 2020-2021 Álvaro Cebrián Juan <acebrianjuan@gmail.com>
+ *
+ * ASTMOPS is a command line tool for evaluating 
+ * the performance of A-SMGCS sensors at airports
+ *
+ * This file is part of ASTMOPS.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -----------------------------------------------------------------------
+ */
+
+#include "profiler.h"
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <atomic>
+#include <chrono>
+
+#ifdef Q_OS_UNIX
+#include <sys/resource.h>
+#include <time.h>
+#endif
+
+#if (QT_VERSION < QT_VERSION_CHECK(5, 14, 0))
+namespace Qt
+{
+static const auto &endl = &::endl;
+static const auto &left = &::left;
+static const auto &right = &::right;
+}  // namespace Qt
+#endif
+
+using namespace Profiler;
+
+namespace
+{
+std::atomic<bool> enabled{false};
+
+QElapsedTimer runTimer;
+
+struct ThreadData;
+
+// Counters of the running threads and totals of the finished ones.
+struct Registry
+{
+    QMutex mutex;
+    QVector<ThreadData *> threads;
+    StageStats finished[stageCount];
+};
+
+Registry &registry()
+{
+    static Registry r;
+    return r;
+}
+
+void accumulate(StageStats &to, const StageStats &from)
+{
+    to.calls += from.calls;
+    to.items += from.items;
+    to.wallNs += from.wallNs;
+    to.cpuNs += from.cpuNs;
+}
+
+struct ThreadData
+{
+    ThreadData()
+    {
+        QMutexLocker locker(&registry().mutex);
+        registry().threads.append(this);
+    }
+
+    ~ThreadData()
+    {
+        QMutexLocker locker(&registry().mutex);
+        for (int i = 0; i < stageCount; ++i)
+        {
+            accumulate(registry().finished[i], stats[i]);
+        }
+        registry().threads.removeOne(this);
+    }
+
+    StageStats stats[stageCount];
+    ScopedTimer *current = nullptr;
+};
+
+ThreadData &threadData()
+{
+    thread_local ThreadData data;
+    return data;
+}
+
+qint64 wallNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+qint64 threadCpuNs()
+{
+#ifdef Q_OS_UNIX
+    timespec ts;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) == 0)
+    {
+        return static_cast<qint64>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+    }
+#endif
+    return 0;
+}
+
+// Whole-process figures of the run.
+struct RunStats
+{
+    double wallS = 0;
+    double cpuS = 0;
+    qint64 peakRssBytes = 0;
+};
+
+RunStats runStats()
+{
+    RunStats rs;
+    rs.wallS = runTimer.isValid() ? runTimer.nsecsElapsed() / 1e9 : 0;
+
+#ifdef Q_OS_UNIX
+    rusage ru;
+    if (getrusage(RUSAGE_SELF, &ru) == 0)
+    {
+        rs.cpuS = ru.ru_utime.tv_sec + ru.ru_utime.tv_usec / 1e6 +
+                  ru.ru_stime.tv_sec + ru.ru_stime.tv_usec / 1e6;
+#ifdef Q_OS_MACOS
+        rs.peakRssBytes = ru.ru_maxrss;  // Bytes.
+#else
+        rs.peakRssBytes = static_cast<qint64>(ru.ru_maxrss) * 1024;  // KiB.
+#endif
+    }
+#endif
+
+    return rs;
+}
+
+double throughput(const StageStats &stats)
+{
+    return stats.wallNs > 0 ? stats.items / (stats.wallNs / 1e9) : 0;
+}
+
+}  // namespace
+
+/* ------------------------------ ScopedTimer ----------------------------- */
+
+ScopedTimer::ScopedTimer(Stage stage, qint64 items) : stage_(stage), items_(items)
+{
+    if (!enabled.load(std::memory_order_relaxed))
+    {
+        return;
+    }
+
+    ThreadData &data = threadData();
+    parent_ = data.current;
+    data.current = this;
+
+    active_ = true;
+    startCpuNs_ = threadCpuNs();
+    startWallNs_ = wallNs();
+}
+
+ScopedTimer::~ScopedTimer()
+{
+    if (!active_)
+    {
+        return;
+    }
+
+    const qint64 wall = wallNs() - startWallNs_;
+    const qint64 cpu = threadCpuNs() - startCpuNs_;
+
+    ThreadData &data = threadData();
+
+    StageStats &stats = data.stats[static_cast<int>(stage_)];
+    ++stats.calls;
+    stats.items += items_;
+    stats.wallNs += wall - childWallNs_;
+    stats.cpuNs += cpu - childCpuNs_;
+
+    if (parent_)
+    {
+        parent_->childWallNs_ += wall;
+        parent_->childCpuNs_ += cpu;
+    }
+
+    data.current = parent_;
+}
+
+void ScopedTimer::setItems(qint64 items)
+{
+    items_ = items;
+}
+
+/* ---------------------------- Free functions ---------------------------- */
+
+/*!
+ * \brief Turns profiling on or off. Turning it on also starts the clock of
+ * the whole run.
+ */
+void Profiler::setEnabled(bool enable)
+{
+    if (enable && !runTimer.isValid())
+    {
+        runTimer.start();
+    }
+
+    enabled.store(enable, std::memory_order_relaxed);
+}
+
+bool Profiler::isEnabled()
+{
+    return enabled.load(std::memory_order_relaxed);
+}
+
+/*!
+ * \brief Clears the statistics of all threads. Must not be called while
+ * other threads are being measured.
+ */
+void Profiler::reset()
+{
+    Registry &r = registry();
+    QMutexLocker locker(&r.mutex);
+
+    for (int i = 0; i < stageCount; ++i)
+    {
+        r.finished[i] = StageStats();
+        for (ThreadData *data : qAsConst(r.threads))
+        {
+            data->stats[i] = StageStats();
+        }
+    }
+
+    if (runTimer.isValid())
+    {
+        runTimer.restart();
+    }
+}
+
+QString Profiler::stageName(Stage stage)
+{
+    switch (stage)
+    {
+    case Stage::XmlRead:
+        return QStringLiteral("XmlRead");
+    case Stage::DgpsRead:
+        return QStringLiteral("DgpsRead");
+    case Stage::RecordDecode:
+        return QStringLiteral("RecordDecode");
+    case Stage::TargetReportExtraction:
+        return QStringLiteral("TargetReportExtraction");
+    case Stage::LocatePoint:
+        return QStringLiteral("LocatePoint");
+    case Stage::TrackBuilding:
+        return QStringLiteral("TrackBuilding");
+    case Stage::QueueWait:
+        return QStringLiteral("QueueWait");
+    case Stage::Association:
+        return QStringLiteral("Association");
+    case Stage::ED116RPA:
+        return QStringLiteral("ED116RPA");
+    case Stage::ED116UR:
+        return QStringLiteral("ED116UR");
+    case Stage::ED116PD:
+        return QStringLiteral("ED116PD");
+    case Stage::ED116PFD:
+        return QStringLiteral("ED116PFD");
+    case Stage::ED117RPA:
+        return QStringLiteral("ED117RPA");
+    case Stage::ED117UR:
+        return QStringLiteral("ED117UR");
+    case Stage::ED117PD:
+        return QStringLiteral("ED117PD");
+    case Stage::ED117PFD:
+        return QStringLiteral("ED117PFD");
+    case Stage::ED117PID:
+        return QStringLiteral("ED117PID");
+    case Stage::ED117PFID:
+        return QStringLiteral("ED117PFID");
+    case Stage::ED117PLG:
+        return QStringLiteral("ED117PLG");
+    case Stage::Results:
+        return QStringLiteral("Results");
+    }
+
+    return QString();
+}
+
+/*!
+ * \brief Statistics of every stage, indexed by Stage, summed over all the
+ * threads. Threads still running must not be measuring at the same time.
+ */
+QVector<StageStats> Profiler::collect()
+{
+    QVector<StageStats> result(stageCount);
+
+    Registry &r = registry();
+    QMutexLocker locker(&r.mutex);
+
+    for (int i = 0; i < stageCount; ++i)
+    {
+        accumulate(result[i], r.finished[i]);
+        for (const ThreadData *data : qAsConst(r.threads))
+        {
+            accumulate(result[i], data->stats[i]);
+        }
+    }
+
+    return result;
+}
+
+/*!
+ * \brief Prints a table with the stages that were run and a summary of
+ * the whole run.
+ */
+void Profiler::printText(QTextStream &out)
+{
+    const QVector<StageStats> stats = collect();
+    const RunStats rs = runStats();
+
+    const int nameWidth = 22;
+    const QVector<QPair<QString, int>> columns = {
+        qMakePair(QStringLiteral("CALLS"), 10),
+        qMakePair(QStringLiteral("ITEMS"), 12),
+        qMakePair(QStringLiteral("WALL [s]"), 9),
+        qMakePair(QStringLiteral("CPU [s]"), 9),
+        qMakePair(QStringLiteral("ITEMS/s"), 12)};
+
+    int tableWidth = nameWidth;
+    for (const auto &column : columns)
+    {
+        tableWidth += column.second + 1;
+    }
+
+    out.setRealNumberPrecision(3);
+    out.setRealNumberNotation(QTextStream::FixedNotation);
+
+    out << Qt::endl;
+
+    out.setFieldAlignment(QTextStream::AlignCenter);
+    out.setPadChar(QLatin1Char('-'));
+    out << qSetFieldWidth(tableWidth) << QStringLiteral("[ Performance report ]") << qSetFieldWidth(0) << Qt::endl;
+    out.setPadChar(QLatin1Char(' '));
+
+    out << qSetFieldWidth(nameWidth) << "STAGE";
+    for (const auto &column : columns)
+    {
+        out << qSetFieldWidth(1) << "" << qSetFieldWidth(column.second) << column.first;
+    }
+    out << qSetFieldWidth(0) << Qt::endl;
+
+    out.setFieldAlignment(QTextStream::AlignRight);
+
+    out << qSetFieldWidth(nameWidth) << QString(nameWidth, QLatin1Char('-'));
+    for (const auto &column : columns)
+    {
+        out << qSetFieldWidth(1) << "" << qSetFieldWidth(column.second) << QString(column.second, QLatin1Char('-'));
+    }
+    out << qSetFieldWidth(0) << Qt::endl;
+
+    auto printRow = [&](const QString &name, const StageStats &s) {
+        out << qSetFieldWidth(nameWidth) << Qt::left << name
+            << qSetFieldWidth(1) << "" << qSetFieldWidth(10) << Qt::right << s.calls
+            << qSetFieldWidth(1) << "" << qSetFieldWidth(12) << Qt::right << s.items
+            << qSetFieldWidth(1) << "" << qSetFieldWidth(9) << Qt::right << s.wallNs / 1e9
+            << qSetFieldWidth(1) << "" << qSetFieldWidth(9) << Qt::right << s.cpuNs / 1e9;
+
+        out.setRealNumberPrecision(0);
+        out << qSetFieldWidth(1) << "" << qSetFieldWidth(12) << Qt::right << throughput(s)
+            << qSetFieldWidth(0) << Qt::endl;
+        out.setRealNumberPrecision(3);
+    };
+
+    StageStats total;
+    for (int i = 0; i < stageCount; ++i)
+    {
+        if (stats.at(i).calls == 0)
+        {
+            continue;
+        }
+
+        printRow(stageName(static_cast<Stage>(i)), stats.at(i));
+
+        total.calls += stats.at(i).calls;
+        total.wallNs += stats.at(i).wallNs;
+        total.cpuNs += stats.at(i).cpuNs;
+    }
+
+    out << Qt::endl;
+
+    out << qSetFieldWidth(0) << "Instrumented: " << total.wallNs / 1e9 << " s wall, "
+        << total.cpuNs / 1e9 << " s CPU" << Qt::endl;
+    out << "Run: " << rs.wallS << " s wall, " << rs.cpuS << " s CPU, peak RSS "
+        << rs.peakRssBytes / (1024.0 * 1024.0) << " MiB" << Qt::endl;
+}
+
+/*!
+ * \brief Writes the statistics of the stages that were run and of the
+ * whole run as a JSON document.
+ */
+void Profiler::printJson(QIODevice *device)
+{
+    const QVector<StageStats> stats = collect();
+    const RunStats rs = runStats();
+
+    QJsonArray stages;
+    for (int i = 0; i < stageCount; ++i)
+    {
+        const StageStats &s = stats.at(i);
+        if (s.calls == 0)
+        {
+            continue;
+        }
+
+        QJsonObject stage;
+        stage.insert(QStringLiteral("stage"), stageName(static_cast<Stage>(i)));
+        stage.insert(QStringLiteral("calls"), s.calls);
+        stage.insert(QStringLiteral("items"), s.items);
+        stage.insert(QStringLiteral("wall"), s.wallNs / 1e9);
+        stage.insert(QStringLiteral("cpu"), s.cpuNs / 1e9);
+        stage.insert(QStringLiteral("throughput"), throughput(s));
+        stages.append(stage);
+    }
+
+    QJsonObject run;
+    run.insert(QStringLiteral("wall"), rs.wallS);
+    run.insert(QStringLiteral("cpu"), rs.cpuS);
+    run.insert(QStringLiteral("peakRss"), rs.peakRssBytes);
+
+    QJsonObject root;
+    root.insert(QStringLiteral("stages"), stages);
+    root.insert(QStringLiteral("run"), run);
+
+    device->write(QJsonDocument(root).toJson());
+}
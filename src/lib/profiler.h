@@ -0,0 +1,116 @@
+/*!
+ * \file profiler.h
+ * \brief Interface of the run profiler.
+ * \author Álvaro Cebrián Juan, 2020. acebrianjuan(at)gmail.com
+ *
+ * -----------------------------------------------------------------------
+ *
+ * Copyright (C) 2020-2021 Álvaro Cebrián Juan <acebrianjuan@gmail.com>
+ *
+ * ASTMOPS is a command line tool for evaluating 
+ * the performance of A-SMGCS sensors at airports
+ *
+ * This file is part of ASTMOPS.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -----------------------------------------------------------------------
+ */
+
+#ifndef ASTMOPS_PROFILER_H
+#define ASTMOPS_PROFILER_H
+
+#include <QIODevice>
+#include <QString>
+#include <QTextStream>
+#include <QVector>
+
+/*!
+ * \brief Lightweight instrumentation of the processing stages.
+ *
+ * Stages are measured with ScopedTimer objects placed around the code of
+ * each stage. Timers nest: the time spent in an inner stage is excluded
+ * from the enclosing one, so the wall and CPU times of all stages add up
+ * to the instrumented part of the run.
+ *
+ * Measurements are accumulated in per-thread counters without locking
+ * and merged when a thread exits or when the statistics are collected.
+ * When profiling is disabled, which is the default, a timer only checks
+ * a flag.
+ */
+namespace Profiler
+{
+enum class Stage
+{
+    XmlRead,
+    DgpsRead,
+    RecordDecode,
+    TargetReportExtraction,
+    LocatePoint,
+    TrackBuilding,
+    QueueWait,
+    Association,
+    ED116RPA,
+    ED116UR,
+    ED116PD,
+    ED116PFD,
+    ED117RPA,
+    ED117UR,
+    ED117PD,
+    ED117PFD,
+    ED117PID,
+    ED117PFID,
+    ED117PLG,
+    Results
+};
+
+constexpr int stageCount = static_cast<int>(Stage::Results) + 1;
+
+struct StageStats
+{
+    qint64 calls = 0;
+    qint64 items = 0;
+    qint64 wallNs = 0;  // Excluding nested stages.
+    qint64 cpuNs = 0;   // Excluding nested stages.
+};
+
+/*!
+ * \brief Measures the stage it is created for until it goes out of scope.
+ * Counts one item unless told otherwise with setItems().
+ */
+class ScopedTimer
+{
+public:
+    explicit ScopedTimer(Stage stage, qint64 items = 1);
+    ~ScopedTimer();
+
+    void setItems(qint64 items);
+
+private:
+    Q_DISABLE_COPY(ScopedTimer)
+
+    Stage stage_;
+    qint64 items_;
+    bool active_ = false;
+
+    qint64 startWallNs_ = 0;
+    qint64 startCpuNs_ = 0;
+    qint64 childWallNs_ = 0;
+    qint64 childCpuNs_ = 0;
+
+    ScopedTimer *parent_ = nullptr;
+};
+
+void setEnabled(bool enabled);
+bool isEnabled();
+void reset();
+
+QString stageName(Stage stage);
+QVector<StageStats> collect();
+
+void printText(QTextStream &out);
+void printJson(QIODevice *device);
+
+}  // namespace Profiler
+
+#endif  // ASTMOPS_PROFILER_H
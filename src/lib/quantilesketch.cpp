@@ -0,0 +1,302 @@
+/*!
+ * \file quantilesketch.cpp
+ * \brief Implementation of the QuantileSketch class.
+ * \author Álvaro Cebrián Juan, 2020. acebrianjuan(at)gmail.com
+ *
+ * -----------------------------------------------------------------------
+ *
+ * Copyright (C) 2020-2021 Álvaro Cebrián Juan <acebrianjuan@gmail.com>
+ *
+ * ASTMOPS is a command line tool for evaluating 
+ * the performance of A-SMGCS sensors at airports
+ *
+ * This file is part of ASTMOPS.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -----------------------------------------------------------------------
+ */
+
+#include "quantilesketch.h"
+#include <QPair>
+#include <algorithm>
+#include <cmath>
+
+QuantileSketch::QuantileSketch(int k) : k_(qMax(k, 8))
+{
+    grow();
+}
+
+QuantileSketch &QuantileSketch::operator<<(double value)
+{
+    if (n_ == 0)
+    {
+        min_ = value;
+        max_ = value;
+    }
+    else
+    {
+        min_ = qMin(min_, value);
+        max_ = qMax(max_, value);
+    }
+
+    levels_[0].append(value);
+    ++retained_;
+    ++n_;
+
+    compress();
+
+    return *this;
+}
+
+QuantileSketch &QuantileSketch::operator+=(const QuantileSketch &other)
+{
+    if (other.isEmpty())
+    {
+        return *this;
+    }
+
+    if (isEmpty())
+    {
+        min_ = other.min_;
+        max_ = other.max_;
+    }
+    else
+    {
+        min_ = qMin(min_, other.min_);
+        max_ = qMax(max_, other.max_);
+    }
+
+    while (levels_.size() < other.levels_.size())
+    {
+        grow();
+    }
+
+    for (int h = 0; h < other.levels_.size(); ++h)
+    {
+        levels_[h].append(other.levels_.at(h));
+    }
+
+    retained_ += other.retained_;
+
+    n_ += other.n_;
+
+    compress();
+
+    return *this;
+}
+
+int QuantileSketch::k() const
+{
+    return k_;
+}
+
+quint64 QuantileSketch::count() const
+{
+    return n_;
+}
+
+int QuantileSketch::retained() const
+{
+    return retained_;
+}
+
+bool QuantileSketch::isEmpty() const
+{
+    return n_ == 0;
+}
+
+/*!
+ * \brief Returns the value whose (weighted) rank is the fraction \a q of
+ * the number of values added to the sketch.
+ */
+double QuantileSketch::quantile(double q) const
+{
+    if (isEmpty() || q < 0 || q > 1)
+    {
+        return qSNaN();
+    }
+
+    if (q == 0)
+    {
+        return min_;
+    }
+    if (q == 1)
+    {
+        return max_;
+    }
+
+    QVector<QPair<double, quint64>> items;
+    items.reserve(retained());
+    for (int h = 0; h < levels_.size(); ++h)
+    {
+        const quint64 weight = Q_UINT64_C(1) << h;
+        for (double value : levels_.at(h))
+        {
+            items.append(qMakePair(value, weight));
+        }
+    }
+
+    std::sort(items.begin(), items.end());
+
+    const double target = q * n_;
+    quint64 cumWeight = 0;
+    for (const QPair<double, quint64> &item : qAsConst(items))
+    {
+        cumWeight += item.second;
+        if (cumWeight >= target)
+        {
+            return item.first;
+        }
+    }
+
+    return max_;
+}
+
+/*!
+ * \brief Adds a level on top of the sketch and recomputes the compactor
+ * capacities, which decay by a factor of 2/3 from the top level down.
+ */
+void QuantileSketch::grow()
+{
+    levels_.resize(levels_.size() + 1);
+
+    const int depth = levels_.size();
+    capacities_.resize(depth);
+    totalCapacity_ = 0;
+    for (int h = 0; h < depth; ++h)
+    {
+        const double cap = std::ceil(k_ * std::pow(2.0 / 3.0, depth - 1 - h));
+        capacities_[h] = qMax(2, static_cast<int>(cap));
+        totalCapacity_ += capacities_.at(h);
+    }
+}
+
+void QuantileSketch::compress()
+{
+    while (retained_ >= totalCapacity_)
+    {
+        for (int h = 0; h < levels_.size(); ++h)
+        {
+            if (levels_.at(h).size() < capacities_.at(h))
+            {
+                continue;
+            }
+
+            if (h + 1 == levels_.size())
+            {
+                grow();
+            }
+
+            QVector<double> &level = levels_[h];
+            std::sort(level.begin(), level.end());
+
+            // An odd value out stays at its level.
+            QVector<double> kept;
+            int size = level.size();
+            if (size % 2 != 0)
+            {
+                kept.append(level.last());
+                --size;
+            }
+
+            // Promote either the even or the odd positions.
+            QVector<double> &next = levels_[h + 1];
+            for (int i = flipCoin() ? 1 : 0; i < size; i += 2)
+            {
+                next.append(level.at(i));
+            }
+
+            retained_ -= size / 2;
+            level.swap(kept);
+            break;
+        }
+    }
+}
+
+bool QuantileSketch::flipCoin()
+{
+    // Xorshift32, seeded with a fixed value so that results are
+    // reproducible from one run to the next.
+    rng_ ^= rng_ << 13;
+    rng_ ^= rng_ >> 17;
+    rng_ ^= rng_ << 5;
+
+    return rng_ & 1;
+}
+
+/*!
+ * \brief Returns true if the levels, capacities and counts agree with
+ * each other as the sketch keeps them, so that a deserialized sketch can
+ * be compressed and read without indexing out of bounds.
+ */
+bool QuantileSketch::isConsistent() const
+{
+    // Weights are powers of two held in a quint64.
+    if (k_ < 8 || levels_.isEmpty() || levels_.size() >= 64 ||
+        capacities_.size() != levels_.size())
+    {
+        return false;
+    }
+
+    // The capacities are those grow() sets for k and the depth.
+    QuantileSketch expected(k_);
+    while (expected.levels_.size() < levels_.size())
+    {
+        expected.grow();
+    }
+
+    if (capacities_ != expected.capacities_ || totalCapacity_ != expected.totalCapacity_)
+    {
+        return false;
+    }
+
+    // Compaction keeps the total weight, and compress() leaves fewer
+    // values than the total capacity.
+    qint64 retained = 0;
+    quint64 weight = 0;
+    for (int h = 0; h < levels_.size(); ++h)
+    {
+        retained += levels_.at(h).size();
+        weight += static_cast<quint64>(levels_.at(h).size()) << h;
+    }
+
+    return retained == retained_ && retained_ < totalCapacity_ && weight == n_;
+}
+
+/* ---------------------------- Free functions ---------------------------- */
+
+/*!
+ * \brief Binary serialization of the whole sketch, including the state of
+ * its coin, so that a deserialized sketch evolves as the original would.
+ */
+QDataStream &operator<<(QDataStream &out, const QuantileSketch &sketch)
+{
+    return out << qint32(sketch.k_) << sketch.n_ << sketch.min_ << sketch.max_
+               << sketch.rng_ << sketch.levels_ << sketch.capacities_
+               << qint32(sketch.retained_) << qint32(sketch.totalCapacity_);
+}
+
+QDataStream &operator>>(QDataStream &in, QuantileSketch &sketch)
+{
+    qint32 k = 0;
+    qint32 retained = 0;
+    qint32 totalCapacity = 0;
+
+    in >> k >> sketch.n_ >> sketch.min_ >> sketch.max_
+       >> sketch.rng_ >> sketch.levels_ >> sketch.capacities_
+       >> retained >> totalCapacity;
+
+    sketch.k_ = k;
+    sketch.retained_ = retained;
+    sketch.totalCapacity_ = totalCapacity;
+
+    // The stream may come from a state file given by the user.
+    if (in.status() != QDataStream::Ok || !sketch.isConsistent())
+    {
+        in.setStatus(QDataStream::ReadCorruptData);
+        sketch = QuantileSketch();
+    }
+
+    return in;
+}
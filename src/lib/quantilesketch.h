@@ -0,0 +1,77 @@
+/*!
+ * \file quantilesketch.h
+ * \brief Interface of the QuantileSketch class.
+ * \author Álvaro Cebrián Juan, 2020. acebrianjuan(at)gmail.com
+ *
+ * -----------------------------------------------------------------------
+ *
+ * Copyright (C) 2020-2021 Álvaro Cebrián Juan <acebrianjuan@gmail.com>
+ *
+ * ASTMOPS is a command line tool for evaluating 
+ * the performance of A-SMGCS sensors at airports
+ *
+ * This file is part of ASTMOPS.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -----------------------------------------------------------------------
+ */
+
+#ifndef ASTMOPS_QUANTILESKETCH_H
+#define ASTMOPS_QUANTILESKETCH_H
+
+#include <QDataStream>
+#include <QVector>
+
+/*!
+ * \brief The QuantileSketch class is a mergeable KLL quantile sketch.
+ *
+ * Values are kept in a hierarchy of compactors whose capacities shrink
+ * geometrically with the level. When the sketch is full, the lowest
+ * overflowing compactor is sorted and every other value is promoted to
+ * the next level with twice the weight. Memory stays in O(k log(n/k))
+ * and the rank error of a quantile read is roughly 1.7/k (about 1 % for
+ * the default k = 200). Minimum and maximum are tracked exactly.
+ */
+class QuantileSketch
+{
+public:
+    static constexpr int defaultK = 200;
+
+    explicit QuantileSketch(int k = defaultK);
+
+    QuantileSketch &operator<<(double value);
+    QuantileSketch &operator+=(const QuantileSketch &other);
+
+    int k() const;
+    quint64 count() const;
+    int retained() const;
+    bool isEmpty() const;
+
+    double quantile(double q) const;
+
+    friend QDataStream &operator<<(QDataStream &out, const QuantileSketch &sketch);
+    friend QDataStream &operator>>(QDataStream &in, QuantileSketch &sketch);
+
+private:
+    void grow();
+    void compress();
+    bool flipCoin();
+    bool isConsistent() const;
+
+    int k_ = defaultK;
+    quint64 n_ = 0;
+    double min_ = qSNaN();
+    double max_ = qSNaN();
+    quint32 rng_ = 0x9E3779B9;
+    QVector<QVector<double>> levels_;
+    QVector<int> capacities_;
+    int retained_ = 0;
+    int totalCapacity_ = 0;
+};
+
+// FREE OPERATORS.
+QDataStream &operator<<(QDataStream &out, const QuantileSketch &sketch);
+QDataStream &operator>>(QDataStream &in, QuantileSketch &sketch);
+
+#endif  // ASTMOPS_QUANTILESKETCH_H
@@ -0,0 +1,106 @@
+/*!
+ * \file rollingevaluator.cpp
+ * \brief Implementation of the RollingEvaluator class.
+ * \author Álvaro Cebrián Juan, 2020. acebrianjuan(at)gmail.com
+ *
+ * -----------------------------------------------------------------------
+ *
+ * Copyright (C) 2020-2021 Álvaro Cebrián Juan <acebrianjuan@gmail.com>
+ *
+ * ASTMOPS is a command line tool for evaluating 
+ * the performance of A-SMGCS sensors at airports
+ *
+ * This file is part of ASTMOPS.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -----------------------------------------------------------------------
+ */
+
+#include "rollingevaluator.h"
+#include "perfevaluator.h"
+#include "trackextractor.h"
+
+RollingEvaluator::RollingEvaluator(const RunConfig &config, qint64 windowMs)
+    : config_(config), windowMs_(windowMs), watermarks_(config.allowedLateness)
+{
+}
+
+void RollingEvaluator::addData(const TargetReport &tr)
+{
+    if (!watermarks_.advance(tr.sys_typ_, tr.tod_))
+    {
+        return;
+    }
+
+    tgtReps_.insert(tr.tod_, tr);
+
+    // Drop the target reports that left the window.
+    const QDateTime start = windowStart();
+    while (tgtReps_.firstKey() < start)
+    {
+        tgtReps_.erase(tgtReps_.begin());
+    }
+}
+
+bool RollingEvaluator::isEmpty() const
+{
+    return tgtReps_.isEmpty();
+}
+
+int RollingEvaluator::size() const
+{
+    return tgtReps_.size();
+}
+
+QDateTime RollingEvaluator::windowStart() const
+{
+    if (tgtReps_.isEmpty())
+    {
+        return QDateTime();
+    }
+
+    return tgtReps_.lastKey().addMSecs(-windowMs_);
+}
+
+QDateTime RollingEvaluator::windowEnd() const
+{
+    if (tgtReps_.isEmpty())
+    {
+        return QDateTime();
+    }
+
+    return tgtReps_.lastKey();
+}
+
+/*!
+ * \brief Builds the tracks of the target reports in the window and
+ * evaluates them from scratch.
+ */
+PerfResults RollingEvaluator::evaluate() const
+{
+    TrackExtractor trackExtr(config_);
+    for (const TargetReport &tr : tgtReps_)
+    {
+        trackExtr.addData(tr);
+    }
+
+    PerfEvaluator perfEval(config_);
+    while (trackExtr.hasPendingData())
+    {
+        std::optional<Track> trk_opt = trackExtr.takeData();
+        if (trk_opt.has_value())
+        {
+            perfEval.addData(trk_opt.value());
+        }
+    }
+
+    perfEval.run();
+
+    return perfEval.results();
+}
+
+const Watermarks &RollingEvaluator::watermarks() const
+{
+    return watermarks_;
+}
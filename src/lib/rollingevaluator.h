@@ -0,0 +1,63 @@
+/*!
+ * \file rollingevaluator.h
+ * \brief Interface of the RollingEvaluator class.
+ * \author Álvaro Cebrián Juan, 2020. acebrianjuan(at)gmail.com
+ *
+ * -----------------------------------------------------------------------
+ *
+ * Copyright (C) 2020-2021 Álvaro Cebrián Juan <acebrianjuan@gmail.com>
+ *
+ * ASTMOPS is a command line tool for evaluating 
+ * the performance of A-SMGCS sensors at airports
+ *
+ * This file is part of ASTMOPS.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -----------------------------------------------------------------------
+ */
+
+#ifndef ASTMOPS_ROLLINGEVALUATOR_H
+#define ASTMOPS_ROLLINGEVALUATOR_H
+
+#include "config.h"
+#include "perfresults.h"
+#include "track.h"
+#include "watermarks.h"
+
+/*!
+ * \brief The RollingEvaluator class keeps the target reports of a live
+ * feed that fall within a sliding time window and evaluates them on
+ * demand.
+ *
+ * The window ends at the most recent target report received, so it
+ * follows the time of the data rather than the wall clock and a replayed
+ * recording gives the same snapshots at any replay speed. Older target
+ * reports are dropped as newer ones arrive, and so are the ones that
+ * arrive later than the allowed lateness.
+ */
+class RollingEvaluator
+{
+public:
+    RollingEvaluator(const RunConfig &config, qint64 windowMs);
+
+    void addData(const TargetReport &tr);
+
+    bool isEmpty() const;
+    int size() const;
+    QDateTime windowStart() const;
+    QDateTime windowEnd() const;
+
+    PerfResults evaluate() const;
+
+    const Watermarks &watermarks() const;
+
+private:
+    RunConfig config_;
+    qint64 windowMs_ = 0;
+
+    TgtRepMap tgtReps_;
+    Watermarks watermarks_;
+};
+
+#endif  // ASTMOPS_ROLLINGEVALUATOR_H
@@ -0,0 +1,142 @@
+/*!
+ * \file runningstats.cpp
+ * \brief Implementation of the RunningStats class.
+ * \author Álvaro Cebrián Juan, 2020. acebrianjuan(at)gmail.com
+ *
+ * -----------------------------------------------------------------------
+ *
+ * Copyright (C) 2020-2021 Álvaro Cebrián Juan <acebrianjuan@gmail.com>
+ *
+ * ASTMOPS is a command line tool for evaluating 
+ * the performance of A-SMGCS sensors at airports
+ *
+ * This file is part of ASTMOPS.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -----------------------------------------------------------------------
+ */
+
+#include "runningstats.h"
+#include <cmath>
+
+RunningStats &RunningStats::operator<<(double x)
+{
+    if (n_ == 0)
+    {
+        min_ = x;
+        max_ = x;
+    }
+    else
+    {
+        min_ = qMin(min_, x);
+        max_ = qMax(max_, x);
+    }
+
+    ++n_;
+    const double delta = x - mean_;
+    mean_ += delta / n_;
+    m2_ += delta * (x - mean_);
+
+    return *this;
+}
+
+RunningStats &RunningStats::operator+=(const RunningStats &other)
+{
+    if (other.n_ == 0)
+    {
+        return *this;
+    }
+
+    if (n_ == 0)
+    {
+        *this = other;
+        return *this;
+    }
+
+    const qint64 n = n_ + other.n_;
+    const double delta = other.mean_ - mean_;
+    mean_ += delta * other.n_ / n;
+    m2_ += other.m2_ + delta * delta * n_ * other.n_ / n;
+    n_ = n;
+
+    min_ = qMin(min_, other.min_);
+    max_ = qMax(max_, other.max_);
+
+    return *this;
+}
+
+bool RunningStats::isEmpty() const
+{
+    return n_ == 0;
+}
+
+qint64 RunningStats::count() const
+{
+    return n_;
+}
+
+double RunningStats::mean() const
+{
+    if (n_ == 0)
+    {
+        return qSNaN();
+    }
+
+    return mean_;
+}
+
+/*!
+ * \brief Sample variance (N - 1 denominator).
+ */
+double RunningStats::variance() const
+{
+    if (n_ == 0)
+    {
+        return qSNaN();
+    }
+
+    if (n_ == 1)
+    {
+        return 0.0;
+    }
+
+    return m2_ / (n_ - 1);
+}
+
+double RunningStats::stdDev() const
+{
+    return std::sqrt(variance());
+}
+
+double RunningStats::min() const
+{
+    if (n_ == 0)
+    {
+        return qSNaN();
+    }
+
+    return min_;
+}
+
+double RunningStats::max() const
+{
+    if (n_ == 0)
+    {
+        return qSNaN();
+    }
+
+    return max_;
+}
+
+/* ---------------------------- Free functions ---------------------------- */
+
+QDataStream &operator<<(QDataStream &out, const RunningStats &stats)
+{
+    return out << stats.n_ << stats.mean_ << stats.m2_ << stats.min_ << stats.max_;
+}
+
+QDataStream &operator>>(QDataStream &in, RunningStats &stats)
+{
+    return in >> stats.n_ >> stats.mean_ >> stats.m2_ >> stats.min_ >> stats.max_;
+}
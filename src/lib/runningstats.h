@@ -0,0 +1,64 @@
+/*!
+ * \file runningstats.h
+ * \brief Interface of the RunningStats class.
+ * \author Álvaro Cebrián Juan, 2020. acebrianjuan(at)gmail.com
+ *
+ * -----------------------------------------------------------------------
+ *
+ * Copyright (C) 2020-2021 Álvaro Cebrián Juan <acebrianjuan@gmail.com>
+ *
+ * ASTMOPS is a command line tool for evaluating 
+ * the performance of A-SMGCS sensors at airports
+ *
+ * This file is part of ASTMOPS.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -----------------------------------------------------------------------
+ */
+
+#ifndef ASTMOPS_RUNNINGSTATS_H
+#define ASTMOPS_RUNNINGSTATS_H
+
+#include <QDataStream>
+#include <QtGlobal>
+
+/*!
+ * \brief The RunningStats class computes the count, mean, standard
+ * deviation, minimum and maximum of a stream of values in a single pass,
+ * without storing them.
+ *
+ * Values are added with Welford's update and two accumulators are merged
+ * with Chan's parallel formula, both of which are numerically stable.
+ */
+class RunningStats
+{
+public:
+    RunningStats &operator<<(double x);
+    RunningStats &operator+=(const RunningStats &other);
+
+    bool isEmpty() const;
+    qint64 count() const;
+
+    double mean() const;
+    double variance() const;
+    double stdDev() const;
+    double min() const;
+    double max() const;
+
+    friend QDataStream &operator<<(QDataStream &out, const RunningStats &stats);
+    friend QDataStream &operator>>(QDataStream &in, RunningStats &stats);
+
+private:
+    qint64 n_ = 0;
+    double mean_ = 0;
+    double m2_ = 0;
+    double min_ = 0;
+    double max_ = 0;
+};
+
+// FREE OPERATORS.
+QDataStream &operator<<(QDataStream &out, const RunningStats &stats);
+QDataStream &operator>>(QDataStream &in, RunningStats &stats);
+
+#endif  // ASTMOPS_RUNNINGSTATS_H
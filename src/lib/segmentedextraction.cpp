@@ -0,0 +1,244 @@
+/*!
+ * \file segmentedextraction.cpp
+ * \brief Parallel target report extraction of time segments of a recording.
+ * \author Álvaro Cebrián Juan, 2020. acebrianjuan(at)gmail.com
+ *
+ * -----------------------------------------------------------------------
+ *
+ * Copyright (C) 2020-2021 Álvaro Cebrián Juan <acebrianjuan@gmail.com>
+ *
+ * ASTMOPS is a command line tool for evaluating 
+ * the performance of A-SMGCS sensors at airports
+ *
+ * This file is part of ASTMOPS.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -----------------------------------------------------------------------
+ */
+
+#include "segmentedextraction.h"
+#include "profiler.h"
+#include "targetreportextractor.h"
+#include <QFile>
+#include <QThread>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+namespace
+{
+// Target reports extracted from a time segment and the rollover state of
+// the reader of the segment.
+struct Segment
+{
+    QVector<TargetReport> reports;
+    SegmentClock clock;
+};
+
+void extractSegment(const char *begin, const char *end, const RunConfig &config,
+    const Aerodrome &aerodrome, Segment &segment)
+{
+    AsterixXmlReader astXmlReader(config);
+
+    TargetReportExtractor tgtRepExtr(config, aerodrome.arp(), aerodrome.smr());
+    tgtRepExtr.setLocatePointCallback([&aerodrome](const QVector3D cartPos, const bool gndBit) {
+        return aerodrome.locatePoint(cartPos, gndBit);
+    });
+
+    for (const char *line = begin; line < end;)
+    {
+        const char *nl = static_cast<const char *>(std::memchr(line, '\n', static_cast<size_t>(end - line)));
+        const char *next = nl ? nl + 1 : end;
+
+        {
+            Profiler::ScopedTimer timer(Profiler::Stage::XmlRead, 0);
+            timer.setItems(next - line);
+
+            astXmlReader.addData(QByteArray::fromRawData(line, static_cast<int>(next - line)));
+        }
+
+        // Drained record by record, so that the target reports come out
+        // in the same order as in a sequential read.
+        while (astXmlReader.hasPendingData())
+        {
+            tgtRepExtr.addData(astXmlReader.takeData().value());
+
+            while (tgtRepExtr.hasPendingData())
+            {
+                segment.reports.append(tgtRepExtr.takeData().value());
+            }
+        }
+
+        line = next;
+    }
+
+    segment.clock = SegmentClock(astXmlReader);
+}
+}  // namespace
+
+SegmentClock::SegmentClock(const AsterixXmlReader &reader)
+    : first_times_(reader.firstTimes()),
+      last_times_(reader.lastTimes()),
+      day_counts_(reader.dayCounts())
+{
+}
+
+/* ---------------------------- Free functions ---------------------------- */
+
+/*!
+ * \brief Returns the number of days to add to the timestamps of each
+ * record type of each segment, read from day zero, so that they are the
+ * same as in a sequential read of the whole recording.
+ *
+ * The midnight TOD rollover rules of AsterixXmlReader are applied across
+ * the segment boundaries: the first timestamp of a segment is compared
+ * with the last one of the previous segments. A backward jump of 24 h
+ * from close to midnight is a rollover. A forward jump of 24 h to close
+ * to midnight is a sample delayed from before a rollover, which the
+ * reader of the segment took as the day before a rollover of its own.
+ */
+QVector<QHash<RecordType, qint64>> segmentDayOffsets(const QVector<SegmentClock> &clocks)
+{
+    const qint64 day_tdiff = (24 * 3600 - 10) * 1000;
+    const QTime closeToMidnight(23, 59, 50);
+
+    // Absolute last timestamps and day counts up to the current segment.
+    QHash<RecordType, QDateTime> last_times;
+    QHash<RecordType, qint64> day_count;
+
+    QVector<QHash<RecordType, qint64>> offsets(clocks.size());
+
+    for (int i = 0; i < clocks.size(); ++i)
+    {
+        const SegmentClock &clock = clocks.at(i);
+
+        for (auto it = clock.first_times_.constBegin(); it != clock.first_times_.constEnd(); ++it)
+        {
+            const RecordType rt = it.key();
+            qint64 offset = day_count.value(rt, 0);
+
+            if (last_times.contains(rt))
+            {
+                const QDateTime lastTod = last_times.value(rt);
+                const QDateTime firstTod = it.value().addDays(offset);
+                const qint64 tdiff = lastTod.msecsTo(firstTod);
+
+                if (tdiff <= -day_tdiff && lastTod.time() >= closeToMidnight)
+                {
+                    // Rollover at the segment boundary.
+                    ++offset;
+                }
+                else if (tdiff >= day_tdiff && firstTod.time() >= closeToMidnight)
+                {
+                    // Delayed sample at the start of the segment.
+                    --offset;
+                }
+            }
+
+            offsets[i].insert(rt, offset);
+            last_times.insert(rt, clock.last_times_.value(rt).addDays(offset));
+            day_count.insert(rt, offset + clock.day_counts_.value(rt));
+        }
+    }
+
+    return offsets;
+}
+
+/*!
+ * \brief Extracts the target reports of the ASTERIX XML recording at
+ * \a path split into \a segments time segments, which are read in
+ * parallel from a memory mapping of the file.
+ *
+ * The recording is split at line boundaries, as it has one record per
+ * line in time order. Every segment is read from day zero and its
+ * timestamps are shifted afterwards by the midnight TOD rollovers of the
+ * previous segments, see segmentDayOffsets().
+ *
+ * Target reports are passed to \a callback in file order, so that the
+ * tracks built from them are stitched across the segment boundaries by
+ * system type and track number exactly as in a sequential read. A segment
+ * is passed on as soon as it and all the segments before it are
+ * extracted, and its target reports are released right after, so only
+ * the segments read ahead of the first pending one are held in memory.
+ */
+bool streamSegmentedTargetReports(const QString &path, int segments, const RunConfig &config,
+    const Aerodrome &aerodrome, const TargetReportCallback &callback)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        qWarning() << "Could not open" << path;
+        return false;
+    }
+
+    // Read into memory when the file cannot be mapped.
+    QByteArray buffer;
+    const char *data = nullptr;
+    const char *end = nullptr;
+
+    if (const uchar *map = file.size() > 0 ? file.map(0, file.size()) : nullptr)
+    {
+        data = reinterpret_cast<const char *>(map);
+        end = data + file.size();
+    }
+    else
+    {
+        buffer = file.readAll();
+        data = buffer.constData();
+        end = data + buffer.size();
+    }
+
+    // Segment boundaries, moved forward to the start of the next line.
+    std::vector<const char *> bounds;
+    bounds.push_back(data);
+    for (int i = 1; i < segments; ++i)
+    {
+        const char *b = data + (end - data) * i / segments;
+        b = qMax(b, bounds.back());
+        const char *nl = static_cast<const char *>(std::memchr(b, '\n', static_cast<size_t>(end - b)));
+        bounds.push_back(nl ? nl + 1 : end);
+    }
+    bounds.push_back(end);
+
+    std::vector<Segment> parts(static_cast<size_t>(segments));
+    std::vector<std::unique_ptr<QThread>> workers;
+
+    for (size_t i = 0; i < parts.size(); ++i)
+    {
+        workers.emplace_back(QThread::create([&bounds, &parts, &config, &aerodrome, i]() {
+            extractSegment(bounds[i], bounds[i + 1], config, aerodrome, parts[i]);
+        }));
+        workers.back()->start();
+    }
+
+    // Segments are passed on in order as soon as they and all the ones
+    // before them are extracted, while the later ones are still being read.
+    QVector<SegmentClock> clocks;
+
+    for (size_t i = 0; i < parts.size(); ++i)
+    {
+        workers[i]->wait();
+
+        // The day offsets of a segment depend only on the segments before
+        // it, so they are final once it is extracted.
+        clocks.append(parts[i].clock);
+        const QHash<RecordType, qint64> offset = segmentDayOffsets(clocks).constLast();
+
+        for (TargetReport &tr : parts[i].reports)
+        {
+            const qint64 days = offset.value(RecordType(tr.sys_typ_, MessageType::TargetReport), 0);
+            if (days != 0)
+            {
+                tr.tod_ = tr.tod_.addDays(days);
+            }
+
+            callback(tr);
+        }
+
+        // Release the segment as soon as it is passed on.
+        parts[i].reports = QVector<TargetReport>();
+    }
+
+    return true;
+}
@@ -0,0 +1,53 @@
+/*!
+ * \file segmentedextraction.h
+ * \brief Parallel target report extraction of time segments of a recording.
+ * \author Álvaro Cebrián Juan, 2020. acebrianjuan(at)gmail.com
+ *
+ * -----------------------------------------------------------------------
+ *
+ * Copyright (C) 2020-2021 Álvaro Cebrián Juan <acebrianjuan@gmail.com>
+ *
+ * ASTMOPS is a command line tool for evaluating 
+ * the performance of A-SMGCS sensors at airports
+ *
+ * This file is part of ASTMOPS.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -----------------------------------------------------------------------
+ */
+
+#ifndef ASTMOPS_SEGMENTEDEXTRACTION_H
+#define ASTMOPS_SEGMENTEDEXTRACTION_H
+
+#include "aerodrome.h"
+#include "asterixxmlreader.h"
+#include "astmops.h"
+#include "config.h"
+#include "targetreport.h"
+#include <QDateTime>
+#include <QHash>
+#include <QString>
+#include <QVector>
+
+/*!
+ * \brief The SegmentClock struct holds the state of the midnight TOD
+ * rollover detection of the AsterixXmlReader that read a time segment of
+ * a recording, starting from day zero.
+ */
+struct SegmentClock
+{
+    SegmentClock() = default;
+    explicit SegmentClock(const AsterixXmlReader &reader);
+
+    QHash<RecordType, QDateTime> first_times_;
+    QHash<RecordType, QDateTime> last_times_;
+    QHash<RecordType, qint64> day_counts_;
+};
+
+QVector<QHash<RecordType, qint64>> segmentDayOffsets(const QVector<SegmentClock> &clocks);
+
+bool streamSegmentedTargetReports(const QString &path, int segments, const RunConfig &config,
+    const Aerodrome &aerodrome, const TargetReportCallback &callback);
+
+#endif  // ASTMOPS_SEGMENTEDEXTRACTION_H
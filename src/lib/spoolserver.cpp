@@ -0,0 +1,214 @@
+/*!
+ * \file spoolserver.cpp
+ * \brief Implementation of the SpoolServer class.
+ * \author Álvaro Cebrián Juan, 2020. acebrianjuan(at)gmail.com
+ *
+ * -----------------------------------------------------------------------
+ *
+ * Copyright (C) 2020-2021 Álvaro Cebrián Juan <acebrianjuan@gmail.com>
+ *
+ * ASTMOPS is a command line tool for evaluating 
+ * the performance of A-SMGCS sensors at airports
+ *
+ * This file is part of ASTMOPS.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -----------------------------------------------------------------------
+ */
+
+#include "spoolserver.h"
+#include <QCoreApplication>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QRunnable>
+
+namespace
+{
+class SpoolJob : public QRunnable
+{
+public:
+    explicit SpoolJob(const std::function<void()> &fn) : fn_(fn)
+    {
+    }
+
+    void run() override
+    {
+        fn_();
+    }
+
+private:
+    std::function<void()> fn_;
+};
+}  // namespace
+
+/*!
+ * \brief Creates a server on the spool directory \a dir that runs \a job
+ * for each recording, at most \a maxJobs at a time.
+ */
+SpoolServer::SpoolServer(const QString &dir, const Job &job, int maxJobs, QObject *parent)
+    : QObject(parent), dir_(QDir(dir).absolutePath()), job_(job)
+{
+    pool_.setMaxThreadCount(qMax(1, maxJobs));
+
+    connect(&watcher_, &QFileSystemWatcher::directoryChanged, this, &SpoolServer::scan);
+}
+
+/*!
+ * \brief Waits for the running jobs before destroying the server.
+ */
+SpoolServer::~SpoolServer()
+{
+    pool_.waitForDone();
+}
+
+/*!
+ * \brief Starts watching the spool directory and queues the recordings
+ * already pending in it. Returns false if the directory does not exist.
+ */
+bool SpoolServer::start()
+{
+    if (!QFileInfo(dir_).isDir())
+    {
+        qWarning() << "Spool directory" << dir_ << "does not exist";
+        return false;
+    }
+
+    watcher_.addPath(dir_);
+    scan();
+
+    return true;
+}
+
+/*!
+ * \brief Blocks until the queued jobs are done and delivers their
+ * jobFinished() signals.
+ */
+void SpoolServer::waitForDone()
+{
+    pool_.waitForDone();
+    QCoreApplication::sendPostedEvents(this, QEvent::MetaCall);
+}
+
+int SpoolServer::activeJobs() const
+{
+    return running_.size();
+}
+
+/*!
+ * \brief Path of the result of the recording at \a inputPath.
+ */
+QString SpoolServer::resultPath(const QString &inputPath)
+{
+    return inputPath + QLatin1String(".json");
+}
+
+/*!
+ * \brief Copies the recording at \a filePath into the spool directory
+ * \a dir, renaming it into place once complete, and returns the path of
+ * its future result. A previous recording with the same name and its
+ * result are replaced.
+ */
+std::optional<QString> SpoolServer::submit(const QString &dir, const QString &filePath)
+{
+    const QString target = QDir(dir).absoluteFilePath(QFileInfo(filePath).fileName());
+    if (!target.endsWith(QLatin1String(".xml")))
+    {
+        qWarning() << "Only .xml recordings can be submitted:" << filePath;
+        return std::nullopt;
+    }
+
+    // Hidden from the server until renamed, as it does not end in ".xml".
+    const QString partPath = target + QLatin1String(".part");
+    QFile::remove(partPath);
+
+    if (!QFile::copy(filePath, partPath))
+    {
+        qWarning() << "Could not copy" << filePath << "to" << partPath;
+        return std::nullopt;
+    }
+
+    QFile::remove(resultPath(target));
+    QFile::remove(target);
+
+    if (!QFile::rename(partPath, target))
+    {
+        qWarning() << "Could not move" << partPath << "to" << target;
+        QFile::remove(partPath);
+        return std::nullopt;
+    }
+
+    return resultPath(target);
+}
+
+void SpoolServer::scan()
+{
+    const QFileInfoList files = QDir(dir_).entryInfoList(
+        QStringList() << QStringLiteral("*.xml"), QDir::Files, QDir::Name);
+
+    for (const QFileInfo &fi : files)
+    {
+        const QString inputPath = fi.absoluteFilePath();
+        const QDateTime modified = fi.lastModified();
+
+        if (!isPending(inputPath, modified))
+        {
+            continue;
+        }
+
+        running_.insert(inputPath, modified);
+        failed_.remove(inputPath);
+
+        qInfo() << "Queued" << inputPath;
+
+        pool_.start(new SpoolJob([this, inputPath]() {
+            const bool ok = job_(inputPath, resultPath(inputPath));
+
+            QMetaObject::invokeMethod(
+                this, [this, inputPath, ok]() { finishJob(inputPath, ok); },
+                Qt::QueuedConnection);
+        }));
+    }
+}
+
+bool SpoolServer::isPending(const QString &inputPath, const QDateTime &modified) const
+{
+    if (running_.contains(inputPath))
+    {
+        return false;
+    }
+
+    // Failed recordings are only retried once they change.
+    auto it = failed_.constFind(inputPath);
+    if (it != failed_.constEnd() && it.value() == modified)
+    {
+        return false;
+    }
+
+    const QFileInfo result(resultPath(inputPath));
+    return !result.exists() || result.lastModified() < modified;
+}
+
+void SpoolServer::finishJob(const QString &inputPath, bool ok)
+{
+    const QDateTime started = running_.take(inputPath);
+    const QFileInfo input(inputPath);
+
+    if (input.exists() && input.lastModified() != started)
+    {
+        // Replaced while it was being evaluated: the result belongs to
+        // the previous recording.
+        QFile::remove(resultPath(inputPath));
+    }
+    else if (!ok)
+    {
+        failed_.insert(inputPath, started);
+    }
+
+    qInfo() << (ok ? "Finished" : "Failed") << inputPath;
+    emit jobFinished(inputPath, ok);
+
+    scan();
+}
@@ -0,0 +1,82 @@
+/*!
+ * \file spoolserver.h
+ * \brief Interface of the SpoolServer class.
+ * \author Álvaro Cebrián Juan, 2020. acebrianjuan(at)gmail.com
+ *
+ * -----------------------------------------------------------------------
+ *
+ * Copyright (C) 2020-2021 Álvaro Cebrián Juan <acebrianjuan@gmail.com>
+ *
+ * ASTMOPS is a command line tool for evaluating 
+ * the performance of A-SMGCS sensors at airports
+ *
+ * This file is part of ASTMOPS.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -----------------------------------------------------------------------
+ */
+
+#ifndef ASTMOPS_SPOOLSERVER_H
+#define ASTMOPS_SPOOLSERVER_H
+
+#include <QDateTime>
+#include <QFileSystemWatcher>
+#include <QHash>
+#include <QObject>
+#include <QThreadPool>
+#include <functional>
+#include <optional>
+
+/*!
+ * \brief The SpoolServer class runs a job for every ASTERIX XML recording
+ * dropped into a spool directory, with bounded parallelism.
+ *
+ * Recordings are the "*.xml" files of the directory. The result of each
+ * one is written by the job next to it, with a ".json" suffix (see
+ * resultPath()), and a recording is pending while its result is missing
+ * or older than it. So restarting the server resumes the unfinished
+ * recordings, and replacing a recording evaluates it again.
+ *
+ * Clients must make recordings appear atomically, e.g. writing them
+ * under another name and renaming them into place. submit() does so.
+ */
+class SpoolServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    // Evaluates the recording at inputPath and writes its result to
+    // resultPath. Runs in a worker thread.
+    using Job = std::function<bool(const QString &inputPath, const QString &resultPath)>;
+
+    SpoolServer(const QString &dir, const Job &job, int maxJobs, QObject *parent = nullptr);
+    ~SpoolServer();
+
+    bool start();
+    void waitForDone();
+    int activeJobs() const;
+
+    static QString resultPath(const QString &inputPath);
+    static std::optional<QString> submit(const QString &dir, const QString &filePath);
+
+signals:
+    void jobFinished(const QString &inputPath, bool ok);
+
+private slots:
+    void scan();
+
+private:
+    bool isPending(const QString &inputPath, const QDateTime &modified) const;
+    void finishJob(const QString &inputPath, bool ok);
+
+    QString dir_;
+    Job job_;
+    QThreadPool pool_;
+    QFileSystemWatcher watcher_;
+
+    QHash<QString, QDateTime> running_;  // Modification time when queued.
+    QHash<QString, QDateTime> failed_;
+};
+
+#endif  // ASTMOPS_SPOOLSERVER_H
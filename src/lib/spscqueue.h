@@ -0,0 +1,188 @@
+/*!
+ * \file spscqueue.h
+ * \brief Bounded lock-free single-producer single-consumer queue.
+ * \author Álvaro Cebrián Juan, 2020. acebrianjuan(at)gmail.com
+ *
+ * -----------------------------------------------------------------------
+ *
+ * Copyright (C) 2020-2021 Álvaro Cebrián Juan <acebrianjuan@gmail.com>
+ *
+ * ASTMOPS is a command line tool for evaluating 
+ * the performance of A-SMGCS sensors at airports
+ *
+ * This file is part of ASTMOPS.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -----------------------------------------------------------------------
+ */
+
+#ifndef ASTMOPS_SPSCQUEUE_H
+#define ASTMOPS_SPSCQUEUE_H
+
+#include <QThread>
+#include <QtGlobal>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <utility>
+
+/*!
+ * \brief The SpscQueue class is a bounded lock-free queue between one
+ * producer thread and one consumer thread.
+ *
+ * It is a ring buffer whose capacity is rounded up to a power of two. The
+ * producer only writes the tail index and the consumer only the head
+ * index, so neither side takes a lock. A full queue makes push() wait,
+ * which propagates backpressure to the producer, and an empty one makes
+ * pop() wait until an item arrives or the producer calls close().
+ *
+ * Waiting spins for a moment, then yields and finally sleeps briefly, so
+ * that an idle stage does not keep a core busy.
+ */
+template <typename T>
+class SpscQueue
+{
+public:
+    explicit SpscQueue(int capacity)
+    {
+        size_t n = 1;
+        while (n < static_cast<size_t>(qMax(capacity, 1)))
+        {
+            n <<= 1;
+        }
+
+        capacity_ = n;
+        mask_ = n - 1;
+        slots_ = std::make_unique<T[]>(n);
+    }
+
+    int capacity() const
+    {
+        return static_cast<int>(capacity_);
+    }
+
+    // Approximate when called while the other side is running.
+    int size() const
+    {
+        return static_cast<int>(tail_.load(std::memory_order_acquire) -
+                                head_.load(std::memory_order_acquire));
+    }
+
+    bool isEmpty() const
+    {
+        return size() == 0;
+    }
+
+    /*!
+     * \brief Appends \a value if the queue is not full. Producer only.
+     * Returns false, leaving \a value untouched, if it is full.
+     */
+    bool tryPush(T &&value)
+    {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_.load(std::memory_order_acquire) == capacity_)
+        {
+            return false;
+        }
+
+        slots_[tail & mask_] = std::move(value);
+        tail_.store(tail + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    /*!
+     * \brief Appends \a value, waiting while the queue is full. Producer
+     * only.
+     */
+    void push(T value)
+    {
+        for (int round = 0; !tryPush(std::move(value)); ++round)
+        {
+            backoff(round);
+        }
+    }
+
+    /*!
+     * \brief Signals the consumer that no more items will be pushed.
+     * Producer only.
+     */
+    void close()
+    {
+        closed_.store(true, std::memory_order_release);
+    }
+
+    /*!
+     * \brief Takes the oldest item, if any. Consumer only.
+     */
+    std::optional<T> tryPop()
+    {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_.load(std::memory_order_acquire))
+        {
+            return std::nullopt;
+        }
+
+        std::optional<T> value(std::move(slots_[head & mask_]));
+        slots_[head & mask_] = T();
+        head_.store(head + 1, std::memory_order_release);
+
+        return value;
+    }
+
+    /*!
+     * \brief Takes the oldest item, waiting while the queue is empty.
+     * Returns std::nullopt once the queue is closed and drained. Consumer
+     * only.
+     */
+    std::optional<T> pop()
+    {
+        for (int round = 0;; ++round)
+        {
+            // Read before trying, so that an item pushed right before
+            // close() is not missed.
+            const bool closed = closed_.load(std::memory_order_acquire);
+
+            std::optional<T> value = tryPop();
+            if (value.has_value() || closed)
+            {
+                return value;
+            }
+
+            backoff(round);
+        }
+    }
+
+private:
+    Q_DISABLE_COPY(SpscQueue)
+
+    static void backoff(int round)
+    {
+        if (round < 64)
+        {
+            return;  // Spin.
+        }
+
+        if (round < 128)
+        {
+            QThread::yieldCurrentThread();
+        }
+        else
+        {
+            QThread::usleep(50);
+        }
+    }
+
+    size_t capacity_ = 0;
+    size_t mask_ = 0;
+    std::unique_ptr<T[]> slots_;
+
+    // On separate cache lines, as each one is written by a different thread.
+    alignas(64) std::atomic<size_t> head_{0};
+    alignas(64) std::atomic<size_t> tail_{0};
+    std::atomic<bool> closed_{false};
+};
+
+#endif  // ASTMOPS_SPSCQUEUE_H
@@ -18,6 +18,250 @@
  */
 
 #include "targetreport.h"
+#include <QDebug>
+#include <QMutex>
+#include <QSet>
+#include <atomic>
+#include <cstring>
+
+/* ------------------------------ InlineIdent ----------------------------- */
+
+namespace
+{
+// Distinct invalid identifications warned about so far. A transponder
+// sending a bad identification sends it in every report, so each value
+// is only reported once, and only the first maxWarned values.
+const int maxWarned = 100;
+
+struct RejectedIdents
+{
+    QMutex mutex;
+    QSet<Ident> warned;
+    quint64 count = 0;
+};
+
+RejectedIdents &rejectedIdents()
+{
+    static RejectedIdents rejected;
+    return rejected;
+}
+
+void rejectIdent(const Ident &ident)
+{
+    RejectedIdents &rejected = rejectedIdents();
+    QMutexLocker locker(&rejected.mutex);
+
+    ++rejected.count;
+
+    if (rejected.warned.size() >= maxWarned || rejected.warned.contains(ident))
+    {
+        return;
+    }
+
+    rejected.warned.insert(ident);
+    qWarning() << "Discarding invalid identification" << ident;
+
+    if (rejected.warned.size() == maxWarned)
+    {
+        qWarning() << "Further invalid identifications are discarded silently";
+    }
+}
+}  // namespace
+
+/*!
+ * \brief Returns true if \a ident fits in an InlineIdent: at most maxSize
+ * Latin-1 characters.
+ */
+bool InlineIdent::isValid(const Ident &ident)
+{
+    if (ident.size() > maxSize)
+    {
+        return false;
+    }
+
+    for (const QChar c : ident)
+    {
+        if (c.unicode() > 0xFF)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+InlineIdent &InlineIdent::operator=(const Ident &ident)
+{
+    reset();
+
+    if (!isValid(ident))
+    {
+        rejectIdent(ident);
+        return *this;
+    }
+
+    const QByteArray latin1 = ident.toLatin1();
+    size_ = static_cast<quint8>(latin1.size());
+    std::memcpy(chars_, latin1.constData(), size_);
+
+    return *this;
+}
+
+/*!
+ * \brief Number of invalid identifications discarded so far by every
+ * InlineIdent of the process.
+ */
+quint64 InlineIdent::rejectedCount()
+{
+    RejectedIdents &rejected = rejectedIdents();
+    QMutexLocker locker(&rejected.mutex);
+
+    return rejected.count;
+}
+
+InlineIdent &InlineIdent::operator=(std::nullopt_t)
+{
+    reset();
+    return *this;
+}
+
+bool InlineIdent::has_value() const
+{
+    return size_ != noValue;
+}
+
+Ident InlineIdent::value() const
+{
+    if (!has_value())
+    {
+        return Ident();
+    }
+
+    return QString::fromLatin1(chars_, size_);
+}
+
+void InlineIdent::reset()
+{
+    std::memset(chars_, 0, maxSize);
+    size_ = noValue;
+}
+
+/* -------------------------------- AreaId -------------------------------- */
+
+namespace
+{
+// Interned named areas by id. Entries are only ever added, under the
+// registry mutex, and published with release stores, so that lookups by
+// id need no lock.
+std::atomic<const Aerodrome::NamedArea *> areaTable[AreaId::maxCount];
+
+struct AreaRegistry
+{
+    QMutex mutex;
+    QHash<Aerodrome::NamedArea, quint16> ids;
+};
+
+AreaRegistry &areaRegistry()
+{
+    static AreaRegistry registry;
+    return registry;
+}
+
+const Aerodrome::NamedArea &defaultNamedArea()
+{
+    static const Aerodrome::NamedArea narea;
+    return narea;
+}
+}  // namespace
+
+AreaId::AreaId(const Aerodrome::NamedArea &narea)
+{
+    if (narea == defaultNamedArea())
+    {
+        return;
+    }
+
+    // Target reports of a thread tend to fall in the same few areas, so
+    // the ids it already knows are looked up without taking the lock.
+    thread_local QHash<Aerodrome::NamedArea, quint16> known;
+
+    auto it = known.constFind(narea);
+    if (it != known.constEnd())
+    {
+        id_ = it.value();
+        return;
+    }
+
+    AreaRegistry &registry = areaRegistry();
+    QMutexLocker locker(&registry.mutex);
+
+    quint16 id = registry.ids.value(narea, 0);
+    if (id == 0)
+    {
+        if (registry.ids.size() + 1 >= maxCount)
+        {
+            qFatal("Too many named areas.");
+        }
+
+        id = static_cast<quint16>(registry.ids.size() + 1);
+        registry.ids.insert(narea, id);
+        areaTable[id].store(new Aerodrome::NamedArea(narea), std::memory_order_release);
+    }
+
+    locker.unlock();
+
+    known.insert(narea, id);
+    id_ = id;
+}
+
+quint16 AreaId::value() const
+{
+    return id_;
+}
+
+Aerodrome::Area AreaId::area() const
+{
+    return namedArea().area_;
+}
+
+const Aerodrome::NamedArea &AreaId::namedArea() const
+{
+    const Aerodrome::NamedArea *narea = areaTable[id_].load(std::memory_order_acquire);
+    if (narea == nullptr)
+    {
+        return defaultNamedArea();
+    }
+
+    return *narea;
+}
+
+AreaId::operator const Aerodrome::NamedArea &() const
+{
+    return namedArea();
+}
+
+/* ---------------------------- Free functions ---------------------------- */
+
+bool operator==(const InlineIdent &lhs, const InlineIdent &rhs)
+{
+    return lhs.size_ == rhs.size_ &&
+           std::memcmp(lhs.chars_, rhs.chars_, InlineIdent::maxSize) == 0;
+}
+
+bool operator!=(const InlineIdent &lhs, const InlineIdent &rhs)
+{
+    return !(lhs == rhs);
+}
+
+bool operator==(const AreaId &lhs, const AreaId &rhs)
+{
+    return lhs.value() == rhs.value();
+}
+
+bool operator!=(const AreaId &lhs, const AreaId &rhs)
+{
+    return !(lhs == rhs);
+}
 
 bool operator==(const TargetReport &lhs, const TargetReport &rhs)
 {
@@ -44,3 +288,141 @@ bool operator==(const TargetReport &lhs, const TargetReport &rhs)
            lhs.pic_ == rhs.pic_ &&
            lhs.narea_ == rhs.narea_;
 }
+
+namespace
+{
+// Flags of the serialized target report.
+enum TargetReportFlag : quint8
+{
+    HasModeS = 0x01,
+    HasIdent = 0x02,
+    HasMode3A = 0x04,
+    HasVer = 0x08,
+    HasPic = 0x10,
+    OnGround = 0x20
+};
+}  // namespace
+
+/*!
+ * \brief Binary serialization of a target report, as used by the track
+ * cache. Timestamps are stored as milliseconds since the epoch and the
+ * optional fields are flagged in a single byte.
+ */
+QDataStream &operator<<(QDataStream &out, const TargetReport &tr)
+{
+    quint8 flags = 0;
+    flags |= tr.mode_s_.has_value() ? HasModeS : 0;
+    flags |= tr.ident_.has_value() ? HasIdent : 0;
+    flags |= tr.mode_3a_.has_value() ? HasMode3A : 0;
+    flags |= tr.ver_.has_value() ? HasVer : 0;
+    flags |= tr.pic_.has_value() ? HasPic : 0;
+    flags |= tr.on_gnd_ ? OnGround : 0;
+
+    // Time spec and, for fixed offsets, the offset from UTC.
+    const Qt::TimeSpec spec = tr.tod_.timeSpec() == Qt::TimeZone ? Qt::OffsetFromUTC : tr.tod_.timeSpec();
+
+    out << static_cast<quint8>(spec) << tr.tod_.toMSecsSinceEpoch();
+    if (spec == Qt::OffsetFromUTC)
+    {
+        out << static_cast<qint32>(tr.tod_.offsetFromUtc());
+    }
+
+    out << tr.x_ << tr.y_ << tr.z_
+        << static_cast<quint32>(tr.narea_.area()) << tr.narea_.namedArea().name_
+        << flags
+        << tr.ds_id_.sac_ << tr.ds_id_.sic_ << tr.trk_nb_
+        << static_cast<quint8>(tr.sys_typ_) << static_cast<quint8>(tr.tgt_typ_);
+
+    if (flags & HasModeS)
+    {
+        out << tr.mode_s_.value();
+    }
+    if (flags & HasIdent)
+    {
+        out << tr.ident_.value();
+    }
+    if (flags & HasMode3A)
+    {
+        out << tr.mode_3a_.value();
+    }
+    if (flags & HasVer)
+    {
+        out << tr.ver_.value();
+    }
+    if (flags & HasPic)
+    {
+        out << tr.pic_.value();
+    }
+
+    return out;
+}
+
+QDataStream &operator>>(QDataStream &in, TargetReport &tr)
+{
+    tr = TargetReport();
+
+    quint8 spec;
+    qint64 msecs;
+    in >> spec >> msecs;
+
+    if (spec == Qt::OffsetFromUTC)
+    {
+        qint32 offset;
+        in >> offset;
+        tr.tod_ = QDateTime::fromMSecsSinceEpoch(msecs, Qt::OffsetFromUTC, offset);
+    }
+    else
+    {
+        tr.tod_ = QDateTime::fromMSecsSinceEpoch(msecs, static_cast<Qt::TimeSpec>(spec));
+    }
+
+    quint32 area;
+    QString name;
+    quint8 flags;
+    quint8 sys_typ;
+    quint8 tgt_typ;
+
+    in >> tr.x_ >> tr.y_ >> tr.z_
+        >> area >> name
+        >> flags
+        >> tr.ds_id_.sac_ >> tr.ds_id_.sic_ >> tr.trk_nb_
+        >> sys_typ >> tgt_typ;
+
+    tr.narea_ = Aerodrome::NamedArea(static_cast<Aerodrome::Area>(area), name);
+    tr.sys_typ_ = static_cast<SystemType>(sys_typ);
+    tr.tgt_typ_ = static_cast<TargetType>(tgt_typ);
+    tr.on_gnd_ = flags & OnGround;
+
+    if (flags & HasModeS)
+    {
+        ModeS mode_s;
+        in >> mode_s;
+        tr.mode_s_ = mode_s;
+    }
+    if (flags & HasIdent)
+    {
+        Ident ident;
+        in >> ident;
+        tr.ident_ = ident;
+    }
+    if (flags & HasMode3A)
+    {
+        Mode3A mode_3a;
+        in >> mode_3a;
+        tr.mode_3a_ = mode_3a;
+    }
+    if (flags & HasVer)
+    {
+        quint8 ver;
+        in >> ver;
+        tr.ver_ = ver;
+    }
+    if (flags & HasPic)
+    {
+        quint8 pic;
+        in >> pic;
+        tr.pic_ = pic;
+    }
+
+    return in;
+}
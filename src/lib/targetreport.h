@@ -23,40 +23,138 @@
 #include "aerodrome.h"
 #include "asterix.h"
 #include "astmops.h"
+#include <QDataStream>
 #include <QDateTime>
+#include <functional>
 #include <optional>
 
-struct TargetReport
+/*!
+ * \brief Aircraft identification stored inline in the target report.
+ *
+ * Holds up to 8 characters, the size of the ICAO aircraft identification
+ * (I010/245, I021/170), in a fixed array so that copying or comparing a
+ * target report never touches the heap. Its interface mirrors the subset
+ * of std::optional<Ident> used throughout the code. Longer or non-Latin-1
+ * identifications are not valid ICAO identifications: assigning one
+ * warns and leaves no value.
+ */
+class InlineIdent
 {
-    DataSrcId ds_id_;
-    SystemType sys_typ_ = SystemType::Unknown;
-    QDateTime tod_;
+public:
+    static constexpr int maxSize = 8;
 
-    TrackNum trk_nb_ = 0;
+    static bool isValid(const Ident &ident);
+    static quint64 rejectedCount();
 
-    std::optional<ModeS> mode_s_;
-    std::optional<Mode3A> mode_3a_;
-    std::optional<Ident> ident_;
+    InlineIdent &operator=(const Ident &ident);
+    InlineIdent &operator=(std::nullopt_t);
 
-    TargetType tgt_typ_ = TargetType::Unknown;
+    bool has_value() const;
+    Ident value() const;
+    void reset();
 
-    bool on_gnd_ = false;
+private:
+    friend bool operator==(const InlineIdent &lhs, const InlineIdent &rhs);
+
+    static constexpr quint8 noValue = 0xFF;
+
+    char chars_[maxSize] = {};
+    quint8 size_ = noValue;
+};
+
+/*!
+ * \brief Named area stored as a 16-bit id.
+ *
+ * Named areas are interned in a process-wide table the first time they
+ * are seen, so a target report carries two bytes instead of a
+ * NamedArea and its QString, and comparing the areas of two target
+ * reports compares two integers. Id 0 is the default NamedArea. The
+ * table is never shrunk, so references returned by namedArea() stay
+ * valid and can be read from any thread without locking.
+ */
+class AreaId
+{
+public:
+    static constexpr int maxCount = 1 << 16;
+
+    AreaId() = default;
+    AreaId(const Aerodrome::NamedArea &narea);
+
+    quint16 value() const;
+
+    Aerodrome::Area area() const;
+    const Aerodrome::NamedArea &namedArea() const;
+    operator const Aerodrome::NamedArea &() const;
+
+private:
+    quint16 id_ = 0;
+};
+
+/*!
+ * \brief Target report as extracted from a surveillance system.
+ *
+ * Members are laid out from the widest to the narrowest, so the only
+ * padding is at the end of the structure, with the hot fields of the
+ * evaluator loops (timestamp, coordinates and area) at the front.
+ */
+struct TargetReport
+{
+    QDateTime tod_;
 
     // Coordinates in local cartesian reference system.
     double x_ = qSNaN();
     double y_ = qSNaN();
     double z_ = qSNaN();
 
-    Aerodrome::NamedArea narea_;
+    std::optional<ModeS> mode_s_;
+    std::optional<Mode3A> mode_3a_;
+
+    AreaId narea_;
+    TrackNum trk_nb_ = 0;
+
+    InlineIdent ident_;
+    DataSrcId ds_id_;
+
+    SystemType sys_typ_ = SystemType::Unknown;
+    TargetType tgt_typ_ = TargetType::Unknown;
+
+    bool on_gnd_ = false;
 
     std::optional<quint8> ver_;
     std::optional<quint8> pic_;
 };
 
+// The members add up to the size of the structure, save for the tail
+// padding that its alignment requires.
+static_assert(sizeof(TargetReport) ==
+                  (sizeof(QDateTime) + 3 * sizeof(double) +
+                   sizeof(std::optional<ModeS>) + sizeof(std::optional<Mode3A>) +
+                   sizeof(AreaId) + sizeof(TrackNum) + sizeof(InlineIdent) +
+                   sizeof(DataSrcId) + sizeof(SystemType) + sizeof(TargetType) +
+                   sizeof(bool) + 2 * sizeof(std::optional<quint8>) +
+                   alignof(TargetReport) - 1) /
+                      alignof(TargetReport) * alignof(TargetReport),
+    "TargetReport members are padded");
+
+Q_DECLARE_TYPEINFO(InlineIdent, Q_PRIMITIVE_TYPE);
+Q_DECLARE_TYPEINFO(AreaId, Q_PRIMITIVE_TYPE);
+Q_DECLARE_TYPEINFO(TargetReport, Q_MOVABLE_TYPE);
+
 Q_DECLARE_METATYPE(TargetReport);
 Q_DECLARE_METATYPE(QVector<TargetReport>);
 
+using TargetReportCallback = std::function<void(const TargetReport &)>;
+
 // FREE OPERATORS.
+bool operator==(const InlineIdent &lhs, const InlineIdent &rhs);
+bool operator!=(const InlineIdent &lhs, const InlineIdent &rhs);
+
+bool operator==(const AreaId &lhs, const AreaId &rhs);
+bool operator!=(const AreaId &lhs, const AreaId &rhs);
+
 bool operator==(const TargetReport &lhs, const TargetReport &rhs);
 
+QDataStream &operator<<(QDataStream &out, const TargetReport &tr);
+QDataStream &operator>>(QDataStream &in, TargetReport &tr);
+
 #endif  // ASTMOPS_TARGETREPORT_H
@@ -18,8 +18,9 @@
  */
 
 #include "targetreportextractor.h"
-#include "config.h"
 #include "geofunctions.h"
+#include "profiler.h"
+#include <algorithm>
 
 #if (QT_VERSION < QT_VERSION_CHECK(5, 14, 0))
 #include <QTextStream>
@@ -29,8 +30,9 @@ static const auto &hex = &::hex;
 }  // namespace Qt
 #endif
 
-TargetReportExtractor::TargetReportExtractor(const QGeoCoordinate &arp,
-    const QHash<Sic, QVector3D> &smr) : arp_(arp), smr_(smr)
+TargetReportExtractor::TargetReportExtractor(const RunConfig &config,
+    const QGeoCoordinate &arp, const QHash<Sic, QVector3D> &smr)
+    : config_(config), arp_(arp), ltp_(arp), smr_(smr)
 {
     // Initialize counters.
     counters_.insert(SystemType::Smr, Counters::InOutCounter());
@@ -40,18 +42,93 @@ TargetReportExtractor::TargetReportExtractor(const QGeoCoordinate &arp,
 
 void TargetReportExtractor::addData(const Asterix::Record &rec)
 {
-    if (rec.rec_typ_.isUnknown())
+    Profiler::ScopedTimer timer(Profiler::Stage::TargetReportExtraction);
+
+    if (extract(rec))
+    {
+        emit readyRead();
+    }
+}
+
+/*!
+ * \brief Adds the records \a recs. readyRead() is emitted once at the end
+ * if any target report was extracted.
+ */
+void TargetReportExtractor::addData(const QVector<Asterix::Record> &recs)
+{
+    Profiler::ScopedTimer timer(Profiler::Stage::TargetReportExtraction, recs.size());
+
+    bool extracted = false;
+    for (const Asterix::Record &rec : recs)
+    {
+        extracted |= extract(rec);
+    }
+
+    if (extracted)
+    {
+        emit readyRead();
+    }
+}
+
+void TargetReportExtractor::addDgpsData(const DgpsTargetData &tgt)
+{
+    addDgpsData(tgt, tgt.data_);
+}
+
+/*!
+ * \brief Adds a single DGPS position of the target described by \a tgt,
+ * whose own position list is ignored. Lets the reference be fed as it is
+ * read.
+ */
+void TargetReportExtractor::addDgpsData(const DgpsTargetData &tgt, const QGeoPositionInfo &pi)
+{
+    Profiler::ScopedTimer timer(Profiler::Stage::TargetReportExtraction);
+
+    extractDgps(tgt, pi);
+
+    emit readyRead();
+}
+
+/*!
+ * \brief Adds the DGPS positions \a pis of the target described by
+ * \a tgt, whose own position list is ignored. readyRead() is emitted once
+ * at the end.
+ */
+void TargetReportExtractor::addDgpsData(const DgpsTargetData &tgt, const QVector<QGeoPositionInfo> &pis)
+{
+    if (pis.isEmpty())
     {
         return;
     }
 
+    Profiler::ScopedTimer timer(Profiler::Stage::TargetReportExtraction, pis.size());
+
+    for (const QGeoPositionInfo &pi : pis)
+    {
+        extractDgps(tgt, pi);
+    }
+
+    emit readyRead();
+}
+
+/*!
+ * \brief Extracts the target report of \a rec, if it is kept. Returns
+ * true if a target report was queued.
+ */
+bool TargetReportExtractor::extract(const Asterix::Record &rec)
+{
+    if (rec.rec_typ_.isUnknown())
+    {
+        return false;
+    }
+
     ++counters_[rec.rec_typ_.sys_typ_].in_;
     if (Asterix::hasMinimumDataItems(rec) && isRecordToBeKept(rec))
     {
         std::optional<TargetReport> tr_opt = makeAsterixTargetReport(rec);
         if (!tr_opt.has_value())
         {
-            return;
+            return false;
         }
 
         TargetReport tr = tr_opt.value();
@@ -61,52 +138,46 @@ void TargetReportExtractor::addData(const Asterix::Record &rec)
         // outside the aerodrome areas.
         if (tr.sys_typ_ == SystemType::Adsb || tr.sys_typ_ == SystemType::Dgps)
         {
-            if (tr.narea_.area_ == Aerodrome::None)
+            if (tr.narea_.area() == Aerodrome::None)
             {
-                return;
+                return false;
             }
         }
 
-        tgt_reports_[tr.sys_typ_].enqueue(tr);
+        enqueue(tr);
         ++counters_[rec.rec_typ_.sys_typ_].out_;
 
-        emit readyRead();
+        return true;
     }
+
+    return false;
 }
 
-void TargetReportExtractor::addDgpsData(const DgpsTargetData &tgt)
+void TargetReportExtractor::extractDgps(const DgpsTargetData &tgt, const QGeoPositionInfo &pi)
 {
-    for (const QGeoPositionInfo &pi : tgt.data_)
-    {
-        QGeoCoordinate coords = pi.coordinate();
-        QVector3D cart = geoToLocalEnu(coords, arp_);
-
-        TargetReport tr;
-        tr.sys_typ_ = SystemType::Dgps;
-        tr.tod_ = pi.timestamp();
-        tr.trk_nb_ = 5000;
-        tr.mode_s_ = tgt.mode_s_;
-        tr.mode_3a_ = tgt.mode_3a_;
-        tr.ident_ = tgt.ident_;
+    QGeoCoordinate coords = pi.coordinate();
 
-        tr.on_gnd_ = cart.z() < 5;
+    TargetReport tr;
+    tr.sys_typ_ = SystemType::Dgps;
+    tr.tod_ = pi.timestamp();
+    tr.trk_nb_ = 5000;
+    tr.mode_s_ = tgt.mode_s_;
+    tr.mode_3a_ = tgt.mode_3a_;
+    tr.ident_ = tgt.ident_;
 
-        tr.x_ = cart.x();
-        tr.y_ = cart.y();
-        tr.z_ = cart.z();
+    ltp_.toEnu(coords.latitude(), coords.longitude(), coords.altitude(), &tr.x_, &tr.y_, &tr.z_);
 
-        QVector3D pos(tr.x_, tr.y_, tr.z_);
-        tr.narea_ = locatePoint(pos, tr.on_gnd_);
+    tr.on_gnd_ = tr.z_ < 5;
 
-        tr.ver_ = 2;
-        tr.pic_ = 14;
+    QVector3D pos(tr.x_, tr.y_, tr.z_);
+    tr.narea_ = locatePoint(pos, tr.on_gnd_);
 
-        tgt_reports_[tr.sys_typ_].enqueue(tr);
-        ++counters_[tr.sys_typ_].in_;
-        ++counters_[tr.sys_typ_].out_;
+    tr.ver_ = 2;
+    tr.pic_ = 14;
 
-        emit readyRead();
-    }
+    enqueue(tr);
+    ++counters_[tr.sys_typ_].in_;
+    ++counters_[tr.sys_typ_].out_;
 }
 
 void TargetReportExtractor::loadExcludedAddresses(QIODevice *device)
@@ -137,22 +208,69 @@ void TargetReportExtractor::setLocatePointCallback(const LocatePointCb &cb)
     locatePoint_cb_ = cb;
 }
 
+/*!
+ * \brief Takes the pending target report with the earliest timestamp.
+ *
+ * The per-system queues are merged by timestamp with a heap of their
+ * heads. Ties go to the system listed first in SystemType.
+ *
+ * Only the target reports pending at the time of the call are ordered:
+ * nothing is held back waiting for the other systems, so the output is
+ * in time order within one batch drained after a series of addData()
+ * calls, as long as every system delivers its own target reports in
+ * time order, but not across batches. A caller that drains after every
+ * record, as the pipelines do, gets the target reports in input order.
+ */
 std::optional<TargetReport> TargetReportExtractor::takeData()
 {
-    for (QQueue<TargetReport> &q : tgt_reports_)
+    if (heads_.empty())
     {
-        if (!q.isEmpty())
-        {
-            return q.dequeue();
-        }
+        return std::nullopt;
     }
 
-    return std::nullopt;
+    auto later = [this](SystemType lhs, SystemType rhs) { return isHeadLater(lhs, rhs); };
+
+    std::pop_heap(heads_.begin(), heads_.end(), later);
+    const SystemType st = heads_.back();
+
+    PoolQueue<TargetReport> &q = tgt_reports_[st];
+    TargetReport tr = q.dequeue();
+    --pending_;
+
+    if (q.isEmpty())
+    {
+        heads_.pop_back();
+    }
+    else
+    {
+        std::push_heap(heads_.begin(), heads_.end(), later);
+    }
+
+    return tr;
+}
+
+/*!
+ * \brief Appends all the pending target reports to \a out, in the order
+ * takeData() would return them.
+ */
+void TargetReportExtractor::takeAll(QVector<TargetReport> &out)
+{
+    out.reserve(out.size() + pending_);
+    while (std::optional<TargetReport> tr = takeData())
+    {
+        out.append(std::move(tr.value()));
+    }
 }
 
 QQueue<TargetReport> TargetReportExtractor::targetReports(SystemType st) const
 {
-    return tgt_reports_.value(st);
+    auto it = tgt_reports_.constFind(st);
+    if (it == tgt_reports_.constEnd())
+    {
+        return QQueue<TargetReport>();
+    }
+
+    return it->toQueue();
 }
 
 Counters::InOutCounter TargetReportExtractor::counters(SystemType st) const
@@ -162,15 +280,39 @@ Counters::InOutCounter TargetReportExtractor::counters(SystemType st) const
 
 bool TargetReportExtractor::hasPendingData() const
 {
-    for (const QQueue<TargetReport> &q : tgt_reports_)
+    return pending_ > 0;
+}
+
+void TargetReportExtractor::enqueue(const TargetReport &tr)
+{
+    PoolQueue<TargetReport> &q = tgt_reports_[tr.sys_typ_];
+    q.enqueue(tr);
+    ++pending_;
+
+    // A system enters the heap when its queue stops being empty.
+    if (q.size() == 1)
     {
-        if (!q.isEmpty())
-        {
-            return true;
-        }
+        heads_.push_back(tr.sys_typ_);
+        std::push_heap(heads_.begin(), heads_.end(),
+            [this](SystemType lhs, SystemType rhs) { return isHeadLater(lhs, rhs); });
     }
+}
 
-    return false;
+/*!
+ * \brief Returns true if the head of the queue of \a lhs goes after the
+ * head of the queue of \a rhs. Both queues must not be empty.
+ */
+bool TargetReportExtractor::isHeadLater(SystemType lhs, SystemType rhs) const
+{
+    const QDateTime &lhsTod = tgt_reports_.constFind(lhs)->head().tod_;
+    const QDateTime &rhsTod = tgt_reports_.constFind(rhs)->head().tod_;
+
+    if (lhsTod != rhsTod)
+    {
+        return lhsTod > rhsTod;
+    }
+
+    return lhs > rhs;
 }
 
 bool TargetReportExtractor::isExcludedAddr(ModeS addr) const
@@ -199,8 +341,6 @@ bool TargetReportExtractor::isRecordToBeKept(const Asterix::Record &rec) const
         return false;
     }
 
-    static ProcessingMode mode = Configuration::processingMode();
-
     bool ok;
     if (rec.rec_typ_.msg_typ_ == MessageType::TargetReport)
     {
@@ -230,10 +370,9 @@ bool TargetReportExtractor::isRecordToBeKept(const Asterix::Record &rec) const
                 return false;
             }
 
-            if (mode == ProcessingMode::Dgps)
+            if (config_.mode == ProcessingMode::Dgps)
             {
-                ModeS dgps_mode_s = Configuration::dgpsModeS();
-                if (tgt_addr == dgps_mode_s)
+                if (tgt_addr == config_.dgpsModeS)
                 {
                     // Only keep target reports that belong to the DGPS target.
                     return true;
@@ -687,11 +826,7 @@ std::optional<TargetReport> TargetReportExtractor::makeAsterixTargetReport(const
             }
         }
 
-        QVector3D cart = geoToLocalEnu(QGeoCoordinate(lat, lon, h), arp_);
-
-        tr.x_ = cart.x();
-        tr.y_ = cart.y();
-        tr.z_ = cart.z();
+        ltp_.toEnu(lat, lon, h, &tr.x_, &tr.y_, &tr.z_);
 
         // Mode S.
         bool mode_s_ok = false;
@@ -820,5 +955,6 @@ std::optional<TargetReport> TargetReportExtractor::makeAsterixTargetReport(const
 
 Aerodrome::NamedArea TargetReportExtractor::locatePoint(const QVector3D pos, const bool gbs) const
 {
+    Profiler::ScopedTimer timer(Profiler::Stage::LocatePoint);
     return locatePoint_cb_(pos, gbs);
 }
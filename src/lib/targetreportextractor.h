@@ -22,12 +22,16 @@
 
 #include "asterix.h"
 #include "astmops.h"
+#include "config.h"
 #include "counters.h"
+#include "geofunctions.h"
+#include "poolqueue.h"
 #include "targetreport.h"
 #include <QGeoCoordinate>
 #include <QObject>
 #include <QQueue>
 #include <optional>
+#include <vector>
 
 using LocatePointCb = std::function<Aerodrome::NamedArea(const QVector3D&, const bool)>;
 
@@ -36,14 +40,18 @@ class TargetReportExtractor : public QObject
     Q_OBJECT
 
 public:
-    TargetReportExtractor(const QGeoCoordinate& arp,
+    TargetReportExtractor(const RunConfig& config, const QGeoCoordinate& arp,
         const QHash<Sic, QVector3D>& smr);
 
     void addData(const Asterix::Record& rec);
+    void addData(const QVector<Asterix::Record>& recs);
     void addDgpsData(const DgpsTargetData& tgt);
+    void addDgpsData(const DgpsTargetData& tgt, const QGeoPositionInfo& pi);
+    void addDgpsData(const DgpsTargetData& tgt, const QVector<QGeoPositionInfo>& pis);
     void loadExcludedAddresses(QIODevice* device);
     void setLocatePointCallback(const LocatePointCb& cb);
     std::optional<TargetReport> takeData();
+    void takeAll(QVector<TargetReport>& out);
 
     QQueue<TargetReport> targetReports(SystemType st) const;
     Counters::InOutCounter counters(SystemType st) const;
@@ -55,6 +63,10 @@ signals:
     void readyRead();
 
 private:
+    bool extract(const Asterix::Record& rec);
+    void extractDgps(const DgpsTargetData& tgt, const QGeoPositionInfo& pi);
+    void enqueue(const TargetReport& tr);
+    bool isHeadLater(SystemType lhs, SystemType rhs) const;
     bool isExcludedAddr(ModeS addr) const;
     bool isRecordToBeKept(const Asterix::Record& rec) const;
     std::optional<TargetReport> makeAsterixTargetReport(const Asterix::Record& rec) const;
@@ -62,12 +74,19 @@ private:
 
     LocatePointCb locatePoint_cb_;
 
+    RunConfig config_;
     QGeoCoordinate arp_;
+    LocalTangentPlane ltp_;
     QHash<Sic, QVector3D> smr_;
 
     QSet<ModeS> excluded_addresses_;
     QHash<SystemType, Counters::InOutCounter> counters_;
-    QHash<SystemType, QQueue<TargetReport>> tgt_reports_;
+    QHash<SystemType, PoolQueue<TargetReport>> tgt_reports_;
+
+    // Systems with pending target reports, as a min-heap by the timestamp
+    // of the head of their queue.
+    std::vector<SystemType> heads_;
+    int pending_ = 0;
 };
 
 #endif  // ASTMOPS_TARGETREPORTEXTRACTOR_H
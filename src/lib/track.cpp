@@ -885,6 +885,50 @@ bool operator==(const TrackCollectionSet &lhs, const TrackCollectionSet &rhs)
            lhs.matches() == rhs.matches();
 }
 
+QDataStream &operator<<(QDataStream &out, const Track &t)
+{
+    out << static_cast<quint8>(t.system_type()) << t.track_number()
+        << t.mode_s().has_value() << t.mode_s().value_or(0)
+        << static_cast<quint32>(t.size());
+
+    for (const TargetReport &tr : t)
+    {
+        out << tr;
+    }
+
+    return out;
+}
+
+QDataStream &operator>>(QDataStream &in, Track &t)
+{
+    quint8 st;
+    TrackNum tn;
+    bool hasModeS;
+    ModeS mode_s;
+    quint32 size;
+    in >> st >> tn >> hasModeS >> mode_s >> size;
+
+    t = hasModeS ? Track(mode_s, static_cast<SystemType>(st), tn)
+                 : Track(static_cast<SystemType>(st), tn);
+
+    QVector<TargetReport> trs;
+    for (quint32 i = 0; i < size && in.status() == QDataStream::Ok; ++i)
+    {
+        TargetReport tr;
+        in >> tr;
+        trs << tr;
+    }
+
+    // Inserting a report puts it before the ones with the same timestamp,
+    // so they are inserted in reverse to rebuild the serialized order.
+    for (auto it = trs.crbegin(); it != trs.crend(); ++it)
+    {
+        t << *it;
+    }
+
+    return in;
+}
+
 bool operator<(const Track &lhs, const Track &rhs)
 {
     return lhs.beginTimestamp() < rhs.beginTimestamp();
@@ -230,6 +230,9 @@ bool operator==(const Track &lhs, const Track &rhs);
 bool operator==(const TrackCollection &lhs, const TrackCollection &rhs);
 bool operator==(const TrackCollectionSet &lhs, const TrackCollectionSet &rhs);
 
+QDataStream &operator<<(QDataStream &out, const Track &t);
+QDataStream &operator>>(QDataStream &in, Track &t);
+
 bool operator<(const Track &lhs, const Track &rhs);
 bool operator<(const TrackCollection &lhs, const TrackCollection &rhs);
 
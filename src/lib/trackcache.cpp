@@ -0,0 +1,256 @@
+/*!
+ * \file trackcache.cpp
+ * \brief Implementation of the TrackCache class.
+ * \author Álvaro Cebrián Juan, 2020. acebrianjuan(at)gmail.com
+ *
+ * -----------------------------------------------------------------------
+ *
+ * Copyright (C) 2020-2021 Álvaro Cebrián Juan <acebrianjuan@gmail.com>
+ *
+ * ASTMOPS is a command line tool for evaluating 
+ * the performance of A-SMGCS sensors at airports
+ *
+ * This file is part of ASTMOPS.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -----------------------------------------------------------------------
+ */
+
+#include "trackcache.h"
+#include "config.h"
+#include "functions.h"
+#include <QBuffer>
+#include <QCryptographicHash>
+#include <QDebug>
+#include <QFile>
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace
+{
+const char magic[] = "ASTMTRKS";
+const int magicSize = 8;
+const QDataStream::Version streamVersion = QDataStream::Qt_5_12;
+}  // namespace
+
+TrackCache::TrackCache(const QString &dir) : dir_(dir)
+{
+}
+
+/*!
+ * \brief Cache key for the tracks extracted from the ASTERIX recording at
+ * \a inputPath with the settings in \a config.
+ *
+ * It covers every input of the extraction: the recording, the aerodrome
+ * KML at \a kmlPath (used to locate the target reports), the DGPS
+ * reference at \a dgpsPath in DGPS mode and the settings read by the
+ * reader and extractors. Evaluation settings are left out on purpose, so
+ * changing them reuses the cache.
+ */
+QByteArray TrackCache::extractionKey(const RunConfig &config, const QString &inputPath,
+    const QString &kmlPath, const QString &dgpsPath)
+{
+    QByteArray data;
+    QDataStream stream(&data, QIODevice::WriteOnly);
+    stream.setVersion(streamVersion);
+
+    auto sortedSics = [](const QSet<Sic> &set) {
+        QVector<Sic> sics;
+        for (Sic sic : set)
+        {
+            sics << sic;
+        }
+        std::sort(sics.begin(), sics.end());
+        return sics;
+    };
+
+    stream << version
+           << fileDigest(inputPath)
+           << fileDigest(kmlPath)
+           << static_cast<int>(config.mode)
+           << config.asterixDate
+           << config.useXmlTimestamp
+           << sortedSics(config.smrSic)
+           << sortedSics(config.mlatSic)
+           << sortedSics(config.adsbSic);
+
+    // Late target reports are discarded, so the lateness changes the tracks.
+    if (config.allowedLateness.has_value())
+    {
+        stream << config.allowedLateness.value();
+    }
+
+    if (config.mode == ProcessingMode::Dgps)
+    {
+        stream << fileDigest(dgpsPath)
+               << config.dgpsModeS
+               << config.dgpsMode3A
+               << config.dgpsIdent
+               << config.dgpsTodOffset;
+    }
+
+    return QCryptographicHash::hash(data, QCryptographicHash::Sha256);
+}
+
+/*!
+ * \brief Decodes the tracks cached under \a key and passes them to
+ * \a callback in the order they were stored. Returns false, without
+ * calling \a callback, if there is no valid cache file for \a key or it
+ * is corrupt, so that the caller extracts the tracks from the sources.
+ */
+bool TrackCache::load(const QByteArray &key, const std::function<void(const Track &)> &callback) const
+{
+    QFile file(filePath(key));
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        return false;
+    }
+
+    // Decode straight from a mapping of the file when it fits in a
+    // QByteArray, from the file itself otherwise.
+    QBuffer buffer;
+    QIODevice *device = &file;
+
+    if (file.size() <= std::numeric_limits<int>::max())
+    {
+        if (const uchar *map = file.map(0, file.size()))
+        {
+            buffer.setData(QByteArray::fromRawData(reinterpret_cast<const char *>(map), static_cast<int>(file.size())));
+            buffer.open(QIODevice::ReadOnly);
+            device = &buffer;
+        }
+    }
+
+    QDataStream in(device);
+    in.setVersion(streamVersion);
+
+    char fileMagic[magicSize];
+    quint16 fileVersion = 0;
+    QByteArray fileKey;
+    quint64 count = 0;
+    quint64 size = 0;
+
+    if (in.readRawData(fileMagic, magicSize) != magicSize ||
+        std::memcmp(fileMagic, magic, magicSize) != 0)
+    {
+        qWarning() << "Ignoring invalid track cache" << file.fileName();
+        return false;
+    }
+
+    in >> fileVersion >> fileKey >> count >> size;
+
+    if (in.status() != QDataStream::Ok || fileVersion != version || fileKey != key ||
+        size != static_cast<quint64>(device->size() - device->pos()))
+    {
+        qWarning() << "Ignoring stale or incomplete track cache" << file.fileName();
+        return false;
+    }
+
+    // Every track is decoded before the first one is handed over, so that
+    // a corrupt file does not leave the caller with part of the tracks.
+    QVector<Track> tracks;
+    for (quint64 i = 0; i < count; ++i)
+    {
+        Track t;
+        in >> t;
+
+        if (in.status() != QDataStream::Ok)
+        {
+            qWarning() << "Ignoring corrupt track cache" << file.fileName();
+            return false;
+        }
+
+        tracks << t;
+    }
+
+    if (!in.atEnd())
+    {
+        qWarning() << "Ignoring corrupt track cache" << file.fileName();
+        return false;
+    }
+
+    for (const Track &t : qAsConst(tracks))
+    {
+        callback(t);
+    }
+
+    return true;
+}
+
+/*!
+ * \brief Starts writing a new cache file for \a key. It replaces any
+ * previous one when commit() is called.
+ */
+bool TrackCache::beginStore(const QByteArray &key)
+{
+    if (!dir_.mkpath(QLatin1String(".")))
+    {
+        qWarning() << "Could not create track cache directory" << dir_.path();
+        return false;
+    }
+
+    saveFile_ = std::make_unique<QSaveFile>(filePath(key));
+    if (!saveFile_->open(QIODevice::WriteOnly))
+    {
+        qWarning() << "Could not write track cache" << saveFile_->fileName();
+        saveFile_.reset();
+        return false;
+    }
+
+    out_.setDevice(saveFile_.get());
+    out_.setVersion(streamVersion);
+
+    out_.writeRawData(magic, magicSize);
+    out_ << version << key;
+
+    // Placeholders for the count and size, filled in by commit().
+    dataPos_ = saveFile_->pos();
+    out_ << quint64(0) << quint64(0);
+
+    count_ = 0;
+
+    return true;
+}
+
+void TrackCache::store(const Track &t)
+{
+    if (!saveFile_)
+    {
+        return;
+    }
+
+    out_ << t;
+    ++count_;
+}
+
+bool TrackCache::commit()
+{
+    if (!saveFile_)
+    {
+        return false;
+    }
+
+    const qint64 end = saveFile_->pos();
+    const quint64 size = static_cast<quint64>(end - dataPos_) - 2 * sizeof(quint64);
+
+    saveFile_->seek(dataPos_);
+    out_ << count_ << size;
+
+    out_.setDevice(nullptr);
+    const bool ok = saveFile_->commit();
+    saveFile_.reset();
+
+    if (!ok)
+    {
+        qWarning() << "Could not write track cache";
+    }
+
+    return ok;
+}
+
+QString TrackCache::filePath(const QByteArray &key) const
+{
+    return dir_.filePath(QString::fromLatin1(key.toHex()) + QLatin1String(".trk"));
+}
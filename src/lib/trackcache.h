@@ -0,0 +1,80 @@
+/*!
+ * \file trackcache.h
+ * \brief Interface of the TrackCache class.
+ * \author Álvaro Cebrián Juan, 2020. acebrianjuan(at)gmail.com
+ *
+ * -----------------------------------------------------------------------
+ *
+ * Copyright (C) 2020-2021 Álvaro Cebrián Juan <acebrianjuan@gmail.com>
+ *
+ * ASTMOPS is a command line tool for evaluating 
+ * the performance of A-SMGCS sensors at airports
+ *
+ * This file is part of ASTMOPS.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -----------------------------------------------------------------------
+ */
+
+#ifndef ASTMOPS_TRACKCACHE_H
+#define ASTMOPS_TRACKCACHE_H
+
+#include "config.h"
+#include "track.h"
+#include <QDataStream>
+#include <QDir>
+#include <QSaveFile>
+#include <functional>
+#include <memory>
+
+/*!
+ * \brief The TrackCache class stores the tracks extracted from a recording
+ * in a binary file, so that later runs on the same recording can skip the
+ * ASTERIX parsing and target report extraction altogether.
+ *
+ * Each cache file is named after a key that hashes the contents of the
+ * input files and the settings that affect extraction (see
+ * extractionKey()), so any change to them just misses the cache. Files
+ * are written through QSaveFile and only appear once complete.
+ *
+ * File layout (QDataStream, Qt 5.12 format):
+ *
+ *     magic      8 bytes   "ASTMTRKS"
+ *     version    quint16   TrackCache::version
+ *     key        QByteArray
+ *     count      quint64   Number of tracks
+ *     size       quint64   Size of the track data in bytes
+ *     tracks     count serialized Track
+ *
+ * On load the file is memory mapped and the tracks are decoded straight
+ * from the mapping.
+ */
+class TrackCache
+{
+public:
+    static constexpr quint16 version = 2;
+
+    explicit TrackCache(const QString &dir);
+
+    static QByteArray extractionKey(const RunConfig &config, const QString &inputPath,
+        const QString &kmlPath, const QString &dgpsPath = QString());
+
+    bool load(const QByteArray &key, const std::function<void(const Track &)> &callback) const;
+
+    bool beginStore(const QByteArray &key);
+    void store(const Track &t);
+    bool commit();
+
+private:
+    QString filePath(const QByteArray &key) const;
+
+    QDir dir_;
+
+    std::unique_ptr<QSaveFile> saveFile_;
+    QDataStream out_;
+    qint64 dataPos_ = 0;
+    quint64 count_ = 0;
+};
+
+#endif  // ASTMOPS_TRACKCACHE_H
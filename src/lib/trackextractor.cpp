@@ -18,14 +18,38 @@
  */
 
 #include "trackextractor.h"
-#include "config.h"
+#include "profiler.h"
 
-TrackExtractor::TrackExtractor()
+TrackExtractor::TrackExtractor(const RunConfig &config)
+    : config_(config), watermarks_(config.allowedLateness)
 {
 }
 
 void TrackExtractor::addData(const TargetReport &tr)
 {
+    Profiler::ScopedTimer timer(Profiler::Stage::TrackBuilding);
+
+    append(tr);
+}
+
+void TrackExtractor::addData(const QVector<TargetReport> &trs)
+{
+    Profiler::ScopedTimer timer(Profiler::Stage::TrackBuilding, trs.size());
+
+    for (const TargetReport &tr : trs)
+    {
+        append(tr);
+    }
+}
+
+void TrackExtractor::append(const TargetReport &tr)
+{
+    // Target reports behind the watermark of their system are dropped.
+    if (!watermarks_.advance(tr.sys_typ_, tr.tod_))
+    {
+        return;
+    }
+
     if (!tracks_.value(tr.sys_typ_).contains(tr.trk_nb_))
     {
         tracks_[tr.sys_typ_].insert(tr.trk_nb_, Track(tr.sys_typ_, tr.trk_nb_));
@@ -62,8 +86,6 @@ bool TrackExtractor::hasPendingData() const
 
 std::optional<Track> TrackExtractor::takeData()
 {
-    static ProcessingMode mode = Configuration::processingMode();
-
     for (QMap<TrackNum, Track> &m : tracks_)
     {
         while (!m.isEmpty())
@@ -71,7 +93,7 @@ std::optional<Track> TrackExtractor::takeData()
             Track t = m.take(m.begin().key());
             SystemType st = t.system_type();
 
-            if (mode == ProcessingMode::Dgps)
+            if (config_.mode == ProcessingMode::Dgps)
             {
                 return t;
             }
@@ -93,3 +115,8 @@ std::optional<Track> TrackExtractor::takeData()
 
     return std::nullopt;
 }
+
+const Watermarks &TrackExtractor::watermarks() const
+{
+    return watermarks_;
+}
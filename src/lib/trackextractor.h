@@ -21,23 +21,32 @@
 #define ASTMOPS_TRACKEXTRACTOR_H
 
 #include "astmops.h"
+#include "config.h"
 #include "targetreport.h"
 #include "track.h"
+#include "watermarks.h"
 
 class TrackExtractor
 {
 public:
-    TrackExtractor();
+    explicit TrackExtractor(const RunConfig& config);
 
     void addData(const TargetReport& tr);
+    void addData(const QVector<TargetReport>& trs);
 
     QVector<Track> tracks(SystemType st) const;
     bool hasPendingData() const;
 
     std::optional<Track> takeData();
 
+    const Watermarks& watermarks() const;
+
 private:
+    void append(const TargetReport& tr);
+
+    RunConfig config_;
     QHash<SystemType, QMap<TrackNum, Track>> tracks_;
+    Watermarks watermarks_;
 };
 
 #endif  // ASTMOPS_TRACKEXTRACTOR_H
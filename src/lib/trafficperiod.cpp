@@ -19,6 +19,7 @@
 
 
 #include "trafficperiod.h"
+#include <algorithm>
 
 /* ----------------------------- TrafficPeriod ---------------------------- */
 
@@ -169,51 +170,32 @@ QSet<ModeS> TrafficPeriod::traffic() const
 
 TrafficPeriodCollection &TrafficPeriodCollection::operator<<(const TrafficPeriod &tp)
 {
-    if (!tp.isValid())
+    // Periods of zero duration do not contribute any traffic.
+    if (!tp.isValid() || tp.beginTimestamp() >= tp.endTimestamp())
     {
         return *this;
     }
 
-    // Make a mutable (non-const) copy of the input period.
-    TrafficPeriod mtp = tp;
+    split(tp.endTimestamp());
+    SegmentMap::iterator it = split(tp.beginTimestamp());
 
-    auto findFirstOverlap = [this](const TrafficPeriod &tp) {
-        QVector<TrafficPeriod>::iterator it;
-        for (it = periods_.begin(); it != periods_.end(); ++it)
-        {
-            if (tp.overlaps(*it))
-            {
-                return it;
-            }
-        }
+    const QSet<ModeS> traffic = tp.traffic();
 
-        return periods_.end();
-    };
-
-
-    // Add first period directly.
-    if (periods_.isEmpty())
-    {
-        periods_ << mtp;
-    }
-    else
+    while (it.key() < tp.endTimestamp())
     {
-        if (overlaps(mtp))
-        {
-            QVector<TrafficPeriod>::iterator it = findFirstOverlap(mtp);
-            Q_ASSERT(it != periods_.end());
-
-            dealOverlap(*it, mtp);
+        SegmentMap::iterator next = it;
+        ++next;
+        Q_ASSERT(next != segments_.end());
 
-            //periods_.insert(it, );
-        }
-        else
+        if (it.value().isEmpty())
         {
-            periods_ << mtp;
+            ++size_;
+            duration_ms_ += it.key().msecsTo(next.key());
         }
 
-        // Sort time periods chronologically.
-        sort();
+        it.value().unite(traffic);
+
+        it = next;
     }
 
     return *this;
@@ -258,13 +240,7 @@ TrafficPeriodCollection &TrafficPeriodCollection::operator<<(const TrackCollecti
 
 double TrafficPeriodCollection::duration() const
 {
-    double dur = 0;
-    for (const TrafficPeriod &tp : periods_)
-    {
-        dur += tp.duration();
-    }
-
-    return dur;
+    return duration_ms_ / 1000.0;
 }
 
 quint32 TrafficPeriodCollection::expectedUpdates(double freq) const
@@ -274,8 +250,10 @@ quint32 TrafficPeriodCollection::expectedUpdates(double freq) const
 
 quint32 TrafficPeriodCollection::expectedTgtReps(double freq) const
 {
+    // Truncated period by period, as TrafficPeriod::expectedTgtReps() does,
+    // so that periods with fractional seconds add up to the same total.
     quint32 etr = 0;
-    for (const TrafficPeriod &tp : periods_)
+    for (const TrafficPeriod &tp : *this)
     {
         etr += tp.expectedTgtReps(freq);
     }
@@ -290,12 +268,25 @@ bool TrafficPeriodCollection::coversTimestamp(const QDateTime &dt) const
         return false;
     }
 
-    for (const TrafficPeriod &tp : periods_)
+    // Segment that contains the timestamp.
+    SegmentMap::const_iterator it = segments_.upperBound(dt);
+    if (it == segments_.constBegin())
     {
-        if (tp.coversTimestamp(dt))
-        {
-            return true;
-        }
+        return false;
+    }
+    --it;
+
+    if (!it.value().isEmpty())
+    {
+        return true;
+    }
+
+    // Periods are closed intervals: the timestamp may match the end of the
+    // preceding segment.
+    if (it.key() == dt && it != segments_.constBegin())
+    {
+        --it;
+        return !it.value().isEmpty();
     }
 
     return false;
@@ -303,12 +294,28 @@ bool TrafficPeriodCollection::coversTimestamp(const QDateTime &dt) const
 
 bool TrafficPeriodCollection::overlaps(const TrafficPeriod &tp) const
 {
-    for (const TrafficPeriod &otp : periods_)
+    // Start from the segment that contains the beginning of the period.
+    SegmentMap::const_iterator it = segments_.upperBound(tp.beginTimestamp());
+    if (it != segments_.constBegin())
+    {
+        --it;
+    }
+
+    while (it != segments_.constEnd() && it.key() < tp.endTimestamp())
     {
-        if (tp.overlaps(otp))
+        SegmentMap::const_iterator next = it;
+        ++next;
+        if (next == segments_.constEnd())
+        {
+            break;
+        }
+
+        if (!it.value().isEmpty() && tp.beginTimestamp() < next.key())
         {
             return true;
         }
+
+        it = next;
     }
 
     return false;
@@ -316,257 +323,202 @@ bool TrafficPeriodCollection::overlaps(const TrafficPeriod &tp) const
 
 bool TrafficPeriodCollection::isEmpty() const
 {
-    return periods_.isEmpty();
+    return size_ == 0;
 }
 
 int TrafficPeriodCollection::size() const
 {
-    return periods_.size();
+    return size_;
 }
 
 QDateTime TrafficPeriodCollection::beginTimestamp() const
 {
-    if (periods_.isEmpty())
+    for (auto it = segments_.constBegin(); it != segments_.constEnd(); ++it)
     {
-        return QDateTime();
+        if (!it.value().isEmpty())
+        {
+            return it.key();
+        }
     }
 
-    return periods_.first().beginTimestamp();
+    return QDateTime();
 }
 
 QDateTime TrafficPeriodCollection::endTimestamp() const
 {
-    if (periods_.isEmpty())
+    if (segments_.isEmpty())
     {
         return QDateTime();
     }
 
-    return periods_.last().endTimestamp();
+    // The end of the last non-empty segment is the key that follows it.
+    SegmentMap::const_iterator it = segments_.constEnd();
+    --it;
+    while (it != segments_.constBegin())
+    {
+        SegmentMap::const_iterator prev = it;
+        --prev;
+        if (!prev.value().isEmpty())
+        {
+            return it.key();
+        }
+        it = prev;
+    }
+
+    return QDateTime();
 }
 
 void TrafficPeriodCollection::removeSmallPeriods(double min_duration)
 {
-    QVector<TrafficPeriod>::iterator it = periods_.begin();
-    while (it != periods_.end())
+    for (auto it = segments_.begin(); it != segments_.end(); ++it)
     {
-        TrafficPeriod tp = *it;
-        if (tp.duration() < min_duration)
+        if (it.value().isEmpty())
         {
-            it = periods_.erase(it);
+            continue;
         }
-        else
+
+        SegmentMap::iterator next = it;
+        ++next;
+        Q_ASSERT(next != segments_.end());
+
+        const qint64 ms = it.key().msecsTo(next.key());
+        if (ms / 1000.0 < min_duration)
         {
-            ++it;
+            --size_;
+            duration_ms_ -= ms;
+
+            it.value().clear();
         }
     }
 }
 
-void TrafficPeriodCollection::dealOverlap(TrafficPeriod &oldtp, TrafficPeriod &newtp)
+TrafficPeriodCollection::SegmentMap::iterator TrafficPeriodCollection::split(const QDateTime &dt)
 {
-    Q_ASSERT(newtp.overlaps(oldtp));
-
-    if (oldtp.beginTimestamp() == newtp.beginTimestamp() &&
-        oldtp.endTimestamp() == newtp.endTimestamp())
+    SegmentMap::iterator it = segments_.lowerBound(dt);
+    if (it != segments_.end() && it.key() == dt)
     {
-        // CASE 0: Old period and new period have identical times.
-
-        // Simply add the traffic contents of the new period to the old one.
-        oldtp << newtp.traffic();
+        return it;
     }
-    else if (oldtp.beginTimestamp() == newtp.beginTimestamp())
-    {
-        if (newtp.endTimestamp() < oldtp.endTimestamp())
-        {
-            // CASE 1: Old period and new period start at the same time.
-            //         New period ends before old period.
 
-            // Create intersection period.
-            TrafficPeriod itp(newtp.beginTimestamp(), newtp.endTimestamp());
-            itp << oldtp.traffic() << newtp.traffic();
-
-            // Shrink old period from the front to match the end of the
-            // intersection period.
-            oldtp.shrinkFront(itp.endTimestamp());
+    // The new boundary inherits the traffic of the segment it falls in.
+    QSet<ModeS> traffic;
+    if (it != segments_.begin())
+    {
+        SegmentMap::iterator prev = it;
+        --prev;
+        traffic = prev.value();
+    }
 
-            if (itp.isValid())
-            {
-                // Insert intersection period.
-                *this << itp;
-            }
-        }
-        else
-        {
-            // CASE 2: Old period and new period start at the same time.
-            //         New period ends after old period.
+    if (!traffic.isEmpty())
+    {
+        ++size_;
+    }
 
-            // Add the traffic contents of the new period to the old one.
-            oldtp << newtp.traffic();
+    return segments_.insert(it, dt, traffic);
+}
 
-            // Create remainder of the new period by copying the new period
-            // and shrinking it from the front to match the end of the
-            // intersection period.
-            TrafficPeriod rnewtp(newtp);
-            rnewtp.shrinkFront(oldtp.endTimestamp());
+/* ------------------------- TrafficPeriodBuilder ------------------------- */
 
-            if (rnewtp.isValid())
-            {
-                // Insert remainder of the new period.
-                *this << rnewtp;
-            }
-        }
-    }
-    else if (oldtp.endTimestamp() == newtp.endTimestamp())
+TrafficPeriodBuilder &TrafficPeriodBuilder::operator<<(const TrafficPeriod &tp)
+{
+    // Periods of zero duration do not contribute any traffic.
+    if (tp.isValid() && tp.beginTimestamp() < tp.endTimestamp())
     {
-        if (oldtp.beginTimestamp() < newtp.beginTimestamp())
-        {
-            // CASE 3: Old period and new period end at the same time.
-            //         New period starts after old period.
+        periods_ << tp;
+    }
 
-            // Create intersection period.
-            TrafficPeriod itp(newtp.beginTimestamp(), newtp.endTimestamp());
-            itp << oldtp.traffic() << newtp.traffic();
+    return *this;
+}
 
-            // Shrink old period from the back to match the beginning of the
-            // intersection period.
-            oldtp.shrinkBack(itp.beginTimestamp());
+TrafficPeriodBuilder &TrafficPeriodBuilder::operator<<(const Track &trk)
+{
+    *this << TrafficPeriod(trk);
 
-            if (itp.isValid())
-            {
-                // Insert intersection period.
-                *this << itp;
-            }
-        }
-        else
-        {
-            // CASE 4: Old period and new period end at the same time.
-            //         New period starts before old period.
+    return *this;
+}
 
-            // Add the traffic contents of the new period to the old one.
-            oldtp << newtp.traffic();
+/*!
+ * \brief Adds the periods collected by \a other, e.g. in another
+ * evaluation of the same traffic.
+ */
+TrafficPeriodBuilder &TrafficPeriodBuilder::operator+=(const TrafficPeriodBuilder &other)
+{
+    periods_ << other.periods_;
 
-            // Create remainder of the new period by copying the new period
-            // and shrinking it from the back to match the beginning of the
-            // intersection period.
-            TrafficPeriod rnewtp(newtp);
-            rnewtp.shrinkBack(oldtp.beginTimestamp());
+    return *this;
+}
 
-            if (rnewtp.isValid())
-            {
-                // Insert remainder of the new period.
-                *this << rnewtp;
-            }
-        }
-    }
-    else if (oldtp.beginTimestamp() < newtp.beginTimestamp())
+TrafficPeriodCollection TrafficPeriodBuilder::build() const
+{
+    struct Event
     {
-        if (newtp.endTimestamp() > oldtp.endTimestamp())
-        {
-            // CASE 5: Old period starts before new period.
-            //         New period ends after old period.
-
-            // Create intersection period.
-            TrafficPeriod itp(newtp.beginTimestamp(), oldtp.endTimestamp());
-            itp << oldtp.traffic() << newtp.traffic();
-
-            // Shrink old period from the back to match the beginning of the
-            // intersection period.
-            oldtp.shrinkBack(itp.beginTimestamp());
+        qint64 msecs_;
+        QDateTime timestamp_;
+        int index_;
+        bool begin_;
+    };
 
-            // Shrink new period from the front to match the end of the
-            // intersection period.
-            newtp.shrinkFront(itp.endTimestamp());
+    QVector<Event> events;
+    events.reserve(2 * periods_.size());
 
-            if (itp.isValid() && newtp.isValid())
-            {
-                // Insert intersection period and remainder of the new period.
-                *this << itp << newtp;
-            }
-        }
-        else
-        {
-            // CASE 6: Old period starts before and ends after new period.
+    for (int i = 0; i < periods_.size(); ++i)
+    {
+        const TrafficPeriod &tp = periods_.at(i);
+        events << Event{tp.beginTimestamp().toMSecsSinceEpoch(), tp.beginTimestamp(), i, true};
+        events << Event{tp.endTimestamp().toMSecsSinceEpoch(), tp.endTimestamp(), i, false};
+    }
 
-            // Create intersection period by copying the new period and adding
-            // the traffic contents of the old period.
-            TrafficPeriod itp(newtp);
-            itp << oldtp.traffic();
+    std::sort(events.begin(), events.end(), [](const Event &lhs, const Event &rhs) {
+        return lhs.msecs_ < rhs.msecs_;
+    });
 
-            // Create remainder of the old period by copying the old period
-            // and shrinking it from the front to match the end of the
-            // intersection period.
-            TrafficPeriod roldtp(oldtp);
-            roldtp.shrinkFront(itp.endTimestamp());
+    // Number of open periods each target is present in.
+    QHash<ModeS, int> active;
 
-            // Shrink old period from the front to match the beginning of the
-            // intersection period.
-            oldtp.shrinkBack(newtp.beginTimestamp());
+    TrafficPeriodCollection col;
+    QDateTime last;
 
-            if (itp.isValid() && roldtp.isValid())
-            {
-                // Insert intersection period and remainder of the old period.
-                *this << itp << roldtp;
-            }
-        }
-    }
-    else if (newtp.beginTimestamp() < oldtp.beginTimestamp())
+    int i = 0;
+    while (i < events.size())
     {
-        if (newtp.endTimestamp() < oldtp.endTimestamp())
-        {
-            // CASE 7: New period starts before old period.
-            //         Old period ends after new period.
+        const qint64 msecs = events.at(i).msecs_;
+        const QDateTime timestamp = events.at(i).timestamp_;
 
-            // Create intersection period.
-            TrafficPeriod itp(oldtp.beginTimestamp(), newtp.endTimestamp());
-            itp << oldtp.traffic() << newtp.traffic();
-
-            // Shrink old period from the back to match the beginning of the
-            // intersection period.
-            oldtp.shrinkFront(itp.endTimestamp());
-
-            // Shrink new period from the front to match the beginning of the
-            // intersection period.
-            newtp.shrinkBack(itp.beginTimestamp());
-
-            if (itp.isValid() && newtp.isValid())
+        if (!active.isEmpty())
+        {
+            QSet<ModeS> traffic;
+            traffic.reserve(active.size());
+            for (auto it = active.constBegin(); it != active.constEnd(); ++it)
             {
-                // Insert intersection and remainder of the new period.
-                *this << itp << newtp;
+                traffic << it.key();
             }
-        }
-        else
-        {
-            // CASE 8: New period starts before and ends after old period.
 
-            // Add the traffic contents of the new period to the old one.
-            oldtp << newtp.traffic();
-
-            // Create remainder of the new period by copying the new period
-            // and shrinking it from the front to match the end of the
-            // intersection period.
-            TrafficPeriod rnewtp(newtp);
-            rnewtp.shrinkFront(oldtp.endTimestamp());
+            col << TrafficPeriod(last, timestamp, traffic);
+        }
 
-            // Shrink new period from the back to match the beginning of the
-            // old period.
-            newtp.shrinkBack(oldtp.beginTimestamp());
+        // Apply all the events that happen at this instant.
+        for (; i < events.size() && events.at(i).msecs_ == msecs; ++i)
+        {
+            const Event &ev = events.at(i);
+            const QSet<ModeS> traffic = periods_.at(ev.index_).traffic();
 
-            if (newtp.isValid() && rnewtp.isValid())
+            for (ModeS addr : traffic)
             {
-                // Insert new period and remainder of the new period.
-                *this << newtp << rnewtp;
+                if (ev.begin_)
+                {
+                    ++active[addr];
+                }
+                else if (--active[addr] == 0)
+                {
+                    active.remove(addr);
+                }
             }
         }
+
+        last = timestamp;
     }
-    else
-    {
-        // This should not happen.
-        // qWarning();
-    }
-}
 
-void TrafficPeriodCollection::sort()
-{
-    std::sort(periods_.begin(), periods_.end());
+    return col;
 }
 
 /* ---------------------------- Free functions ---------------------------- */
@@ -582,3 +534,30 @@ bool operator<(const TrafficPeriod &lhs, const TrafficPeriod &rhs)
 {
     return lhs.beginTimestamp() < rhs.beginTimestamp();
 }
+
+QDataStream &operator<<(QDataStream &out, const TrafficPeriod &tp)
+{
+    return out << tp.beginTimestamp() << tp.endTimestamp() << tp.traffic();
+}
+
+QDataStream &operator>>(QDataStream &in, TrafficPeriod &tp)
+{
+    QDateTime begin;
+    QDateTime end;
+    QSet<ModeS> traffic;
+    in >> begin >> end >> traffic;
+
+    tp = TrafficPeriod(begin, end, traffic);
+
+    return in;
+}
+
+QDataStream &operator<<(QDataStream &out, const TrafficPeriodBuilder &builder)
+{
+    return out << builder.periods_;
+}
+
+QDataStream &operator>>(QDataStream &in, TrafficPeriodBuilder &builder)
+{
+    return in >> builder.periods_;
+}
@@ -22,6 +22,9 @@
 
 #include "astmops.h"
 #include "track.h"
+#include <QDataStream>
+#include <QMap>
+#include <QSet>
 
 /*!
  * \brief The TrafficPeriod class is an abstraction that implements the
@@ -68,10 +71,62 @@ Q_DECLARE_METATYPE(QVector<TrafficPeriod>);
 /*!
  * \brief The TimePeriodCollection class is an abstraction for collecting a
  * series of TrafficPeriod objects.
+ *
+ * Periods are kept as an ordered map of boundaries: each timestamp opens a
+ * segment that lasts until the next one and holds the traffic present
+ * during it (an empty set marks a gap). Adding a period splits the map at
+ * its begin and end and merges its traffic into the segments in between,
+ * so inserting is O(log n) plus the segments it spans, and the duration
+ * total is kept up to date on the fly.
  */
 class TrafficPeriodCollection
 {
+    using SegmentMap = QMap<QDateTime, QSet<ModeS>>;
+
 public:
+    /*!
+     * \brief Iterates over the non-empty segments of the collection,
+     * yielding them as TrafficPeriod values in chronological order.
+     */
+    class const_iterator
+    {
+    public:
+        const_iterator(SegmentMap::const_iterator it, SegmentMap::const_iterator last)
+            : it_(it), last_(last)
+        {
+            skipGaps();
+        }
+
+        TrafficPeriod operator*() const
+        {
+            SegmentMap::const_iterator next = it_;
+            ++next;
+            return TrafficPeriod(it_.key(), next.key(), it_.value());
+        }
+
+        const_iterator &operator++()
+        {
+            ++it_;
+            skipGaps();
+            return *this;
+        }
+
+        bool operator==(const const_iterator &other) const { return it_ == other.it_; }
+        bool operator!=(const const_iterator &other) const { return it_ != other.it_; }
+
+    private:
+        void skipGaps()
+        {
+            while (it_ != last_ && it_.value().isEmpty())
+            {
+                ++it_;
+            }
+        }
+
+        SegmentMap::const_iterator it_;
+        SegmentMap::const_iterator last_;
+    };
+
     TrafficPeriodCollection() = default;
 
     TrafficPeriodCollection &operator<<(const TrafficPeriod &tp);
@@ -81,10 +136,8 @@ public:
     TrafficPeriodCollection &operator<<(const Track &trk);
     TrafficPeriodCollection &operator<<(const TrackCollection &col);
 
-    QVector<TrafficPeriod>::iterator begin() { return periods_.begin(); }
-    QVector<TrafficPeriod>::iterator end() { return periods_.end(); }
-    QVector<TrafficPeriod>::const_iterator begin() const { return periods_.constBegin(); }
-    QVector<TrafficPeriod>::const_iterator end() const { return periods_.constEnd(); }
+    const_iterator begin() const { return const_iterator(segments_.constBegin(), segments_.constEnd()); }
+    const_iterator end() const { return const_iterator(segments_.constEnd(), segments_.constEnd()); }
 
     double duration() const;
     quint32 expectedUpdates(double freq = 1.0) const;
@@ -100,17 +153,52 @@ public:
     void removeSmallPeriods(double min_duration);
 
 private:
-    void dealOverlap(TrafficPeriod &oldtp, TrafficPeriod &newtp);
-    void sort();
+    SegmentMap::iterator split(const QDateTime &dt);
 
-    QVector<TrafficPeriod> periods_;
+    SegmentMap segments_;
+
+    int size_ = 0;               // Number of non-empty segments.
+    qint64 duration_ms_ = 0;     // Sum of the non-empty segment durations.
 };
 
 Q_DECLARE_METATYPE(TrafficPeriodCollection);
 
 
+/*!
+ * \brief The TrafficPeriodBuilder class builds a TrafficPeriodCollection
+ * out of a batch of possibly overlapping TrafficPeriod objects.
+ *
+ * The begin and end instants of all the periods are sorted once and swept
+ * in chronological order, emitting a period with the traffic present
+ * between every two consecutive instants. The result is identical to
+ * inserting the periods one by one into a TrafficPeriodCollection, at a
+ * cost of O(n log n) for the whole batch.
+ */
+class TrafficPeriodBuilder
+{
+public:
+    TrafficPeriodBuilder &operator<<(const TrafficPeriod &tp);
+    TrafficPeriodBuilder &operator<<(const Track &trk);
+    TrafficPeriodBuilder &operator+=(const TrafficPeriodBuilder &other);
+
+    TrafficPeriodCollection build() const;
+
+    friend QDataStream &operator<<(QDataStream &out, const TrafficPeriodBuilder &builder);
+    friend QDataStream &operator>>(QDataStream &in, TrafficPeriodBuilder &builder);
+
+private:
+    QVector<TrafficPeriod> periods_;
+};
+
+
 // FREE OPERATORS.
 bool operator==(const TrafficPeriod &lhs, const TrafficPeriod &rhs);
 bool operator<(const TrafficPeriod &lhs, const TrafficPeriod &rhs);
 
+QDataStream &operator<<(QDataStream &out, const TrafficPeriod &tp);
+QDataStream &operator>>(QDataStream &in, TrafficPeriod &tp);
+
+QDataStream &operator<<(QDataStream &out, const TrafficPeriodBuilder &builder);
+QDataStream &operator>>(QDataStream &in, TrafficPeriodBuilder &builder);
+
 #endif  // ASTMOPS_TRAFFICPERIOD_H
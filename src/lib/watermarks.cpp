@@ -0,0 +1,120 @@
+/*!
+ * \file watermarks.cpp
+ * \brief Implementation of the Watermarks class.
+ * \author Álvaro Cebrián Juan, 2020. acebrianjuan(at)gmail.com
+ *
+ * -----------------------------------------------------------------------
+ *
+ * Copyright (C) 2020-2021 Álvaro Cebrián Juan <acebrianjuan@gmail.com>
+ *
+ * ASTMOPS is a command line tool for evaluating 
+ * the performance of A-SMGCS sensors at airports
+ *
+ * This file is part of ASTMOPS.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -----------------------------------------------------------------------
+ */
+
+#include "watermarks.h"
+#include <QStringList>
+#include <QPair>
+#include <QVector>
+
+/*!
+ * \brief Constructs watermarks that lag \a allowedLateness seconds behind
+ * the most recent timestamp of each system type, or disabled ones if it
+ * is not set.
+ */
+Watermarks::Watermarks(std::optional<double> allowedLateness)
+{
+    if (allowedLateness.has_value())
+    {
+        allowedLatenessMs_ = qRound64(allowedLateness.value() * 1000);
+    }
+}
+
+bool Watermarks::isEnabled() const
+{
+    return allowedLatenessMs_.has_value();
+}
+
+/*!
+ * \brief Advances the watermark of \a st with \a tod. Returns false, and
+ * counts it as late, if \a tod is behind the watermark.
+ */
+bool Watermarks::advance(SystemType st, const QDateTime &tod)
+{
+    if (!allowedLatenessMs_.has_value())
+    {
+        return true;
+    }
+
+    const QDateTime latest = latest_.value(st);
+    if (!latest.isValid() || tod > latest)
+    {
+        latest_.insert(st, tod);
+    }
+    else if (tod < latest.addMSecs(-allowedLatenessMs_.value()))
+    {
+        ++late_[st];
+        return false;
+    }
+
+    return true;
+}
+
+/*!
+ * \brief Returns the watermark of \a st, or an invalid timestamp if the
+ * watermarks are disabled or nothing was received from \a st yet.
+ */
+QDateTime Watermarks::watermark(SystemType st) const
+{
+    const QDateTime latest = latest_.value(st);
+    if (!allowedLatenessMs_.has_value() || !latest.isValid())
+    {
+        return QDateTime();
+    }
+
+    return latest.addMSecs(-allowedLatenessMs_.value());
+}
+
+qint64 Watermarks::lateCount(SystemType st) const
+{
+    return late_.value(st);
+}
+
+qint64 Watermarks::lateCount() const
+{
+    qint64 count = 0;
+    for (qint64 n : late_)
+    {
+        count += n;
+    }
+
+    return count;
+}
+
+/*!
+ * \brief Returns the late counts per system type, e.g. "SMR 12, MLAT 3".
+ */
+QString Watermarks::lateSummary() const
+{
+    const QVector<QPair<SystemType, QString>> systems = {
+        {SystemType::Smr, QStringLiteral("SMR")},
+        {SystemType::Mlat, QStringLiteral("MLAT")},
+        {SystemType::Adsb, QStringLiteral("ADS-B")},
+        {SystemType::Dgps, QStringLiteral("DGPS")}};
+
+    QStringList parts;
+    for (const auto &system : systems)
+    {
+        if (late_.value(system.first) > 0)
+        {
+            parts << QStringLiteral("%1 %2").arg(system.second).arg(late_.value(system.first));
+        }
+    }
+
+    return parts.join(QLatin1String(", "));
+}
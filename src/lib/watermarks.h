@@ -0,0 +1,62 @@
+/*!
+ * \file watermarks.h
+ * \brief Interface of the Watermarks class.
+ * \author Álvaro Cebrián Juan, 2020. acebrianjuan(at)gmail.com
+ *
+ * -----------------------------------------------------------------------
+ *
+ * Copyright (C) 2020-2021 Álvaro Cebrián Juan <acebrianjuan@gmail.com>
+ *
+ * ASTMOPS is a command line tool for evaluating 
+ * the performance of A-SMGCS sensors at airports
+ *
+ * This file is part of ASTMOPS.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -----------------------------------------------------------------------
+ */
+
+#ifndef ASTMOPS_WATERMARKS_H
+#define ASTMOPS_WATERMARKS_H
+
+#include "astmops.h"
+#include <QDateTime>
+#include <QHash>
+#include <QString>
+#include <optional>
+
+/*!
+ * \brief The Watermarks class keeps an event-time watermark per system
+ * type: the most recent timestamp received from the system minus the
+ * allowed lateness.
+ *
+ * Sensors deliver their data with different latencies, so each system
+ * type has its own watermark. A timestamp behind the watermark of its
+ * system is late: it is counted and rejected, so that whatever lies
+ * behind the watermark can be considered final. Without an allowed
+ * lateness every timestamp is accepted.
+ */
+class Watermarks
+{
+public:
+    Watermarks() = default;
+    explicit Watermarks(std::optional<double> allowedLateness);
+
+    bool isEnabled() const;
+
+    bool advance(SystemType st, const QDateTime &tod);
+
+    QDateTime watermark(SystemType st) const;
+    qint64 lateCount(SystemType st) const;
+    qint64 lateCount() const;
+    QString lateSummary() const;
+
+private:
+    std::optional<qint64> allowedLatenessMs_;
+
+    QHash<SystemType, QDateTime> latest_;
+    QHash<SystemType, qint64> late_;
+};
+
+#endif  // ASTMOPS_WATERMARKS_H
@@ -0,0 +1,249 @@
+/*!
+ * \file main.cpp
+ * \brief Replays an ASTERIX XML recording over the network.
+ * \author Álvaro Cebrián Juan, 2020. acebrianjuan(at)gmail.com
+ *
+ * -----------------------------------------------------------------------
+ *
+ * Copyright (C) 2020-2021 Álvaro Cebrián Juan <acebrianjuan@gmail.com>
+ *
+ * ASTMOPS is a command line tool for evaluating 
+ * the performance of A-SMGCS sensors at airports
+ *
+ * This file is part of ASTMOPS.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -----------------------------------------------------------------------
+ */
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHostAddress>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QThread>
+#include <QUdpSocket>
+#include <memory>
+#include <optional>
+
+/*
+ * Sends the records of an ASTERIX XML recording, one line each, to a live
+ * astmops instance (see its --listen option):
+ *
+ *     astmops-replay [--udp <address>:<port> | --tcp <port>] [--speed <factor>] <file.xml>
+ *
+ * Over UDP (the default, to 127.0.0.1:5000) each record goes in its own
+ * datagram. With --tcp the tool waits for astmops to connect on <port>.
+ * Records are paced by their timestamps, --speed times faster than real
+ * time; 0 sends them as fast as possible.
+ */
+
+namespace
+{
+const int maxBufferedBytes = 1 << 20;
+const qint64 msecsPerDay = 86400000;
+
+// Value of the "timestamp" attribute of a record, in ms since midnight.
+std::optional<qint64> recordTimestamp(const QByteArray &line)
+{
+    const QByteArray key("timestamp=\"");
+
+    const int begin = line.indexOf(key);
+    if (begin == -1)
+    {
+        return std::nullopt;
+    }
+
+    const int end = line.indexOf('"', begin + key.size());
+    if (end == -1)
+    {
+        return std::nullopt;
+    }
+
+    bool ok = false;
+    const qint64 ts = line.mid(begin + key.size(), end - begin - key.size()).toLongLong(&ok);
+    if (!ok)
+    {
+        return std::nullopt;
+    }
+
+    return ts;
+}
+
+QString optionValue(const QStringList &args, const QString &name)
+{
+    const int idx = args.indexOf(name);
+    if (idx == -1 || idx + 1 >= args.size())
+    {
+        return QString();
+    }
+
+    return args.at(idx + 1);
+}
+}  // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication application(argc, argv);
+    QCoreApplication::setOrganizationName(QLatin1String("astmops"));
+    QCoreApplication::setApplicationName(QLatin1String("astmops-replay"));
+
+    const QStringList args = application.arguments();
+    const QStringList valueOptions = {QLatin1String("--udp"), QLatin1String("--tcp"),
+        QLatin1String("--speed")};
+
+    QString inputPath;
+    for (int i = 1; i < args.size(); ++i)
+    {
+        if (valueOptions.contains(args.at(i)))
+        {
+            ++i;
+        }
+        else if (!args.at(i).startsWith(QLatin1String("--")))
+        {
+            inputPath = args.at(i);
+            break;
+        }
+    }
+
+    if (inputPath.isEmpty())
+    {
+        qCritical("Usage: astmops-replay [--udp <address>:<port> | --tcp <port>] [--speed <factor>] <file.xml>");
+        return 1;
+    }
+
+    double speed = 1.0;
+    if (args.contains(QLatin1String("--speed")))
+    {
+        bool ok = false;
+        speed = optionValue(args, QLatin1String("--speed")).toDouble(&ok);
+        if (!ok || speed < 0)
+        {
+            qCritical("Invalid --speed value.");
+            return 1;
+        }
+    }
+
+    QFile file(inputPath);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        qCritical() << "Could not open" << inputPath;
+        return 1;
+    }
+
+    // Destination.
+    QTcpServer server;
+    std::unique_ptr<QTcpSocket> tcp;
+    QUdpSocket udp;
+    QHostAddress udpHost(QHostAddress::LocalHost);
+    quint16 udpPort = 5000;
+
+    if (args.contains(QLatin1String("--tcp")))
+    {
+        bool ok = false;
+        const quint16 port = optionValue(args, QLatin1String("--tcp")).toUShort(&ok);
+        if (!ok || !server.listen(QHostAddress::Any, port))
+        {
+            qCritical() << "Could not listen on TCP port" << port;
+            return 1;
+        }
+
+        qInfo() << "Waiting for a connection on TCP port" << port;
+        server.waitForNewConnection(-1);
+        tcp.reset(server.nextPendingConnection());
+    }
+    else if (args.contains(QLatin1String("--udp")))
+    {
+        const QString dest = optionValue(args, QLatin1String("--udp"));
+        const int sep = dest.lastIndexOf(QLatin1Char(':'));
+
+        bool ok = false;
+        udpHost = QHostAddress(dest.left(sep));
+        udpPort = dest.mid(sep + 1).toUShort(&ok);
+        if (sep == -1 || !ok || udpHost.isNull())
+        {
+            qCritical("Invalid --udp value, expected <address>:<port>.");
+            return 1;
+        }
+    }
+
+    // Send.
+    QElapsedTimer clock;
+    std::optional<qint64> first;
+    qint64 previous = 0;
+    qint64 dayOffset = 0;
+    qint64 n = 0;
+
+    while (!file.atEnd())
+    {
+        const QByteArray line = file.readLine();
+        if (line.trimmed().isEmpty())
+        {
+            continue;
+        }
+
+        const std::optional<qint64> ts = recordTimestamp(line);
+        if (speed > 0 && ts.has_value())
+        {
+            // Timestamps go back to zero at midnight.
+            if (first.has_value() && ts.value() + dayOffset < previous - msecsPerDay / 2)
+            {
+                dayOffset += msecsPerDay;
+            }
+
+            const qint64 t = ts.value() + dayOffset;
+            if (!first.has_value())
+            {
+                first = t;
+                clock.start();
+            }
+
+            const qint64 wait = static_cast<qint64>((t - first.value()) / speed) - clock.elapsed();
+            if (wait > 0)
+            {
+                if (tcp)
+                {
+                    tcp->flush();
+                }
+                QThread::msleep(static_cast<unsigned long>(wait));
+            }
+
+            previous = t;
+        }
+
+        if (tcp)
+        {
+            tcp->write(line);
+            if (tcp->bytesToWrite() > maxBufferedBytes)
+            {
+                tcp->waitForBytesWritten(-1);
+            }
+        }
+        else
+        {
+            udp.writeDatagram(line, udpHost, udpPort);
+        }
+
+        ++n;
+    }
+
+    if (tcp)
+    {
+        while (tcp->bytesToWrite() > 0)
+        {
+            if (!tcp->waitForBytesWritten(-1))
+            {
+                break;
+            }
+        }
+
+        tcp->disconnectFromHost();
+    }
+
+    qInfo() << "Sent" << n << "records";
+
+    return 0;
+}
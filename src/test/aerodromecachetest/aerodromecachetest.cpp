@@ -0,0 +1,186 @@
+/*!
+ * \file aerodromecachetest.cpp
+ * \brief Implements unit tests for the AerodromeCache class.
+ * \author Álvaro Cebrián Juan, 2020. acebrianjuan(at)gmail.com
+ *
+ * -----------------------------------------------------------------------
+ *
+ * Copyright (C) 2020-2021 Álvaro Cebrián Juan <acebrianjuan@gmail.com>
+ *
+ * ASTMOPS is a command line tool for evaluating 
+ * the performance of A-SMGCS sensors at airports
+ *
+ * This file is part of ASTMOPS.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -----------------------------------------------------------------------
+ */
+
+#include "aerodromecache.h"
+#include <QDataStream>
+#include <QFile>
+#include <QObject>
+#include <QRegularExpression>
+#include <QTemporaryDir>
+#include <QtTest>
+#include <memory>
+
+namespace
+{
+void writeFile(const QString &path, const QByteArray &data)
+{
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write(data);
+}
+
+QByteArray readFile(const QString &path)
+{
+    QFile file(path);
+    file.open(QIODevice::ReadOnly);
+    return file.readAll();
+}
+
+Aerodrome makeAerodrome()
+{
+    Aerodrome aerodrome(QGeoCoordinate(41.29694, 2.07833, 4.3));
+    aerodrome.addSmr(7, QVector3D(-100, 50, 20));
+
+    QPolygonF runway;
+    runway << QPointF(-1000, -30) << QPointF(1000, -30) << QPointF(1000, 30) << QPointF(-1000, 30);
+    aerodrome.addRunwayElement(QLatin1String("RWY1"), runway);
+
+    QPolygonF stand;
+    stand << QPointF(-10, 100) << QPointF(10, 100) << QPointF(10, 120) << QPointF(-10, 120);
+    aerodrome.addStandElement(QLatin1String("S1"), stand);
+
+    return aerodrome;
+}
+
+void compareAerodromes(const Aerodrome &lhs, const Aerodrome &rhs)
+{
+    QCOMPARE(lhs.arp(), rhs.arp());
+    QCOMPARE(lhs.smr(), rhs.smr());
+
+    const QVector<QVector3D> points = {{0, 0, 0}, {0, 110, 0}, {5000, 5000, 0}};
+    for (const QVector3D &pt : points)
+    {
+        QCOMPARE(lhs.locatePoint(pt, true), rhs.locatePoint(pt, true));
+    }
+}
+
+}  // namespace
+
+class AerodromeCacheTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+
+    void testHit();
+    void testStaleDigest();
+    void testVersionMismatch();
+    void testCorrupt();
+    void testMissingSource();
+
+private:
+    std::unique_ptr<QTemporaryDir> dir_;
+    QString sourcePath_;
+};
+
+void AerodromeCacheTest::init()
+{
+    dir_ = std::make_unique<QTemporaryDir>();
+    QVERIFY(dir_->isValid());
+
+    sourcePath_ = dir_->filePath(QLatin1String("aerodrome.kml"));
+    writeFile(sourcePath_, "<kml/>");
+}
+
+void AerodromeCacheTest::testHit()
+{
+    AerodromeCache cache(sourcePath_);
+    QCOMPARE(cache.filePath(), sourcePath_ + QLatin1String(".cache"));
+
+    // Nothing cached yet.
+    QVERIFY(!cache.load().has_value());
+
+    const Aerodrome aerodrome = makeAerodrome();
+    QVERIFY(cache.store(aerodrome));
+
+    std::optional<Aerodrome> cached = AerodromeCache(sourcePath_).load();
+    QVERIFY(cached.has_value());
+    compareAerodromes(cached.value(), aerodrome);
+}
+
+void AerodromeCacheTest::testStaleDigest()
+{
+    QVERIFY(AerodromeCache(sourcePath_).store(makeAerodrome()));
+
+    // Any change to the source file invalidates the cache.
+    writeFile(sourcePath_, "<kml></kml>");
+    QVERIFY(!AerodromeCache(sourcePath_).load().has_value());
+
+    // Storing again brings it back in sync.
+    QVERIFY(AerodromeCache(sourcePath_).store(makeAerodrome()));
+    QVERIFY(AerodromeCache(sourcePath_).load().has_value());
+
+    // Restoring the original contents does not match the new cache.
+    writeFile(sourcePath_, "<kml/>");
+    QVERIFY(!AerodromeCache(sourcePath_).load().has_value());
+}
+
+void AerodromeCacheTest::testVersionMismatch()
+{
+    AerodromeCache cache(sourcePath_);
+    QVERIFY(cache.store(makeAerodrome()));
+
+    // The version follows the 8-byte magic.
+    QByteArray data = readFile(cache.filePath());
+
+    QByteArray field;
+    QDataStream stream(&field, QIODevice::WriteOnly);
+    stream << quint16(AerodromeCache::version - 1);
+
+    data.replace(8, field.size(), field);
+    writeFile(cache.filePath(), data);
+
+    QVERIFY(!cache.load().has_value());
+}
+
+void AerodromeCacheTest::testCorrupt()
+{
+    AerodromeCache cache(sourcePath_);
+    QVERIFY(cache.store(makeAerodrome()));
+
+    const QByteArray data = readFile(cache.filePath());
+
+    // Trailing garbage.
+    writeFile(cache.filePath(), data + "garbage");
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression(QLatin1String("^Ignoring corrupt aerodrome cache")));
+    QVERIFY(!cache.load().has_value());
+
+    // Truncated aerodrome.
+    writeFile(cache.filePath(), data.left(data.size() - 4));
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression(QLatin1String("^Ignoring corrupt aerodrome cache")));
+    QVERIFY(!cache.load().has_value());
+
+    // Not a cache file at all.
+    writeFile(cache.filePath(), "not an aerodrome cache");
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression(QLatin1String("^Ignoring invalid aerodrome cache")));
+    QVERIFY(!cache.load().has_value());
+}
+
+void AerodromeCacheTest::testMissingSource()
+{
+    AerodromeCache cache(dir_->filePath(QLatin1String("missing.kml")));
+
+    QVERIFY(!cache.store(makeAerodrome()));
+    QVERIFY(!QFile::exists(cache.filePath()));
+    QVERIFY(!cache.load().has_value());
+}
+
+QTEST_GUILESS_MAIN(AerodromeCacheTest)
+#include "aerodromecachetest.moc"
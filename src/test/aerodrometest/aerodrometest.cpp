@@ -32,6 +32,9 @@ private slots:
 
     void testLocatePoint_data();
     void testLocatePoint();
+
+    void testDataStream_data();
+    void testDataStream();
 };
 
 void AerodromeTest::testElements_data()
@@ -266,5 +269,46 @@ void AerodromeTest::testLocatePoint()
     }
 }
 
+void AerodromeTest::testDataStream_data()
+{
+    testLocatePoint_data();
+}
+
+void AerodromeTest::testDataStream()
+{
+    using PairVec = QVector<QPair<QVector3D, uint>>;
+
+    QFETCH(Aerodrome, aerodrome);
+    QFETCH(PairVec, points);
+    QFETCH(QVector<Aerodrome::NamedArea>, result);
+
+    aerodrome.setArp(QGeoCoordinate(41.297, 2.078, 4.0));
+    aerodrome.addSmr(7, QVector3D(-100.0, 50.0, 20.0));
+
+    QByteArray data;
+    {
+        QDataStream out(&data, QIODevice::WriteOnly);
+        out << aerodrome;
+    }
+
+    Aerodrome copy;
+    QDataStream in(data);
+    in >> copy;
+
+    QCOMPARE(in.status(), QDataStream::Ok);
+    QVERIFY(in.atEnd());
+
+    QCOMPARE(copy.arp(), aerodrome.arp());
+    QCOMPARE(copy.smr(), aerodrome.smr());
+    QCOMPARE(copy.hasAllElements(), aerodrome.hasAllElements());
+
+    auto it = result.begin();
+    for (QPair<QVector3D, uint> pair : points)
+    {
+        QCOMPARE(copy.locatePoint(pair.first, pair.second), *it);
+        ++it;
+    }
+}
+
 QTEST_APPLESS_MAIN(AerodromeTest)
 #include "aerodrometest.moc"
@@ -180,7 +180,7 @@ void AsterixXmlReaderTest::test_data()
 
 void AsterixXmlReaderTest::test()
 {
-    AsterixXmlReader astXmlRdr;
+    AsterixXmlReader astXmlRdr(RunConfig::fromSettings());
 
     QFETCH(QString, fileName);
     QFile file(QFINDTESTDATA(fileName));
@@ -0,0 +1,212 @@
+/*!
+ * \file counterstest.cpp
+ * \brief Implements unit tests for the Counters namespace.
+ * \author Álvaro Cebrián Juan, 2020. acebrianjuan(at)gmail.com
+ *
+ * -----------------------------------------------------------------------
+ *
+ * Copyright (C) 2020-2021 Álvaro Cebrián Juan <acebrianjuan@gmail.com>
+ *
+ * ASTMOPS is a command line tool for evaluating 
+ * the performance of A-SMGCS sensors at airports
+ *
+ * This file is part of ASTMOPS.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -----------------------------------------------------------------------
+ */
+
+#include "counters.h"
+#include <QObject>
+#include <QtTest>
+
+/*!
+ * \brief Reference IntervalCounter that steps through every interval, as
+ * the original implementation did.
+ */
+class SteppingIntervalCounter
+{
+public:
+    void setPeriod(double period)
+    {
+        if (period <= 0)
+        {
+            return;
+        }
+
+        period_ = period;
+    }
+
+    void init(const QDateTime &tod)
+    {
+        intervalStart_ = tod;
+    }
+
+    void update(const QDateTime &tod)
+    {
+        if (!intervalStart_.isValid())
+        {
+            return;
+        }
+
+        if (tod >= intervalStart_)
+        {
+            while (!contains(tod))
+            {
+                advance();
+            }
+
+            ++counter_.valid_;
+            advance();
+        }
+    }
+
+    void finish(const QDateTime &tod)
+    {
+        if (!intervalStart_.isValid())
+        {
+            return;
+        }
+
+        if (tod >= intervalStart_)
+        {
+            while (!contains(tod))
+            {
+                advance();
+            }
+        }
+    }
+
+    Counters::BasicCounter read()
+    {
+        Counters::BasicCounter counter = counter_;
+        counter_.reset();
+
+        return counter;
+    }
+
+private:
+    QDateTime intervalEnd() const
+    {
+        return intervalStart_.addMSecs(period_ * 1000.0);
+    }
+
+    bool contains(const QDateTime &tod) const
+    {
+        return intervalStart_ <= tod && tod < intervalEnd();
+    }
+
+    void advance()
+    {
+        intervalStart_ = intervalEnd();
+        ++counter_.total_;
+    }
+
+    double period_ = 1.0;
+    QDateTime intervalStart_;
+    Counters::BasicCounter counter_;
+};
+
+class CountersTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testIntervalCounter_data();
+    void testIntervalCounter();
+};
+
+void CountersTest::testIntervalCounter_data()
+{
+    // Each step is an operation followed by its arguments. Times are
+    // seconds from an arbitrary origin. "read" is followed by the expected
+    // number of valid and total intervals.
+    QTest::addColumn<QStringList>("steps");
+
+    auto steps = [](const char *script) {
+        return QString::fromLatin1(script).split(QLatin1Char(';'));
+    };
+
+    QTest::newRow("Updates in one interval")
+        << steps("init 0; update 0.1; update 0.2; update 0.9; finish 0.95; read 1 1");
+    QTest::newRow("Gap")
+        << steps("init 0; update 0.5; update 3.2; read 2 4; finish 5.5; read 0 1");
+    QTest::newRow("Update on a boundary")
+        << steps("init 0; update 1; update 2; read 2 3");
+    QTest::newRow("Finish on a boundary")
+        << steps("init 0; update 0.5; finish 3; read 1 3; update 3; read 1 1");
+    QTest::newRow("Finish before the interval")
+        << steps("init 10; update 9.5; finish 9.9; read 0 0");
+    QTest::newRow("Long gap")
+        << steps("init 0; update 0; update 86399.999; finish 86400; read 2 86400");
+    QTest::newRow("Set period")
+        << steps("init 0; update 0.5; period 2.5; update 3.4; update 6.1; finish 9; read 3 4");
+    QTest::newRow("Set period at a boundary")
+        << steps("init 0; update 0.2; finish 1; period 0.25; update 1.3; finish 2; read 2 5");
+    QTest::newRow("Set period before init")
+        << steps("period 5; init 1; update 5.9; update 6; finish 21; read 2 4");
+    QTest::newRow("Fractional period")
+        << steps("period 0.3; init 0; update 0.29; update 0.61; finish 1.5; read 2 5");
+    QTest::newRow("Not initialized")
+        << steps("update 1; finish 2; read 0 0");
+}
+
+void CountersTest::testIntervalCounter()
+{
+    QFETCH(QStringList, steps);
+
+    const QDateTime origin = QDateTime::fromMSecsSinceEpoch(1588672800000, Qt::UTC);
+    auto time = [&origin](const QString &seconds) {
+        return origin.addMSecs(qRound64(seconds.toDouble() * 1000));
+    };
+
+    Counters::IntervalCounter counter;
+    SteppingIntervalCounter reference;
+
+    for (const QString &step : steps)
+    {
+        const QStringList args = step.trimmed().split(QLatin1Char(' '));
+        QVERIFY(!args.isEmpty());
+
+        const QString &op = args.first();
+        if (op == QLatin1String("init"))
+        {
+            counter.init(time(args.at(1)));
+            reference.init(time(args.at(1)));
+        }
+        else if (op == QLatin1String("update"))
+        {
+            counter.update(time(args.at(1)));
+            reference.update(time(args.at(1)));
+        }
+        else if (op == QLatin1String("finish"))
+        {
+            counter.finish(time(args.at(1)));
+            reference.finish(time(args.at(1)));
+        }
+        else if (op == QLatin1String("period"))
+        {
+            counter.setPeriod(args.at(1).toDouble());
+            reference.setPeriod(args.at(1).toDouble());
+        }
+        else if (op == QLatin1String("read"))
+        {
+            const Counters::BasicCounter read = counter.read();
+            const Counters::BasicCounter expected = reference.read();
+
+            QCOMPARE(read.valid_, expected.valid_);
+            QCOMPARE(read.total_, expected.total_);
+
+            QCOMPARE(read.valid_, args.at(1).toUInt());
+            QCOMPARE(read.total_, args.at(2).toUInt());
+        }
+        else
+        {
+            QFAIL(qPrintable(QLatin1String("Unknown step: ") + step));
+        }
+    }
+}
+
+QTEST_GUILESS_MAIN(CountersTest);
+#include "counterstest.moc"
@@ -32,6 +32,9 @@ private slots:
 
     void testReadDgpsCsv_data();
     void testReadDgpsCsv();
+
+    void testStreamDgpsCsvFile_data();
+    void testStreamDgpsCsvFile();
 };
 
 Q_DECLARE_METATYPE(QVector<QGeoPositionInfo>);
@@ -117,5 +120,48 @@ void DgpsCsvReaderTest::testReadDgpsCsv()
     }
 }
 
+void DgpsCsvReaderTest::testStreamDgpsCsvFile_data()
+{
+    QTest::addColumn<QString>("fileName");
+    QTest::addColumn<int>("threads");
+
+    for (const char *fileName : {"dgps_unix.csv", "dgps_iso.csv"})
+    {
+        for (int threads : {1, 2, 3, 16})
+        {
+            QTest::addRow("%s, %d threads", fileName, threads) << QString::fromLatin1(fileName)
+                                                              << threads;
+        }
+    }
+}
+
+void DgpsCsvReaderTest::testStreamDgpsCsvFile()
+{
+    QFETCH(QString, fileName);
+    QFETCH(int, threads);
+
+    const QString path = QFINDTESTDATA(fileName);
+
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::ReadOnly | QIODevice::Text));
+    const QVector<QGeoPositionInfo> expected = readDgpsCsv(&file);
+
+    // The chunked parse must yield the same positions in the same order.
+    QVector<QGeoPositionInfo> actual;
+    ErrorType error = streamDgpsCsvFile(path, threads, [&actual](const QGeoPositionInfo &info) {
+        actual.append(info);
+    });
+
+    QCOMPARE(error, ErrorType::NoError);
+    QCOMPARE(actual.size(), expected.size());
+    QVERIFY(!actual.isEmpty());
+
+    for (int i = 0; i < actual.size(); ++i)
+    {
+        QCOMPARE(actual.at(i).timestamp(), expected.at(i).timestamp());
+        QCOMPARE(actual.at(i).coordinate(), expected.at(i).coordinate());
+    }
+}
+
 QTEST_APPLESS_MAIN(DgpsCsvReaderTest)
 #include "dgpscsvreadertest.moc"
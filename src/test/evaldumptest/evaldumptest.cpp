@@ -0,0 +1,205 @@
+/*!
+ * \file evaldumptest.cpp
+ * \brief Implements unit tests for the EvalDump class.
+ * \author Álvaro Cebrián Juan, 2020. acebrianjuan(at)gmail.com
+ *
+ * -----------------------------------------------------------------------
+ *
+ * Copyright (C) 2020-2021 Álvaro Cebrián Juan <acebrianjuan@gmail.com>
+ *
+ * ASTMOPS is a command line tool for evaluating 
+ * the performance of A-SMGCS sensors at airports
+ *
+ * This file is part of ASTMOPS.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -----------------------------------------------------------------------
+ */
+
+#include "evaldump.h"
+#include <QBuffer>
+#include <QObject>
+#include <QtTest>
+
+/*!
+ * \brief Device that accepts \a capacity bytes and then fails every
+ * write, as a full disk does.
+ */
+class FullDevice : public QIODevice
+{
+public:
+    explicit FullDevice(qint64 capacity) : capacity_(capacity)
+    {
+    }
+
+protected:
+    qint64 readData(char *, qint64) override
+    {
+        return -1;
+    }
+
+    qint64 writeData(const char *, qint64 len) override
+    {
+        if (written_ + len > capacity_)
+        {
+            return -1;
+        }
+
+        written_ += len;
+        return len;
+    }
+
+private:
+    qint64 capacity_ = 0;
+    qint64 written_ = 0;
+};
+
+class EvalDumpTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testLayout();
+    void testWriteFailure();
+};
+
+void EvalDumpTest::testLayout()
+{
+    const Aerodrome::NamedArea rwy(Aerodrome::Area::Runway, QLatin1String("25L"));
+    const Aerodrome::NamedArea twy(Aerodrome::Area::Taxiway, QLatin1String("A"));
+
+    const QDateTime t0 = QDateTime::fromMSecsSinceEpoch(1600000000000, Qt::UTC);
+    const QDateTime t1 = t0.addMSecs(1500);
+
+    QBuffer buffer;
+    buffer.open(QIODevice::ReadWrite);
+
+    {
+        // Chunks of 2 rows: the 3 RPA errors take 2 chunks.
+        EvalDump dump(&buffer, 2);
+        dump.addRpaError(SystemType::Smr, rwy, 7, 0x3C65AC, t0, 1.5);
+        dump.addRpaError(SystemType::Smr, twy, 7, 0x3C65AC, t1, 2.5);
+        dump.addRpaError(SystemType::Mlat, rwy, 9, std::nullopt, t1, 3.5);
+        dump.addPdWindow(SystemType::Mlat, twy, 9, std::nullopt, t0, t1, 1, 2);
+    }
+
+    buffer.seek(0);
+    QDataStream in(&buffer);
+    in.setByteOrder(QDataStream::LittleEndian);
+    in.setFloatingPointPrecision(QDataStream::DoublePrecision);
+
+    char magic[8];
+    QCOMPARE(in.readRawData(magic, 8), 8);
+    QCOMPARE(QByteArray(magic, 8), QByteArray("ASTMDUMP"));
+
+    quint16 version;
+    in >> version;
+    QCOMPARE(version, EvalDump::version);
+
+    quint8 table;
+    quint32 rows;
+
+    // First RPA chunk.
+    in >> table >> rows;
+    QCOMPARE(table, static_cast<quint8>(EvalDump::Table::RpaErrors));
+    QCOMPARE(rows, 2u);
+
+    quint8 sys[2];
+    qint64 tod[2];
+    quint16 area[2];
+    quint16 tn[2];
+    quint32 ms[2];
+    double err[2];
+    in >> sys[0] >> sys[1] >> tod[0] >> tod[1] >> area[0] >> area[1]
+        >> tn[0] >> tn[1] >> ms[0] >> ms[1] >> err[0] >> err[1];
+
+    QCOMPARE(sys[0], static_cast<quint8>(SystemType::Smr));
+    QCOMPARE(tod[0], t0.toMSecsSinceEpoch());
+    QCOMPARE(tod[1], t1.toMSecsSinceEpoch());
+    QCOMPARE(area[0], quint16(0));
+    QCOMPARE(area[1], quint16(1));
+    QCOMPARE(tn[1], quint16(7));
+    QCOMPARE(ms[0], 0x3C65ACu);
+    QCOMPARE(err[0], 1.5);
+    QCOMPARE(err[1], 2.5);
+
+    // Second RPA chunk, written at finish().
+    in >> table >> rows;
+    QCOMPARE(table, static_cast<quint8>(EvalDump::Table::RpaErrors));
+    QCOMPARE(rows, 1u);
+    in >> sys[0] >> tod[0] >> area[0] >> tn[0] >> ms[0] >> err[0];
+    QCOMPARE(sys[0], static_cast<quint8>(SystemType::Mlat));
+    QCOMPARE(area[0], quint16(0));
+    QCOMPARE(ms[0], EvalDump::noModeS);
+    QCOMPARE(err[0], 3.5);
+
+    // PD windows.
+    in >> table >> rows;
+    QCOMPARE(table, static_cast<quint8>(EvalDump::Table::PdWindows));
+    QCOMPARE(rows, 1u);
+    qint64 begin;
+    qint64 end;
+    quint32 hits;
+    quint32 total;
+    in >> sys[0] >> begin >> end >> area[0] >> tn[0] >> ms[0] >> hits >> total;
+    QCOMPARE(begin, t0.toMSecsSinceEpoch());
+    QCOMPARE(end, t1.toMSecsSinceEpoch());
+    QCOMPARE(area[0], quint16(1));
+    QCOMPARE(tn[0], quint16(9));
+    QCOMPARE(hits, 1u);
+    QCOMPARE(total, 2u);
+
+    // Area dictionary.
+    in >> table >> rows;
+    QCOMPARE(table, static_cast<quint8>(EvalDump::Table::Areas));
+    QCOMPARE(rows, 2u);
+    for (quint32 i = 0; i < rows; ++i)
+    {
+        quint16 id;
+        quint32 flags;
+        quint32 size;
+        in >> id >> flags >> size;
+
+        QByteArray name(static_cast<int>(size), '\0');
+        in.readRawData(name.data(), name.size());
+
+        const Aerodrome::NamedArea &expected = i == 0 ? rwy : twy;
+        QCOMPARE(id, static_cast<quint16>(i));
+        QCOMPARE(flags, static_cast<quint32>(expected.area_));
+        QCOMPARE(QString::fromUtf8(name), expected.fullName());
+    }
+
+    in >> table;
+    QCOMPARE(table, static_cast<quint8>(EvalDump::Table::End));
+    QVERIFY(in.atEnd());
+}
+
+void EvalDumpTest::testWriteFailure()
+{
+    const Aerodrome::NamedArea rwy(Aerodrome::Area::Runway, QLatin1String("25L"));
+    const QDateTime t0 = QDateTime::fromMSecsSinceEpoch(1600000000000, Qt::UTC);
+
+    // Room for the header only.
+    FullDevice device(10);
+    device.open(QIODevice::WriteOnly | QIODevice::Unbuffered);
+
+    EvalDump dump(&device, 1);
+    QVERIFY(dump.isOk());
+
+    dump.addRpaError(SystemType::Smr, rwy, 7, 0x3C65AC, t0, 1.5);
+    QVERIFY(!dump.isOk());
+    QVERIFY(!dump.finish());
+    QVERIFY(!dump.finish());
+
+    // A device with room for everything.
+    FullDevice roomy(1 << 20);
+    roomy.open(QIODevice::WriteOnly | QIODevice::Unbuffered);
+
+    EvalDump complete(&roomy, 1);
+    complete.addRpaError(SystemType::Smr, rwy, 7, 0x3C65AC, t0, 1.5);
+    QVERIFY(complete.finish());
+}
+
+QTEST_GUILESS_MAIN(EvalDumpTest);
+#include "evaldumptest.moc"
@@ -0,0 +1,193 @@
+/*!
+ * \file functionstest.cpp
+ * \brief Implements unit tests for the statistics functions.
+ * \author Álvaro Cebrián Juan, 2020. acebrianjuan(at)gmail.com
+ *
+ * -----------------------------------------------------------------------
+ *
+ * Copyright (C) 2020-2021 Álvaro Cebrián Juan <acebrianjuan@gmail.com>
+ *
+ * ASTMOPS is a command line tool for evaluating 
+ * the performance of A-SMGCS sensors at airports
+ *
+ * This file is part of ASTMOPS.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -----------------------------------------------------------------------
+ */
+
+#include "functions.h"
+#include <QFile>
+#include <QObject>
+#include <QTemporaryDir>
+#include <QtTest>
+#include <algorithm>
+#include <cmath>
+
+class FunctionsTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testPercentile_data();
+    void testPercentile();
+
+    void testQuantiles_data();
+    void testQuantiles();
+
+    void testRunningStats();
+
+    void testFileDigest();
+};
+
+void FunctionsTest::testPercentile_data()
+{
+    QTest::addColumn<QVector<double>>("valuesIn");
+    QTest::addColumn<double>("percentIn");
+    QTest::addColumn<double>("percentileOut");
+
+    const QVector<double> v = {7, 1, 3, 9, 5, 2, 8, 4, 6, 10};
+
+    QTest::newRow("P0") << v << 0.0 << 1.0;
+    QTest::newRow("P25") << v << 25.0 << 3.0;
+    QTest::newRow("P50") << v << 50.0 << 5.5;
+    QTest::newRow("P95") << v << 95.0 << 10.0;
+    QTest::newRow("P100") << v << 100.0 << 10.0;
+    QTest::newRow("Single") << QVector<double>{4.2} << 75.0 << 4.2;
+}
+
+void FunctionsTest::testPercentile()
+{
+    QFETCH(QVector<double>, valuesIn);
+    QFETCH(double, percentIn);
+    QFETCH(double, percentileOut);
+
+    QCOMPARE(percentile(valuesIn, percentIn), percentileOut);
+
+    QVector<double> sorted = valuesIn;
+    std::sort(sorted.begin(), sorted.end());
+    QCOMPARE(sortedPercentile(sorted, percentIn), percentileOut);
+}
+
+void FunctionsTest::testQuantiles_data()
+{
+    QTest::addColumn<QVector<double>>("valuesIn");
+
+    QVector<double> pic;
+    for (int i = 0; i < 1000; ++i)
+    {
+        pic << (i * 7919) % 16;
+    }
+
+    QTest::newRow("Empty") << QVector<double>();
+    QTest::newRow("Single") << QVector<double>{3};
+    QTest::newRow("Pair") << QVector<double>{5, 1};
+    QTest::newRow("PIC") << pic;
+}
+
+void FunctionsTest::testQuantiles()
+{
+    QFETCH(QVector<double>, valuesIn);
+
+    const QVector<double> percents = {0, 1, 12.5, 25, 50, 75, 90, 95, 99, 100};
+
+    QVector<double> v = valuesIn;
+    const QVector<double> q = quantiles(v, percents);
+
+    QVector<quint64> histogram(16, 0);
+    for (double x : qAsConst(valuesIn))
+    {
+        ++histogram[static_cast<int>(x)];
+    }
+
+    QCOMPARE(q.size(), percents.size());
+    for (int i = 0; i < percents.size(); ++i)
+    {
+        const double expected = percentile(valuesIn, percents.at(i));
+        if (qIsNaN(expected))
+        {
+            QVERIFY(qIsNaN(q.at(i)));
+            QVERIFY(qIsNaN(histogramPercentile(histogram, percents.at(i))));
+            continue;
+        }
+
+        QCOMPARE(q.at(i), expected);
+        QCOMPARE(histogramPercentile(histogram, percents.at(i)), expected);
+    }
+
+    // Out of range percents.
+    QVERIFY(qIsNaN(quantiles(v, {-1}).first()));
+    QVERIFY(qIsNaN(quantiles(v, {101}).first()));
+}
+
+void FunctionsTest::testRunningStats()
+{
+    QVector<double> values;
+    for (int i = 0; i < 1001; ++i)
+    {
+        values << 1e3 + ((i * 7919) % 1000) / 100.0;
+    }
+
+    // Reference two-pass results.
+    double sum = 0;
+    for (double x : qAsConst(values))
+    {
+        sum += x;
+    }
+    const double mn = sum / values.size();
+
+    double sqSum = 0;
+    for (double x : qAsConst(values))
+    {
+        sqSum += (x - mn) * (x - mn);
+    }
+    const double sd = std::sqrt(sqSum / (values.size() - 1));
+
+    QCOMPARE(mean(values), mn);
+    QCOMPARE(stdDev(values), sd);
+
+    // Merging partial accumulators gives the same moments.
+    RunningStats lhs;
+    RunningStats rhs;
+    for (int i = 0; i < values.size(); ++i)
+    {
+        (i < 300 ? lhs : rhs) << values.at(i);
+    }
+
+    lhs += rhs;
+    lhs += RunningStats();
+
+    QCOMPARE(lhs.count(), static_cast<qint64>(values.size()));
+    QCOMPARE(lhs.mean(), mn);
+    QCOMPARE(lhs.stdDev(), sd);
+    QCOMPARE(lhs.min(), *std::min_element(values.begin(), values.end()));
+    QCOMPARE(lhs.max(), *std::max_element(values.begin(), values.end()));
+
+    // Degenerate cases.
+    RunningStats empty;
+    QVERIFY(empty.isEmpty());
+    QVERIFY(qIsNaN(empty.mean()));
+    QVERIFY(qIsNaN(empty.stdDev()));
+    QCOMPARE(stdDev({4.2}), 0.0);
+}
+
+void FunctionsTest::testFileDigest()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    const QString path = dir.filePath(QLatin1String("abc.txt"));
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write("abc");
+    file.close();
+
+    QCOMPARE(fileDigest(path).toHex(), QByteArray("ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad"));
+
+    // Unreadable files have no digest.
+    QVERIFY(fileDigest(dir.filePath(QLatin1String("missing.txt"))).isEmpty());
+}
+
+QTEST_GUILESS_MAIN(FunctionsTest);
+#include "functionstest.moc"
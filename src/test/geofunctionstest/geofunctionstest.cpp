@@ -19,6 +19,7 @@
  */
 
 #include "geofunctions.h"
+#include <GeographicLib/LocalCartesian.hpp>
 #include <QGeoCoordinate>
 #include <QObject>
 #include <QtTest>
@@ -41,6 +42,9 @@ private slots:
     void geoToLocalEnuTest_data();
     void geoToLocalEnuTest();
 
+    void localTangentPlaneTest_data();
+    void localTangentPlaneTest();
+
     // TODO: Implement missing tests.
     //void dmsToDegTest_data();
     //void dmsToDegTest();
@@ -112,7 +116,7 @@ void GeoFunctionsTest::ecefToLocalEnuTest_data()
 
     QGeoCoordinate leblSmrGeo(41.29561944, 2.095113889, 4.3200000000000003);
     //QVector3D leblSmrEcef(000, 000, 000);
-    //QVector3D leblSmrEnu(1394.60223, -162.34771, 0);
+    //QVector3D leblSmrEnu(1394.65525, -161.69581, -0.15431);
 
     QTest::newRow("LEBL_ARP") << leblArpGeo << leblArpEcef << leblArpEnu;
     //QTest::newRow("LEBL_SMR") << leblArpGeo << leblSmrEcef << leblSmrEnu;
@@ -141,7 +145,7 @@ void GeoFunctionsTest::geoToLocalEnuTest_data()
     QVector3D leblArpEnu(0, 0, 0);
 
     QGeoCoordinate leblSmrGeo(41.29561944, 2.095113889, 4.3200000000000003);
-    QVector3D leblSmrEnu(1394.60223, -162.34771, 0);
+    QVector3D leblSmrEnu(1394.655, -161.696, -0.154);
 
     QTest::newRow("LEBL_ARP") << leblArpGeo << leblArpGeo << leblArpEnu;
     QTest::newRow("LEBL_SMR") << leblArpGeo << leblSmrGeo << leblSmrEnu;
@@ -155,8 +159,65 @@ void GeoFunctionsTest::geoToLocalEnuTest()
 
     QVector3D enuOut = geoToLocalEnu(geoIn, geoRef);
 
-    QVERIFY(std::fabs(enuOut.x() - enuOutValid.x() < 1));
-    QVERIFY(std::fabs(enuOut.y() - enuOutValid.y() < 1));
+    QVERIFY(std::fabs(enuOut.x() - enuOutValid.x()) < 0.01);
+    QVERIFY(std::fabs(enuOut.y() - enuOutValid.y()) < 0.01);
+    QVERIFY(std::fabs(enuOut.z() - enuOutValid.z()) < 0.01);
+}
+
+void GeoFunctionsTest::localTangentPlaneTest_data()
+{
+    QTest::addColumn<QGeoCoordinate>("geoRef");
+
+    QTest::newRow("LEBL_ARP") << QGeoCoordinate(41.297076579982225, 2.0784629201158662, 4.32);
+    QTest::newRow("Southern hemisphere") << QGeoCoordinate(-33.946111, 151.177222, 6.0);
+    QTest::newRow("High latitude") << QGeoCoordinate(78.246111, 15.465556, 28.0);
+}
+
+void GeoFunctionsTest::localTangentPlaneTest()
+{
+    QFETCH(QGeoCoordinate, geoRef);
+
+    // Grid of points up to 1º (~100 km) away from the origin, from the
+    // ground up to cruise levels.
+    QVector<double> lat, lon, h;
+    for (double dLat = -1.0; dLat <= 1.0; dLat += 0.25)
+    {
+        for (double dLon = -1.0; dLon <= 1.0; dLon += 0.25)
+        {
+            for (double alt : {0.0, 1000.0, 12000.0})
+            {
+                lat << geoRef.latitude() + dLat;
+                lon << geoRef.longitude() + dLon;
+                h << alt;
+            }
+        }
+    }
+
+    const int n = lat.size();
+    QVector<double> east(n), north(n), up(n);
+
+    LocalTangentPlane ltp(geoRef);
+    ltp.toEnu(n, lat.constData(), lon.constData(), h.constData(),
+        east.data(), north.data(), up.data());
+
+    GeographicLib::LocalCartesian lc(geoRef.latitude(), geoRef.longitude(), geoRef.altitude());
+
+    for (int i = 0; i < n; ++i)
+    {
+        double x, y, z;
+        lc.Forward(lat.at(i), lon.at(i), h.at(i), x, y, z);
+
+        QVERIFY(std::fabs(east.at(i) - x) < 1e-3);
+        QVERIFY(std::fabs(north.at(i) - y) < 1e-3);
+        QVERIFY(std::fabs(up.at(i) - z) < 1e-3);
+
+        // Single conversions match the batch ones.
+        double e, nn, u;
+        ltp.toEnu(lat.at(i), lon.at(i), h.at(i), &e, &nn, &u);
+        QVERIFY(std::fabs(e - east.at(i)) < 1e-9);
+        QVERIFY(std::fabs(nn - north.at(i)) < 1e-9);
+        QVERIFY(std::fabs(u - up.at(i)) < 1e-9);
+    }
 }
 
 QTEST_APPLESS_MAIN(GeoFunctionsTest)
@@ -0,0 +1,124 @@
+/*!
+ * \file livefeedtest.cpp
+ * \brief Implements unit tests for the LiveFeed class.
+ * \author Álvaro Cebrián Juan, 2020. acebrianjuan(at)gmail.com
+ *
+ * -----------------------------------------------------------------------
+ *
+ * Copyright (C) 2020-2021 Álvaro Cebrián Juan <acebrianjuan@gmail.com>
+ *
+ * ASTMOPS is a command line tool for evaluating 
+ * the performance of A-SMGCS sensors at airports
+ *
+ * This file is part of ASTMOPS.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -----------------------------------------------------------------------
+ */
+
+#include "livefeed.h"
+#include <QObject>
+#include <QSignalSpy>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QUdpSocket>
+#include <QtTest>
+#include <memory>
+
+class LiveFeedTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testUdp();
+    void testTcp();
+    void testTcpReconnect();
+};
+
+void LiveFeedTest::testUdp()
+{
+    // Find a free port.
+    QUdpSocket probe;
+    QVERIFY(probe.bind(QHostAddress::LocalHost, 0));
+    const quint16 port = probe.localPort();
+    probe.close();
+
+    LiveFeed feed;
+    QVERIFY(feed.listenUdp(port));
+
+    QSignalSpy spy(&feed, &LiveFeed::readyRead);
+
+    QUdpSocket sender;
+    sender.writeDatagram(QByteArray("<ASTERIX a/>\n"), QHostAddress::LocalHost, port);
+    sender.writeDatagram(QByteArray("<ASTERIX b/>"), QHostAddress::LocalHost, port);
+
+    QByteArray data;
+    auto receive = [&feed, &data]() {
+        data.append(feed.takeData());
+        return data.count('\n') == 2;
+    };
+    QTRY_VERIFY_WITH_TIMEOUT(receive(), 5000);
+
+    // Datagrams without a trailing newline are completed.
+    QCOMPARE(data, QByteArray("<ASTERIX a/>\n<ASTERIX b/>\n"));
+    QVERIFY(spy.count() >= 1);
+    QVERIFY(!feed.hasPendingData());
+}
+
+void LiveFeedTest::testTcp()
+{
+    QTcpServer server;
+    QVERIFY(server.listen(QHostAddress::LocalHost, 0));
+
+    LiveFeed feed;
+    feed.connectTcp(QStringLiteral("127.0.0.1"), server.serverPort());
+
+    QVERIFY(server.waitForNewConnection(5000));
+    std::unique_ptr<QTcpSocket> client(server.nextPendingConnection());
+
+    // A record split across writes is only passed on once complete.
+    client->write("<ASTERIX a/>\n<AST");
+    client->flush();
+
+    QTRY_VERIFY_WITH_TIMEOUT(feed.hasPendingData(), 5000);
+    QCOMPARE(feed.takeData(), QByteArray("<ASTERIX a/>\n"));
+
+    client->write("ERIX b/>\n");
+    client->flush();
+
+    QTRY_VERIFY_WITH_TIMEOUT(feed.hasPendingData(), 5000);
+    QCOMPARE(feed.takeData(), QByteArray("<ASTERIX b/>\n"));
+}
+
+void LiveFeedTest::testTcpReconnect()
+{
+    QTcpServer server;
+    QVERIFY(server.listen(QHostAddress::LocalHost, 0));
+
+    LiveFeed feed;
+    feed.connectTcp(QStringLiteral("127.0.0.1"), server.serverPort());
+
+    QVERIFY(server.waitForNewConnection(5000));
+    std::unique_ptr<QTcpSocket> client(server.nextPendingConnection());
+
+    // The incomplete line of a lost connection is dropped.
+    client->write("<ASTERIX a/>\n<AST");
+    client->flush();
+    QTRY_VERIFY_WITH_TIMEOUT(feed.hasPendingData(), 5000);
+    QCOMPARE(feed.takeData(), QByteArray("<ASTERIX a/>\n"));
+
+    client->disconnectFromHost();
+
+    QTRY_VERIFY_WITH_TIMEOUT(server.hasPendingConnections(), 5000);
+    client.reset(server.nextPendingConnection());
+
+    client->write("<ASTERIX b/>\n");
+    client->flush();
+
+    QTRY_VERIFY_WITH_TIMEOUT(feed.hasPendingData(), 5000);
+    QCOMPARE(feed.takeData(), QByteArray("<ASTERIX b/>\n"));
+}
+
+QTEST_GUILESS_MAIN(LiveFeedTest)
+#include "livefeedtest.moc"
@@ -19,11 +19,155 @@
 
 #include "perfevaluator.h"
 #include "config.h"
+#include "pipeline.h"
+#include <QBuffer>
 #include <QObject>
 #include <QtTest>
+#include <algorithm>
 
 using namespace Literals;
 
+namespace
+{
+/*!
+ * \brief Tracks of a target moving along x at 10 m/s for 30 s, on the
+ * runway and then on a taxiway, 1000 m away in y from the other targets:
+ * an ADS-B reference whose PIC is \a picLow one report in three and
+ * \a picHigh otherwise, and SMR and MLAT tracks with position errors,
+ * missed updates, wrong identifications and a false detection.
+ */
+QVector<Track> targetTracks(int target, quint8 picLow, quint8 picHigh)
+{
+    const ModeS mode_s = 0x000001 + target;
+    const QDateTime start = "2020-05-05T10:00:00.000Z"_ts.addSecs(3 * target);
+    const double y0 = 1000.0 * target;
+
+    Track trk_adsb(SystemType::Adsb, 100 + target);
+    Track trk_mlat(SystemType::Mlat, 200 + target);
+    Track trk_smr(SystemType::Smr, 300 + target);
+
+    for (int i = 0; i < 30; ++i)
+    {
+        const Aerodrome::NamedArea narea(i < 15 ? Aerodrome::Area::Runway : Aerodrome::Area::Taxiway);
+
+        TargetReport tr_adsb;
+        tr_adsb.ds_id_.sac_ = 0;
+        tr_adsb.ds_id_.sic_ = 219;
+        tr_adsb.sys_typ_ = SystemType::Adsb;
+        tr_adsb.tod_ = start.addSecs(i);
+        tr_adsb.trk_nb_ = 100 + target;
+        tr_adsb.mode_s_ = mode_s;
+        tr_adsb.mode_3a_ = 0001;
+        tr_adsb.ident_ = QLatin1String("FOO1234 ");
+        tr_adsb.on_gnd_ = true;
+        tr_adsb.x_ = 10.0 * i;
+        tr_adsb.y_ = y0;
+        tr_adsb.z_ = 0.0;
+        tr_adsb.narea_ = narea;
+        tr_adsb.ver_ = 2;
+        tr_adsb.pic_ = i % 3 == 0 ? picLow : picHigh;
+        trk_adsb << tr_adsb;
+
+        if (i % 5 != 2)
+        {
+            TargetReport tr_mlat;
+            tr_mlat.ds_id_.sac_ = 0;
+            tr_mlat.ds_id_.sic_ = 107;
+            tr_mlat.sys_typ_ = SystemType::Mlat;
+            tr_mlat.tod_ = start.addMSecs(1000 * i + 500);
+            tr_mlat.trk_nb_ = 200 + target;
+            tr_mlat.mode_s_ = mode_s;
+            tr_mlat.mode_3a_ = i % 9 == 0 ? 0002 : 0001;
+            tr_mlat.ident_ = QLatin1String(i % 11 == 0 ? "BAR1234 " : "FOO1234 ");
+            tr_mlat.on_gnd_ = true;
+            tr_mlat.x_ = 10.0 * i + 5.0 + 0.5 * (i % 3) * (target + 1) + (i == 20 ? 60.0 : 0.0);
+            tr_mlat.y_ = y0 - 1.0;
+            tr_mlat.narea_ = narea;
+            trk_mlat << tr_mlat;
+        }
+
+        if (i % 7 != 3)
+        {
+            TargetReport tr_smr;
+            tr_smr.ds_id_.sac_ = 0;
+            tr_smr.ds_id_.sic_ = 7;
+            tr_smr.sys_typ_ = SystemType::Smr;
+            tr_smr.tod_ = start.addMSecs(1000 * i + 250);
+            tr_smr.trk_nb_ = 300 + target;
+            tr_smr.on_gnd_ = true;
+            tr_smr.x_ = 10.0 * i + 2.5 + (i % 4) * (target + 1);
+            tr_smr.y_ = y0 + 2.0;
+            tr_smr.narea_ = narea;
+            trk_smr << tr_smr;
+        }
+    }
+
+    return {trk_adsb, trk_mlat, trk_smr};
+}
+
+bool sameValue(double lhs, double rhs)
+{
+    return (qIsNaN(lhs) && qIsNaN(rhs)) || qAbs(lhs - rhs) <= 1e-9 * qMax(1.0, qAbs(rhs));
+}
+
+void compareStats(const PerfResults::Stats &lhs, const PerfResults::Stats &rhs, const QString &what)
+{
+    QVERIFY2(sameValue(lhs.p95, rhs.p95), qPrintable(what));
+    QVERIFY2(sameValue(lhs.p99, rhs.p99), qPrintable(what));
+    QVERIFY2(sameValue(lhs.mean, rhs.mean), qPrintable(what));
+    QVERIFY2(sameValue(lhs.stdDev, rhs.stdDev), qPrintable(what));
+    QVERIFY2(sameValue(lhs.percent, rhs.percent), qPrintable(what));
+    QVERIFY2(lhs.n == rhs.n, qPrintable(what));
+}
+
+// Compares every metric, area and sub-area of two sets of results.
+void compareResults(const PerfResults &lhs, const PerfResults &rhs)
+{
+    QCOMPARE(lhs.metrics().size(), rhs.metrics().size());
+
+    for (int i = 0; i < lhs.metrics().size(); ++i)
+    {
+        const PerfResults::Metric &lm = lhs.metrics().at(i);
+        const PerfResults::Metric &rm = rhs.metrics().at(i);
+
+        QCOMPARE(lm.id, rm.id);
+        QCOMPARE(lm.areas.size(), rm.areas.size());
+
+        for (int j = 0; j < lm.areas.size(); ++j)
+        {
+            const PerfResults::AreaResult &la = lm.areas.at(j);
+            const PerfResults::AreaResult &ra = rm.areas.at(j);
+
+            QCOMPARE(la.name, ra.name);
+            compareStats(la.total, ra.total, lm.id + QLatin1Char(' ') + la.name);
+
+            QCOMPARE(la.subAreas.size(), ra.subAreas.size());
+            for (int k = 0; k < la.subAreas.size(); ++k)
+            {
+                QCOMPARE(la.subAreas.at(k).first, ra.subAreas.at(k).first);
+                compareStats(la.subAreas.at(k).second, ra.subAreas.at(k).second,
+                    lm.id + QLatin1Char(' ') + la.subAreas.at(k).first);
+            }
+        }
+    }
+}
+
+// Total number of samples of the metric \a id over its first area.
+qint64 metricCount(const PerfResults &results, const QString &id)
+{
+    for (const PerfResults::Metric &m : results.metrics())
+    {
+        if (m.id == id && !m.areas.isEmpty())
+        {
+            return m.areas.first().total.n;
+        }
+    }
+
+    return 0;
+}
+
+}  // namespace
+
 class PerfEvaluatorTest : public QObject
 {
     Q_OBJECT
@@ -63,6 +207,12 @@ private slots:
 
     void testED117PLG_data();
     void testED117PLG();
+
+    void testStateMerge_data();
+    void testStateMerge();
+
+    void testPartitionMerge();
+    void testShardMerge();
 };
 
 void PerfEvaluatorTest::initTestCase()
@@ -379,14 +529,20 @@ void PerfEvaluatorTest::testED116RPA()
     QFETCH(QVector<Track>, tracksIn);
     QFETCH(RpaHash, countersOut);
 
-    PerfEvaluator perfEval;
+    PerfEvaluator perfEval(RunConfig::fromSettings());
     for (const Track &trk : tracksIn)
     {
         perfEval.addData(trk);
     }
     perfEval.run();
 
-    QCOMPARE(static_cast<RpaHash>(perfEval.smrRpaErrors_), countersOut);
+    RpaHash errors;
+    for (auto it = perfEval.smrRpaErrors_.constBegin(); it != perfEval.smrRpaErrors_.constEnd(); ++it)
+    {
+        errors.insert(it.key(), it.value().samples());
+    }
+
+    QCOMPARE(errors, countersOut);
 }
 
 void PerfEvaluatorTest::testED116UR_data()
@@ -673,7 +829,7 @@ void PerfEvaluatorTest::testED116UR()
     QFETCH(QVector<Track>, tracksIn);
     QFETCH(UrHash, countersOut);
 
-    PerfEvaluator perfEval;
+    PerfEvaluator perfEval(RunConfig::fromSettings());
     for (const Track &trk : tracksIn)
     {
         perfEval.addData(trk);
@@ -968,7 +1124,7 @@ void PerfEvaluatorTest::testED116PD()
     QFETCH(QVector<Track>, tracksIn);
     QFETCH(PdHash, countersOut);
 
-    PerfEvaluator perfEval;
+    PerfEvaluator perfEval(RunConfig::fromSettings());
     for (const Track &trk : tracksIn)
     {
         perfEval.addData(trk);
@@ -1810,7 +1966,7 @@ void PerfEvaluatorTest::testED116PFD()
     QFETCH(QVector<Track>, tracksIn);
     QFETCH(PfdHash, countersOut);
 
-    PerfEvaluator perfEval;
+    PerfEvaluator perfEval(RunConfig::fromSettings());
     for (const Track &trk : tracksIn)
     {
         perfEval.addData(trk);
@@ -2146,14 +2302,20 @@ void PerfEvaluatorTest::testED117RPA()
     QFETCH(QVector<Track>, tracksIn);
     QFETCH(RpaHash, countersOut);
 
-    PerfEvaluator perfEval;
+    PerfEvaluator perfEval(RunConfig::fromSettings());
     for (const Track &trk : tracksIn)
     {
         perfEval.addData(trk);
     }
     perfEval.run();
 
-    QCOMPARE(static_cast<RpaHash>(perfEval.mlatRpaErrors_), countersOut);
+    RpaHash errors;
+    for (auto it = perfEval.mlatRpaErrors_.constBegin(); it != perfEval.mlatRpaErrors_.constEnd(); ++it)
+    {
+        errors.insert(it.key(), it.value().samples());
+    }
+
+    QCOMPARE(errors, countersOut);
 }
 
 void PerfEvaluatorTest::testED117UR_data()
@@ -2467,7 +2629,7 @@ void PerfEvaluatorTest::testED117UR()
     QFETCH(QVector<Track>, tracksIn);
     QFETCH(UrHash, countersOut);
 
-    PerfEvaluator perfEval;
+    PerfEvaluator perfEval(RunConfig::fromSettings());
     for (const Track &trk : tracksIn)
     {
         perfEval.addData(trk);
@@ -2788,7 +2950,7 @@ void PerfEvaluatorTest::testED117PD()
     QFETCH(QVector<Track>, tracksIn);
     QFETCH(PdHash, countersOut);
 
-    PerfEvaluator perfEval;
+    PerfEvaluator perfEval(RunConfig::fromSettings());
     for (const Track &trk : tracksIn)
     {
         perfEval.addData(trk);
@@ -3125,7 +3287,7 @@ void PerfEvaluatorTest::testED117PFD()
     QFETCH(QVector<Track>, tracksIn);
     QFETCH(PfdHash, countersOut);
 
-    PerfEvaluator perfEval;
+    PerfEvaluator perfEval(RunConfig::fromSettings());
     for (const Track &trk : tracksIn)
     {
         perfEval.addData(trk);
@@ -3450,7 +3612,7 @@ void PerfEvaluatorTest::testED117PID()
     QFETCH(QVector<Track>, tracksIn);
     QFETCH(PidHash, countersOut);
 
-    PerfEvaluator perfEval;
+    PerfEvaluator perfEval(RunConfig::fromSettings());
     for (const Track &trk : tracksIn)
     {
         perfEval.addData(trk);
@@ -3775,7 +3937,7 @@ void PerfEvaluatorTest::testED117PFID()
     QFETCH(QVector<Track>, tracksIn);
     QFETCH(PfidHash, countersOut);
 
-    PerfEvaluator perfEval;
+    PerfEvaluator perfEval(RunConfig::fromSettings());
     for (const Track &trk : tracksIn)
     {
         perfEval.addData(trk);
@@ -4012,7 +4174,7 @@ void PerfEvaluatorTest::testED117PLG()
     QFETCH(QVector<Track>, tracksIn);
     QFETCH(PlgHash, countersOut);
 
-    PerfEvaluator perfEval;
+    PerfEvaluator perfEval(RunConfig::fromSettings());
     for (const Track &trk : tracksIn)
     {
         perfEval.addData(trk);
@@ -4022,5 +4184,198 @@ void PerfEvaluatorTest::testED117PLG()
     QCOMPARE(static_cast<PlgHash>(perfEval.mlatPlg_), countersOut);
 }
 
+void PerfEvaluatorTest::testStateMerge_data()
+{
+    testED116UR_data();
+}
+
+void PerfEvaluatorTest::testStateMerge()
+{
+    using UrHash = QHash<Aerodrome::NamedArea, Counters::UrCounter>;
+
+    QFETCH(QVector<Track>, tracksIn);
+    QFETCH(UrHash, countersOut);
+
+    PerfEvaluator perfEval(RunConfig::fromSettings());
+    for (const Track &trk : tracksIn)
+    {
+        perfEval.addData(trk);
+    }
+    perfEval.setMergeable(true);
+    perfEval.evaluate();
+
+    QBuffer buffer;
+    buffer.open(QIODevice::ReadWrite);
+    QVERIFY(perfEval.saveState(&buffer));
+
+    // Merging the same state twice doubles every counter.
+    PerfEvaluator merged(RunConfig::fromSettings());
+    for (int i = 0; i < 2; ++i)
+    {
+        buffer.seek(0);
+        QVERIFY(merged.mergeState(&buffer));
+    }
+
+    AreaHash<Counters::UrCounter> expected = perfEval.smrUr_;
+    expected += perfEval.smrUr_;
+
+    QCOMPARE(static_cast<UrHash>(perfEval.smrUr_), countersOut);
+    QCOMPARE(static_cast<UrHash>(merged.smrUr_), static_cast<UrHash>(expected));
+
+    // The PIC threshold comes from the merged histograms.
+    perfEval.finish();
+    merged.finish();
+    QCOMPARE(merged.pic_p95_, perfEval.pic_p95_);
+
+    // Anything else is rejected.
+    QBuffer garbage;
+    garbage.setData(QByteArrayLiteral("NOTSTATE"));
+    garbage.open(QIODevice::ReadOnly);
+    QVERIFY(!merged.mergeState(&garbage));
+}
+
+void PerfEvaluatorTest::testPartitionMerge()
+{
+    // The first two targets are reported with a lower PIC than the other
+    // two, so the first half of the traffic alone has a lower PIC
+    // threshold than the whole traffic.
+    const QVector<Track> lhsTracks = targetTracks(0, 6, 7) + targetTracks(1, 6, 7);
+    const QVector<Track> rhsTracks = targetTracks(2, 9, 10) + targetTracks(3, 9, 10);
+
+    const RunConfig config = RunConfig::fromSettings();
+
+    PerfEvaluator single(config);
+    PerfEvaluator lhs(config);
+    PerfEvaluator rhs(config);
+
+    for (const Track &trk : lhsTracks)
+    {
+        single.addData(trk);
+        lhs.addData(trk);
+    }
+
+    for (const Track &trk : rhsTracks)
+    {
+        single.addData(trk);
+        rhs.addData(trk);
+    }
+
+    lhs.setMergeable(true);
+    rhs.setMergeable(true);
+
+    single.run();
+    lhs.evaluate();
+    rhs.evaluate();
+
+    // A single evaluation only computes the RPA errors at its threshold.
+    QVERIFY(single.smrRpaErrorsByPic_.isEmpty());
+    QVERIFY(single.mlatRpaErrorsByPic_.isEmpty());
+    QVERIFY(!lhs.smrRpaErrorsByPic_.isEmpty());
+    QVERIFY(!lhs.mlatRpaErrorsByPic_.isEmpty());
+
+    QBuffer buffer;
+    buffer.open(QIODevice::WriteOnly);
+    QTest::ignoreMessage(QtWarningMsg, "Cannot save the state of an evaluation that is not mergeable");
+    QVERIFY(!single.saveState(&buffer));
+
+    QCOMPARE(int(lhs.pic_p95_), 7);
+    QCOMPARE(int(rhs.pic_p95_), 10);
+    QCOMPARE(int(single.pic_p95_), 10);
+
+    lhs += rhs;
+    lhs.finish();
+
+    QCOMPARE(lhs.pic_p95_, single.pic_p95_);
+
+    // Every metric is evaluated on some data.
+    for (const QString &id : {QStringLiteral("ED116RPA"), QStringLiteral("ED116PFD"),
+             QStringLiteral("ED117RPA"), QStringLiteral("ED117PFD")})
+    {
+        QVERIFY2(metricCount(single.results(), id) > 0, qPrintable(id));
+    }
+
+    compareResults(lhs.results(), single.results());
+}
+
+void PerfEvaluatorTest::testShardMerge()
+{
+    QVector<Track> tracks;
+    for (int target = 0; target < 6; ++target)
+    {
+        tracks << (target % 2 == 0 ? targetTracks(target, 6, 7) : targetTracks(target, 9, 10));
+    }
+
+    const RunConfig config = RunConfig::fromSettings();
+
+    PerfEvaluator single(config);
+    for (const Track &trk : tracks)
+    {
+        single.addData(trk);
+    }
+    single.run();
+
+    // Evaluate each shard as Pipeline does, keeping the SMR tracks in
+    // every shard, and merge their saved states as --shards does.
+    const int shards = 3;
+    PerfEvaluator merged(config);
+
+    for (int shard = 0; shard < shards; ++shard)
+    {
+        PerfEvaluator part(config);
+        for (const Track &trk : tracks)
+        {
+            if (trk.system_type() == SystemType::Smr || !trk.mode_s().has_value() ||
+                Pipeline::shardOf(trk.mode_s().value(), shards) == shard)
+            {
+                part.addData(trk);
+            }
+        }
+        part.setMergeable(true);
+        part.evaluate();
+
+        QBuffer buffer;
+        buffer.open(QIODevice::ReadWrite);
+        QVERIFY(part.saveState(&buffer));
+        buffer.seek(0);
+        QVERIFY(merged.mergeState(&buffer));
+    }
+
+    merged.finish();
+
+    QCOMPARE(merged.pic_p95_, single.pic_p95_);
+
+    // RPA errors, in any order.
+    auto sortedErrors = [](const AreaHash<ErrorAccumulator> &errors) {
+        AreaHash<QVector<double>> result;
+        for (auto it = errors.constBegin(); it != errors.constEnd(); ++it)
+        {
+            QVector<double> samples = it.value().samples();
+            std::sort(samples.begin(), samples.end());
+            result.insert(it.key(), samples);
+        }
+        return result;
+    };
+
+    QVERIFY(!single.smrRpaErrors_.isEmpty());
+    QVERIFY(!single.mlatRpaErrors_.isEmpty());
+    QCOMPARE(sortedErrors(merged.smrRpaErrors_), sortedErrors(single.smrRpaErrors_));
+    QCOMPARE(sortedErrors(merged.mlatRpaErrors_), sortedErrors(single.mlatRpaErrors_));
+
+    // Every other counter.
+    QVERIFY(merged.smrUr_ == single.smrUr_);
+    QVERIFY(merged.mlatUr_ == single.mlatUr_);
+    QVERIFY(merged.smrPd_ == single.smrPd_);
+    QVERIFY(merged.mlatPd_ == single.mlatPd_);
+    QVERIFY(merged.smrPfd_ == single.smrPfd_);
+    QVERIFY(merged.mlatPfd_ == single.mlatPfd_);
+    QVERIFY(merged.mlatPidIdent_ == single.mlatPidIdent_);
+    QVERIFY(merged.mlatPidMode3A_ == single.mlatPidMode3A_);
+    QVERIFY(merged.mlatPfidIdent_ == single.mlatPfidIdent_);
+    QVERIFY(merged.mlatPfidMode3A_ == single.mlatPfidMode3A_);
+    QVERIFY(merged.mlatPlg_ == single.mlatPlg_);
+
+    compareResults(merged.results(), single.results());
+}
+
 QTEST_GUILESS_MAIN(PerfEvaluatorTest);
 #include "perfevaluatortest.moc"
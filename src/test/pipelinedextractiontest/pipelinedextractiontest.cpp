@@ -0,0 +1,144 @@
+/*!
+ * \file pipelinedextractiontest.cpp
+ * \brief Implements unit tests for the pipelined extraction.
+ * \author Álvaro Cebrián Juan, 2020. acebrianjuan(at)gmail.com
+ *
+ * -----------------------------------------------------------------------
+ *
+ * Copyright (C) 2020-2021 Álvaro Cebrián Juan <acebrianjuan@gmail.com>
+ *
+ * ASTMOPS is a command line tool for evaluating 
+ * the performance of A-SMGCS sensors at airports
+ *
+ * This file is part of ASTMOPS.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -----------------------------------------------------------------------
+ */
+
+#include "asterixxmlreader.h"
+#include "config.h"
+#include "pipelinedextraction.h"
+#include "targetreportextractor.h"
+#include <QObject>
+#include <QThread>
+#include <QtTest>
+
+class PipelinedExtractionTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void testSequentialOrder_data();
+    void testSequentialOrder();
+
+private:
+    Aerodrome aerodrome_;
+};
+
+void PipelinedExtractionTest::initTestCase()
+{
+    QCoreApplication::setOrganizationName(QLatin1String("astmops"));
+    QCoreApplication::setApplicationName(QLatin1String("astmops-pipelinedextractiontest"));
+
+    Settings settings;
+    settings.clear();
+
+    settings.beginGroup(QLatin1String("Asterix"));
+    settings.setValue(QLatin1String("Date"), QLatin1String("2020-05-05"));
+    settings.setValue(QLatin1String("SmrSic"), 7);
+    settings.setValue(QLatin1String("MlatSic"), 107);
+    settings.setValue(QLatin1String("AdsbSic"), 219);
+    settings.endGroup();
+
+    aerodrome_.setArp(QGeoCoordinate(41.297, 2.078, 4.0));
+    aerodrome_.addSmr(7, QVector3D(-100.0, 50.0, 20.0));
+}
+
+void PipelinedExtractionTest::testSequentialOrder_data()
+{
+    QTest::addColumn<QString>("fileName");
+    QTest::addColumn<int>("batchSize");
+    QTest::addColumn<int>("queueCapacity");
+    QTest::addColumn<bool>("slowConsumer");
+
+    const QStringList fileNames = {QLatin1String("cat010.xml"), QLatin1String("cat010_rollover.xml"),
+        QLatin1String("cat010_rollover_delayed.xml")};
+
+    for (const QString &fileName : fileNames)
+    {
+        const QByteArray name = fileName.toLatin1();
+        const QString path = QLatin1String("../asterixxmlreadertest/") + fileName;
+
+        QTest::newRow((name + " DEFAULT").constData()) << path << 256 << 64 << false;
+
+        // One item per batch and a single slot per queue, so that every
+        // stage fills its queue and waits on the next one.
+        QTest::newRow((name + " BACKPRESSURE").constData()) << path << 1 << 1 << false;
+        QTest::newRow((name + " BACKPRESSURE SLOW CONSUMER").constData()) << path << 1 << 1 << true;
+    }
+}
+
+void PipelinedExtractionTest::testSequentialOrder()
+{
+    QFETCH(QString, fileName);
+    QFETCH(int, batchSize);
+    QFETCH(int, queueCapacity);
+    QFETCH(bool, slowConsumer);
+
+    const QString path = QFINDTESTDATA(fileName);
+    const RunConfig config = RunConfig::fromSettings();
+
+    // Single-threaded reference, drained record by record.
+    QVector<TargetReport> expected;
+    {
+        QFile file(path);
+        QVERIFY(file.open(QIODevice::ReadOnly));
+
+        AsterixXmlReader astXmlReader(config);
+
+        TargetReportExtractor tgtRepExtr(config, aerodrome_.arp(), aerodrome_.smr());
+        tgtRepExtr.setLocatePointCallback([this](const QVector3D cartPos, const bool gndBit) {
+            return aerodrome_.locatePoint(cartPos, gndBit);
+        });
+
+        while (!file.atEnd())
+        {
+            astXmlReader.addData(file.readLine());
+
+            while (astXmlReader.hasPendingData())
+            {
+                tgtRepExtr.addData(astXmlReader.takeData().value());
+
+                while (tgtRepExtr.hasPendingData())
+                {
+                    expected << tgtRepExtr.takeData().value();
+                }
+            }
+        }
+    }
+
+    QVERIFY(!expected.isEmpty());
+
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+
+    QVector<TargetReport> actual;
+    streamPipelinedTargetReports(&file, config, aerodrome_,
+        [&actual, slowConsumer](const TargetReport &tr) {
+            if (slowConsumer)
+            {
+                QThread::msleep(5);
+            }
+
+            actual << tr;
+        },
+        batchSize, queueCapacity);
+
+    QCOMPARE(actual, expected);
+}
+
+QTEST_GUILESS_MAIN(PipelinedExtractionTest);
+#include "pipelinedextractiontest.moc"
@@ -0,0 +1,191 @@
+/*!
+ * \file poolqueuetest.cpp
+ * \brief Implements unit tests for the PoolQueue class.
+ * \author Álvaro Cebrián Juan, 2020. acebrianjuan(at)gmail.com
+ *
+ * -----------------------------------------------------------------------
+ *
+ * Copyright (C) 2020-2021 Álvaro Cebrián Juan <acebrianjuan@gmail.com>
+ *
+ * ASTMOPS is a command line tool for evaluating 
+ * the performance of A-SMGCS sensors at airports
+ *
+ * This file is part of ASTMOPS.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -----------------------------------------------------------------------
+ */
+
+#include "poolqueue.h"
+#include "targetreport.h"
+#include <QObject>
+#include <QQueue>
+#include <QtTest>
+
+class PoolQueueTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testFifo();
+    void testBlockReuse();
+    void testClear();
+    void testCopy();
+
+    void benchmarkQQueue();
+    void benchmarkPoolQueue();
+};
+
+// Number of target reports queued and drained per round in the benchmarks,
+// about the backlog of a batch of the pipeline.
+static const int benchmarkBacklog = 4096;
+
+static TargetReport makeTargetReport(int i)
+{
+    TargetReport tr;
+    tr.sys_typ_ = SystemType::Mlat;
+    tr.trk_nb_ = static_cast<TrackNum>(i);
+    tr.tod_ = QDateTime::fromMSecsSinceEpoch(i, Qt::UTC);
+    tr.x_ = i;
+
+    return tr;
+}
+
+void PoolQueueTest::testFifo()
+{
+    PoolQueue<int> queue;
+    QVERIFY(queue.isEmpty());
+
+    // Spans several blocks.
+    const int n = 3 * PoolQueue<int>::blockSize + 10;
+    for (int i = 0; i < n; ++i)
+    {
+        queue.enqueue(i);
+    }
+
+    QCOMPARE(queue.size(), n);
+    QCOMPARE(queue.head(), 0);
+    QCOMPARE(queue.at(n - 1), n - 1);
+    QCOMPARE(queue.toQueue().size(), n);
+
+    for (int i = 0; i < n; ++i)
+    {
+        QCOMPARE(queue.dequeue(), i);
+    }
+
+    QVERIFY(queue.isEmpty());
+}
+
+void PoolQueueTest::testBlockReuse()
+{
+    PoolQueue<QString> queue;
+    const int n = 2 * PoolQueue<QString>::blockSize + 1;
+
+    // Interleaves pushes and pops, as the extractor does.
+    for (int round = 0; round < 10; ++round)
+    {
+        for (int i = 0; i < n; ++i)
+        {
+            queue.enqueue(QString::number(i));
+            if (i % 2 == 1)
+            {
+                QVERIFY(!queue.dequeue().isEmpty());
+            }
+        }
+
+        while (!queue.isEmpty())
+        {
+            queue.dequeue();
+        }
+    }
+
+    // The blocks of the first round are reused by the following ones.
+    QVERIFY(queue.blockCount() <= 3);
+
+    queue.release();
+    QCOMPARE(queue.blockCount(), 0);
+}
+
+void PoolQueueTest::testClear()
+{
+    PoolQueue<int> queue;
+    for (int i = 0; i < PoolQueue<int>::blockSize + 1; ++i)
+    {
+        queue.enqueue(i);
+    }
+
+    queue.dequeue();
+    queue.clear();
+
+    QVERIFY(queue.isEmpty());
+    QCOMPARE(queue.blockCount(), 2);
+
+    queue.enqueue(7);
+    QCOMPARE(queue.head(), 7);
+    QCOMPARE(queue.size(), 1);
+}
+
+void PoolQueueTest::testCopy()
+{
+    PoolQueue<int> queue;
+    for (int i = 0; i < PoolQueue<int>::blockSize + 5; ++i)
+    {
+        queue.enqueue(i);
+    }
+    queue.dequeue();
+
+    PoolQueue<int> copy(queue);
+    QCOMPARE(copy.size(), queue.size());
+    QCOMPARE(copy.head(), 1);
+
+    copy.dequeue();
+    QCOMPARE(queue.head(), 1);
+
+    PoolQueue<int> moved(std::move(copy));
+    QCOMPARE(moved.head(), 2);
+    QVERIFY(copy.isEmpty());
+
+    QHash<int, PoolQueue<int>> hash;
+    hash[1].enqueue(5);
+    QCOMPARE(hash.value(1).head(), 5);
+}
+
+void PoolQueueTest::benchmarkQQueue()
+{
+    QQueue<TargetReport> queue;
+
+    QBENCHMARK
+    {
+        for (int i = 0; i < benchmarkBacklog; ++i)
+        {
+            queue.enqueue(makeTargetReport(i));
+        }
+
+        while (!queue.isEmpty())
+        {
+            queue.dequeue();
+        }
+    }
+}
+
+void PoolQueueTest::benchmarkPoolQueue()
+{
+    PoolQueue<TargetReport> queue;
+
+    QBENCHMARK
+    {
+        for (int i = 0; i < benchmarkBacklog; ++i)
+        {
+            queue.enqueue(makeTargetReport(i));
+        }
+
+        while (!queue.isEmpty())
+        {
+            queue.dequeue();
+        }
+    }
+}
+
+QTEST_GUILESS_MAIN(PoolQueueTest);
+#include "poolqueuetest.moc"
@@ -0,0 +1,126 @@
+/*!
+ * \file profilertest.cpp
+ * \brief Implements unit tests for the run profiler.
+ * \author Álvaro Cebrián Juan, 2020. acebrianjuan(at)gmail.com
+ *
+ * -----------------------------------------------------------------------
+ *
+ * Copyright (C) 2020-2021 Álvaro Cebrián Juan <acebrianjuan@gmail.com>
+ *
+ * ASTMOPS is a command line tool for evaluating 
+ * the performance of A-SMGCS sensors at airports
+ *
+ * This file is part of ASTMOPS.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -----------------------------------------------------------------------
+ */
+
+#include "profiler.h"
+#include <QElapsedTimer>
+#include <QObject>
+#include <QThread>
+#include <QtTest>
+#include <memory>
+
+using Profiler::ScopedTimer;
+using Profiler::Stage;
+using Profiler::StageStats;
+
+class ProfilerTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanupTestCase();
+
+    void testDisabled();
+    void testNesting();
+    void testThreads();
+};
+
+void ProfilerTest::init()
+{
+    Profiler::setEnabled(true);
+    Profiler::reset();
+}
+
+void ProfilerTest::cleanupTestCase()
+{
+    Profiler::setEnabled(false);
+}
+
+void ProfilerTest::testDisabled()
+{
+    Profiler::setEnabled(false);
+
+    {
+        ScopedTimer timer(Stage::XmlRead, 10);
+    }
+
+    for (const StageStats &s : Profiler::collect())
+    {
+        QCOMPARE(s.calls, Q_INT64_C(0));
+        QCOMPARE(s.items, Q_INT64_C(0));
+    }
+}
+
+void ProfilerTest::testNesting()
+{
+    QElapsedTimer elapsed;
+    elapsed.start();
+
+    {
+        ScopedTimer outer(Stage::TargetReportExtraction);
+        QThread::msleep(20);
+
+        {
+            ScopedTimer inner(Stage::LocatePoint, 0);
+            inner.setItems(5);
+            QThread::msleep(30);
+        }
+    }
+
+    const qint64 elapsedNs = elapsed.nsecsElapsed();
+
+    const QVector<StageStats> stats = Profiler::collect();
+    const StageStats outer = stats.at(static_cast<int>(Stage::TargetReportExtraction));
+    const StageStats inner = stats.at(static_cast<int>(Stage::LocatePoint));
+
+    QCOMPARE(outer.calls, Q_INT64_C(1));
+    QCOMPARE(outer.items, Q_INT64_C(1));
+    QCOMPARE(inner.calls, Q_INT64_C(1));
+    QCOMPARE(inner.items, Q_INT64_C(5));
+
+    QVERIFY(outer.wallNs >= 20'000'000);
+    QVERIFY(inner.wallNs >= 30'000'000);
+
+    // The inner stage is not counted twice.
+    QVERIFY(outer.wallNs + inner.wallNs <= elapsedNs);
+}
+
+void ProfilerTest::testThreads()
+{
+    {
+        ScopedTimer timer(Stage::DgpsRead);
+    }
+
+    std::unique_ptr<QThread> thread(QThread::create([]() {
+        for (int i = 0; i < 3; ++i)
+        {
+            ScopedTimer timer(Stage::DgpsRead, 2);
+        }
+    }));
+    thread->start();
+    QVERIFY(thread->wait());
+
+    // Counters of finished threads are kept.
+    const StageStats s = Profiler::collect().at(static_cast<int>(Stage::DgpsRead));
+    QCOMPARE(s.calls, Q_INT64_C(4));
+    QCOMPARE(s.items, Q_INT64_C(7));
+}
+
+QTEST_GUILESS_MAIN(ProfilerTest)
+#include "profilertest.moc"
@@ -0,0 +1,227 @@
+/*!
+ * \file quantilesketchtest.cpp
+ * \brief Implements unit tests for the QuantileSketch and
+ * ErrorAccumulator classes.
+ * \author Álvaro Cebrián Juan, 2020. acebrianjuan(at)gmail.com
+ *
+ * -----------------------------------------------------------------------
+ *
+ * Copyright (C) 2020-2021 Álvaro Cebrián Juan <acebrianjuan@gmail.com>
+ *
+ * ASTMOPS is a command line tool for evaluating 
+ * the performance of A-SMGCS sensors at airports
+ *
+ * This file is part of ASTMOPS.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -----------------------------------------------------------------------
+ */
+
+#include "erroraccumulator.h"
+#include "functions.h"
+#include "quantilesketch.h"
+#include <QObject>
+#include <QtTest>
+#include <algorithm>
+
+class QuantileSketchTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testSketchRankError_data();
+    void testSketchRankError();
+    void testSketchMerge();
+    void testSketchStream();
+
+    void testExactAccumulator();
+    void testSketchAccumulator();
+};
+
+// Deterministic, unevenly distributed error samples.
+static QVector<double> makeErrors(int n)
+{
+    QVector<double> v;
+    v.reserve(n);
+
+    quint32 state = 12345;
+    for (int i = 0; i < n; ++i)
+    {
+        state = state * 1664525u + 1013904223u;
+        double u = (state >> 8) / double(1 << 24);
+        v << u * u * 50.0;
+    }
+
+    return v;
+}
+
+// Fraction of the values that are lower than x.
+static double rankOf(const QVector<double> &sorted, double x)
+{
+    auto it = std::lower_bound(sorted.begin(), sorted.end(), x);
+    return (it - sorted.begin()) / static_cast<double>(sorted.size());
+}
+
+void QuantileSketchTest::testSketchRankError_data()
+{
+    QTest::addColumn<int>("n");
+    QTest::addColumn<double>("q");
+
+    QTest::newRow("n=1000 P50") << 1000 << 0.50;
+    QTest::newRow("n=1000 P95") << 1000 << 0.95;
+    QTest::newRow("n=100000 P50") << 100000 << 0.50;
+    QTest::newRow("n=100000 P95") << 100000 << 0.95;
+    QTest::newRow("n=100000 P99") << 100000 << 0.99;
+}
+
+void QuantileSketchTest::testSketchRankError()
+{
+    QFETCH(int, n);
+    QFETCH(double, q);
+
+    QVector<double> errors = makeErrors(n);
+
+    QuantileSketch sketch;
+    for (double e : qAsConst(errors))
+    {
+        sketch << e;
+    }
+
+    std::sort(errors.begin(), errors.end());
+
+    QCOMPARE(sketch.count(), static_cast<quint64>(n));
+    QVERIFY(sketch.retained() < 4 * QuantileSketch::defaultK);
+    QVERIFY(qAbs(rankOf(errors, sketch.quantile(q)) - q) < 0.02);
+    QCOMPARE(sketch.quantile(0), errors.first());
+    QCOMPARE(sketch.quantile(1), errors.last());
+}
+
+void QuantileSketchTest::testSketchMerge()
+{
+    QVector<double> errors = makeErrors(50000);
+
+    QuantileSketch lhs;
+    QuantileSketch rhs;
+    for (int i = 0; i < errors.size(); ++i)
+    {
+        (i % 3 == 0 ? lhs : rhs) << errors.at(i);
+    }
+
+    lhs += rhs;
+
+    std::sort(errors.begin(), errors.end());
+
+    QCOMPARE(lhs.count(), static_cast<quint64>(errors.size()));
+    QVERIFY(qAbs(rankOf(errors, lhs.quantile(0.95)) - 0.95) < 0.02);
+}
+
+void QuantileSketchTest::testSketchStream()
+{
+    QuantileSketch sketch(50);
+    for (double error : makeErrors(5000))
+    {
+        sketch << error;
+    }
+
+    QByteArray data;
+    {
+        QDataStream out(&data, QIODevice::WriteOnly);
+        out << sketch;
+    }
+
+    QuantileSketch copy;
+    {
+        QDataStream in(data);
+        in >> copy;
+        QCOMPARE(in.status(), QDataStream::Ok);
+    }
+
+    QCOMPARE(copy.count(), sketch.count());
+    QCOMPARE(copy.retained(), sketch.retained());
+    QCOMPARE(copy.quantile(0.95), sketch.quantile(0.95));
+
+    // Writes a sketch field by field, as operator<<() does.
+    auto write = [](qint32 k, quint64 n, const QVector<QVector<double>> &levels,
+                     const QVector<int> &capacities, qint32 retained, qint32 totalCapacity) {
+        QByteArray bytes;
+        QDataStream out(&bytes, QIODevice::WriteOnly);
+        out << k << n << 1.0 << 2.0 << quint32(1) << levels << capacities << retained << totalCapacity;
+        return bytes;
+    };
+
+    auto read = [](const QByteArray &bytes) {
+        QuantileSketch s;
+        QDataStream in(bytes);
+        in >> s;
+        return in.status();
+    };
+
+    const QVector<double> level = {1.0, 2.0};
+
+    // A consistent single-level sketch of two values.
+    QCOMPARE(read(write(200, 2, {level}, {200}, 2, 200)), QDataStream::Ok);
+
+    // Inconsistent ones.
+    QCOMPARE(read(write(200, 2, {level, {}}, {200}, 2, 200)), QDataStream::ReadCorruptData);
+    QCOMPARE(read(write(200, 2, {level}, {100}, 2, 100)), QDataStream::ReadCorruptData);
+    QCOMPARE(read(write(200, 2, {level}, {200}, 5, 200)), QDataStream::ReadCorruptData);
+    QCOMPARE(read(write(200, 3, {level}, {200}, 2, 200)), QDataStream::ReadCorruptData);
+    QCOMPARE(read(write(200, 2, {level}, {200}, 2, 300)), QDataStream::ReadCorruptData);
+    QCOMPARE(read(write(0, 2, {level}, {200}, 2, 200)), QDataStream::ReadCorruptData);
+    QCOMPARE(read(write(200, 0, {}, {}, 0, 0)), QDataStream::ReadCorruptData);
+
+    // Truncated.
+    QCOMPARE(read(data.left(data.size() - 1)), QDataStream::ReadPastEnd);
+}
+
+void QuantileSketchTest::testExactAccumulator()
+{
+    const QVector<double> errors = makeErrors(1001);
+
+    ErrorAccumulator lhs;
+    ErrorAccumulator rhs;
+    for (int i = 0; i < errors.size(); ++i)
+    {
+        (i < 400 ? lhs : rhs) << errors.at(i);
+    }
+
+    lhs += rhs;
+
+    QVERIFY(lhs.isExact());
+    QCOMPARE(lhs.samples(), errors);
+    QCOMPARE(lhs.count(), static_cast<qint64>(errors.size()));
+    QCOMPARE(lhs.percentile(95), percentile(errors, 95));
+    QCOMPARE(lhs.percentile(99), percentile(errors, 99));
+    QCOMPARE(lhs.percentiles({95, 99}), QVector<double>({percentile(errors, 95), percentile(errors, 99)}));
+    QCOMPARE(lhs.samples(), errors);
+    QCOMPARE(lhs.mean(), mean(errors));
+    QCOMPARE(lhs.stdDev(), stdDev(errors));
+}
+
+void QuantileSketchTest::testSketchAccumulator()
+{
+    const QVector<double> errors = makeErrors(20000);
+
+    ErrorAccumulator lhs(QuantileSketch::defaultK);
+    ErrorAccumulator rhs;
+    for (int i = 0; i < errors.size(); ++i)
+    {
+        (i % 2 == 0 ? lhs : rhs) << errors.at(i);
+    }
+
+    // Merging an exact accumulator into a sketch one yields a sketch.
+    lhs += rhs;
+
+    QVERIFY(!lhs.isExact());
+    QCOMPARE(lhs.count(), static_cast<qint64>(errors.size()));
+    QVERIFY(qAbs(lhs.mean() - mean(errors)) < 1e-9);
+    QVERIFY(qAbs(lhs.stdDev() - stdDev(errors)) < 1e-9);
+
+    QVector<double> sorted = errors;
+    std::sort(sorted.begin(), sorted.end());
+    QVERIFY(qAbs(rankOf(sorted, lhs.percentile(95)) - 0.95) < 0.02);
+}
+
+QTEST_GUILESS_MAIN(QuantileSketchTest);
+#include "quantilesketchtest.moc"
@@ -0,0 +1,106 @@
+/*!
+ * \file rollingevaluatortest.cpp
+ * \brief Implements unit tests for the RollingEvaluator class.
+ * \author Álvaro Cebrián Juan, 2020. acebrianjuan(at)gmail.com
+ *
+ * -----------------------------------------------------------------------
+ *
+ * Copyright (C) 2020-2021 Álvaro Cebrián Juan <acebrianjuan@gmail.com>
+ *
+ * ASTMOPS is a command line tool for evaluating 
+ * the performance of A-SMGCS sensors at airports
+ *
+ * This file is part of ASTMOPS.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -----------------------------------------------------------------------
+ */
+
+#include "astmops.h"
+#include "rollingevaluator.h"
+#include <QObject>
+#include <QtTest>
+
+class RollingEvaluatorTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testWindow();
+    void testEvaluate();
+
+private:
+    static TargetReport makeTgtRep(const QDateTime &tod, TrackNum trk_nb);
+};
+
+TargetReport RollingEvaluatorTest::makeTgtRep(const QDateTime &tod, TrackNum trk_nb)
+{
+    TargetReport tr;
+    tr.sys_typ_ = SystemType::Smr;
+    tr.tod_ = tod;
+    tr.trk_nb_ = trk_nb;
+    tr.narea_ = Aerodrome::NamedArea(Aerodrome::Area::Runway);
+
+    return tr;
+}
+
+void RollingEvaluatorTest::testWindow()
+{
+    using namespace Literals;
+
+    RollingEvaluator eval(RunConfig(), 60 * 1000);
+    QVERIFY(eval.isEmpty());
+    QVERIFY(!eval.windowStart().isValid());
+
+    eval.addData(makeTgtRep("2020-05-05T10:00:00.000Z"_ts, 1));
+    eval.addData(makeTgtRep("2020-05-05T10:00:30.000Z"_ts, 1));
+    eval.addData(makeTgtRep("2020-05-05T10:01:00.000Z"_ts, 1));
+
+    QCOMPARE(eval.size(), 3);
+    QCOMPARE(eval.windowStart(), "2020-05-05T10:00:00.000Z"_ts);
+    QCOMPARE(eval.windowEnd(), "2020-05-05T10:01:00.000Z"_ts);
+
+    // Moves the window forward.
+    eval.addData(makeTgtRep("2020-05-05T10:01:15.000Z"_ts, 1));
+
+    QCOMPARE(eval.size(), 3);
+    QCOMPARE(eval.windowStart(), "2020-05-05T10:00:15.000Z"_ts);
+    QCOMPARE(eval.windowEnd(), "2020-05-05T10:01:15.000Z"_ts);
+
+    // Late, but within the window.
+    eval.addData(makeTgtRep("2020-05-05T10:00:20.000Z"_ts, 2));
+    QCOMPARE(eval.size(), 4);
+
+    // Late and already out of the window.
+    eval.addData(makeTgtRep("2020-05-05T10:00:10.000Z"_ts, 2));
+    QCOMPARE(eval.size(), 4);
+    QCOMPARE(eval.windowEnd(), "2020-05-05T10:01:15.000Z"_ts);
+
+    // A gap longer than the window drops everything before it.
+    eval.addData(makeTgtRep("2020-05-05T11:00:00.000Z"_ts, 1));
+    QCOMPARE(eval.size(), 1);
+}
+
+void RollingEvaluatorTest::testEvaluate()
+{
+    using namespace Literals;
+
+    RollingEvaluator eval(RunConfig(), 60 * 1000);
+    for (int i = 0; i < 10; ++i)
+    {
+        eval.addData(makeTgtRep("2020-05-05T10:00:00.000Z"_ts.addSecs(i), 1));
+    }
+
+    // Evaluating leaves the window untouched, so snapshots can be
+    // taken repeatedly.
+    const PerfResults first = eval.evaluate();
+    const PerfResults second = eval.evaluate();
+
+    QCOMPARE(eval.size(), 10);
+    QVERIFY(!first.metrics().isEmpty());
+    QCOMPARE(first.metrics().size(), second.metrics().size());
+}
+
+QTEST_GUILESS_MAIN(RollingEvaluatorTest)
+#include "rollingevaluatortest.moc"
@@ -0,0 +1,169 @@
+/*!
+ * \file segmentedextractiontest.cpp
+ * \brief Implements unit tests for the segmented extraction.
+ * \author Álvaro Cebrián Juan, 2020. acebrianjuan(at)gmail.com
+ *
+ * -----------------------------------------------------------------------
+ *
+ * Copyright (C) 2020-2021 Álvaro Cebrián Juan <acebrianjuan@gmail.com>
+ *
+ * ASTMOPS is a command line tool for evaluating 
+ * the performance of A-SMGCS sensors at airports
+ *
+ * This file is part of ASTMOPS.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -----------------------------------------------------------------------
+ */
+
+#include "asterixxmlreader.h"
+#include "config.h"
+#include "segmentedextraction.h"
+#include <QObject>
+#include <QtTest>
+
+class SegmentedExtractionTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void testDayOffsets_data();
+    void testDayOffsets();
+    void testStreamSegments_data();
+    void testStreamSegments();
+
+private:
+    Aerodrome aerodrome_;
+};
+
+void SegmentedExtractionTest::initTestCase()
+{
+    QCoreApplication::setOrganizationName(QLatin1String("astmops"));
+    QCoreApplication::setApplicationName(QLatin1String("astmops-segmentedextractiontest"));
+
+    Settings settings;
+    settings.clear();
+
+    settings.beginGroup(QLatin1String("Asterix"));
+    settings.setValue(QLatin1String("Date"), QLatin1String("2020-05-05"));
+    settings.setValue(QLatin1String("SmrSic"), 7);
+    settings.setValue(QLatin1String("MlatSic"), 107);
+    settings.setValue(QLatin1String("AdsbSic"), 219);
+    settings.endGroup();
+
+    aerodrome_.setArp(QGeoCoordinate(41.297, 2.078, 4.0));
+    aerodrome_.addSmr(7, QVector3D(-100.0, 50.0, 20.0));
+}
+
+void SegmentedExtractionTest::testDayOffsets_data()
+{
+    QTest::addColumn<QString>("fileName");
+
+    QTest::newRow("MIDNIGHT ROLLOVER") << "../asterixxmlreadertest/cat010_rollover.xml";
+    QTest::newRow("MIDNIGHT ROLLOVER DELAYED SAMPLE") << "../asterixxmlreadertest/cat010_rollover_delayed.xml";
+}
+
+void SegmentedExtractionTest::testDayOffsets()
+{
+    QFETCH(QString, fileName);
+
+    QFile file(QFINDTESTDATA(fileName));
+    QVERIFY(file.open(QIODevice::ReadOnly));
+
+    QByteArrayList lines;
+    while (!file.atEnd())
+    {
+        lines << file.readLine();
+    }
+
+    const RunConfig config = RunConfig::fromSettings();
+
+    auto readRecords = [&config](const QByteArrayList &part, QVector<Asterix::Record> &records) {
+        AsterixXmlReader reader(config);
+        for (const QByteArray &line : part)
+        {
+            reader.addData(line);
+        }
+
+        while (reader.hasPendingData())
+        {
+            records << reader.takeData().value();
+        }
+
+        return SegmentClock(reader);
+    };
+
+    QVector<Asterix::Record> expected;
+    readRecords(lines, expected);
+
+    // Every split of the recording in three segments, some of them empty,
+    // gives the same timestamps as a sequential read.
+    for (int k1 = 0; k1 <= lines.size(); ++k1)
+    {
+        for (int k2 = k1; k2 <= lines.size(); ++k2)
+        {
+            const QVector<QByteArrayList> parts = {
+                lines.mid(0, k1), lines.mid(k1, k2 - k1), lines.mid(k2)};
+
+            QVector<QVector<Asterix::Record>> records(parts.size());
+            QVector<SegmentClock> clocks;
+            for (int i = 0; i < parts.size(); ++i)
+            {
+                clocks << readRecords(parts.at(i), records[i]);
+            }
+
+            const QVector<QHash<RecordType, qint64>> offsets = segmentDayOffsets(clocks);
+
+            QVector<Asterix::Record> actual;
+            for (int i = 0; i < parts.size(); ++i)
+            {
+                for (Asterix::Record rec : records.at(i))
+                {
+                    rec.timestamp_ = rec.timestamp_.addDays(offsets.at(i).value(rec.rec_typ_, 0));
+                    actual << rec;
+                }
+            }
+
+            QCOMPARE(actual, expected);
+        }
+    }
+}
+
+void SegmentedExtractionTest::testStreamSegments_data()
+{
+    QTest::addColumn<QString>("fileName");
+
+    QTest::newRow("RECORDING") << "../asterixxmlreadertest/cat010.xml";
+    QTest::newRow("MIDNIGHT ROLLOVER") << "../asterixxmlreadertest/cat010_rollover.xml";
+    QTest::newRow("MIDNIGHT ROLLOVER DELAYED SAMPLE") << "../asterixxmlreadertest/cat010_rollover_delayed.xml";
+}
+
+void SegmentedExtractionTest::testStreamSegments()
+{
+    QFETCH(QString, fileName);
+
+    const QString path = QFINDTESTDATA(fileName);
+    const RunConfig config = RunConfig::fromSettings();
+
+    auto streamReports = [&](int segments) {
+        QVector<TargetReport> reports;
+        const bool ok = streamSegmentedTargetReports(path, segments, config, aerodrome_,
+            [&reports](const TargetReport &tr) { reports << tr; });
+
+        return ok ? reports : QVector<TargetReport>();
+    };
+
+    const QVector<TargetReport> expected = streamReports(1);
+    QVERIFY(!expected.isEmpty());
+
+    // More segments than lines leaves some of them empty.
+    for (int segments = 2; segments <= 12; ++segments)
+    {
+        QCOMPARE(streamReports(segments), expected);
+    }
+}
+
+QTEST_GUILESS_MAIN(SegmentedExtractionTest);
+#include "segmentedextractiontest.moc"
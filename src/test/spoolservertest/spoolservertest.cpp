@@ -0,0 +1,227 @@
+/*!
+ * \file spoolservertest.cpp
+ * \brief Implements unit tests for the SpoolServer class.
+ * \author Álvaro Cebrián Juan, 2020. acebrianjuan(at)gmail.com
+ *
+ * -----------------------------------------------------------------------
+ *
+ * Copyright (C) 2020-2021 Álvaro Cebrián Juan <acebrianjuan@gmail.com>
+ *
+ * ASTMOPS is a command line tool for evaluating 
+ * the performance of A-SMGCS sensors at airports
+ *
+ * This file is part of ASTMOPS.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -----------------------------------------------------------------------
+ */
+
+#include "spoolserver.h"
+#include <QAtomicInt>
+#include <QDir>
+#include <QFile>
+#include <QMutex>
+#include <QObject>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QThread>
+#include <QtTest>
+
+namespace
+{
+void writeFile(const QString &path, const QByteArray &data)
+{
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write(data);
+}
+
+QByteArray readFile(const QString &path)
+{
+    QFile file(path);
+    file.open(QIODevice::ReadOnly);
+    return file.readAll();
+}
+
+// Copies the recording to its result, keeping track of the jobs run.
+class CopyJob
+{
+public:
+    bool operator()(const QString &inputPath, const QString &resultPath)
+    {
+        const int n = running_.fetchAndAddOrdered(1) + 1;
+
+        int max = maxRunning_.loadAcquire();
+        while (n > max && !maxRunning_.testAndSetOrdered(max, n))
+        {
+            max = maxRunning_.loadAcquire();
+        }
+
+        {
+            QMutexLocker locker(&mutex_);
+            inputs_ << QFileInfo(inputPath).fileName();
+        }
+
+        QThread::msleep(50);
+
+        const QByteArray data = readFile(inputPath);
+        running_.fetchAndSubOrdered(1);
+
+        if (data.startsWith("fail"))
+        {
+            return false;
+        }
+
+        QFile result(resultPath);
+        result.open(QIODevice::WriteOnly);
+        result.write(data);
+
+        return true;
+    }
+
+    QStringList inputs()
+    {
+        QMutexLocker locker(&mutex_);
+        QStringList list = inputs_;
+        list.sort();
+        return list;
+    }
+
+    int maxRunning() const
+    {
+        return maxRunning_.loadAcquire();
+    }
+
+private:
+    QAtomicInt running_;
+    QAtomicInt maxRunning_;
+    QMutex mutex_;
+    QStringList inputs_;
+};
+}  // namespace
+
+class SpoolServerTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void testSubmit();
+    void testResume();
+    void testResubmit();
+};
+
+void SpoolServerTest::initTestCase()
+{
+    QCoreApplication::setOrganizationName(QLatin1String("astmops"));
+    QCoreApplication::setApplicationName(QLatin1String("astmops-spoolservertest"));
+}
+
+void SpoolServerTest::testSubmit()
+{
+    QTemporaryDir spool;
+    QTemporaryDir source;
+    QVERIFY(spool.isValid() && source.isValid());
+
+    CopyJob copyJob;
+    auto job = [&copyJob](const QString &in, const QString &out) { return copyJob(in, out); };
+
+    SpoolServer server(spool.path(), job, 2);
+    QSignalSpy spy(&server, &SpoolServer::jobFinished);
+    QVERIFY(server.start());
+
+    QStringList resultPaths;
+    for (int i = 0; i < 6; ++i)
+    {
+        const QString path = source.filePath(QStringLiteral("rec%1.xml").arg(i));
+        writeFile(path, QByteArray::number(i));
+
+        std::optional<QString> resultPath = SpoolServer::submit(spool.path(), path);
+        QVERIFY(resultPath.has_value());
+        resultPaths << resultPath.value();
+    }
+
+    QVERIFY(!SpoolServer::submit(spool.path(), source.filePath(QStringLiteral("rec.csv"))).has_value());
+
+    QTRY_COMPARE_WITH_TIMEOUT(spy.count(), 6, 10000);
+
+    for (int i = 0; i < 6; ++i)
+    {
+        QCOMPARE(readFile(resultPaths.at(i)), QByteArray::number(i));
+    }
+
+    QCOMPARE(copyJob.inputs().size(), 6);
+    QVERIFY(copyJob.maxRunning() <= 2);
+    QCOMPARE(server.activeJobs(), 0);
+}
+
+void SpoolServerTest::testResume()
+{
+    QTemporaryDir spool;
+    QVERIFY(spool.isValid());
+
+    // Done in a previous run.
+    writeFile(spool.filePath(QStringLiteral("a.xml")), "a");
+    writeFile(spool.filePath(QStringLiteral("a.xml.json")), "a");
+
+    // Pending, failing, and not a recording.
+    writeFile(spool.filePath(QStringLiteral("b.xml")), "b");
+    writeFile(spool.filePath(QStringLiteral("c.xml")), "fail");
+    writeFile(spool.filePath(QStringLiteral("d.xml.part")), "d");
+
+    CopyJob copyJob;
+    auto job = [&copyJob](const QString &in, const QString &out) { return copyJob(in, out); };
+
+    SpoolServer server(spool.path(), job, 4);
+    QSignalSpy spy(&server, &SpoolServer::jobFinished);
+    QVERIFY(server.start());
+
+    server.waitForDone();
+
+    QCOMPARE(spy.count(), 2);
+    QCOMPARE(copyJob.inputs(), QStringList() << QStringLiteral("b.xml") << QStringLiteral("c.xml"));
+    QVERIFY(QFileInfo::exists(spool.filePath(QStringLiteral("b.xml.json"))));
+    QVERIFY(!QFileInfo::exists(spool.filePath(QStringLiteral("c.xml.json"))));
+
+    // Failed recordings are not retried until they change.
+    writeFile(spool.filePath(QStringLiteral("e.xml")), "e");
+
+    QTRY_COMPARE_WITH_TIMEOUT(spy.count(), 3, 10000);
+    server.waitForDone();
+
+    QCOMPARE(spy.count(), 3);
+    QCOMPARE(spy.last().at(0).toString(), spool.filePath(QStringLiteral("e.xml")));
+    QCOMPARE(spy.last().at(1).toBool(), true);
+}
+
+void SpoolServerTest::testResubmit()
+{
+    QTemporaryDir spool;
+    QTemporaryDir source;
+    QVERIFY(spool.isValid() && source.isValid());
+
+    CopyJob copyJob;
+    auto job = [&copyJob](const QString &in, const QString &out) { return copyJob(in, out); };
+
+    SpoolServer server(spool.path(), job, 1);
+    QSignalSpy spy(&server, &SpoolServer::jobFinished);
+    QVERIFY(server.start());
+
+    const QString path = source.filePath(QStringLiteral("rec.xml"));
+
+    writeFile(path, "first");
+    std::optional<QString> resultPath = SpoolServer::submit(spool.path(), path);
+    QVERIFY(resultPath.has_value());
+    QTRY_COMPARE_WITH_TIMEOUT(spy.count(), 1, 10000);
+    QCOMPARE(readFile(resultPath.value()), QByteArray("first"));
+
+    writeFile(path, "second");
+    QVERIFY(SpoolServer::submit(spool.path(), path).has_value());
+    QTRY_COMPARE_WITH_TIMEOUT(spy.count(), 2, 10000);
+    QCOMPARE(readFile(resultPath.value()), QByteArray("second"));
+}
+
+QTEST_GUILESS_MAIN(SpoolServerTest)
+#include "spoolservertest.moc"
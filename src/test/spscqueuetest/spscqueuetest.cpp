@@ -0,0 +1,118 @@
+/*!
+ * \file spscqueuetest.cpp
+ * \brief Implements unit tests for the SpscQueue class.
+ * \author Álvaro Cebrián Juan, 2020. acebrianjuan(at)gmail.com
+ *
+ * -----------------------------------------------------------------------
+ *
+ * Copyright (C) 2020-2021 Álvaro Cebrián Juan <acebrianjuan@gmail.com>
+ *
+ * ASTMOPS is a command line tool for evaluating 
+ * the performance of A-SMGCS sensors at airports
+ *
+ * This file is part of ASTMOPS.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -----------------------------------------------------------------------
+ */
+
+#include "spscqueue.h"
+#include <QObject>
+#include <QThread>
+#include <QtTest>
+#include <memory>
+
+class SpscQueueTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testCapacity();
+    void testFifo();
+    void testClose();
+    void testThreads();
+};
+
+void SpscQueueTest::testCapacity()
+{
+    SpscQueue<int> queue(5);
+    QCOMPARE(queue.capacity(), 8);
+
+    for (int i = 0; i < queue.capacity(); ++i)
+    {
+        QVERIFY(queue.tryPush(int(i)));
+    }
+
+    QVERIFY(!queue.tryPush(8));
+    QCOMPARE(queue.size(), 8);
+
+    // A value that does not fit is not taken.
+    SpscQueue<QVector<int>> vectors(1);
+    QVector<int> rejected = {1, 2, 3};
+    QVERIFY(vectors.tryPush(QVector<int>()));
+    QVERIFY(!vectors.tryPush(std::move(rejected)));
+    QCOMPARE(rejected.size(), 3);
+}
+
+void SpscQueueTest::testFifo()
+{
+    SpscQueue<int> queue(4);
+
+    // Wraps around the ring several times.
+    for (int i = 0; i < 20; ++i)
+    {
+        QVERIFY(queue.tryPush(int(i)));
+        QVERIFY(queue.tryPush(int(i + 100)));
+        QCOMPARE(queue.tryPop(), std::optional<int>(i));
+        QCOMPARE(queue.tryPop(), std::optional<int>(i + 100));
+    }
+
+    QVERIFY(queue.isEmpty());
+    QVERIFY(!queue.tryPop().has_value());
+}
+
+void SpscQueueTest::testClose()
+{
+    SpscQueue<int> queue(4);
+    queue.push(1);
+    queue.push(2);
+    queue.close();
+
+    // Items pushed before close() are still delivered.
+    QCOMPARE(queue.pop(), std::optional<int>(1));
+    QCOMPARE(queue.pop(), std::optional<int>(2));
+    QVERIFY(!queue.pop().has_value());
+}
+
+void SpscQueueTest::testThreads()
+{
+    const int n = 200000;
+
+    // A small queue, so that both sides wait on each other.
+    SpscQueue<int> queue(16);
+
+    std::unique_ptr<QThread> producer(QThread::create([&queue]() {
+        for (int i = 0; i < n; ++i)
+        {
+            queue.push(i);
+        }
+        queue.close();
+    }));
+    producer->start();
+
+    int expected = 0;
+    bool ordered = true;
+    while (std::optional<int> value = queue.pop())
+    {
+        ordered = ordered && value.value() == expected;
+        ++expected;
+    }
+
+    QVERIFY(producer->wait(60000));
+    QVERIFY(ordered);
+    QCOMPARE(expected, n);
+}
+
+QTEST_GUILESS_MAIN(SpscQueueTest);
+#include "spscqueuetest.moc"
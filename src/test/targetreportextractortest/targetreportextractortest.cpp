@@ -22,6 +22,7 @@
 #include "geofunctions.h"
 #include <QObject>
 #include <QtTest>
+#include <memory>
 
 class TargetReportExtractorTest : public QObject
 {
@@ -43,9 +44,21 @@ private slots:
     void addDataTest_data();
     void addDataTest();
 
+    void addDataBatchTest_data();
+    void addDataBatchTest();
+
+    void takeDataMergeTest_data();
+    void takeDataMergeTest();
+
     void addDgpsDataTest_data();
     void addDgpsDataTest();
 
+    void benchmarkPerRecord_data();
+    void benchmarkPerRecord();
+
+    void benchmarkBatch_data();
+    void benchmarkBatch();
+
     /* TODO: Consider adding a test that takes as input a sequence of
      * records of different nature (resembling a real stream of data).
      */
@@ -496,7 +509,7 @@ void TargetReportExtractorTest::addDataTest()
         return Aerodrome::NamedArea(Aerodrome::Area::Runway);
     };
 
-    TargetReportExtractor tgtRepExtr(leblArpGeo, smrHashEnu);
+    TargetReportExtractor tgtRepExtr(RunConfig::fromSettings(), leblArpGeo, smrHashEnu);
     tgtRepExtr.setLocatePointCallback(runwayCb);
 
     // Feed Records.
@@ -519,6 +532,183 @@ void TargetReportExtractorTest::addDataTest()
     }
 }
 
+// Extractor at LEBL that places every target report on the runway.
+static std::unique_ptr<TargetReportExtractor> makeLeblExtractor()
+{
+    QGeoCoordinate leblArpGeo(41.297076579982225, 2.0784629201158662, 4.3200000000000003);
+    QGeoCoordinate leblSmrGeo(41.29561944, 2.095113889, 4.3200000000000003);
+
+    QHash<Sic, QVector3D> smrHashEnu;
+    smrHashEnu.insert(7, geoToLocalEnu(leblSmrGeo, leblArpGeo));
+
+    auto runwayCb = [](const QVector3D cartPos, const bool gndBit) {
+        Q_UNUSED(cartPos);
+        Q_UNUSED(gndBit);
+        return Aerodrome::NamedArea(Aerodrome::Area::Runway);
+    };
+
+    auto tgtRepExtr = std::make_unique<TargetReportExtractor>(RunConfig::fromSettings(), leblArpGeo, smrHashEnu);
+    tgtRepExtr->setLocatePointCallback(runwayCb);
+
+    return tgtRepExtr;
+}
+
+// Records of a data row repeated to make a stream for the benchmarks.
+static QVector<Asterix::Record> repeatRecords(const QVector<Asterix::Record> &recs, int times)
+{
+    QVector<Asterix::Record> stream;
+    stream.reserve(recs.size() * times);
+
+    for (int i = 0; i < times; ++i)
+    {
+        stream << recs;
+    }
+
+    return stream;
+}
+
+void TargetReportExtractorTest::addDataBatchTest_data()
+{
+    addDataTest_data();
+}
+
+void TargetReportExtractorTest::addDataBatchTest()
+{
+    QFETCH(SystemType, sysType);
+    QFETCH(QVector<Asterix::Record>, recsIn);
+    QFETCH(QVector<TargetReport>, tgtRepsOut);
+
+    std::unique_ptr<TargetReportExtractor> tgtRepExtr = makeLeblExtractor();
+    QSignalSpy spy(tgtRepExtr.get(), &TargetReportExtractor::readyRead);
+
+    tgtRepExtr->addData(recsIn);
+
+    // One signal for the whole batch.
+    QCOMPARE(spy.count(), tgtRepsOut.isEmpty() ? 0 : 1);
+
+    Counters::InOutCounter counter = tgtRepExtr->counters(sysType);
+    QCOMPARE(counter.in_, static_cast<quint32>(recsIn.size()));
+    QCOMPARE(counter.out_, static_cast<quint32>(tgtRepsOut.size()));
+
+    QVector<TargetReport> trs;
+    tgtRepExtr->takeAll(trs);
+
+    QCOMPARE(trs, tgtRepsOut);
+    QVERIFY(!tgtRepExtr->hasPendingData());
+}
+
+void TargetReportExtractorTest::takeDataMergeTest_data()
+{
+    addDataTest_data();
+}
+
+void TargetReportExtractorTest::takeDataMergeTest()
+{
+    using namespace Literals;
+
+    QFETCH(SystemType, sysType);
+    QFETCH(QVector<Asterix::Record>, recsIn);
+    QFETCH(QVector<TargetReport>, tgtRepsOut);
+
+    // DGPS positions around the time of the records, added first.
+    DgpsTargetData dgps;
+    dgps.mode_s_ = 0x000001;
+    dgps.data_ << QGeoPositionInfo(QGeoCoordinate(41.2854687222, 2.0835099167, 50.0),
+                      "2020-05-05T23:59:57.500Z"_ts)
+               << QGeoPositionInfo(QGeoCoordinate(41.2854687222, 2.0835099167, 50.0),
+                      "2020-05-05T23:59:58.500Z"_ts)
+               << QGeoPositionInfo(QGeoCoordinate(41.2854687222, 2.0835099167, 50.0),
+                      "2020-05-05T23:59:59.500Z"_ts)
+               << QGeoPositionInfo(QGeoCoordinate(41.2854687222, 2.0835099167, 50.0),
+                      "2020-05-06T00:00:00.500Z"_ts);
+
+    std::unique_ptr<TargetReportExtractor> tgtRepExtr = makeLeblExtractor();
+    tgtRepExtr->addDgpsData(dgps);
+    tgtRepExtr->addData(recsIn);
+
+    QVector<TargetReport> trs;
+    while (tgtRepExtr->hasPendingData())
+    {
+        trs.append(tgtRepExtr->takeData().value());
+    }
+
+    QVERIFY(!tgtRepExtr->takeData().has_value());
+    QCOMPARE(trs.size(), dgps.data_.size() + tgtRepsOut.size());
+
+    // Merged in time order, each system keeping its own order.
+    QVector<TargetReport> sysTrs;
+    for (int i = 0; i < trs.size(); ++i)
+    {
+        if (i > 0)
+        {
+            QVERIFY(trs.at(i - 1).tod_ <= trs.at(i).tod_);
+        }
+
+        if (trs.at(i).sys_typ_ == sysType)
+        {
+            sysTrs << trs.at(i);
+        }
+    }
+
+    QCOMPARE(sysTrs, tgtRepsOut);
+}
+
+void TargetReportExtractorTest::benchmarkPerRecord_data()
+{
+    addDataTest_data();
+}
+
+void TargetReportExtractorTest::benchmarkPerRecord()
+{
+    QFETCH(QVector<Asterix::Record>, recsIn);
+
+    const QVector<Asterix::Record> stream = repeatRecords(recsIn, 1000);
+
+    std::unique_ptr<TargetReportExtractor> tgtRepExtr = makeLeblExtractor();
+
+    QVector<TargetReport> trs;
+    QObject::connect(tgtRepExtr.get(), &TargetReportExtractor::readyRead, [&]() {
+        while (tgtRepExtr->hasPendingData())
+        {
+            trs.append(tgtRepExtr->takeData().value());
+        }
+    });
+
+    QBENCHMARK
+    {
+        trs.resize(0);
+        for (const Asterix::Record &rec : stream)
+        {
+            tgtRepExtr->addData(rec);
+        }
+    }
+}
+
+void TargetReportExtractorTest::benchmarkBatch_data()
+{
+    addDataTest_data();
+}
+
+void TargetReportExtractorTest::benchmarkBatch()
+{
+    QFETCH(QVector<Asterix::Record>, recsIn);
+
+    const QVector<Asterix::Record> stream = repeatRecords(recsIn, 1000);
+
+    std::unique_ptr<TargetReportExtractor> tgtRepExtr = makeLeblExtractor();
+
+    QVector<TargetReport> trs;
+    QObject::connect(tgtRepExtr.get(), &TargetReportExtractor::readyRead, [&]() {
+        tgtRepExtr->takeAll(trs);
+    });
+
+    QBENCHMARK
+    {
+        trs.resize(0);
+        tgtRepExtr->addData(stream);
+    }
+}
+
 void TargetReportExtractorTest::addDgpsDataTest_data()
 {
     using namespace Literals;
@@ -665,7 +855,7 @@ void TargetReportExtractorTest::addDgpsDataTest()
         return Aerodrome::NamedArea(Aerodrome::Area::Runway);
     };
 
-    TargetReportExtractor tgtRepExtr(leblArpGeo, smrHashEnu);
+    TargetReportExtractor tgtRepExtr(RunConfig::fromSettings(), leblArpGeo, smrHashEnu);
     tgtRepExtr.setLocatePointCallback(runwayCb);
 
     // Feed data.
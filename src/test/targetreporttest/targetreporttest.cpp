@@ -0,0 +1,197 @@
+/*!
+ * \file targetreporttest.cpp
+ * \brief Implements unit tests for the TargetReport class.
+ * \author Álvaro Cebrián Juan, 2020. acebrianjuan(at)gmail.com
+ *
+ * -----------------------------------------------------------------------
+ *
+ * Copyright (C) 2020-2021 Álvaro Cebrián Juan <acebrianjuan@gmail.com>
+ *
+ * ASTMOPS is a command line tool for evaluating 
+ * the performance of A-SMGCS sensors at airports
+ *
+ * This file is part of ASTMOPS.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -----------------------------------------------------------------------
+ */
+
+#include "targetreport.h"
+#include <QObject>
+#include <QRegularExpression>
+#include <QThread>
+#include <QtTest>
+#include <memory>
+
+class TargetReportTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testInlineIdent_data();
+    void testInlineIdent();
+    void testInlineIdentEquality();
+    void testInlineIdentWarnings();
+    void testAreaId();
+    void testAreaIdThreads();
+};
+
+void TargetReportTest::testInlineIdent_data()
+{
+    QTest::addColumn<QString>("ident");
+    QTest::addColumn<bool>("valid");
+
+    QTest::newRow("Empty") << QString() << true;
+    QTest::newRow("Short") << QStringLiteral("IBE") << true;
+    QTest::newRow("8 characters") << QStringLiteral("IBE1234A") << true;
+    QTest::newRow("Latin-1") << QStringLiteral("ÇÑ") << true;
+    QTest::newRow("Over-long") << QStringLiteral("IBE1234AB") << false;
+    QTest::newRow("Non Latin-1") << QStringLiteral("IBE€") << false;
+}
+
+void TargetReportTest::testInlineIdent()
+{
+    QFETCH(QString, ident);
+    QFETCH(bool, valid);
+
+    QCOMPARE(InlineIdent::isValid(ident), valid);
+
+    InlineIdent inlineIdent;
+    QVERIFY(!inlineIdent.has_value());
+    QCOMPARE(inlineIdent.value(), Ident());
+
+    if (!valid)
+    {
+        QTest::ignoreMessage(QtWarningMsg, QRegularExpression(QLatin1String("^Discarding invalid identification")));
+    }
+
+    inlineIdent = ident;
+    QCOMPARE(inlineIdent.has_value(), valid);
+
+    if (valid)
+    {
+        QCOMPARE(inlineIdent.value(), ident);
+    }
+
+    inlineIdent = std::nullopt;
+    QVERIFY(!inlineIdent.has_value());
+}
+
+void TargetReportTest::testInlineIdentEquality()
+{
+    InlineIdent none;
+    InlineIdent empty;
+    empty = QString();
+    InlineIdent abc;
+    abc = QStringLiteral("ABC");
+    InlineIdent abcd;
+    abcd = QStringLiteral("ABCD");
+    InlineIdent abc2;
+    abc2 = QStringLiteral("ABCD");
+    abc2 = QStringLiteral("ABC");  // No leftovers from the longer value.
+
+    QVERIFY(none != empty);
+    QVERIFY(abc != abcd);
+    QVERIFY(abc == abc2);
+
+    abc2.reset();
+    QVERIFY(abc2 == none);
+}
+
+void TargetReportTest::testInlineIdentWarnings()
+{
+    const quint64 rejected = InlineIdent::rejectedCount();
+
+    // Only the first occurrence of each invalid value is reported, every
+    // one is counted.
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression(QLatin1String("^Discarding invalid identification \"REPEATED1\"")));
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression(QLatin1String("^Discarding invalid identification \"REPEATED2\"")));
+
+    InlineIdent inlineIdent;
+    for (int i = 0; i < 3; ++i)
+    {
+        inlineIdent = QStringLiteral("REPEATED1");
+        inlineIdent = QStringLiteral("REPEATED2");
+        QVERIFY(!inlineIdent.has_value());
+    }
+
+    QCOMPARE(InlineIdent::rejectedCount(), rejected + 6);
+}
+
+void TargetReportTest::testAreaId()
+{
+    const Aerodrome::NamedArea rwy1(Aerodrome::Area::Runway, QLatin1String("RWY1"));
+    const Aerodrome::NamedArea rwy2(Aerodrome::Area::Runway, QLatin1String("RWY2"));
+    const Aerodrome::NamedArea twy(Aerodrome::Area::Taxiway);
+
+    const AreaId none;
+    QCOMPARE(none.value(), quint16(0));
+    QCOMPARE(none.namedArea(), Aerodrome::NamedArea());
+    QCOMPARE(AreaId(Aerodrome::NamedArea()), none);
+
+    const AreaId rwy1Id(rwy1);
+    QVERIFY(rwy1Id != none);
+    QCOMPARE(AreaId(rwy1), rwy1Id);
+    QVERIFY(AreaId(rwy2) != rwy1Id);
+    QVERIFY(AreaId(twy) != rwy1Id);
+
+    QCOMPARE(rwy1Id.namedArea(), rwy1);
+    QCOMPARE(rwy1Id.area(), Aerodrome::Area::Runway);
+    QCOMPARE(AreaId(twy).namedArea(), twy);
+
+    // Target reports compare and serialize their area by value.
+    TargetReport tr;
+    tr.tod_ = QDateTime::fromMSecsSinceEpoch(0, Qt::UTC);
+    tr.narea_ = rwy2;
+
+    QByteArray bytes;
+    QDataStream out(&bytes, QIODevice::WriteOnly);
+    out << tr;
+
+    TargetReport copy;
+    QDataStream in(bytes);
+    in >> copy;
+
+    QCOMPARE(copy.narea_, tr.narea_);
+    QCOMPARE(copy.narea_.namedArea().name_, QLatin1String("RWY2"));
+}
+
+void TargetReportTest::testAreaIdThreads()
+{
+    const int threads = 4;
+    const int areas = 100;
+
+    // Every thread interns the same areas, in a different order.
+    std::vector<QVector<quint16>> ids(threads);
+    std::vector<std::unique_ptr<QThread>> workers;
+
+    for (int t = 0; t < threads; ++t)
+    {
+        workers.emplace_back(QThread::create([&ids, t]() {
+            QVector<quint16> threadIds(areas);
+            for (int i = 0; i < areas; ++i)
+            {
+                const int a = (i * 7 + t * 13) % areas;
+                const Aerodrome::NamedArea narea(Aerodrome::Area::Stand,
+                    QStringLiteral("STAND%1").arg(a));
+                threadIds[a] = AreaId(narea).value();
+            }
+            ids[t] = threadIds;
+        }));
+        workers.back()->start();
+    }
+
+    for (const auto &worker : workers)
+    {
+        QVERIFY(worker->wait(60000));
+    }
+
+    for (int t = 1; t < threads; ++t)
+    {
+        QCOMPARE(ids[t], ids[0]);
+    }
+}
+
+QTEST_GUILESS_MAIN(TargetReportTest);
+#include "targetreporttest.moc"
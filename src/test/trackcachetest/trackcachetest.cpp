@@ -0,0 +1,319 @@
+/*!
+ * \file trackcachetest.cpp
+ * \brief Implements unit tests for the TrackCache class.
+ * \author Álvaro Cebrián Juan, 2020. acebrianjuan(at)gmail.com
+ *
+ * -----------------------------------------------------------------------
+ *
+ * Copyright (C) 2020-2021 Álvaro Cebrián Juan <acebrianjuan@gmail.com>
+ *
+ * ASTMOPS is a command line tool for evaluating 
+ * the performance of A-SMGCS sensors at airports
+ *
+ * This file is part of ASTMOPS.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -----------------------------------------------------------------------
+ */
+
+#include "trackcache.h"
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QObject>
+#include <QRegularExpression>
+#include <QTemporaryDir>
+#include <QtTest>
+
+using namespace Literals;
+
+namespace
+{
+void writeFile(const QString &path, const QByteArray &data)
+{
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write(data);
+}
+
+QByteArray readFile(const QString &path)
+{
+    QFile file(path);
+    file.open(QIODevice::ReadOnly);
+    return file.readAll();
+}
+
+QString cacheFilePath(const QTemporaryDir &dir, const QByteArray &key)
+{
+    return dir.filePath(QString::fromLatin1(key.toHex()) + QLatin1String(".trk"));
+}
+
+// Offsets of the header fields in a cache file.
+const int versionPos = 8;
+const int countPos = versionPos + 2 + 4 + 32;
+
+// Overwrites the quint16 or quint64 at \a pos of the file at \a path.
+template <typename T>
+void patchFile(const QString &path, int pos, T value)
+{
+    QByteArray data = readFile(path);
+
+    QByteArray field;
+    QDataStream stream(&field, QIODevice::WriteOnly);
+    stream << value;
+
+    data.replace(pos, field.size(), field);
+    writeFile(path, data);
+}
+
+Track makeTrack(TrackNum trk_nb, double x)
+{
+    TargetReport tr;
+    tr.ds_id_.sac_ = 0;
+    tr.ds_id_.sic_ = 219;
+    tr.sys_typ_ = SystemType::Adsb;
+    tr.trk_nb_ = trk_nb;
+    tr.mode_s_ = 0x000001;
+    tr.ident_ = QLatin1String("FOO1234 ");
+    tr.tgt_typ_ = TargetType::Aircraft;
+    tr.on_gnd_ = true;
+    tr.narea_ = Aerodrome::NamedArea(Aerodrome::Area::Runway, QLatin1String("RWY1"));
+
+    QVector<TargetReport> trs;
+    for (int i = 0; i < 3; ++i)
+    {
+        tr.tod_ = "2020-05-05T10:00:00.000Z"_ts.addSecs(i);
+        tr.x_ = x + i;
+        tr.y_ = -x;
+        trs << tr;
+    }
+
+    return Track(SystemType::Adsb, trk_nb, trs);
+}
+
+}  // namespace
+
+class TrackCacheTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testExtractionKey();
+    void testHit();
+    void testStaleKey();
+    void testVersionMismatch();
+    void testCorrupt();
+    void testCommit();
+
+private:
+    // Stores \a tracks under \a key in \a dir.
+    void store(const QTemporaryDir &dir, const QByteArray &key, const QVector<Track> &tracks);
+    QVector<Track> load(const QTemporaryDir &dir, const QByteArray &key, bool *ok);
+
+    const QByteArray key_ = QByteArray(32, 'k');
+    const QVector<Track> tracks_ = {makeTrack(101, 10.0), makeTrack(102, 20.0), makeTrack(103, 30.0)};
+};
+
+void TrackCacheTest::store(const QTemporaryDir &dir, const QByteArray &key, const QVector<Track> &tracks)
+{
+    TrackCache cache(dir.path());
+    QVERIFY(cache.beginStore(key));
+    for (const Track &t : tracks)
+    {
+        cache.store(t);
+    }
+    QVERIFY(cache.commit());
+}
+
+QVector<Track> TrackCacheTest::load(const QTemporaryDir &dir, const QByteArray &key, bool *ok)
+{
+    QVector<Track> tracks;
+    *ok = TrackCache(dir.path()).load(key, [&tracks](const Track &t) { tracks << t; });
+    return tracks;
+}
+
+void TrackCacheTest::testExtractionKey()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    const QString input = dir.filePath(QLatin1String("input.xml"));
+    const QString kml = dir.filePath(QLatin1String("aerodrome.kml"));
+    const QString dgps = dir.filePath(QLatin1String("dgps.csv"));
+    writeFile(input, "<asterix/>");
+    writeFile(kml, "<kml/>");
+    writeFile(dgps, "dgps");
+
+    RunConfig config;
+    config.asterixDate = QDate(2020, 5, 5);
+    config.smrSic << 7;
+
+    const QByteArray key = TrackCache::extractionKey(config, input, kml, dgps);
+    QCOMPARE(key.size(), 32);
+    QCOMPARE(TrackCache::extractionKey(config, input, kml, dgps), key);
+
+    // Evaluation settings do not change the tracks.
+    RunConfig evalConfig = config;
+    evalConfig.rpaPicPercentile = 50;
+    QCOMPARE(TrackCache::extractionKey(evalConfig, input, kml, dgps), key);
+
+    // Extraction settings do.
+    RunConfig sicConfig = config;
+    sicConfig.smrSic << 8;
+    QVERIFY(TrackCache::extractionKey(sicConfig, input, kml, dgps) != key);
+
+    // The DGPS file only matters in DGPS mode.
+    writeFile(dgps, "other dgps");
+    QCOMPARE(TrackCache::extractionKey(config, input, kml, dgps), key);
+
+    RunConfig dgpsConfig = config;
+    dgpsConfig.mode = ProcessingMode::Dgps;
+    const QByteArray dgpsKey = TrackCache::extractionKey(dgpsConfig, input, kml, dgps);
+    QVERIFY(dgpsKey != key);
+    writeFile(dgps, "dgps");
+    QVERIFY(TrackCache::extractionKey(dgpsConfig, input, kml, dgps) != dgpsKey);
+
+    // The contents of the input files are hashed, not their paths.
+    writeFile(kml, "<kml></kml>");
+    QVERIFY(TrackCache::extractionKey(config, input, kml, dgps) != key);
+    writeFile(kml, "<kml/>");
+    QCOMPARE(TrackCache::extractionKey(config, input, kml, dgps), key);
+
+    writeFile(input, "<asterix></asterix>");
+    QVERIFY(TrackCache::extractionKey(config, input, kml, dgps) != key);
+}
+
+void TrackCacheTest::testHit()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    bool ok = true;
+    QVERIFY(load(dir, key_, &ok).isEmpty());
+    QVERIFY(!ok);
+
+    store(dir, key_, tracks_);
+
+    const QVector<Track> tracks = load(dir, key_, &ok);
+    QVERIFY(ok);
+    QCOMPARE(tracks, tracks_);
+
+    // An empty set of tracks is a hit too.
+    const QByteArray emptyKey(32, 'e');
+    store(dir, emptyKey, QVector<Track>());
+    QVERIFY(load(dir, emptyKey, &ok).isEmpty());
+    QVERIFY(ok);
+}
+
+void TrackCacheTest::testStaleKey()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    store(dir, key_, tracks_);
+
+    // A different key misses.
+    const QByteArray otherKey(32, 'o');
+    bool ok = true;
+    QVERIFY(load(dir, otherKey, &ok).isEmpty());
+    QVERIFY(!ok);
+
+    // A file under the name of a key that holds another one is ignored.
+    QVERIFY(QFile::copy(cacheFilePath(dir, key_), cacheFilePath(dir, otherKey)));
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression(QLatin1String("^Ignoring stale or incomplete track cache")));
+    QVERIFY(load(dir, otherKey, &ok).isEmpty());
+    QVERIFY(!ok);
+
+    // So is a truncated one.
+    const QByteArray data = readFile(cacheFilePath(dir, key_));
+    writeFile(cacheFilePath(dir, key_), data.left(data.size() - 1));
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression(QLatin1String("^Ignoring stale or incomplete track cache")));
+    QVERIFY(load(dir, key_, &ok).isEmpty());
+    QVERIFY(!ok);
+}
+
+void TrackCacheTest::testVersionMismatch()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    store(dir, key_, tracks_);
+    patchFile(cacheFilePath(dir, key_), versionPos, quint16(TrackCache::version - 1));
+
+    bool ok = true;
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression(QLatin1String("^Ignoring stale or incomplete track cache")));
+    QVERIFY(load(dir, key_, &ok).isEmpty());
+    QVERIFY(!ok);
+
+    // A file that is not a track cache at all.
+    writeFile(cacheFilePath(dir, key_), "not a track cache");
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression(QLatin1String("^Ignoring invalid track cache")));
+    QVERIFY(load(dir, key_, &ok).isEmpty());
+    QVERIFY(!ok);
+}
+
+void TrackCacheTest::testCorrupt()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    // More tracks announced than stored: decoding runs past the end after
+    // the stored ones, none of which may reach the callback.
+    store(dir, key_, tracks_);
+    patchFile(cacheFilePath(dir, key_), countPos, quint64(tracks_.size() + 1));
+
+    bool ok = true;
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression(QLatin1String("^Ignoring corrupt track cache")));
+    QVERIFY(load(dir, key_, &ok).isEmpty());
+    QVERIFY(!ok);
+
+    // Fewer tracks announced than stored: data is left over.
+    store(dir, key_, tracks_);
+    patchFile(cacheFilePath(dir, key_), countPos, quint64(tracks_.size() - 1));
+
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression(QLatin1String("^Ignoring corrupt track cache")));
+    QVERIFY(load(dir, key_, &ok).isEmpty());
+    QVERIFY(!ok);
+
+    // Storing again replaces the corrupt file.
+    store(dir, key_, tracks_);
+    QCOMPARE(load(dir, key_, &ok), tracks_);
+    QVERIFY(ok);
+}
+
+void TrackCacheTest::testCommit()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    const QString path = cacheFilePath(dir, key_);
+
+    // Nothing to commit before beginStore().
+    TrackCache cache(dir.path());
+    QVERIFY(!cache.commit());
+
+    // The file only appears once committed.
+    QVERIFY(cache.beginStore(key_));
+    cache.store(tracks_.first());
+    QVERIFY(!QFile::exists(path));
+    QVERIFY(cache.commit());
+    QVERIFY(QFile::exists(path));
+
+    // A second commit has nothing left to write.
+    QVERIFY(!cache.commit());
+
+    bool ok = false;
+    QCOMPARE(load(dir, key_, &ok), QVector<Track>({tracks_.first()}));
+    QVERIFY(ok);
+
+    // The cache directory is created on demand.
+    const QString subdir = dir.filePath(QLatin1String("sub/dir"));
+    TrackCache nested(subdir);
+    QVERIFY(nested.beginStore(key_));
+    QVERIFY(nested.commit());
+    QVERIFY(QFile::exists(QDir(subdir).filePath(QString::fromLatin1(key_.toHex()) + QLatin1String(".trk"))));
+}
+
+QTEST_GUILESS_MAIN(TrackCacheTest)
+#include "trackcachetest.moc"
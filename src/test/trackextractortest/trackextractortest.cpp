@@ -30,6 +30,7 @@ private slots:
     void initTestCase();
     void test_data();
     void test();
+    void lateTest();
 };
 
 void TrackExtractorTest::initTestCase()
@@ -41,9 +42,9 @@ void TrackExtractorTest::initTestCase()
     settings.clear();
 
     settings.beginGroup(QLatin1String("Asterix"));
-    settings.setValue(QLatin1String("SicSmr"), 7);
-    settings.setValue(QLatin1String("SicMlat"), 107);
-    settings.setValue(QLatin1String("SicAdsb"), 219);
+    settings.setValue(QLatin1String("SmrSic"), 7);
+    settings.setValue(QLatin1String("MlatSic"), 107);
+    settings.setValue(QLatin1String("AdsbSic"), 219);
     settings.endGroup();
 }
 
@@ -283,7 +284,7 @@ void TrackExtractorTest::test_data()
 
 void TrackExtractorTest::test()
 {
-    TrackExtractor trackExtr;
+    TrackExtractor trackExtr(RunConfig::fromSettings());
 
     QFETCH(SystemType, sysType);
     QFETCH(QVector<TargetReport>, tgtRepsIn);
@@ -306,5 +307,53 @@ void TrackExtractorTest::test()
     }
 }
 
+void TrackExtractorTest::lateTest()
+{
+    using namespace Literals;
+
+    RunConfig config = RunConfig::fromSettings();
+    config.allowedLateness = 1.0;
+
+    TrackExtractor trackExtr(config);
+
+    auto makeTgtRep = [](SystemType st, TrackNum trkNb, const QDateTime &tod) {
+        TargetReport tr;
+        tr.sys_typ_ = st;
+        tr.trk_nb_ = trkNb;
+        tr.tod_ = tod;
+        return tr;
+    };
+
+    trackExtr.addData(makeTgtRep(SystemType::Smr, 1001, "2020-05-05T10:00:05.000Z"_ts));
+
+    // Out of order, but within the allowed lateness.
+    trackExtr.addData(makeTgtRep(SystemType::Smr, 1001, "2020-05-05T10:00:04.500Z"_ts));
+
+    // Behind the SMR watermark.
+    trackExtr.addData(makeTgtRep(SystemType::Smr, 1002, "2020-05-05T10:00:03.000Z"_ts));
+
+    // Each system type has its own watermark.
+    trackExtr.addData(makeTgtRep(SystemType::Mlat, 2001, "2020-05-05T10:00:01.000Z"_ts));
+
+    QCOMPARE(trackExtr.watermarks().watermark(SystemType::Smr), "2020-05-05T10:00:04.000Z"_ts);
+    QCOMPARE(trackExtr.watermarks().lateCount(SystemType::Smr), qint64(1));
+    QCOMPARE(trackExtr.watermarks().lateCount(SystemType::Mlat), qint64(0));
+    QCOMPARE(trackExtr.watermarks().lateSummary(), QLatin1String("SMR 1"));
+
+    const QVector<Track> smrTracks = trackExtr.tracks(SystemType::Smr);
+    QCOMPARE(smrTracks.size(), 1);
+    QCOMPARE(smrTracks.first().size(), 2);
+    QCOMPARE(trackExtr.tracks(SystemType::Mlat).size(), 1);
+
+    // Without an allowed lateness every target report is kept.
+    TrackExtractor allExtr(RunConfig::fromSettings());
+    allExtr.addData(makeTgtRep(SystemType::Smr, 1001, "2020-05-05T10:00:05.000Z"_ts));
+    allExtr.addData(makeTgtRep(SystemType::Smr, 1002, "2020-05-05T10:00:03.000Z"_ts));
+
+    QVERIFY(!allExtr.watermarks().isEnabled());
+    QCOMPARE(allExtr.watermarks().lateCount(), qint64(0));
+    QCOMPARE(allExtr.tracks(SystemType::Smr).size(), 2);
+}
+
 QTEST_GUILESS_MAIN(TrackExtractorTest);
 #include "trackextractortest.moc"
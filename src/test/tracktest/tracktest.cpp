@@ -35,6 +35,7 @@ private slots:
     void testTrack();
     void testTrackCollection();
     void testTrackCollectionSet();
+    void testDataStream();
 
     // TODO: Add tests for intersect(), resample() and average() functions.
 };
@@ -1195,5 +1196,88 @@ void TrackTest::testTrackCollectionSet()
     }
 }
 
+void TrackTest::testDataStream()
+{
+    TargetReport tr_1;
+    tr_1.ds_id_.sac_ = 0;
+    tr_1.ds_id_.sic_ = 219;
+    tr_1.sys_typ_ = SystemType::Adsb;
+    tr_1.tod_ = "2020-05-05T10:00:00.000Z"_ts;
+    tr_1.trk_nb_ = 101;
+    tr_1.mode_s_ = 0x000001;
+    tr_1.mode_3a_ = 0001;
+    tr_1.ident_ = QLatin1String("FOO1234 ");
+    tr_1.tgt_typ_ = TargetType::Aircraft;
+    tr_1.on_gnd_ = true;
+    tr_1.x_ = -50.0;
+    tr_1.y_ = -25.0;
+    tr_1.z_ = 0.0;
+    tr_1.ver_ = 2;
+    tr_1.pic_ = 7;
+    tr_1.narea_ = Aerodrome::NamedArea(Aerodrome::Area::Runway, QLatin1String("RWY1"));
+
+    TargetReport tr_2;
+    tr_2.ds_id_.sac_ = 0;
+    tr_2.ds_id_.sic_ = 219;
+    tr_2.sys_typ_ = SystemType::Adsb;
+    tr_2.tod_ = "2020-05-05T10:00:01.500Z"_ts;
+    tr_2.trk_nb_ = 101;
+    tr_2.x_ = 0.0;
+    tr_2.y_ = 0.0;
+    tr_2.z_ = 0.0;
+    tr_2.narea_ = Aerodrome::NamedArea(Aerodrome::Area::Taxiway);
+
+    const Track trk_modes(0x000001, SystemType::Adsb, 101, {tr_1, tr_2});
+    const Track trk_nomodes(SystemType::Adsb, 101, {tr_2});
+
+    QByteArray data;
+    {
+        QDataStream out(&data, QIODevice::WriteOnly);
+        out << trk_modes << trk_nomodes;
+    }
+
+    QDataStream in(data);
+    Track trk_modes_in;
+    Track trk_nomodes_in;
+    in >> trk_modes_in >> trk_nomodes_in;
+
+    QCOMPARE(in.status(), QDataStream::Ok);
+    QVERIFY(in.atEnd());
+
+    QCOMPARE(trk_modes_in, trk_modes);
+    QCOMPARE(trk_modes_in.mode_s(), trk_modes.mode_s());
+    QCOMPARE(trk_modes_in.begin()->narea_.namedArea().name_, QLatin1String("RWY1"));
+    QCOMPARE(trk_modes_in.begin()->tod_.timeSpec(), Qt::UTC);
+
+    QCOMPARE(trk_nomodes_in, trk_nomodes);
+    QVERIFY(!trk_nomodes_in.mode_s().has_value());
+    QVERIFY(!trk_nomodes_in.begin()->ident_.has_value());
+
+    // Reports that share a timestamp keep their order.
+    TargetReport tr_a = tr_2;
+    tr_a.x_ = 10.0;
+    TargetReport tr_b = tr_2;
+    tr_b.x_ = 20.0;
+    TargetReport tr_c = tr_2;
+    tr_c.x_ = 30.0;
+
+    const Track trk_dup(SystemType::Adsb, 101, {tr_1, tr_a, tr_b, tr_c});
+
+    QByteArray dupData;
+    {
+        QDataStream out(&dupData, QIODevice::WriteOnly);
+        out << trk_dup;
+    }
+
+    QDataStream dupIn(dupData);
+    Track trk_dup_in;
+    dupIn >> trk_dup_in;
+
+    QCOMPARE(dupIn.status(), QDataStream::Ok);
+    QCOMPARE(trk_dup_in.data().values(tr_2.tod_), trk_dup.data().values(tr_2.tod_));
+    QCOMPARE(trk_dup_in.data().value(tr_2.tod_).x_, trk_dup.data().value(tr_2.tod_).x_);
+    QCOMPARE(trk_dup_in, trk_dup);
+}
+
 QTEST_GUILESS_MAIN(TrackTest);
 #include "tracktest.moc"
@@ -37,6 +37,10 @@ private slots:
 
     void testTrafficPeriodCollection_data();
     void testTrafficPeriodCollection();
+    void testTrafficPeriodBuilder_data();
+    void testTrafficPeriodBuilder();
+    void testExpectedTgtReps_data();
+    void testExpectedTgtReps();
 };
 
 void TrafficPeriodTest::initTestCase()
@@ -230,6 +234,101 @@ void TrafficPeriodTest::testTrafficPeriodCollection()
         QCOMPARE(tp, periodsOut.at(i));
         ++i;
     }
+
+    // Running totals.
+    double duration = 0;
+    quint32 etr = 0;
+    for (const TrafficPeriod &tp : periodsOut)
+    {
+        duration += tp.duration();
+        etr += tp.expectedTgtReps();
+    }
+
+    QCOMPARE(tpcol.duration(), duration);
+    QCOMPARE(tpcol.expectedTgtReps(), etr);
+    QCOMPARE(tpcol.beginTimestamp(), periodsOut.first().beginTimestamp());
+    QCOMPARE(tpcol.endTimestamp(), periodsOut.last().endTimestamp());
+}
+
+void TrafficPeriodTest::testTrafficPeriodBuilder_data()
+{
+    testTrafficPeriodCollection_data();
+}
+
+void TrafficPeriodTest::testTrafficPeriodBuilder()
+{
+    QFETCH(QVector<TrafficPeriod>, periodsIn);
+    QFETCH(QVector<TrafficPeriod>, periodsOut);
+
+    TrafficPeriodBuilder builder;
+    for (const TrafficPeriod &tp_in : periodsIn)
+    {
+        builder << tp_in;
+    }
+
+    TrafficPeriodCollection tpcol = builder.build();
+
+    QCOMPARE(tpcol.size(), periodsOut.size());
+
+    int i = 0;
+    for (const TrafficPeriod &tp : tpcol)
+    {
+        QCOMPARE(tp, periodsOut.at(i));
+        ++i;
+    }
+
+    // The batch builder must match incremental insertion.
+    TrafficPeriodCollection tpcolInc;
+    tpcolInc << periodsIn;
+
+    QCOMPARE(tpcol.duration(), tpcolInc.duration());
+    QCOMPARE(tpcol.expectedTgtReps(), tpcolInc.expectedTgtReps());
+}
+
+void TrafficPeriodTest::testExpectedTgtReps_data()
+{
+    QTest::addColumn<QVector<TrafficPeriod>>("periodsIn");
+    QTest::addColumn<double>("freq");
+    QTest::addColumn<quint32>("etr");
+
+    // Two separate periods of 1.5 s: 1 + 1 expected target reports, not
+    // the 3 that truncating the total would give.
+    QVector<TrafficPeriod> separate;
+    separate
+        << TrafficPeriod("2020-05-05T10:00:00.000Z"_ts, "2020-05-05T10:00:01.500Z"_ts, {0x000001})
+        << TrafficPeriod("2020-05-05T10:00:03.000Z"_ts, "2020-05-05T10:00:04.500Z"_ts, {0x000002});
+
+    // Overlapping periods split into 0.7 s {1}, 1.1 s {1, 2} and 0.6 s {2}:
+    // 0 + 2 + 0 at 1 Hz.
+    QVector<TrafficPeriod> overlapping;
+    overlapping
+        << TrafficPeriod("2020-05-05T10:00:00.000Z"_ts, "2020-05-05T10:00:01.800Z"_ts, {0x000001})
+        << TrafficPeriod("2020-05-05T10:00:00.700Z"_ts, "2020-05-05T10:00:02.400Z"_ts, {0x000002});
+
+    QTest::newRow("Separate 1 Hz") << separate << 1.0 << quint32(2);
+    QTest::newRow("Separate 2 Hz") << separate << 2.0 << quint32(6);
+    QTest::newRow("Overlapping 1 Hz") << overlapping << 1.0 << quint32(2);
+    QTest::newRow("Overlapping 4 Hz") << overlapping << 4.0 << quint32(2 + 8 + 2);
+}
+
+void TrafficPeriodTest::testExpectedTgtReps()
+{
+    QFETCH(QVector<TrafficPeriod>, periodsIn);
+    QFETCH(double, freq);
+    QFETCH(quint32, etr);
+
+    TrafficPeriodCollection tpcol;
+    tpcol << periodsIn;
+
+    QCOMPARE(tpcol.expectedTgtReps(freq), etr);
+
+    TrafficPeriodBuilder builder;
+    for (const TrafficPeriod &tp : periodsIn)
+    {
+        builder << tp;
+    }
+
+    QCOMPARE(builder.build().expectedTgtReps(freq), etr);
 }
 
 QTEST_GUILESS_MAIN(TrafficPeriodTest);